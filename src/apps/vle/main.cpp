@@ -215,7 +215,8 @@ static void show_help() noexcept
           "package,P  Select package mode,\n  package name [options]...\n"
           "                vle -P foo create: build new foo package\n"
           "                vle -P foo configure: configure the foo package\n"
-          "                vle -P foo build: build the foo package\n"
+          "                vle -P foo build: build the foo package and\n"
+          "                    compile its experiments (.vpzc)\n"
           "                vle -P foo test: start a unit test campaign\n"
           "                vle -P foo install: install libs\n"
           "                vle -P foo clean: clean up the build directory\n"
@@ -447,6 +448,32 @@ static bool init_package(vle::utils::Package &pkg, const CmdArgs &args)
     return true;
 }
 
+static bool compile_experiments(const vle::utils::Package &pkg)
+{
+    if (not vle::utils::Path(pkg.getExpDir(vle::utils::PKG_BINARY))
+                .is_directory())
+        return true;
+
+    bool success = true;
+
+    for (const auto &exp : pkg.getExperiments(vle::utils::PKG_BINARY)) {
+        std::string vpz = exp.string();
+
+        try {
+            vle::vpz::Vpz::compile(vpz);
+        }
+        catch (const std::exception &e) {
+            fprintf(stderr,
+                    _("Cannot compile experiment `%s': %s\n"),
+                    vpz.c_str(),
+                    e.what());
+            success = false;
+        }
+    }
+
+    return success;
+}
+
 static int manage_package_mode(vle::utils::ContextPtr ctx,
                                const std::string &output_file,
                                std::chrono::milliseconds timeout,
@@ -493,7 +520,7 @@ static int manage_package_mode(vle::utils::ContextPtr ctx,
                 pkg->install();
                 pkg->wait(std::cerr, std::cerr);
             }
-            stop = not pkg->isSuccess();
+            stop = not pkg->isSuccess() or not compile_experiments(*pkg);
         }
         else if (*it == "test") {
             pkg->test();
@@ -951,6 +978,11 @@ int main(int argc, char **argv)
     else
         ctx->set_log_function(std::make_unique<vle_log_file>());
 
+    long log_capacity = 0;
+    if (ctx->get_setting("vle.log.asynchronous", &log_capacity) and
+        log_capacity > 0)
+        ctx->set_log_asynchronous(static_cast<std::size_t>(log_capacity));
+
     CmdArgs commands(argv + ::optind, argv + argc);
 
     switch (mode) {
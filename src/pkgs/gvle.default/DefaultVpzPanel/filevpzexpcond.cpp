@@ -190,7 +190,8 @@ FileVpzExpCond::reload(bool resize)
                         case vle::value::Value::TABLE:
                         case vle::value::Value::XMLTYPE:
                         case vle::value::Value::NIL:
-                        case vle::value::Value::MATRIX: {
+                        case vle::value::Value::MATRIX:
+                        case vle::value::Value::MAPPED: {
                             insertTextEdit(rows, k+2,
                                     VleValueWidget::getValueDisplay(
                                             *val, VleValueWidget::Insight));
@@ -252,7 +253,8 @@ FileVpzExpCond::showEditPlace()
         case vle::value::Value::INTEGER:
         case vle::value::Value::DOUBLE:
         case vle::value::Value::STRING:
-        case vle::value::Value::USER: {
+        case vle::value::Value::USER:
+        case vle::value::Value::MAPPED: {
             QLabel* lab = new QLabel("Nothing to edit");
             ui->vlValue->addWidget(lab);
             lab->show();
@@ -0,0 +1,242 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/utils/unit-test.hpp>
+#include <vle/devs/RootCoordinator.hpp>
+#include <vle/vpz/CoupledModel.hpp>
+#include <vle/vpz/Dynamics.hpp>
+#include <vle/vpz/Experiment.hpp>
+#include <vle/value/Integer.hpp>
+#include <QssSystem.hpp>
+#include <cmath>
+#include <map>
+
+using namespace vle;
+
+#define DECLARE_DYNAMICS_SYMBOL(symbol_, model_)        \
+    extern "C" {                                        \
+        VLE_MODULE vle::devs::Dynamics*                 \
+        symbol_(const vle::devs::DynamicsInit& init,    \
+                const vle::devs::InitEventList& events) \
+        {                                               \
+            return new model_(init, events);            \
+        }                                               \
+    }
+
+struct Result
+{
+    double x;
+    double y;
+    std::uint64_t steps;
+};
+
+std::map<int, Result> decay_results;
+std::map<int, Result> oscillator_results;
+std::map<int, Result> fast_decay_results;
+
+/* dx/dt = -x with x(0) = 1. */
+class Decay : public qss::System
+{
+public:
+    Decay(const devs::DynamicsInit& init, const devs::InitEventList& events)
+        : qss::System(init, events, 1)
+    {
+        depends(0, 0);
+    }
+
+    virtual double compute(std::size_t, const double *q,
+                           devs::Time) const override
+    {
+        return -q[0];
+    }
+
+    virtual void finish() override
+    {
+        decay_results[order()] = { value(0, 5.0), 0.0, steps() };
+    }
+};
+
+/* dx/dt = y, dy/dt = -x with x(0) = 1 and y(0) = 0. */
+class Oscillator : public qss::System
+{
+public:
+    Oscillator(const devs::DynamicsInit& init,
+               const devs::InitEventList& events)
+        : qss::System(init, events, 2)
+    {
+        depends(0, 1);
+        depends(1, 0);
+    }
+
+    virtual double compute(std::size_t i, const double *q,
+                           devs::Time) const override
+    {
+        return i == 0 ? q[1] : -q[0];
+    }
+
+    virtual void finish() override
+    {
+        oscillator_results[order()] = { value(0, 5.0), value(1, 5.0),
+                                        steps() };
+    }
+};
+
+/* dx/dt = -1e5 x with x(0) = 1: the time scale is far below the unit. */
+class FastDecay : public qss::System
+{
+public:
+    FastDecay(const devs::DynamicsInit& init,
+              const devs::InitEventList& events)
+        : qss::System(init, events, 1)
+    {
+        depends(0, 0);
+    }
+
+    virtual double compute(std::size_t, const double *q,
+                           devs::Time) const override
+    {
+        return -1e5 * q[0];
+    }
+
+    virtual void finish() override
+    {
+        fast_decay_results[order()] = { value(0, 5e-5), 0.0, steps() };
+    }
+};
+
+DECLARE_DYNAMICS_SYMBOL(dynamics_decay, Decay)
+DECLARE_DYNAMICS_SYMBOL(dynamics_fast_decay, FastDecay)
+DECLARE_DYNAMICS_SYMBOL(dynamics_oscillator, Oscillator)
+
+void run(const std::string& symbol, int order, double init,
+         double duration = 5.0)
+{
+    auto ctx = vle::utils::make_context();
+    vpz::Vpz vpz;
+
+    vpz.project().experiment().setDuration(duration);
+    vpz.project().experiment().setBegin(0.0);
+
+    vpz::Condition cond("cond");
+    cond.addValueToPort("order", value::Integer::create(order));
+    cond.addValueToPort("quantum", value::Double::create(1e-4));
+    if (duration < 1.0)
+        cond.addValueToPort("time-scale", value::Double::create(duration));
+    if (symbol == "dynamics_oscillator") {
+        auto tuple = value::Tuple::create();
+        tuple->toTuple().add(init);
+        tuple->toTuple().add(0.0);
+        cond.addValueToPort("init", std::move(tuple));
+    } else {
+        cond.addValueToPort("init", value::Double::create(init));
+    }
+    vpz.project().experiment().conditions().add(cond);
+
+    auto x = vpz.project().dynamics().dynamiclist().emplace(
+        "dyn", vpz::Dynamic("dyn"));
+    Ensures(x.second == true);
+    x.first->second.setLibrary(symbol);
+
+    vpz::CoupledModel *top = new vpz::CoupledModel("top", nullptr);
+    auto *atom = top->addAtomicModel("system");
+    atom->setDynamics("dyn");
+    atom->setConditions({ "cond" });
+
+    vpz.project().model().setGraph(std::unique_ptr<vpz::BaseModel>(top));
+
+    devs::RootCoordinator root(ctx);
+    root.load(vpz);
+    vpz.clear();
+    root.init();
+    while (root.run())
+        ;
+    root.finish();
+}
+
+void test_min_positive_root()
+{
+    // (s - 1)(s - 2)(s + 3) = s^3 - 7 s + 6
+    EnsuresApproximatelyEqual(qss::min_positive_root(6, -7, 0, 1), 1.0,
+                              1e-12);
+    // (s - 2)(s - 5) = s^2 - 7 s + 10
+    EnsuresApproximatelyEqual(qss::min_positive_root(10, -7, 1, 0), 2.0,
+                              1e-12);
+    EnsuresApproximatelyEqual(qss::min_positive_root(-4, 2, 0, 0), 2.0,
+                              1e-12);
+    Ensures(devs::isInfinity(qss::min_positive_root(1, 1, 0, 0)));
+    Ensures(devs::isInfinity(qss::min_positive_root(1, 0, 1, 0)));
+}
+
+void test_decay()
+{
+    for (int order = 1; order <= 3; ++order)
+        run("dynamics_decay", order, 1.0);
+
+    for (int order = 1; order <= 3; ++order)
+        EnsuresApproximatelyEqual(decay_results[order].x, std::exp(-5.0),
+                                  1e-2);
+
+    Ensures(decay_results[2].steps < decay_results[1].steps);
+    Ensures(decay_results[3].steps < decay_results[2].steps);
+}
+
+void test_oscillator()
+{
+    for (int order = 2; order <= 3; ++order) {
+        run("dynamics_oscillator", order, 1.0);
+
+        EnsuresApproximatelyEqual(oscillator_results[order].x,
+                                  std::cos(5.0), 1e-2);
+        EnsuresApproximatelyEqual(oscillator_results[order].y,
+                                  -std::sin(5.0), 1e-2);
+    }
+}
+
+void test_fast_decay()
+{
+    for (int order = 1; order <= 3; ++order) {
+        run("dynamics_fast_decay", order, 1.0, 5e-5);
+
+        EnsuresApproximatelyEqual(fast_decay_results[order].x,
+                                  std::exp(-5.0), 1e-2);
+    }
+
+    Ensures(fast_decay_results[2].steps < fast_decay_results[1].steps);
+    Ensures(fast_decay_results[3].steps < fast_decay_results[2].steps);
+}
+
+int main()
+{
+    vle::Init app;
+
+    test_min_positive_root();
+    test_decay();
+    test_oscillator();
+    test_fast_decay();
+
+    return unit_test::report_errors();
+}
@@ -175,9 +175,51 @@ void test_dynamic_obs()
     }
 }
 
+void test_incremental_outputs()
+{
+    auto ctx = vle::utils::make_context();
+    vle::utils::Path p(PKGS_TEST_DIR);
+    vle::utils::Path::current_path(p);
+
+    vpz::Vpz file(PKGS_TEST_DIR "/dynamic_obs.vpz");
+    devs::RootCoordinator root(ctx);
+
+    root.load(file);
+    file.clear();
+    root.init();
+
+    devs::OutputCursor cursor;
+    std::size_t rows = 0;
+    bool header = false;
+
+    while (root.run()) {
+        auto delta = root.outputs(cursor);
+        if (delta and delta->exist("viewTimed")) {
+            const auto &matrix = delta->getMatrix("viewTimed");
+            if (rows == 0)
+                header = matrix.get(0, 0) and matrix.get(0, 0)->isString();
+            rows += matrix.rows();
+        }
+
+        // Nothing new without simulation.
+        auto empty = root.outputs(cursor);
+        Ensures(not empty or not empty->exist("viewTimed"));
+    }
+
+    Ensures(header);
+    EnsuresEqual(cursor["viewTimed"], rows);
+
+    std::unique_ptr<value::Map> out = root.finish();
+    Ensures(out);
+
+    // All the rows but the last one, still open before the finish.
+    EnsuresEqual(out->getMatrix("viewTimed").rows(), rows + 1);
+}
+
 int main()
 {
     test_dynamic_obs();
+    test_incremental_outputs();
 
     return unit_test::report_errors();
 }
@@ -16,7 +16,7 @@
 
 #include <vle/value/Map.hpp>
 #include <vle/value/Tuple.hpp>
-#include <vle/devs/Dynamics.hpp>
+#include <vle/devs/StaticDynamics.hpp>
 #include <deque>
 
 namespace vd = vle::devs;
@@ -24,11 +24,14 @@ namespace vv = vle::value;
 namespace vg = vle::vpz;
 namespace vu = vle::utils;
 
-class Integrator : public vd::Dynamics
+VLE_DEVS_PORT(X_dot, "X_dot");
+VLE_DEVS_PORT(Quanta, "Quanta");
+
+class Integrator : public vd::StaticDynamics<Integrator, X_dot, Quanta>
 {
 public:
     Integrator(const vd::DynamicsInit &init, const vd::InitEventList &events)
-        : vd::Dynamics(init, events)
+        : vd::StaticDynamics<Integrator, X_dot, Quanta>(init, events)
     {
         double x_0_val;
         if (events.exist("X_0")) {
@@ -42,21 +45,18 @@ public:
 
         m_current_value = x_0_val;
 
-        m_x_dot_port_label = "X_dot";
-        m_quanta_port_label = "Quanta";
-
         vg::ConnectionList my_list;
         my_list = getModel().getInputPortList();
 
-        if (0 == my_list.count(m_x_dot_port_label))
+        if (0 == my_list.count(X_dot::name()))
             throw vu::ModellingError("Model %s has no ports %s",
                                      getModelName().c_str(),
-                                     m_x_dot_port_label.c_str());
+                                     X_dot::name());
 
-        if (0 == my_list.count(m_quanta_port_label))
+        if (0 == my_list.count(Quanta::name()))
             throw vu::ModellingError("Model %s has no ports %s",
                                      getModelName().c_str(),
-                                     m_quanta_port_label.c_str());
+                                     Quanta::name());
 
         m_output_port_label = "I_out";
         my_list = getModel().getOutputPortList();
@@ -81,38 +81,30 @@ public:
         return 0;
     }
 
-    virtual void externalTransition(const vd::ExternalEventList &events,
-                                    vd::Time time) override
+    void on(Quanta, const vd::ExternalEvent &event, vd::Time  /*time*/)
     {
-        double up_val, down_val;
-        double x_dot_val;
-
-        auto it = events.begin();
-        while (it != events.end()) {
-            if (m_quanta_port_label == (*it).getPortName()) {
-                up_val = (*it).getMap().getDouble("up");
-                m_upthreshold = up_val;
-                down_val = (*it).getMap().getDouble("down");
-                m_downthreshold = down_val;
-                if (WAIT_FOR_QUANTA == m_state)
-                    m_state = RUNNING;
-                if (WAIT_FOR_BOTH == m_state)
-                    m_state = WAIT_FOR_X_DOT;
-            }
-            if (m_x_dot_port_label == (*it).getPortName()) {
-                x_dot_val = (*it).getMap().getDouble("d_val");
-                record_t record;
-                record.date = time;
-                record.x_dot = x_dot_val;
-                archive.push_back(record);
-                if (WAIT_FOR_X_DOT == m_state)
-                    m_state = RUNNING;
-                if (WAIT_FOR_BOTH == m_state)
-                    m_state = WAIT_FOR_QUANTA;
-            }
-            ++it;
-        }
+        m_upthreshold = event.getMap().getDouble("up");
+        m_downthreshold = event.getMap().getDouble("down");
+        if (WAIT_FOR_QUANTA == m_state)
+            m_state = RUNNING;
+        if (WAIT_FOR_BOTH == m_state)
+            m_state = WAIT_FOR_X_DOT;
+    }
 
+    void on(X_dot, const vd::ExternalEvent &event, vd::Time time)
+    {
+        record_t record;
+        record.date = time;
+        record.x_dot = event.getMap().getDouble("d_val");
+        archive.push_back(record);
+        if (WAIT_FOR_X_DOT == m_state)
+            m_state = RUNNING;
+        if (WAIT_FOR_BOTH == m_state)
+            m_state = WAIT_FOR_QUANTA;
+    }
+
+    void onExternalEnd(vd::Time time)
+    {
         if (RUNNING == m_state) {
             m_current_value = current_value(time);
             m_expected_value = expected_value(time);
@@ -246,8 +238,6 @@ private:
     } State;
     State m_state;
 
-    std::string m_x_dot_port_label;
-    std::string m_quanta_port_label;
     std::string m_output_port_label;
     bool m_has_output_port;
 
@@ -0,0 +1,124 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "QssSystem.hpp"
+
+namespace vd = vle::devs;
+namespace vv = vle::value;
+namespace vu = vle::utils;
+
+/**
+ * A sparse linear system dx/dt = A q + b integrated by the QSS engine.
+ *
+ * The conditions of the model, in addition to the QSS conditions:
+ * - @c size (integer): the number of variables.
+ * - @c A-rows, @c A-columns, @c A-values (tuples): the non-zero
+ *   coefficients of A.
+ * - @c b (tuple of size values, 0).
+ */
+class LinearSystem : public qss::System
+{
+public:
+    LinearSystem(const vd::DynamicsInit &init, const vd::InitEventList &events)
+        : qss::System(init, events, events.getInt("size"))
+        , m_offsets(size() + 1, 0)
+        , m_b(size(), 0.0)
+    {
+        if (events.exist("b")) {
+            const auto &b = events.getTuple("b").value();
+            if (b.size() != size())
+                throw vu::ModellingError("%s: bad b size",
+                                         getModelName().c_str());
+            std::copy(b.begin(), b.end(), m_b.begin());
+        }
+
+        if (not events.exist("A-values"))
+            return;
+
+        const auto &rows = events.getTuple("A-rows").value();
+        const auto &columns = events.getTuple("A-columns").value();
+        const auto &values = events.getTuple("A-values").value();
+
+        if (rows.size() != values.size() or columns.size() != values.size())
+            throw vu::ModellingError("%s: bad A sizes",
+                                     getModelName().c_str());
+
+        for (std::size_t k = 0, e = values.size(); k != e; ++k) {
+            auto i = to_index(rows[k]);
+            auto j = to_index(columns[k]);
+
+            depends(i, j);
+            m_offsets[i + 1]++;
+        }
+
+        for (std::size_t i = 0, e = size(); i != e; ++i)
+            m_offsets[i + 1] += m_offsets[i];
+
+        m_columns.resize(values.size());
+        m_values.resize(values.size());
+
+        std::vector<std::size_t> pos(m_offsets.begin(), m_offsets.end() - 1);
+        for (std::size_t k = 0, e = values.size(); k != e; ++k) {
+            auto p = pos[to_index(rows[k])]++;
+            m_columns[p] = to_index(columns[k]);
+            m_values[p] = values[k];
+        }
+    }
+
+    virtual ~LinearSystem() = default;
+
+protected:
+    virtual double compute(std::size_t i,
+                           const double *q,
+                           vd::Time /* time */) const override
+    {
+        double ret = m_b[i];
+
+        for (auto k = m_offsets[i]; k != m_offsets[i + 1]; ++k)
+            ret += m_values[k] * q[m_columns[k]];
+
+        return ret;
+    }
+
+private:
+    std::size_t to_index(double value) const
+    {
+        if (not(value >= 0.0) or value >= size() or
+            value != std::floor(value))
+            throw vu::ModellingError("%s: bad index %f",
+                                     getModelName().c_str(), value);
+
+        return static_cast<std::size_t>(value);
+    }
+
+    std::vector<std::size_t> m_offsets;
+    std::vector<std::size_t> m_columns;
+    std::vector<double> m_values;
+    std::vector<double> m_b;
+};
+
+DECLARE_DYNAMICS(LinearSystem)
@@ -0,0 +1,583 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_ADAPTATIVE_QSS_QSSSYSTEM_HPP
+#define VLE_ADAPTATIVE_QSS_QSSSYSTEM_HPP
+
+#include <vle/devs/Dynamics.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/String.hpp>
+#include <vle/value/Tuple.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace qss {
+
+/**
+ * Get the smallest positive real root of the polynomial c0 + c1 s + c2 s^2
+ * + c3 s^3 or infinity if the polynomial has no positive root.
+ */
+inline double min_positive_root(double c0, double c1, double c2, double c3)
+{
+    double roots[3];
+    int n = 0;
+
+    if (c3 != 0.0) {
+        const double a = c2 / c3, b = c1 / c3, c = c0 / c3;
+        const double p = b - a * a / 3.0;
+        const double q = 2.0 * a * a * a / 27.0 - a * b / 3.0 + c;
+        const double disc = q * q / 4.0 + p * p * p / 27.0;
+
+        if (disc > 0.0) {
+            const double r = std::sqrt(disc);
+            roots[n++] = std::cbrt(-q / 2.0 + r) + std::cbrt(-q / 2.0 - r) -
+                         a / 3.0;
+        }
+        else if (p == 0.0) {
+            roots[n++] = -a / 3.0;
+        }
+        else {
+            const double m = 2.0 * std::sqrt(-p / 3.0);
+            const double arg =
+              std::max(-1.0, std::min(1.0, 3.0 * q / (p * m)));
+            const double phi = std::acos(arg) / 3.0;
+            const double third = 2.0 * std::acos(-1.0) / 3.0;
+
+            for (int k = 0; k != 3; ++k)
+                roots[n++] = m * std::cos(phi - third * k) - a / 3.0;
+        }
+
+        // The roots of a cubic with a small leading coefficient are not
+        // accurate: refine them with Newton's method.
+        for (int k = 0; k != n; ++k) {
+            for (int it = 0; it != 2; ++it) {
+                const double s = roots[k];
+                const double f = ((c3 * s + c2) * s + c1) * s + c0;
+                const double df = (3.0 * c3 * s + 2.0 * c2) * s + c1;
+                if (df == 0.0)
+                    break;
+                roots[k] = s - f / df;
+            }
+        }
+    }
+    else if (c2 != 0.0) {
+        const double disc = c1 * c1 - 4.0 * c2 * c0;
+
+        if (disc >= 0.0) {
+            const double q = -0.5 * (c1 + std::copysign(std::sqrt(disc), c1));
+            roots[n++] = q / c2;
+            if (q != 0.0)
+                roots[n++] = c0 / q;
+        }
+    }
+    else if (c1 != 0.0) {
+        roots[n++] = -c0 / c1;
+    }
+
+    double ret = vle::devs::infinity;
+    for (int k = 0; k != n; ++k)
+        if (roots[k] > 0.0 and roots[k] < ret)
+            ret = roots[k];
+
+    return ret;
+}
+
+/**
+ * A system of ordinary differential equations integrated with the QSS1,
+ * QSS2 or QSS3 method in a single atomic model.
+ *
+ * Each variable i has a state trajectory x_i (a polynomial of degree @c
+ * order) and a quantized trajectory q_i (a polynomial of degree @c order -
+ * 1). A variable is quantized again when |x_i - q_i| reaches its quantum.
+ * Then only the derivatives which read q_i (declared with depends()) are
+ * computed again.
+ *
+ * compute() only returns the derivative f_i, so the higher coefficients of
+ * x_i are approximated: the derivatives of f_i along the extrapolated
+ * quantized trajectories are forward finite differences (two points for
+ * QSS2, three points for QSS3). The step of the differences is relative to
+ * the time x_i takes to move by its quantum, h_i = derivative-step *
+ * min(quantum_i / |f_i|, time-scale), so that it follows the dynamics of
+ * the variable instead of the time unit of the model.
+ *
+ * The conditions of the model:
+ * - @c order (integer, 2): 1, 2 or 3.
+ * - @c quantum (double, 1e-3): the absolute quantum.
+ * - @c relative-quantum (double, 0): the quantum relative to |x_i|.
+ * - @c derivative-step (double, 1e-2): the step of the finite differences
+ *   relative to the time scale of the variable.
+ * - @c time-scale (double, 1): the largest time scale, used when the
+ *   derivative is null or small.
+ * - @c init (double or tuple of size values, 0): the initial values.
+ * - @c names (set of strings, x0, x1, ...): the names of the variables.
+ *
+ * The observation port of a variable is its name. At each quantization of
+ * a variable, the model sends its value on the output port with the name
+ * of the variable, if this port exists.
+ */
+class System : public vle::devs::Dynamics
+{
+public:
+    System(const vle::devs::DynamicsInit &init,
+           const vle::devs::InitEventList &events,
+           std::size_t size)
+        : vle::devs::Dynamics(init, events)
+        , m_tx(size, 0.0)
+        , m_x0(size, 0.0)
+        , m_x1(size, 0.0)
+        , m_x2(size, 0.0)
+        , m_x3(size, 0.0)
+        , m_tq(size, 0.0)
+        , m_q0(size, 0.0)
+        , m_q1(size, 0.0)
+        , m_q2(size, 0.0)
+        , m_tn(size, vle::devs::infinity)
+        , m_dq(size, 0.0)
+        , m_scratch(size, 0.0)
+        , m_mark(size, 0)
+        , m_output(size, false)
+        , m_quantum(1e-3)
+        , m_relative_quantum(0.0)
+        , m_step(1e-2)
+        , m_time_scale(1.0)
+        , m_last(0.0)
+        , m_next(vle::devs::infinity)
+        , m_epoch(0)
+        , m_steps(0)
+        , m_order(2)
+    {
+        if (size == 0)
+            throw vle::utils::ModellingError("QSS system %s: no variable",
+                                             getModelName().c_str());
+
+        if (events.exist("order"))
+            m_order = events.getInt("order");
+        if (m_order < 1 or m_order > 3)
+            throw vle::utils::ModellingError("QSS system %s: bad order %d",
+                                             getModelName().c_str(),
+                                             m_order);
+
+        if (events.exist("quantum"))
+            m_quantum = events.getDouble("quantum");
+        if (events.exist("relative-quantum"))
+            m_relative_quantum = events.getDouble("relative-quantum");
+        if (not(m_quantum > 0.0) or m_relative_quantum < 0.0)
+            throw vle::utils::ModellingError("QSS system %s: bad quantum",
+                                             getModelName().c_str());
+
+        if (events.exist("derivative-step"))
+            m_step = events.getDouble("derivative-step");
+        if (events.exist("time-scale"))
+            m_time_scale = events.getDouble("time-scale");
+        if (not(m_step > 0.0) or not(m_time_scale > 0.0))
+            throw vle::utils::ModellingError(
+                "QSS system %s: bad derivative step",
+                getModelName().c_str());
+
+        if (events.exist("init")) {
+            const auto &value = events.get("init");
+
+            if (value->isTuple()) {
+                const auto &tuple = value->toTuple().value();
+                if (tuple.size() != size)
+                    throw vle::utils::ModellingError(
+                        "QSS system %s: bad init size",
+                        getModelName().c_str());
+                std::copy(tuple.begin(), tuple.end(), m_x0.begin());
+            }
+            else {
+                std::fill(m_x0.begin(), m_x0.end(), value->toDouble().value());
+            }
+        }
+
+        m_names.reserve(size);
+        if (events.exist("names")) {
+            const auto &names = events.getSet("names");
+            if (names.size() != size)
+                throw vle::utils::ModellingError(
+                    "QSS system %s: bad names size", getModelName().c_str());
+
+            for (std::size_t i = 0; i != size; ++i)
+                m_names.emplace_back(names.getString(i));
+        }
+        else {
+            for (std::size_t i = 0; i != size; ++i)
+                m_names.emplace_back("x" + std::to_string(i));
+        }
+
+        for (std::size_t i = 0; i != size; ++i) {
+            m_index[m_names[i]] = i;
+            m_output[i] = getModel().existOutputPort(m_names[i]);
+        }
+    }
+
+    virtual ~System() = default;
+
+    virtual vle::devs::Time init(vle::devs::Time time) override
+    {
+        build_graph();
+
+        m_last = time;
+        m_steps = 0;
+        m_heap.clear();
+        m_due.clear();
+
+        for (std::size_t i = 0, e = size(); i != e; ++i) {
+            m_tx[i] = time;
+            m_tq[i] = time;
+            m_q0[i] = m_x0[i];
+            m_q1[i] = 0.0;
+            m_q2[i] = 0.0;
+        }
+
+        for (std::size_t i = 0, e = size(); i != e; ++i)
+            derivatives(i, time);
+
+        // The slopes of the quantized trajectories are only known after a
+        // first computation of the derivatives.
+        if (m_order > 1) {
+            for (std::size_t i = 0, e = size(); i != e; ++i) {
+                m_q1[i] = m_x1[i];
+                m_q2[i] = m_order > 2 ? m_x2[i] : 0.0;
+            }
+
+            for (std::size_t i = 0, e = size(); i != e; ++i)
+                derivatives(i, time);
+        }
+
+        for (std::size_t i = 0, e = size(); i != e; ++i) {
+            m_dq[i] = quantum(i);
+            schedule(i, time);
+        }
+
+        next();
+
+        return m_next - m_last;
+    }
+
+    virtual void output(vle::devs::Time time,
+                        vle::devs::ExternalEventList &output) const override
+    {
+        for (auto i : m_due) {
+            if (m_output[i]) {
+                output.emplace_back(m_names[i]);
+                output.back().addDouble(value(i, time));
+            }
+        }
+    }
+
+    virtual vle::devs::Time timeAdvance() const override
+    {
+        return m_next - m_last;
+    }
+
+    virtual void internalTransition(vle::devs::Time time) override
+    {
+        m_last = time;
+        ++m_epoch;
+
+        for (auto i : m_due) {
+            advance(i, time);
+
+            m_tq[i] = time;
+            m_q0[i] = m_x0[i];
+            m_q1[i] = m_order > 1 ? m_x1[i] : 0.0;
+            m_q2[i] = m_order > 2 ? m_x2[i] : 0.0;
+            m_dq[i] = quantum(i);
+            ++m_steps;
+        }
+
+        m_affected.clear();
+        for (auto i : m_due)
+            for (auto k = m_infl_offsets[i]; k != m_infl_offsets[i + 1]; ++k)
+                m_affected.push_back(m_infl_targets[k]);
+
+        for (auto k : m_affected) {
+            if (m_mark[k] == m_epoch)
+                continue;
+
+            m_mark[k] = m_epoch;
+            advance(k, time);
+            derivatives(k, time);
+            schedule(k, time);
+        }
+
+        for (auto i : m_due)
+            if (m_mark[i] != m_epoch)
+                schedule(i, time);
+
+        m_due.clear();
+        next();
+    }
+
+    virtual std::unique_ptr<vle::value::Value>
+    observation(const vle::devs::ObservationEvent &event) const override
+    {
+        auto it = m_index.find(event.getPortName());
+        if (it == m_index.end())
+            return nullptr;
+
+        return vle::value::Double::create(value(it->second, event.getTime()));
+    }
+
+    /** Get the number of variables. */
+    std::size_t size() const noexcept { return m_x0.size(); }
+
+    /** Get the order of the QSS method. */
+    int order() const noexcept { return m_order; }
+
+    /** Get the number of quantizations since the beginning. */
+    std::uint64_t steps() const noexcept { return m_steps; }
+
+    /** Get the value of the variable @e i at @e time. */
+    double value(std::size_t i, vle::devs::Time time) const noexcept
+    {
+        const double dt = time - m_tx[i];
+
+        return m_x0[i] + dt * (m_x1[i] + dt * (m_x2[i] + dt * m_x3[i]));
+    }
+
+protected:
+    /**
+     * Compute the derivative of the variable @e i at @e time. @e q
+     * contains the values of the quantized trajectories of the variables
+     * declared with depends(i, j); the other values are undefined.
+     */
+    virtual double
+    compute(std::size_t i, const double *q, vle::devs::Time time) const = 0;
+
+    /**
+     * Declare that the derivative of the variable @e i reads the variable
+     * @e j. Call it in the constructor of the subclass.
+     */
+    void depends(std::size_t i, std::size_t j)
+    {
+        if (i >= size() or j >= size())
+            throw vle::utils::ModellingError(
+                "QSS system %s: bad dependency %zu %zu",
+                getModelName().c_str(), i, j);
+
+        m_pairs.emplace_back(i, j);
+    }
+
+private:
+    /* Builds the dependencies (the variables read by each derivative) and
+       the influences (the derivatives that read each variable) in
+       compressed sparse rows. */
+    void build_graph()
+    {
+        const auto n = size();
+
+        std::sort(m_pairs.begin(), m_pairs.end());
+        m_pairs.erase(std::unique(m_pairs.begin(), m_pairs.end()),
+                      m_pairs.end());
+
+        m_dep_offsets.assign(n + 1, 0);
+        m_infl_offsets.assign(n + 1, 0);
+
+        for (const auto &elem : m_pairs) {
+            m_dep_offsets[elem.first + 1]++;
+            m_infl_offsets[elem.second + 1]++;
+        }
+
+        for (std::size_t i = 0; i != n; ++i) {
+            m_dep_offsets[i + 1] += m_dep_offsets[i];
+            m_infl_offsets[i + 1] += m_infl_offsets[i];
+        }
+
+        m_dep_targets.resize(m_pairs.size());
+        m_infl_targets.resize(m_pairs.size());
+
+        std::vector<std::size_t> pos(m_infl_offsets.begin(),
+                                     m_infl_offsets.end() - 1);
+
+        for (std::size_t k = 0, e = m_pairs.size(); k != e; ++k) {
+            m_dep_targets[k] = m_pairs[k].second;
+            m_infl_targets[pos[m_pairs[k].second]++] = m_pairs[k].first;
+        }
+    }
+
+    double quantum(std::size_t i) const noexcept
+    {
+        return std::max(m_quantum, m_relative_quantum * std::abs(m_x0[i]));
+    }
+
+    /* The step of the finite differences of @e i for the derivative @e f.
+       A null derivative gives an infinite ratio and the time scale. */
+    double step(std::size_t i, double f) const noexcept
+    {
+        return m_step * std::min(quantum(i) / std::abs(f), m_time_scale);
+    }
+
+    /* Moves the origin of the state trajectory of @e i to @e time. */
+    void advance(std::size_t i, vle::devs::Time time) noexcept
+    {
+        const double dt = time - m_tx[i];
+
+        m_x0[i] = value(i, time);
+        m_x1[i] += dt * (2.0 * m_x2[i] + 3.0 * dt * m_x3[i]);
+        m_x2[i] += 3.0 * dt * m_x3[i];
+        m_tx[i] = time;
+    }
+
+    double derivative(std::size_t i, vle::devs::Time time)
+    {
+        for (auto k = m_dep_offsets[i]; k != m_dep_offsets[i + 1]; ++k) {
+            const auto j = m_dep_targets[k];
+            const double dt = time - m_tq[j];
+
+            m_scratch[j] = m_q0[j] + dt * (m_q1[j] + dt * m_q2[j]);
+        }
+
+        return compute(i, m_scratch.data(), time);
+    }
+
+    /* Computes the coefficients of the state trajectory of @e i at @e time
+       from the derivative on the quantized trajectories. */
+    void derivatives(std::size_t i, vle::devs::Time time)
+    {
+        const double f0 = derivative(i, time);
+
+        m_x1[i] = f0;
+        m_x2[i] = 0.0;
+        m_x3[i] = 0.0;
+
+        if (m_order == 2) {
+            const double h = step(i, f0);
+            const double f1 = derivative(i, time + h);
+
+            m_x2[i] = (f1 - f0) / h / 2.0;
+        }
+        else if (m_order == 3) {
+            const double h = step(i, f0);
+            const double f1 = derivative(i, time + h);
+            const double f2 = derivative(i, time + 2.0 * h);
+
+            m_x2[i] = (-3.0 * f0 + 4.0 * f1 - f2) / (2.0 * h) / 2.0;
+            m_x3[i] = (f0 - 2.0 * f1 + f2) / (h * h) / 6.0;
+        }
+    }
+
+    /* Computes the time when |x_i - q_i| reaches the quantum of @e i. */
+    void schedule(std::size_t i, vle::devs::Time time)
+    {
+        const double dt = time - m_tq[i];
+        const double d0 = m_x0[i] - (m_q0[i] + dt * (m_q1[i] + dt * m_q2[i]));
+        const double d1 = m_x1[i] - (m_q1[i] + 2.0 * dt * m_q2[i]);
+        const double d2 = m_x2[i] - m_q2[i];
+        const double d3 = m_x3[i];
+
+        if (std::abs(d0) >= m_dq[i]) {
+            m_tn[i] = time;
+        }
+        else {
+            const double s = std::min(
+                min_positive_root(d0 - m_dq[i], d1, d2, d3),
+                min_positive_root(d0 + m_dq[i], d1, d2, d3));
+            m_tn[i] = time + s;
+        }
+
+        if (not vle::devs::isInfinity(m_tn[i])) {
+            m_heap.emplace_back(m_tn[i], i);
+            std::push_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+        }
+    }
+
+    /* Pops the variables with the smallest time of next quantization. The
+       heap entries that do not match m_tn are outdated. */
+    void next()
+    {
+        m_next = vle::devs::infinity;
+
+        while (not m_heap.empty()) {
+            auto top = m_heap.front();
+
+            if (m_tn[top.second] == top.first) {
+                if (vle::devs::isInfinity(m_next))
+                    m_next = top.first;
+                else if (top.first != m_next)
+                    break;
+
+                m_due.push_back(top.second);
+            }
+
+            std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+            m_heap.pop_back();
+        }
+
+        std::sort(m_due.begin(), m_due.end());
+        m_due.erase(std::unique(m_due.begin(), m_due.end()), m_due.end());
+    }
+
+    std::vector<double> m_tx;
+    std::vector<double> m_x0;
+    std::vector<double> m_x1;
+    std::vector<double> m_x2;
+    std::vector<double> m_x3;
+    std::vector<double> m_tq;
+    std::vector<double> m_q0;
+    std::vector<double> m_q1;
+    std::vector<double> m_q2;
+    std::vector<double> m_tn;
+    std::vector<double> m_dq;
+    std::vector<double> m_scratch;
+    std::vector<std::uint64_t> m_mark;
+    std::vector<bool> m_output;
+    std::vector<std::string> m_names;
+    std::map<std::string, std::size_t> m_index;
+
+    std::vector<std::pair<std::size_t, std::size_t>> m_pairs;
+    std::vector<std::size_t> m_dep_offsets;
+    std::vector<std::size_t> m_dep_targets;
+    std::vector<std::size_t> m_infl_offsets;
+    std::vector<std::size_t> m_infl_targets;
+
+    std::vector<std::pair<vle::devs::Time, std::size_t>> m_heap;
+    std::vector<std::size_t> m_due;
+    std::vector<std::size_t> m_affected;
+
+    double m_quantum;
+    double m_relative_quantum;
+    double m_step;
+    double m_time_scale;
+    vle::devs::Time m_last;
+    vle::devs::Time m_next;
+    std::uint64_t m_epoch;
+    std::uint64_t m_steps;
+    int m_order;
+};
+}
+
+#endif
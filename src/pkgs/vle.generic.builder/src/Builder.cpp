@@ -15,13 +15,17 @@
  */
 
 #include <algorithm>
+#include <cstdint>
+#include <fstream>
 #include <random>
 #include <vle/devs/Executive.hpp>
 #include <vle/translator/GraphTranslator.hpp>
 #include <vle/translator/MatrixTranslator.hpp>
 #include <vle/utils/Exception.hpp>
+#include <vle/utils/Package.hpp>
 #include <vle/utils/Tools.hpp>
 #include <vle/value/Map.hpp>
+#include <vle/value/Mapped.hpp>
 #include <vle/value/Set.hpp>
 #include <vle/value/Tuple.hpp>
 
@@ -58,6 +62,85 @@ class Builder : public vle::devs::Executive {
         classname = model_classname;
     }
 
+    /**
+     * An array of integers read from a condition. A value::Mapped of
+     * int32 is used without copy, a tuple or a set of numbers is
+     * converted.
+     */
+    struct int_array {
+        std::vector<std::int32_t> storage;
+        const std::int32_t *data = nullptr;
+        std::size_t size = 0;
+    };
+
+    static int_array get_int_array(const vle::devs::InitEventList &events,
+                                   const std::string &name)
+    {
+        int_array ret;
+        const auto &v = events.get(name);
+
+        if (v->isMapped()) {
+            auto span = v->toMapped().span<std::int32_t>();
+            ret.data = span.data();
+            ret.size = span.size();
+            return ret;
+        }
+
+        if (v->isTuple()) {
+            for (auto elem : v->toTuple().value())
+                ret.storage.push_back(static_cast<std::int32_t>(elem));
+        } else if (v->isSet()) {
+            for (const auto &elem : v->toSet().value())
+                ret.storage.push_back(elem->isInteger()
+                                          ? elem->toInteger().value()
+                                          : static_cast<std::int32_t>(
+                                                elem->toDouble().value()));
+        } else {
+            throw vle::utils::ModellingError(
+                "Condition %s: expected mapped, tuple or set of integers",
+                name.c_str());
+        }
+
+        ret.data = ret.storage.data();
+        ret.size = ret.storage.size();
+        return ret;
+    }
+
+    /**
+     * Read the edges from a text file of the package data directory
+     * (the package of the condition @c edges-package): a couple of
+     * integers (source destination) by line.
+     */
+    int_array read_edges_file(const vle::devs::InitEventList &events)
+    {
+        std::string filename = events.getString("edges-file");
+        if (events.exist("edges-package")) {
+            vle::utils::Package pkg(context(),
+                                    events.getString("edges-package"));
+            filename = pkg.getDataFile(filename);
+        }
+
+        std::ifstream ifs(filename);
+        if (not ifs.is_open())
+            throw vle::utils::ModellingError("Can not open edges file %s",
+                                             filename.c_str());
+
+        int_array ret;
+        std::int32_t src, dst;
+        while (ifs >> src >> dst) {
+            ret.storage.push_back(src);
+            ret.storage.push_back(dst);
+        }
+
+        if (not ifs.eof())
+            throw vle::utils::ModellingError("Bad edges file %s",
+                                             filename.c_str());
+
+        ret.data = ret.storage.data();
+        ret.size = ret.storage.size();
+        return ret;
+    }
+
 public:
     vle::translator::graph_generator::connectivity
     graph_generator_connectivity()
@@ -122,6 +205,57 @@ public:
         gg.make_graph(*this, model_number, userdefined);
     }
 
+    void use_edgelist_graph_generator(const vle::devs::InitEventList &events)
+    {
+        auto edges = events.exist("edges-file")
+                         ? read_edges_file(events)
+                         : get_int_array(events, "edges");
+
+        if (edges.size % 2)
+            throw vle::utils::ModellingError("Edges list size error");
+
+        vle::translator::graph_generator::parameter param{
+            std::bind(&Builder::graph_generator_make_model,
+                      this,
+                      std::placeholders::_1,
+                      std::placeholders::_2,
+                      std::placeholders::_3),
+            graph_generator_connectivity(),
+            directed};
+
+        vle::translator::graph_generator gg(param);
+
+        gg.make_graph(*this, model_number, edges.data, edges.size / 2);
+    }
+
+    void use_csr_graph_generator(const vle::devs::InitEventList &events)
+    {
+        auto offsets = get_int_array(events, "offsets");
+        auto targets = get_int_array(events, "targets");
+
+        if (offsets.size != vle::utils::numeric_cast<std::size_t>(
+                                model_number + 1))
+            throw vle::utils::ModellingError("Offsets size error");
+
+        if (offsets.data[model_number] < 0 or
+            vle::utils::numeric_cast<std::size_t>(
+                offsets.data[model_number]) != targets.size)
+            throw vle::utils::ModellingError("Targets size error");
+
+        vle::translator::graph_generator::parameter param{
+            std::bind(&Builder::graph_generator_make_model,
+                      this,
+                      std::placeholders::_1,
+                      std::placeholders::_2,
+                      std::placeholders::_3),
+            graph_generator_connectivity(),
+            directed};
+
+        vle::translator::graph_generator gg(param);
+
+        gg.make_csr_graph(*this, model_number, offsets.data, targets.data);
+    }
+
     void use_smallworld_graph_generator(const vle::devs::InitEventList &events)
     {
         vle::translator::graph_generator::parameter param{
@@ -222,6 +356,10 @@ public:
 
         if (generator_name == "defined")
             use_defined_graph_generator(events);
+        else if (generator_name == "edge-list")
+            use_edgelist_graph_generator(events);
+        else if (generator_name == "csr")
+            use_csr_graph_generator(events);
         else if (generator_name == "small-world")
             use_smallworld_graph_generator(events);
         else if (generator_name == "scale-free")
@@ -46,8 +46,9 @@ class Console : public Plugin
     /** Define the buffer for valid values (model observed). */
     typedef std::vector < bool > ValidElement;
 
-    /** Define a new bag indicator*/
-    typedef std::map < std::string, double> NewBagWatcher;
+    /** Define a new bag indicator (the date of the last value of each
+     * column). */
+    typedef std::vector < double > NewBagWatcher;
 
     bool mFlushByBag;
     bool mJulian;
@@ -142,7 +143,7 @@ public:
                                 % name).str());
         }
 
-        mNewBagWatcher[name] = -1.0;
+        mNewBagWatcher.push_back(-1.0);
         mColumns[name] = mBuffer.size();
         mBuffer.add(std::unique_ptr<value::Value>());
         mValid.push_back(false);
@@ -166,12 +167,9 @@ public:
                          const double& time,
                          std::unique_ptr<value::Value> value) override
     {
-        std::string name(buildname(parent, simulator, port));
-        Columns::iterator it;
-
         if (not simulator.empty()) {
-            name = buildname(parent, simulator, port);
-            it = mColumns.find(name);
+            std::string name(buildname(parent, simulator, port));
+            Columns::iterator it = mColumns.find(name);
 
             if (it == mColumns.end()) {
                 throw utils::InternalError((boost::format(
@@ -179,26 +177,47 @@ public:
                                         "No observable ?") % name).str());
             }
 
-            if (mIsStart) {
-                if (time != mTime ||
-                        (mFlushByBag &&
-                                mNewBagWatcher[name] == time)) {
-                    flush();
-                }
+            push(it->second, time, std::move(value));
+        }
+        mTime = time;
+    }
+
+    /**
+     * Each onNewObservable adds a column at the end of the buffer, the
+     * identifier of the observable is the index of its column.
+     */
+    virtual void onValues(const std::string& /*view*/,
+                          const double& time,
+                          ColumnValue* values,
+                          std::size_t size) override
+    {
+        for (std::size_t i = 0; i != size; ++i)
+            push(values[i].column->id, time, std::move(values[i].value));
+
+        mTime = time;
+    }
+
+    void push(int column, double time, std::unique_ptr<value::Value> value)
+    {
+        if (mIsStart) {
+            if (time != mTime ||
+                    (mFlushByBag &&
+                            mNewBagWatcher[column] == time)) {
+                flush();
+            }
+        } else {
+            if (not mHaveFirstEvent) {
+                mHaveFirstEvent = true;
             } else {
-                if (not mHaveFirstEvent) {
-                    mHaveFirstEvent = true;
-                } else {
-                    flush();
-                    mIsStart = true;
-                }
+                flush();
+                mIsStart = true;
             }
+        }
 
-            mBuffer.set(it->second, std::move(value));
-            mValid[it->second] = true;
+        mBuffer.set(column, std::move(value));
+        mValid[column] = true;
 
-            mNewBagWatcher[name] = time;
-        }
+        mNewBagWatcher[column] = time;
         mTime = time;
     }
 
@@ -176,7 +176,7 @@ void File::onNewObservable(const std::string& simulator,
                         name).str());
     }
 
-    m_newbagwatcher[name] = -1.0;
+    m_newbagwatcher.push_back(-1.0);
     m_columns[name] = m_buffer.size();
     m_buffer.add(std::unique_ptr<value::Value>());
     m_valid.push_back(false);
@@ -197,12 +197,9 @@ void File::onValue(const std::string& simulator,
         const double& time,
         std::unique_ptr<value::Value> value)
 {
-    std::string name(buildname(parent, simulator, port));
-    Columns::iterator it;
-
     if (not simulator.empty()) {
-        name = buildname(parent, simulator, port);
-        it = m_columns.find(name);
+        std::string name(buildname(parent, simulator, port));
+        Columns::iterator it = m_columns.find(name);
 
         if (it == m_columns.end()) {
             throw utils::InternalError(
@@ -210,25 +207,44 @@ void File::onValue(const std::string& simulator,
                             "No observable ?") % name).str());
         }
 
-        if (m_isstart) {
-            if (time != m_time ||
-                    (m_flushbybag &&
-                            m_newbagwatcher[name] == time)) {
-                flush();
-            }
+        push(it->second, time, std::move(value));
+    }
+    m_time = time;
+}
+
+void File::onValues(const std::string& /*view*/,
+        const double& time,
+        ColumnValue* values,
+        std::size_t size)
+{
+    // Each onNewObservable adds a column at the end of the buffer, the
+    // identifier of the observable is the index of its column.
+    for (std::size_t i = 0; i != size; ++i)
+        push(values[i].column->id, time, std::move(values[i].value));
+
+    m_time = time;
+}
+
+void File::push(int column, double time, std::unique_ptr<value::Value> value)
+{
+    if (m_isstart) {
+        if (time != m_time ||
+                (m_flushbybag &&
+                        m_newbagwatcher[column] == time)) {
+            flush();
+        }
+    } else {
+        if (not m_havefirstevent) {
+            m_havefirstevent = true;
         } else {
-            if (not m_havefirstevent) {
-                m_havefirstevent = true;
-            } else {
-                flush();
-                m_isstart = true;
-            }
+            flush();
+            m_isstart = true;
         }
-        m_buffer.set(it->second, std::move(value));
-        m_valid[it->second] = true;
-
-        m_newbagwatcher[name] = time;
     }
+    m_buffer.set(column, std::move(value));
+    m_valid[column] = true;
+
+    m_newbagwatcher[column] = time;
     m_time = time;
 }
 
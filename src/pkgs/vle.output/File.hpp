@@ -106,6 +106,11 @@ public:
                          const double& time,
                          std::unique_ptr<value::Value> value) override;
 
+    virtual void onValues(const std::string& view,
+                          const double& time,
+                          ColumnValue* values,
+                          std::size_t size) override;
+
     virtual std::unique_ptr<value::Matrix> finish(const double& time) override;
 
     class FileType
@@ -130,8 +135,9 @@ private:
     /** Define the buffer for valid values (model observed). */
     typedef std::vector < bool > ValidElement;
 
-    /** Define a new bag indicator*/
-    typedef std::map < std::string, double> NewBagWatcher;
+    /** Define a new bag indicator (the date of the last value of each
+     * column). */
+    typedef std::vector < double > NewBagWatcher;
 
     enum OutputType {
         FILE, /*!< classical file stream (std::ofstream). */
@@ -156,6 +162,8 @@ private:
 
     void flush();
 
+    void push(int column, double time, std::unique_ptr<value::Value> value);
+
     void finalFlush(double trame_time);
 
     void copyToFile(const std::string& filename,
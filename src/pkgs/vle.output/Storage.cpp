@@ -68,37 +68,64 @@ enum StorageHeaderType
                                  * the matrix results. */
 };
 
+/**
+ * The Storage plug-in stores the observations into memory and returns
+ * them as a value::Matrix. The first column stores the dates.
+ *
+ * The rows are appended into chunks of \e inc_rows rows. A chunk is
+ * never reallocated, so appending a row never copies the previous rows
+ * and matrixRows() only copies the rows appended since the cursor of the
+ * caller.
+ */
 class Storage : public Plugin
 {
+    /** A row of the results, shorter than the number of columns if
+     * observables were added after the row. */
+    typedef std::vector < std::unique_ptr<value::Value> > Row;
+
+    /** A chunk of rows, reserved at construction. */
+    typedef std::vector < Row > Chunk;
+
 public:
     Storage(const std::string& location)
         : Plugin(location),
-          m_matrix(nullptr),
           m_time(devs::negativeInfinity),
-          m_headertype(STORAGE_HEADER_NONE)
+          m_headertype(STORAGE_HEADER_NONE),
+          m_rzcolumns(100),
+          m_rzrows(100),
+          m_columns(1),
+          m_rows(0),
+          m_open(false)
     {
     }
 
-    /**
-     * We do not remove the m_matrix attribute. The @c
-     * manager::Simulation can retrieve it from the @c
-     * devs::RootCoordinator. Users have in charge to freed the
-     * m_matrix.
-     */
     virtual ~Storage()
     {
     }
 
     /**
-     * Return a clone of the current matrix
-     * The pointer is given in the finish function
+     * Return a clone of the current results.
      */
     virtual std::unique_ptr<value::Matrix> matrix() const override
     {
-        if (m_matrix) {
-            return std::unique_ptr<value::Matrix>(new value::Matrix(*m_matrix));
-        }
-        return {};
+        if (not m_open)
+            return {};
+
+        return build(0, m_rows, false);
+    }
+
+    /**
+     * Return a clone of the complete rows appended since the row \e
+     * first. The last row is not complete: observations at the same date
+     * can still arrive.
+     */
+    virtual std::unique_ptr<value::Matrix>
+    matrixRows(std::size_t first) const override
+    {
+        if (not m_open or first + 1 >= m_rows)
+            return {};
+
+        return build(first, m_rows - 1, false);
     }
 
     virtual std::string name() const override
@@ -116,18 +143,16 @@ public:
                              std::unique_ptr<value::Value> parameters,
                              const double& /*time*/) override
     {
-        int rzcolumns = 100, rzrows = 100;
-
         if (parameters and parameters->isMap()) {
             const value::Map& map = parameters->toMap();
 
 
             if (map.exist("inc_columns")) {
-                rzcolumns = map.getInt("inc_columns");
+                m_rzcolumns = std::max(1, map.getInt("inc_columns"));
             }
 
             if (map.exist("inc_rows")) {
-                rzrows = map.getInt("inc_rows");
+                m_rzrows = std::max(1, map.getInt("inc_rows"));
             }
 
             if (map.exist("header")) {
@@ -139,15 +164,11 @@ public:
 
             parameters.reset();
         }
-        if (m_headertype == STORAGE_HEADER_TOP) {
-            m_matrix.reset(new value::Matrix(1, 1, rzcolumns, rzrows,
-                 rzcolumns, rzrows));
-            m_matrix->add(0, 0, std::unique_ptr<value::Value>(
-                    new vle::value::String("time")));
-        } else {
-            m_matrix.reset(new value::Matrix(1, 0, rzcolumns, rzrows,
-                    rzcolumns, rzrows));
 
+        m_open = true;
+
+        if (m_headertype == STORAGE_HEADER_TOP) {
+            addRow().emplace_back(new vle::value::String("time"));
         }
     }
 
@@ -158,16 +179,14 @@ public:
                                  const double& /*time*/) override
     {
         std::string key = buildKey(parent, simulator, port);
-        Index idx = m_matrix->columns();
+        Index idx = m_columns++;
 
-        m_colAccess.insert(std::make_pair(key, m_matrix->columns()));
-
-
-        m_matrix->addColumn();
+        m_colAccess.insert(std::make_pair(key, idx));
+        m_colIds.push_back(idx);
 
         if (m_headertype == STORAGE_HEADER_TOP) {
-            m_matrix->add(idx, 0, std::unique_ptr<value::Value>
-                                   (new vle::value::String(key)));
+            set(idx, 0, std::unique_ptr<value::Value>
+                (new vle::value::String(key)));
         }
     }
 
@@ -192,36 +211,115 @@ public:
             std::string key = buildKey(parent, simulator, port);
 
             MapPairIndex::const_iterator it = m_colAccess.find(key);
-            m_matrix->set(it->second, m_matrix->rows()-1, std::move(value));
+            set(it->second, m_rows - 1, std::move(value));
         }
     }
 
+    virtual void onValues(const std::string& /*view*/,
+                          const double& time,
+                          ColumnValue* values,
+                          std::size_t size) override
+    {
+        nextTime(time);
+
+        const Index row = m_rows - 1;
+        for (std::size_t i = 0; i != size; ++i)
+            set(m_colIds[values[i].column->id], row,
+                std::move(values[i].value));
+    }
+
+    /**
+     * Return the results. The values are moved into the matrix, the
+     * plug-in is empty after this call.
+     */
     virtual std::unique_ptr<value::Matrix>
     finish(const double& /*time*/) override
     {
-        return std::move(m_matrix);
+        if (not m_open)
+            return {};
+
+        auto result = build(0, m_rows, true);
+        m_chunks.clear();
+        m_rows = 0;
+        m_open = false;
+
+        return result;
     }
 
 private:
-    std::unique_ptr<value::Matrix>  m_matrix;
+    std::vector < std::unique_ptr < Chunk > > m_chunks;
     MapPairIndex                    m_colAccess;
+    std::vector<Index>              m_colIds; /**< column of each
+                                                * ObservableColumn::id. */
     double                          m_time;
     StorageHeaderType               m_headertype;
+    Index                           m_rzcolumns;
+    Index                           m_rzrows;
+    Index                           m_columns;
+    Index                           m_rows;
+    bool                            m_open;
 
-    inline void nextTime(double trame_time)
+    Row& row(Index i) const
     {
-        if (trame_time != m_time) {
-            m_time = trame_time;
-            setLastTime();
+        return (*m_chunks[i / m_rzrows])[i % m_rzrows];
+    }
+
+    Row& addRow()
+    {
+        if (m_rows % m_rzrows == 0) {
+            m_chunks.emplace_back(new Chunk);
+            m_chunks.back()->reserve(m_rzrows);
         }
+
+        m_chunks.back()->emplace_back();
+        m_chunks.back()->back().reserve(m_columns);
+        ++m_rows;
+
+        return m_chunks.back()->back();
     }
 
-    inline void setLastTime()
+    void set(Index column, Index i, std::unique_ptr<value::Value> value)
     {
-        value::Matrix::size_type row(m_matrix->rows());
-        m_matrix->addRow();
-        m_matrix->add(0, row, std::unique_ptr<value::Value>(
-                new vle::value::Double(m_time)));
+        Row& r = row(i);
+
+        if (r.size() <= column)
+            r.resize(column + 1);
+
+        r[column] = std::move(value);
+    }
+
+    /**
+     * Build a matrix with the rows [\e first, \e last). If \e move is
+     * true, the values are moved from the rows, otherwise, they are
+     * cloned.
+     */
+    std::unique_ptr<value::Matrix> build(Index first, Index last,
+                                         bool move) const
+    {
+        std::unique_ptr<value::Matrix> result(
+            new value::Matrix(m_columns, last - first, m_rzcolumns,
+                              m_rzrows));
+
+        for (Index i = first; i != last; ++i) {
+            Row& r = row(i);
+
+            for (Index j = 0, e = r.size(); j != e; ++j) {
+                if (r[j]) {
+                    result->set(j, i - first,
+                                move ? std::move(r[j]) : r[j]->clone());
+                }
+            }
+        }
+
+        return result;
+    }
+
+    inline void nextTime(double trame_time)
+    {
+        if (trame_time != m_time) {
+            m_time = trame_time;
+            addRow().emplace_back(new vle::value::Double(m_time));
+        }
     }
 };
 
@@ -0,0 +1,73 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_DEVS_CHECKPOINT_HPP
+#define VLE_DEVS_CHECKPOINT_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/devs/Time.hpp>
+#include <vle/value/Value.hpp>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace vle {
+namespace devs {
+
+/**
+ * @brief The state of an atomic model into a @c devs::Checkpoint.
+ */
+struct VLE_API CheckpointModel {
+    /// The date of the next internal event (@c devs::infinity if the
+    /// model is passive).
+    Time tn;
+
+    /// The value returned by the @c devs::Dynamics::serialize function.
+    std::shared_ptr<const value::Value> state;
+};
+
+/**
+ * @brief A @c devs::Checkpoint is a snapshot of a simulation taken between
+ * two bags: the date of the snapshot, and for each atomic model (indexed by
+ * its complete name), its next internal event and its state.
+ *
+ * Between two bags, the external events are already consumed by the
+ * transitions, so the scheduler state is completely defined by the @e tn of
+ * the models: the models with @e tn equal to the date of the snapshot are
+ * the next bag.
+ *
+ * A @c devs::Checkpoint is immutable once built: it can be shared by
+ * several simulations (see @c devs::RootCoordinator::load) to restart from
+ * the same warm state (a spin-up period for example).
+ */
+struct VLE_API Checkpoint {
+    Time time = negativeInfinity;
+    std::map<std::string, CheckpointModel> models;
+};
+}
+} // namespace vle devs
+
+#endif
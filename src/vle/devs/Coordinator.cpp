@@ -25,8 +25,11 @@
  */
 
 #include "Thread.hpp"
+#include <algorithm>
 #include <boost/bind.hpp>
 #include <functional>
+#include <limits>
+#include <map>
 #include <vle/devs/Coordinator.hpp>
 #include <vle/devs/Dynamics.hpp>
 #include <vle/devs/ExternalEvent.hpp>
@@ -46,40 +49,34 @@ using std::map;
 using std::string;
 using std::pair;
 
-namespace {
-
-/** Compute the depth of the hierarchy.
- *
- * @return @e depth returns 0 if executive is in the top model otherwise a
- * internet less than 0.
- */
-inline int depth(const std::unique_ptr<vle::devs::Dynamics> &mdl) noexcept
-{
-    int ret = 0;
-
-    const vle::vpz::CoupledModel *parent = mdl->getModel().getParent();
-    while (parent != nullptr) {
-        parent = parent->getParent();
-        --ret;
-    }
-
-    return ret;
-}
-}
-
 namespace vle {
 namespace devs {
 
 Coordinator::Coordinator(utils::ContextPtr context,
                          const vpz::Dynamics &dyn,
                          const vpz::Classes &cls,
-                         const vpz::Experiment &experiment)
+                         vpz::Experiment experiment)
     : m_context(context)
     , m_currentTime(0.0)
     , m_simulators_thread_pool(m_context)
-    , m_modelFactory(context, m_eventViewList, dyn, cls, experiment)
+    , m_modelFactory(context,
+                     m_eventViewList,
+                     dyn,
+                     cls,
+                     std::move(experiment))
     , m_isStarted(false)
+    , m_parallel_init(false)
+    , m_next_order(0)
 {
+    bool parallel_init = false;
+    m_context->get_setting("vle.simulation.parallel-init", &parallel_init);
+
+    m_parallel_init =
+        parallel_init and m_simulators_thread_pool.parallelize();
+
+    auto resolution = m_modelFactory.experiment().resolution();
+    m_eventTable.setResolution(resolution);
+    m_timed_observation_scheduler.setResolution(resolution);
 }
 
 void Coordinator::init(const vpz::Model &mdls, Time current, Time duration)
@@ -91,10 +88,21 @@ void Coordinator::init(const vpz::Model &mdls, Time current, Time duration)
     m_isStarted = true;
 
     m_eventTable.init(current);
+    buildGraph();
+
+    if (not m_graph.empty() and mdls.node())
+        mdls.node()->clearConnections();
+
+    buildPartitions(current);
 }
 
 void Coordinator::run()
 {
+    if (partitioned()) {
+        runPartitions();
+        return;
+    }
+
     Bag &bag = m_eventTable.getCurrentBag();
     if (not bag.dynamics.empty() or not bag.executives.empty())
         m_currentTime = m_eventTable.getCurrentTime();
@@ -127,14 +135,15 @@ void Coordinator::run()
 
     //
     // First we sort executives models according to the depth of the executive
-    // model into the structure of the models.
+    // model into the structure of the models. The depth is computed when
+    // the simulator is added: executives can add or remove models but
+    // never move a model into another coupled model.
     //
     if (not bag.executives.empty()) {
         std::sort(bag.executives.begin(),
                   bag.executives.end(),
                   [](const Simulator *lhs, const Simulator *rhs) {
-                      return ::depth(lhs->dynamics()) <
-                             ::depth(rhs->dynamics());
+                      return lhs->depth() < rhs->depth();
                   });
     }
 
@@ -191,10 +200,7 @@ void Coordinator::run()
     for (auto &elem : bag.dynamics) {
         auto &observations = elem->getObservations();
         for (auto &obs : observations)
-            obs.view->run(elem->dynamics().get(),
-                          m_currentTime,
-                          obs.portname,
-                          std::move(obs.value));
+            obs.view->push(elem->dynamics().get(), obs);
 
         observations.clear();
     }
@@ -202,62 +208,448 @@ void Coordinator::run()
     for (auto &elem : bag.executives) {
         auto &observations = elem->getObservations();
         for (auto &obs : observations)
-            obs.view->run(elem->dynamics().get(),
-                          m_currentTime,
-                          obs.portname,
-                          std::move(obs.value));
+            obs.view->push(elem->dynamics().get(), obs);
 
         observations.clear();
     }
 
+    for (auto &elem : m_eventViewList)
+        elem.second.flush(m_currentTime);
+
     //
     // Process observation event if the next bag is scheduled for a different
     // date than \e m_currentTime.
     //
     auto next = m_eventTable.getNextTime();
-    if (next > m_currentTime) {
+    if (next > m_currentTime)
+        processTimedObservations(next);
 
-        //
-        // Scheduler is empty. We eat all timed view until the duration time
-        //
-        auto eatuntil = std::min(next, m_durationTime);
+    //
+    // Finally, we destroy model and simulator if one executive delete a model
+    //
+    if (not m_delete_model.empty())
+        dynamic_deletion();
+
+    m_eventTable.makeNextBag();
+    m_currentTime = m_eventTable.getCurrentTime();
+}
 
-        while (m_timed_observation_scheduler.haveObservationAtTime(eatuntil)) {
-            auto obs =
-                m_timed_observation_scheduler.getObservationAtTime(eatuntil);
+void Coordinator::processTimedObservations(Time next)
+{
+    //
+    // Scheduler is empty. We eat all timed view until the duration time
+    //
+    auto eatuntil = std::min(next, m_durationTime);
+
+    while (m_timed_observation_scheduler.haveObservationAtTime(eatuntil)) {
+        auto obs = m_timed_observation_scheduler.getObservationAtTime(eatuntil);
 
-            if (not obs.empty()) {
-                m_currentTime = obs.back().mTime;
+        if (not obs.empty()) {
+            m_currentTime = obs.back().mTime;
 
-                for (auto &elem : obs) {
-                    elem.run();
-                    elem.update();
+            for (auto &elem : obs) {
+                elem.run();
+                elem.update();
 
-                    if (not isInfinity(elem.mTime))
-                        m_timed_observation_scheduler.add(
-                            elem.mView, elem.mTime, elem.mTimestep);
-                }
+                if (not isInfinity(elem.mTime))
+                    m_timed_observation_scheduler.add(
+                        elem.mView, elem.mTime, elem.mTimestep);
             }
         }
+    }
+
+    if (isInfinity(next) or next > m_durationTime) {
+        //
+        // For all Timed view, process a final observation and clear the
+        // scheduler.
+        //
+        m_currentTime = m_durationTime;
+        m_timed_observation_scheduler.finalize(m_currentTime);
+    }
+}
+
+static void transition(Simulator *simulator, Time time)
+{
+    if (simulator->haveInternalEvent()) {
+        if (not simulator->haveExternalEvents())
+            simulator->internalTransition(time);
+        else
+            simulator->confluentTransitions(time);
+    }
+    else {
+        simulator->externalTransition(time);
+    }
+}
+
+void Coordinator::buildPartitions(Time current)
+{
+    bool partition = false;
+    m_context->get_setting("vle.simulation.partition", &partition);
+
+    if (not partition or not m_simulators_thread_pool.parallelize() or
+        not m_eventViewList.empty())
+        return;
+
+    for (const auto &elem : m_simulators)
+        if (elem->dynamics()->isExecutive())
+            return;
+
+    //
+    // The partition of a model is its top-level coupled model. The
+    // top-level atomic models are in the same partition.
+    //
+    std::map<const vpz::BaseModel *, std::size_t> partitions;
+    std::vector<std::size_t> index(m_next_order);
+
+    for (const auto &elem : m_simulators) {
+        const vpz::BaseModel *top = elem->getStructure();
+        while (top->getParent() and top->getParent()->getParent())
+            top = top->getParent();
+
+        if (top->isAtomic())
+            top = nullptr;
 
-        if (isInfinity(next) or next > m_durationTime) {
-            //
-            // For all Timed view, process a final observation and clear the
-            // scheduler.
-            //
-            m_currentTime = m_durationTime;
-            m_timed_observation_scheduler.finalize(m_currentTime);
+        auto it = partitions.emplace(top, partitions.size()).first;
+        index[elem->order()] = it->second;
+    }
+
+    if (partitions.size() < 2)
+        return;
+
+    m_partition_index = std::move(index);
+    for (std::size_t i = 0, e = partitions.size(); i != e; ++i) {
+        m_partitions.emplace_back(std::make_unique<Partition>());
+        m_partitions.back()->scheduler.setResolution(
+            m_eventTable.resolution());
+    }
+
+    for (const auto &elem : m_simulators) {
+        auto partition = m_partition_index[elem->order()];
+        bool boundary = false;
+
+        for (const auto &port : elem->getStructure()->getOutputPortList())
+            forEachTarget(
+                elem.get(),
+                port.first,
+                [this, partition, &boundary](Simulator *target,
+                                             const std::string &) {
+                    if (m_partition_index[target->order()] != partition)
+                        boundary = true;
+                });
+
+        if (boundary)
+            m_partitions[partition]->boundary.emplace_back(elem.get());
+    }
+
+    //
+    // Move the first events from the scheduler to the partitions'
+    // schedulers.
+    //
+    m_eventTable.clear();
+
+    for (const auto &elem : m_simulators) {
+        elem->setBagEpoch(0);
+
+        auto tn = elem->getTn();
+        if (not isInfinity(tn))
+            m_partitions[m_partition_index[elem->order()]]
+                ->scheduler.addInternal(elem.get(), tn);
+    }
+
+    for (auto &elem : m_partitions)
+        elem->scheduler.init(current);
+
+    vInfo(m_context,
+          _("Simulation kernel: %zu partitions\n"),
+          m_partitions.size());
+}
+
+Time Coordinator::partitionHorizon() const
+{
+    Time horizon = infinity;
+
+    for (const auto &elem : m_partitions) {
+        if (elem->boundary.empty())
+            continue;
+
+        Time lookahead = infinity;
+        for (const auto *sim : elem->boundary) {
+            horizon = std::min(horizon, sim->getTn());
+            lookahead = std::min(lookahead, sim->dynamics()->lookahead());
         }
+
+        horizon = std::min(horizon,
+                           elem->scheduler.getCurrentTime() +
+                               std::max(lookahead, Time(0.0)));
     }
 
+    return horizon;
+}
+
+void Coordinator::runPartitions()
+{
+    Time time = infinity;
+    for (const auto &elem : m_partitions)
+        time = std::min(time, elem->scheduler.getCurrentTime());
+
+    m_currentTime = time;
+
+    vDbg(m_context, _("-------- BAG [%f] --------\n"), m_currentTime);
+
     //
-    // Finally, we destroy model and simulator if one executive delete a model
+    // The partitions advance independently until the horizon. The window
+    // stops at the next timed observation and at the end of the
+    // simulation. Otherwise, all the partitions process their bag at @e
+    // time together.
     //
-    if (not m_delete_model.empty())
-        dynamic_deletion();
+    Time horizon = partitionHorizon();
+    Time limit =
+        std::min(m_durationTime, m_timed_observation_scheduler.getNextTime());
+
+    if (horizon > time and limit >= time) {
+        m_simulators_thread_pool.for_each(
+            m_partitions.size(),
+            [this, horizon, limit](std::size_t index) {
+                runPartitionWindow(index, horizon, limit);
+            },
+            1);
+    }
+    else {
+        runPartitionsBag(time);
+    }
 
-    m_eventTable.makeNextBag();
-    m_currentTime = m_eventTable.getCurrentTime();
+    Time next = infinity;
+    for (const auto &elem : m_partitions)
+        next = std::min(next, elem->scheduler.getCurrentTime());
+
+    if (next > m_currentTime)
+        processTimedObservations(next);
+
+    m_currentTime = next;
+}
+
+void Coordinator::runPartitionWindow(std::size_t index,
+                                     Time horizon,
+                                     Time limit)
+{
+    auto &partition = *m_partitions[index];
+
+    for (;;) {
+        Time time = partition.scheduler.getCurrentTime();
+        if (time >= horizon or time > limit)
+            return;
+
+        auto &dynamics = partition.scheduler.getCurrentBag().dynamics;
+        const std::size_t nb_dynamics = dynamics.size();
+
+        for (std::size_t i = 0; i != nb_dynamics; ++i)
+            dynamics[i]->output(time);
+
+        dispatchPartitionEvents(dynamics, nb_dynamics, index);
+
+        for (auto &elem : dynamics)
+            transition(elem, time);
+
+        schedulePartition(partition);
+    }
+}
+
+void Coordinator::runPartitionsBag(Time time)
+{
+    //
+    // The bag of the sequential kernel is the union of the partitions'
+    // bags sorted by creation order.
+    //
+    auto &bag = m_partition_bag;
+    bag.clear();
+
+    for (auto &elem : m_partitions) {
+        elem->scheduler.postpone(time);
+
+        auto &dynamics = elem->scheduler.getCurrentBag().dynamics;
+        bag.insert(bag.end(), dynamics.begin(), dynamics.end());
+    }
+
+    std::sort(bag.begin(),
+              bag.end(),
+              [](const Simulator *lhs, const Simulator *rhs) {
+                  return lhs->order() < rhs->order();
+              });
+
+    for (auto &elem : bag)
+        elem->output(time);
+
+    dispatchPartitionEvents(
+        bag, bag.size(), std::numeric_limits<std::size_t>::max());
+
+    m_simulators_thread_pool.for_each(
+        m_partitions.size(),
+        [this, time](std::size_t index) {
+            auto &partition = *m_partitions[index];
+
+            for (auto &elem : partition.scheduler.getCurrentBag().dynamics)
+                transition(elem, time);
+
+            schedulePartition(partition);
+        },
+        1);
+}
+
+void Coordinator::dispatchPartitionEvents(std::vector<Simulator *> &simulators,
+                                          const std::size_t number,
+                                          const std::size_t partition)
+{
+    for (std::size_t i = 0; i != number; ++i) {
+        if (simulators[i]->result().empty())
+            continue;
+
+        auto &eventList = simulators[i]->result();
+        for (auto &elem : eventList) {
+            forEachTarget(
+                simulators[i],
+                elem.getPortName(),
+                [&](Simulator *simulator, const std::string &port) {
+                    auto target = m_partition_index[simulator->order()];
+
+                    if (partition != std::numeric_limits<std::size_t>::max()
+                        and target != partition)
+                        throw utils::ModellingError(
+                            (fmt(_("Model `%1%' sends an event to another "
+                                   "partition before its lookahead")) %
+                             simulators[i]->getStructure()->getCompleteName())
+                                .str());
+
+                    m_partitions[target]->scheduler.addExternal(
+                        simulator, elem.attributes(), port);
+                });
+        }
+
+        simulators[i]->clear_result();
+    }
+}
+
+void Coordinator::schedulePartition(Partition &partition)
+{
+    for (auto &elem : partition.scheduler.getCurrentBag().dynamics) {
+        auto tn = elem->getTn();
+        if (not isInfinity(tn))
+            partition.scheduler.addInternal(elem, tn);
+    }
+
+    partition.scheduler.makeNextBag();
+}
+
+std::unique_ptr<Checkpoint> Coordinator::checkpoint(Time time) const
+{
+    if (partitioned())
+        throw utils::InternalError(
+            _("Checkpoint: not available with the partitioned kernel"));
+
+    if (m_eventTable.getCurrentTime() < time)
+        throw utils::InternalError(
+            (fmt(_("Checkpoint: bag at %1% before the checkpoint %2%")) %
+             m_eventTable.getCurrentTime() % time)
+                .str());
+
+    auto ret = std::make_unique<Checkpoint>();
+    ret->time = time;
+
+    for (const auto &elem : m_simulators) {
+        auto state = elem->dynamics()->serialize();
+        if (not state)
+            throw utils::ModellingError(
+                (fmt(_("Checkpoint: the model `%1%' does not implement "
+                       "the serialize function")) %
+                 elem->getStructure()->getCompleteName())
+                    .str());
+
+        auto name = elem->getStructure()->getCompleteName();
+        auto result = ret->models.emplace(
+            std::move(name),
+            CheckpointModel{ elem->getTn(), std::move(state) });
+
+        if (not result.second)
+            throw utils::InternalError(
+                (fmt(_("Checkpoint: two models named `%1%'")) %
+                 result.first->first)
+                    .str());
+    }
+
+    return ret;
+}
+
+void Coordinator::restore(const Checkpoint &checkpoint)
+{
+    if (partitioned())
+        throw utils::InternalError(
+            _("Checkpoint: not available with the partitioned kernel"));
+
+    if (checkpoint.models.size() != m_simulators.size())
+        throw utils::InternalError(
+            (fmt(_("Checkpoint: %1% models in the checkpoint, %2% in the "
+                   "simulation")) %
+             checkpoint.models.size() % m_simulators.size())
+                .str());
+
+    m_eventTable.clear();
+    m_currentTime = checkpoint.time;
+
+    for (auto &elem : m_simulators) {
+        auto name = elem->getStructure()->getCompleteName();
+        auto it = checkpoint.models.find(name);
+
+        if (it == checkpoint.models.end())
+            throw utils::InternalError(
+                (fmt(_("Checkpoint: the model `%1%' is not in the "
+                       "checkpoint")) %
+                 name)
+                    .str());
+
+        elem->dynamics()->deserialize(*it->second.state);
+        elem->setTn(it->second.tn);
+
+        if (not isInfinity(it->second.tn))
+            m_eventTable.addInternal(elem.get(), it->second.tn);
+    }
+
+    m_eventTable.init(checkpoint.time);
+}
+
+void Coordinator::inject(Time time,
+                         const std::string &model,
+                         const std::string &port,
+                         std::shared_ptr<value::Value> value)
+{
+    if (partitioned())
+        throw utils::InternalError(
+            _("Inject: not available with the partitioned kernel"));
+
+    if (time > m_eventTable.getCurrentTime())
+        throw utils::ArgError(
+            (fmt(_("Inject: %1% is after the next bag %2%")) % time %
+             m_eventTable.getCurrentTime())
+                .str());
+
+    auto it = std::find_if(m_simulators.begin(),
+                           m_simulators.end(),
+                           [&model](const std::unique_ptr<Simulator> &sim) {
+                               return sim->getStructure()->getCompleteName() ==
+                                      model;
+                           });
+
+    if (it == m_simulators.end())
+        throw utils::ArgError(
+            (fmt(_("Inject: unknown model `%1%'")) % model).str());
+
+    if (not(*it)->getStructure()->existInputPort(port))
+        throw utils::ArgError(
+            (fmt(_("Inject: unknown input port `%1%' in model `%2%'")) % port %
+             model)
+                .str());
+
+    m_eventTable.postpone(time);
+    m_eventTable.addExternal(it->get(), std::move(value), port);
+    m_currentTime = time;
 }
 
 void Coordinator::createModel(vpz::AtomicModel *model,
@@ -331,26 +723,8 @@ void Coordinator::dynamic_deletion()
 
     m_delete_model.clear();
 
-    for (auto &elem : lst) {
-        m_eventTable.delSimulator(elem);
-
-        for (auto it = m_simulators.begin(), et = m_simulators.end(); it != et;
-             ++it) {
-            if (it->get() == elem) {
-                elem->finish();
-                auto &observations = elem->getObservations();
-                for (auto &obs : observations)
-                    obs.view->run(elem->dynamics().get(),
-                                  m_currentTime,
-                                  obs.portname,
-                                  std::move(obs.value));
-
-                observations.clear();
-                m_simulators.erase(it);
-                break;
-            }
-        }
-    }
+    for (auto &elem : lst)
+        m_simulators.erase(elem->slot());
 }
 
 void Coordinator::getSimulatorsSource(
@@ -404,9 +778,14 @@ Simulator *Coordinator::addModel(vpz::AtomicModel *model)
 {
     assert(model && "Coordinator: nullptr model to add?");
 
-    m_simulators.emplace_back(std::make_unique<Simulator>(model));
+    auto simulator = std::make_unique<Simulator>(model);
+    auto *ret = simulator.get();
+
+    ret->setSlot(m_simulators.insert(std::move(simulator)));
+    ret->setOrder(m_next_order++);
+    ret->updateDepth();
 
-    return m_simulators.back().get();
+    return ret;
 }
 
 ///
@@ -420,6 +799,19 @@ void Coordinator::delAtomicModel(vpz::AtomicModel *atom,
 
     Simulator *satom = atom->get_simulator();
 
+    //
+    // The final observations are sent while the views still know the
+    // observables of the model and before the model itself is deleted.
+    //
+    m_eventTable.delSimulator(satom);
+    satom->finish();
+
+    auto &observations = satom->getObservations();
+    for (auto &obs : observations)
+        obs.view->run(satom->dynamics().get(), m_currentTime, obs);
+
+    observations.clear();
+
     for (auto &elem : m_eventViewList)
         elem.second.removeObservable(satom->dynamics().get());
 
@@ -455,20 +847,67 @@ void Coordinator::dispatchExternalEvent(std::vector<Simulator *> &simulators,
 
         auto &eventList = simulators[i]->result();
         for (auto &elem : eventList) {
-            auto x = simulators[i]->targets(elem.getPortName());
-
-            if (x.first != x.second and x.first->second.first) {
-                for (auto jt = x.first; jt != x.second; ++jt)
-                    m_eventTable.addExternal(jt->second.first,
-                                             elem.attributes(),
-                                             jt->second.second);
-            }
+            forEachTarget(
+                simulators[i],
+                elem.getPortName(),
+                [this, &elem](Simulator *simulator, const std::string &port) {
+                    m_eventTable.addExternal(
+                        simulator, elem.attributes(), port);
+                });
         }
 
         simulators[i]->clear_result();
     }
 }
 
+template <typename Function>
+void Coordinator::forEachTarget(Simulator *simulator,
+                                const std::string &port,
+                                Function function)
+{
+    if (not m_graph.empty()) {
+        const ModelGraph::Target *first, *last;
+
+        if (m_graph.targets(simulator, m_graph.port(port), &first, &last))
+            for (; first != last; ++first)
+                function(first->simulator, m_graph.name(first->port));
+
+        return;
+    }
+
+    auto x = simulator->targets(port);
+
+    if (x.first != x.second and x.first->second.first) {
+        for (auto jt = x.first; jt != x.second; ++jt)
+            function(jt->second.first, jt->second.second);
+    }
+}
+
+void Coordinator::buildGraph()
+{
+    //
+    // Only executives change the structure of the models: without
+    // executive, the simulators use the compact graph.
+    //
+    std::vector<Simulator *> simulators;
+    simulators.reserve(m_simulators.size());
+
+    for (const auto &elem : m_simulators) {
+        if (elem->dynamics()->isExecutive())
+            return;
+
+        simulators.emplace_back(elem.get());
+    }
+
+    std::sort(simulators.begin(),
+              simulators.end(),
+              [](const Simulator *lhs, const Simulator *rhs) {
+                  return lhs->order() < rhs->order();
+              });
+
+    m_graph.build(simulators);
+}
+
 void Coordinator::buildViews()
 {
     const vpz::Outputs &outs(m_modelFactory.outputs());
@@ -498,6 +937,11 @@ void Coordinator::buildViews()
 
                 m_timed_observation_scheduler.add(
                     &v, m_currentTime, elem.second.timestep());
+
+                if (elem.second.aggregation() != vpz::View::AGGREGATE_NONE)
+                    v.setAggregation(elem.second.aggregation(),
+                                     elem.second.window(),
+                                     m_currentTime);
             }
             else {
                 auto &v = m_eventViewList[elem.second.name()];
@@ -510,6 +954,11 @@ void Coordinator::buildViews()
                        file,
                        m_currentTime,
                        (output.data()) ? output.data()->clone() : nullptr);
+
+                if (elem.second.aggregation() != vpz::View::AGGREGATE_NONE)
+                    v.setAggregation(elem.second.aggregation(),
+                                     elem.second.window(),
+                                     m_currentTime);
             }
         }
     }
@@ -517,24 +966,56 @@ void Coordinator::buildViews()
 
 void Coordinator::processInit(Simulator *simulator)
 {
-    Time tn = simulator->init(m_currentTime);
+    scheduleInit(simulator, simulator->init(m_currentTime));
+}
 
+void Coordinator::scheduleInit(Simulator *simulator, Time tn)
+{
     if (not isInfinity(tn)) {
         m_eventTable.addInternal(simulator, tn);
     }
 }
 
+std::size_t Coordinator::getMergedBags() const noexcept
+{
+    auto ret = m_eventTable.mergedBags();
+
+    for (const auto &elem : m_partitions)
+        ret += elem->scheduler.mergedBags();
+
+    return ret;
+}
+
 std::unique_ptr<value::Map> Coordinator::finish()
 {
-    for (auto &elem : m_simulators) {
-        assert(elem.get());
+    if (m_eventTable.resolution() > 0.0)
+        vInfo(m_context,
+              _("Simulation kernel: %zu bags merged by the time resolution "
+                "%g\n"),
+              getMergedBags(),
+              m_eventTable.resolution());
+
+    //
+    // The deletions change the order of the simulators in the slot map:
+    // models are finished in the creation order.
+    //
+    std::vector<Simulator *> simulators;
+    simulators.reserve(m_simulators.size());
+    for (auto &elem : m_simulators)
+        simulators.emplace_back(elem.get());
+
+    std::sort(simulators.begin(),
+              simulators.end(),
+              [](const Simulator *lhs, const Simulator *rhs) {
+                  return lhs->order() < rhs->order();
+              });
+
+    for (auto *elem : simulators) {
+        assert(elem);
         elem->finish();
         auto &observations = elem->getObservations();
         for (auto &obs : observations)
-            obs.view->run(elem->dynamics().get(),
-                          m_currentTime,
-                          obs.portname,
-                          std::move(obs.value));
+            obs.view->run(elem->dynamics().get(), m_currentTime, obs);
 
         observations.clear();
     }
@@ -590,5 +1071,32 @@ std::unique_ptr<value::Map> Coordinator::getMap() const
 
     return result;
 }
+
+std::unique_ptr<value::Map> Coordinator::getMap(OutputCursor &cursor) const
+{
+    std::unique_ptr<value::Map> result;
+
+    auto read = [&result, &cursor](const std::string &name, const View &view) {
+        auto &first = cursor[name];
+        auto matrix = view.matrix(first);
+
+        if (matrix) {
+            first += matrix->rows();
+
+            if (not result)
+                result = std::unique_ptr<value::Map>(new value::Map());
+
+            result->add(name, std::move(matrix));
+        }
+    };
+
+    for (const auto &elem : m_timedViewList)
+        read(elem.first, elem.second);
+
+    for (const auto &elem : m_eventViewList)
+        read(elem.first, elem.second);
+
+    return result;
+}
 }
 } // namespace vle devs
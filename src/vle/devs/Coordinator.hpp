@@ -29,7 +29,9 @@
 
 #include "Thread.hpp"
 #include <vle/DllDefines.hpp>
+#include <vle/devs/Checkpoint.hpp>
 #include <vle/devs/ModelFactory.hpp>
+#include <vle/devs/ModelGraph.hpp>
 #include <vle/devs/Scheduler.hpp>
 #include <vle/devs/Simulator.hpp>
 #include <vle/devs/Time.hpp>
@@ -52,7 +54,7 @@ public:
     Coordinator(utils::ContextPtr context,
                 const vpz::Dynamics &dyn,
                 const vpz::Classes &cls,
-                const vpz::Experiment &experiment);
+                vpz::Experiment experiment);
 
     ~Coordinator() = default;
 
@@ -62,6 +64,10 @@ public:
      * call for each Simulator the processInitEvent. Before this,
      * dispatchStateEvent is call for all StateEvent.
      *
+     * Without executive, the connections are copied into the compact graph
+     * and removed from the models of @e mdls (the names of the ports are
+     * kept, see vpz::BaseModel::clearConnections()).
+     *
      * @throw Exception::Internal if a condition have no model port name
      * associed.
      */
@@ -80,6 +86,42 @@ public:
      */
     void run();
 
+    /**
+     * @brief Build a snapshot of the simulation. All the bags before @e
+     * time must be processed.
+     * @param time The date of the snapshot.
+     * @throw utils::InternalError if a bag before @e time remains.
+     * @throw utils::ModellingError if a model does not implement the
+     * devs::Dynamics::serialize function.
+     */
+    std::unique_ptr<Checkpoint> checkpoint(Time time) const;
+
+    /**
+     * @brief Restore the state of the models and the scheduler from a
+     * snapshot. Must be called after @c init().
+     * @param checkpoint The snapshot built by @c checkpoint() on the same
+     * model.
+     * @throw utils::InternalError if the models differ from the snapshot.
+     */
+    void restore(const Checkpoint &checkpoint);
+
+    /**
+     * @brief Send an external event to the input port of an atomic model
+     * between two bags. The event is processed in a bag at @e time, before
+     * the next bag.
+     * @param time The date of the event, after the last processed bag and
+     * before or at the next bag.
+     * @param model The complete name of the atomic model.
+     * @param port The name of the input port.
+     * @param value The value of the event.
+     * @throw utils::ArgError if the model or the port does not exist or if
+     * @e time is after the next bag.
+     */
+    void inject(Time time,
+                const std::string &model,
+                const std::string &port,
+                std::shared_ptr<value::Value> value);
+
     /**
      * @brief Build a new devs::Simulator from the dynamics library. Attach
      * to this model information of dynamics, condition and observable.
@@ -169,6 +211,12 @@ public:
 
     inline Time getCurrentTime() const { return m_currentTime; }
 
+    /**
+     * @brief Get the number of bags merged by the time resolution of the
+     * experiment (see vpz::Experiment::resolution()).
+     */
+    std::size_t getMergedBags() const noexcept;
+
     /**
      * @brief Get a constant reference to the list of vpz::Dynamics objects.
      * @return A constant reference to the list of vpz::Dynamics objects.
@@ -217,6 +265,46 @@ public:
 
     void processInit(Simulator *simulator);
 
+    /**
+     * @brief Add the simulator into the scheduler if its first internal
+     * event @e tn, computed by Simulator::init(), is finite.
+     */
+    void scheduleInit(Simulator *simulator, Time tn);
+
+    /**
+     * @brief Return true if the atomic models can be built and initialized
+     * on the simulation thread pool (the @e vle.simulation.parallel-init
+     * setting with at least one worker thread).
+     */
+    bool parallelInit() const noexcept { return m_parallel_init; }
+
+    /**
+     * @brief Return true if the partitioned kernel is used: each top-level
+     * coupled model (and the top-level atomic models together) has its
+     * own scheduler. Partitions advance independently on the simulation
+     * thread pool until a safe horizon computed from the
+     * Dynamics::lookahead() of the models connected to other partitions.
+     * The bags are the same as the sequential kernel.
+     *
+     * The kernel is used with the @e vle.simulation.partition setting, at
+     * least one worker thread, two partitions, no executive and no event
+     * view.
+     */
+    bool partitioned() const noexcept { return not m_partitions.empty(); }
+
+    /**
+     * @brief Call @e function for each index in [0, size) on the
+     * simulation thread pool, by blocks of @e block_size indices (0 for
+     * the @e vle.simulation.block-size setting).
+     * @throw The exception of the lowest index if any.
+     */
+    void parallelFor(std::size_t size,
+                     const std::function<void(std::size_t)> &function,
+                     long block_size = 0)
+    {
+        m_simulators_thread_pool.for_each(size, function, block_size);
+    }
+
     /**
      * Retrieves for all Views the \c vle::value::Matrix result.
      *
@@ -225,6 +313,18 @@ public:
      */
     std::unique_ptr<value::Map> getMap() const;
 
+    /**
+     * Retrieves for all Views the rows of the \c vle::value::Matrix result
+     * appended since the previous call with the same cursor. Only the
+     * complete rows are returned: the last row of a view can still
+     * receive values.
+     *
+     * @param cursor the number of rows already read for each view,
+     * updated by this function.
+     * @return NULL if there is no new row.
+     */
+    std::unique_ptr<value::Map> getMap(OutputCursor &cursor) const;
+
     /**
      * Called when the simulation finishes
      *
@@ -261,7 +361,8 @@ private:
     Time m_currentTime;
     Time m_durationTime;
     SimulatorProcessParallel m_simulators_thread_pool;
-    std::vector<std::unique_ptr<Simulator>> m_simulators;
+    SlotMap<Simulator> m_simulators;
+    ModelGraph m_graph;
     Scheduler m_eventTable;
     TimedObservationScheduler m_timed_observation_scheduler;
     std::map<std::string, View> m_eventViewList;
@@ -271,6 +372,104 @@ private:
     std::vector<vpz::BaseModel *> m_delete_model;
 
     bool m_isStarted;
+    bool m_parallel_init;
+    std::size_t m_next_order;
+
+    /**
+     * @brief The atomic models of a top-level coupled model with their
+     * scheduler.
+     */
+    struct Partition {
+        Scheduler scheduler;
+
+        /* The models with an output port connected to another partition. */
+        std::vector<Simulator *> boundary;
+    };
+
+    std::vector<std::unique_ptr<Partition>> m_partitions;
+
+    /* The index of the partition of each simulator (by creation order). */
+    std::vector<std::size_t> m_partition_index;
+
+    /* The union of the partitions' bags reused by runPartitionsBag(). */
+    std::vector<Simulator *> m_partition_bag;
+
+    /**
+     * @brief Build the compact graph of the connections if the structure
+     * of the models is static (no executive).
+     *
+     * The graph is not updated when an executive changes the structure:
+     * if an executive exists, no graph is built and the simulators search
+     * their targets into the models.
+     */
+    void buildGraph();
+
+    /**
+     * @brief Call @e function for each target (simulator and input port)
+     * of the output port @e port of the simulator. Use the compact graph
+     * if it exists, the targets of the simulator otherwise.
+     */
+    template <typename Function>
+    void forEachTarget(Simulator *simulator,
+                       const std::string &port,
+                       Function function);
+
+    /**
+     * @brief Split the models into partitions if the partitioned kernel is
+     * enabled and move the scheduled events into the partitions.
+     */
+    void buildPartitions(Time current);
+
+    /**
+     * @brief The run() function of the partitioned kernel: process the
+     * bags of all partitions before the safe horizon (in parallel) or the
+     * next bag of all partitions together.
+     */
+    void runPartitions();
+
+    /**
+     * @brief Compute the date before which no partition can receive an
+     * event from another partition.
+     */
+    Time partitionHorizon() const;
+
+    /**
+     * @brief Process the bags of a partition with a date lower than @e
+     * horizon and lower or equal to @e limit.
+     */
+    void runPartitionWindow(std::size_t index, Time horizon, Time limit);
+
+    /**
+     * @brief Process the bags at @e time of all the partitions in the
+     * order of the sequential kernel.
+     */
+    void runPartitionsBag(Time time);
+
+    /**
+     * @brief Dispatch the external events of the @e number first
+     * simulators to the partitions' schedulers.
+     * @param partition The partition of the simulators or @e
+     * std::numeric_limits<std::size_t>::max() to accept events between
+     * partitions.
+     * @throw utils::ModellingError if an event is sent to another
+     * partition (a model does not respect its lookahead).
+     */
+    void dispatchPartitionEvents(std::vector<Simulator *> &simulators,
+                                 const std::size_t number,
+                                 const std::size_t partition);
+
+    /**
+     * @brief Add the simulators of the current bag into the scheduler of
+     * the partition and build the next bag.
+     */
+    void schedulePartition(Partition &partition);
+
+    /**
+     * @brief Process the timed observations before @e next (the date of
+     * the next bag) and the final observations at the end of the
+     * simulation.
+     */
+    void processTimedObservations(Time next);
 
     /**
      * @brief Build, for each vpz::View a StreamWriter and View.
@@ -297,9 +496,10 @@ private:
                                const std::size_t number);
 
     /**
-     * @brief Delete the atomic model from Graph, the Simulator from
-     * Coordinator and clean all events on devs::EventTable. Do not
-     * use the AtomicModel after this function, it is delete.
+     * @brief Finish the Simulator of the atomic model, send its last
+     * observations, remove its observables from the views and clean all
+     * events on devs::EventTable. The Simulator is added to \e
+     * to_delete, the caller deletes the model and the Simulator.
      *
      * @param atom the model to delete.
      */
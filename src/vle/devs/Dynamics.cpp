@@ -43,6 +43,7 @@ Dynamics::Dynamics(const DynamicsInit& init,
     : m_context(init.context)
     , m_model(init.model)
     , m_packageid(init.packageid)
+    , m_seed(init.seed)
 {
 }
 
@@ -36,6 +36,7 @@
 #include <vle/devs/Time.hpp>
 #include <vle/utils/Context.hpp>
 #include <vle/utils/PackageTable.hpp>
+#include <vle/utils/Rand.hpp>
 #include <vle/utils/Types.hpp>
 #include <vle/value/Boolean.hpp>
 #include <vle/value/Double.hpp>
@@ -246,12 +247,62 @@ public:
         return {};
     }
 
+    /**
+     * @brief Process an observation event into a real number without
+     * allocation. The views which reduce their observations (see @c
+     * vpz::View::setAggregation()) call it before observation().
+     * @param event the state event with of the port
+     * @param[out] value the value of state variable
+     * @return false if the port is not observed as a real number: the
+     * view calls observation() instead.
+     */
+    virtual bool realObservation(const ObservationEvent & /* event */,
+                                 double & /* value */) const
+    {
+        return false;
+    }
+
     /**
      * @brief When the simulation of the atomic model is finished, the
      * finish method is invoked.
      */
     virtual void finish() {}
 
+    /**
+     * @brief Save the state of the model into a checkpoint (see @c
+     * devs::Checkpoint). The default implementation returns a null pointer:
+     * the model does not support the checkpoint and the simulation can not
+     * be saved.
+     *
+     * The checkpoint is taken between two bags, the model does not have
+     * pending external events.
+     * @return A value with the complete state of the model.
+     */
+    virtual std::unique_ptr<vle::value::Value> serialize() const
+    {
+        return {};
+    }
+
+    /**
+     * @brief Restore the state of the model from the value built by @c
+     * serialize(). The function is called after the @c init() function,
+     * so the parameters read from the conditions are those of the new
+     * simulation. The value is shared between several simulations and must
+     * not be kept by reference.
+     * @param state The value returned by @c serialize().
+     */
+    virtual void deserialize(const vle::value::Value & /* state */) {}
+
+    /**
+     * @brief Get the lookahead of the model: after an external event at
+     * date @e t, the model does not send output before @e t +
+     * lookahead(). The partitioned kernel uses it to compute the date
+     * until which the partitions advance independently. The default
+     * implementation returns 0 (no guarantee).
+     * @return A positive duration.
+     */
+    virtual Time lookahead() const { return 0.0; }
+
     /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
      * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
      * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
@@ -390,6 +441,31 @@ public:
      */
     utils::ContextPtr context() const noexcept { return m_context; }
 
+    /**
+     * Get the seed of the random streams of the simulation (the @e seed
+     * port of the simulation engine condition).
+     */
+    std::uint64_t seed() const noexcept { return m_seed; }
+
+    /**
+     * Build the random stream @e stream of the atomic model. The stream
+     * depends only on the seed of the simulation and on the complete name
+     * of the atomic model, so the draws of a model are reproducible
+     * whatever the other models, the number of threads or the order of
+     * the transitions.
+     *
+     * @code
+     * MyModel(const vd::DynamicsInit& init, const vd::InitEventList& evts)
+     *   : vd::Dynamics(init, evts)
+     *   , m_rand(randStream())
+     * {}
+     * @endcode
+     */
+    utils::RandStream randStream(std::uint64_t stream = 0) const
+    {
+        return utils::RandStream(m_seed, m_model.getCompleteName(), stream);
+    }
+
 private:
     ///< A reference to the context.
     utils::ContextPtr m_context;
@@ -399,6 +475,9 @@ private:
 
     ///< An iterator to std::set of the vle::utils::PackageTable.
     PackageId m_packageid;
+
+    ///< The seed of the random streams.
+    std::uint64_t m_seed;
 };
 
 #define Trace(ctx, priority, arg...)                                          \
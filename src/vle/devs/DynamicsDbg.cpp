@@ -181,4 +181,31 @@ void DynamicsDbg::finish()
     mDynamics->finish();
 }
 
+std::unique_ptr<vle::value::Value> DynamicsDbg::serialize() const
+{
+    assert(mDynamics && "DynamicsDbg: missing set(Dynamics)");
+
+    vDbg(context(), _("                     %s [DEVS] serialize\n"),
+         mName.c_str());
+
+    return mDynamics->serialize();
+}
+
+void DynamicsDbg::deserialize(const vle::value::Value& state)
+{
+    assert(mDynamics && "DynamicsDbg: missing set(Dynamics)");
+
+    vDbg(context(), _("                     %s [DEVS] deserialize\n"),
+         mName.c_str());
+
+    mDynamics->deserialize(state);
+}
+
+Time DynamicsDbg::lookahead() const
+{
+    assert(mDynamics && "DynamicsDbg: missing set(Dynamics)");
+
+    return mDynamics->lookahead();
+}
+
 }} // namespace vle devs
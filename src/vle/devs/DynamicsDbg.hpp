@@ -157,6 +157,12 @@ public:
      * finish method is invoked.
      */
     virtual void finish() override;
+
+    virtual std::unique_ptr<vle::value::Value> serialize() const override;
+
+    virtual void deserialize(const vle::value::Value& state) override;
+
+    virtual Time lookahead() const override;
 };
 
 }} // namespace vle devs
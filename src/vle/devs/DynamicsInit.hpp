@@ -28,6 +28,8 @@
 #ifndef VLE_DEVS_DYNAMICS_INIT_HPP
 #define VLE_DEVS_DYNAMICS_INIT_HPP
 
+#include <cstdint>
+
 namespace vle { namespace devs {
 
 class Coordinator;
@@ -37,6 +39,7 @@ struct DynamicsInit
     utils::ContextPtr       context;
     const vpz::AtomicModel& model;
     PackageId               packageid;
+    std::uint64_t           seed = 1; /**< Seed of the random streams. */
 };
 
 struct ExecutiveInit
@@ -45,6 +48,7 @@ struct ExecutiveInit
     utils::ContextPtr       context;
     const vpz::AtomicModel& model;
     PackageId               packageid;
+    std::uint64_t           seed = 1; /**< Seed of the random streams. */
 };
 
 struct DynamicsWrapperInit
@@ -53,6 +57,7 @@ struct DynamicsWrapperInit
     utils::ContextPtr       context;
     const vpz::AtomicModel& model;
     PackageId               packageid;
+    std::uint64_t           seed = 1; /**< Seed of the random streams. */
 };
 
 }} // namespace vle devs
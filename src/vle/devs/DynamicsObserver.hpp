@@ -48,6 +48,10 @@ class DynamicsObserver : public Dynamics
     /// devs::Dynamics model.
     std::vector<Observation>& mObservations;
 
+    /// Fill the observation of a view: a real number without allocation if
+    /// the view is aggregated and the model provides it, a value otherwise.
+    void observe(Observation& observation, const ObservationEvent& event) const;
+
 public:
     // These vectors stores View and observation's port for earch function to
     // observer.
@@ -168,11 +172,20 @@ public:
     virtual std::unique_ptr<vle::value::Value>
     observation(const ObservationEvent& event) const override;
 
+    virtual bool realObservation(const ObservationEvent& event,
+                                 double& value) const override;
+
     /**
      * When the simulation of the atomic model is finished, the
      * finish method is invoked.
      */
     virtual void finish() override;
+
+    virtual std::unique_ptr<vle::value::Value> serialize() const override;
+
+    virtual void deserialize(const vle::value::Value& state) override;
+
+    virtual Time lookahead() const override;
 };
 
 inline
@@ -229,7 +242,7 @@ void DynamicsObserver::output(Time time, ExternalEventList& output) const
         mObservations.emplace_back();
         mObservations.back().view = std::get<0>(elem);
         mObservations.back().portname = std::get<1>(elem);
-        mObservations.back().value = mDynamics->observation(event);
+        observe(mObservations.back(), event);
     }
 }
 
@@ -256,7 +269,7 @@ void DynamicsObserver::internalTransition(Time time)
         mObservations.emplace_back();
         mObservations.back().view = std::get<0>(elem);
         mObservations.back().portname = std::get<1>(elem);
-        mObservations.back().value = mDynamics->observation(event);
+        observe(mObservations.back(), event);
     }
 }
 
@@ -276,7 +289,7 @@ void DynamicsObserver::externalTransition(const ExternalEventList& event,
         mObservations.emplace_back();
         mObservations.back().view = std::get<0>(elem);
         mObservations.back().portname = std::get<1>(elem);
-        mObservations.back().value = mDynamics->observation(event);
+        observe(mObservations.back(), event);
     }
 }
 
@@ -295,7 +308,7 @@ void DynamicsObserver::confluentTransitions(
         mObservations.emplace_back();
         mObservations.back().view = std::get<0>(elem);
         mObservations.back().portname = std::get<1>(elem);
-        mObservations.back().value = mDynamics->observation(event);
+        observe(mObservations.back(), event);
     }
 }
 
@@ -308,6 +321,28 @@ DynamicsObserver::observation(const ObservationEvent& event) const
     return mDynamics->observation(event);
 }
 
+inline
+bool DynamicsObserver::realObservation(const ObservationEvent& event,
+                                       double& value) const
+{
+    assert(mDynamics && "DynamicsObserver: missing set(Dynamics)");
+
+    return mDynamics->realObservation(event, value);
+}
+
+inline
+void DynamicsObserver::observe(Observation& observation,
+                               const ObservationEvent& event) const
+{
+    if (observation.view->aggregated() and
+        mDynamics->realObservation(event, observation.real)) {
+        observation.isreal = true;
+        return;
+    }
+
+    observation.value = mDynamics->observation(event);
+}
+
 inline
 void DynamicsObserver::finish()
 {
@@ -323,10 +358,34 @@ void DynamicsObserver::finish()
         mObservations.emplace_back();
         mObservations.back().view = std::get<0>(elem);
         mObservations.back().portname = std::get<1>(elem);
-        mObservations.back().value = mDynamics->observation(event);
+        observe(mObservations.back(), event);
     }
 }
 
+inline
+std::unique_ptr<vle::value::Value> DynamicsObserver::serialize() const
+{
+    assert(mDynamics && "DynamicsObserver: missing set(Dynamics)");
+
+    return mDynamics->serialize();
+}
+
+inline
+void DynamicsObserver::deserialize(const vle::value::Value& state)
+{
+    assert(mDynamics && "DynamicsObserver: missing set(Dynamics)");
+
+    mDynamics->deserialize(state);
+}
+
+inline
+Time DynamicsObserver::lookahead() const
+{
+    assert(mDynamics && "DynamicsObserver: missing set(Dynamics)");
+
+    return mDynamics->lookahead();
+}
+
 }} // namespace vle devs
 
 #endif
@@ -32,7 +32,8 @@ namespace vle { namespace devs {
 
 DynamicsWrapper::DynamicsWrapper(const DynamicsWrapperInit& init,
                                  const devs::InitEventList& events)
-    : Dynamics(DynamicsInit{init.context, init.model, init.packageid}, events)
+    : Dynamics(DynamicsInit{init.context, init.model, init.packageid,
+                            init.seed}, events)
     , m_library(init.library)
 {}
 
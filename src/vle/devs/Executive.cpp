@@ -35,7 +35,8 @@ namespace vle {
 namespace devs {
 
 Executive::Executive(const ExecutiveInit &init, const InitEventList &events)
-    : Dynamics(DynamicsInit{init.context, init.model, init.packageid}, events)
+    : Dynamics(DynamicsInit{init.context, init.model, init.packageid,
+                            init.seed}, events)
     , m_coordinator(init.coordinator)
 {
 }
@@ -31,6 +31,7 @@
 #include <vle/value/Double.hpp>
 #include <vle/value/Integer.hpp>
 #include <vle/value/Map.hpp>
+#include <vle/value/Mapped.hpp>
 #include <vle/value/Matrix.hpp>
 #include <vle/value/Null.hpp>
 #include <vle/value/Set.hpp>
@@ -145,6 +146,11 @@ const value::Matrix &InitEventList::getMatrix(const std::string &name) const
     return ::pp_get_value(m_value, name).toMatrix();
 }
 
+const value::Mapped &InitEventList::getMapped(const std::string &name) const
+{
+    return ::pp_get_value(m_value, name).toMapped();
+}
+
 const std::string &InitEventList::getString(const std::string &name) const
 {
     return ::pp_get_value(m_value, name).toString().value();
@@ -29,6 +29,7 @@
 
 #include <unordered_map>
 #include <vle/DllDefines.hpp>
+#include <vle/value/Mapped.hpp>
 #include <vle/value/Value.hpp>
 
 namespace vle {
@@ -230,6 +231,34 @@ public:
      */
     const value::Matrix &getMatrix(const std::string &name) const;
 
+    /**
+     * @brief Get the Mapped value from specified key.
+     * @param name The name of the Value in the Map.
+     * @return A referece to the Mapped.
+     * @throw utils::ArgError if type is not Value::MAPPED or value do not
+     * exist.
+     */
+    const value::Mapped &getMapped(const std::string &name) const;
+
+    /**
+     * @brief Get a view of the numbers of the file referenced by a Mapped
+     * value. The data are not copied: the span uses the memory mapping
+     * shared by all the simulators of the process.
+     * @code
+     * auto rain = events.getSpan<double>("rain");
+     * for (std::size_t day = 0; day < rain.size(); ++day)
+     *     total += rain[day];
+     * @endcode
+     * @param name The name of the Value in the Map.
+     * @throw utils::ArgError if type is not Value::MAPPED or value do not
+     * exist, utils::CastError if T does not match the type of the file.
+     */
+    template <typename T>
+    value::MappedSpan<T> getSpan(const std::string &name) const
+    {
+        return getMapped(name).span<T>();
+    }
+
 private:
     container_type m_value;
 };
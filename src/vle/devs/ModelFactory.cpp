@@ -37,6 +37,7 @@
 #include <vle/utils/Algo.hpp>
 #include <vle/utils/Package.hpp>
 #include <vle/utils/i18n.hpp>
+#include <vle/value/Mapped.hpp>
 #include <vle/vpz/AtomicModel.hpp>
 #include <vle/vpz/BaseModel.hpp>
 #include <vle/vpz/CoupledModel.hpp>
@@ -44,29 +45,39 @@
 namespace vle {
 namespace devs {
 
+/**
+ * Map the file of a value::Mapped. The file is searched into the data
+ * directory of the package of the value or, without package, used as a
+ * path.
+ */
+static void openMapped(utils::ContextPtr context, value::Mapped &mapped)
+{
+    if (mapped.package().empty())
+        mapped.open(mapped.file());
+    else
+        mapped.open(utils::Package(context, mapped.package())
+                        .getDataFile(mapped.file()));
+}
+
 ModelFactory::ModelFactory(utils::ContextPtr context,
                            std::map<std::string, View> &eventviews,
                            const vpz::Dynamics &dyn,
                            const vpz::Classes &cls,
-                           const vpz::Experiment &exp)
+                           vpz::Experiment exp)
     : mContext(context)
     , mEventViews(eventviews)
     , mDynamics(dyn)
     , mClasses(cls)
-    , mExperiment(exp)
+    , mExperiment(std::move(exp))
+    , mSeed(mExperiment.seed())
 {
 }
 
-void ModelFactory::createModel(Coordinator &coordinator,
-                               const vpz::Conditions &experiment_conditions,
-                               vpz::AtomicModel *model,
-                               const std::string &dynamics,
-                               const std::vector<std::string> &conditions,
-                               const std::string &observable)
+static InitEventList
+buildInitEventList(utils::ContextPtr context,
+                   const vpz::Conditions &experiment_conditions,
+                   const std::vector<std::string> &conditions)
 {
-    const vpz::Dynamic &dyn = mDynamics.get(dynamics);
-    auto sim = coordinator.addModel(model);
-
     InitEventList initValues;
 
     if (not conditions.empty()) {
@@ -82,14 +93,31 @@ void ModelFactory::createModel(Coordinator &coordinator,
                          elem.first)
                             .str());
 
-                initValues.add(elem.first, elem.second);
+                // The external data are mapped when a model uses the
+                // condition: a missing file in an unused condition is not
+                // an error. The simulators share the mapping (see
+                // utils::MappedFile::open).
+                if (elem.second and elem.second->isMapped() and
+                    not elem.second->toMapped().isOpen()) {
+                    auto mapped = std::make_shared<value::Mapped>(
+                        elem.second->toMapped());
+                    openMapped(context, *mapped);
+                    initValues.add(elem.first, mapped);
+                }
+                else {
+                    initValues.add(elem.first, elem.second);
+                }
             }
         }
     }
 
-    sim->addDynamics(
-        attachDynamics(coordinator, sim, dyn, initValues, observable));
+    return initValues;
+}
 
+void ModelFactory::attachObservables(Coordinator &coordinator,
+                                     vpz::AtomicModel *model,
+                                     const std::string &observable)
+{
     if (not observable.empty()) {
         vpz::Observable &ob(mExperiment.views().observables().get(observable));
         const vpz::ObservablePortList &lst(ob.observableportlist());
@@ -100,10 +128,129 @@ void ModelFactory::createModel(Coordinator &coordinator,
                 coordinator.addObservableToView(model, elem.first, viewname);
         }
     }
+}
+
+void ModelFactory::createModel(Coordinator &coordinator,
+                               const vpz::Conditions &experiment_conditions,
+                               vpz::AtomicModel *model,
+                               const std::string &dynamics,
+                               const std::vector<std::string> &conditions,
+                               const std::string &observable)
+{
+    const vpz::Dynamic &dyn = mDynamics.get(dynamics);
+    auto sim = coordinator.addModel(model);
+
+    auto initValues =
+        buildInitEventList(mContext, experiment_conditions, conditions);
+
+    sim->addDynamics(
+        attachDynamics(coordinator, sim, dyn, initValues, observable));
+
+    attachObservables(coordinator, model, observable);
 
     coordinator.processInit(sim);
 }
 
+void ModelFactory::createModelsParallel(
+    Coordinator &coordinator,
+    const vpz::AtomicModelVector &atomicmodellist)
+{
+    using ModuleType = utils::Context::ModuleType;
+
+    struct Job {
+        Simulator *simulator;
+        const vpz::Dynamic *dynamic;
+        void *symbol;
+        ModuleType type;
+        Time tn;
+    };
+
+    //
+    // The simulators and the symbols are built in the order of the models
+    // list: the context and the coordinator are not thread safe.
+    //
+    std::vector<Job> jobs;
+    jobs.reserve(atomicmodellist.size());
+
+    std::map<std::string, std::pair<void *, ModuleType>> symbols;
+    for (auto &elem : atomicmodellist) {
+        const vpz::Dynamic &dyn = mDynamics.get(elem->dynamics());
+
+        auto it = symbols.find(dyn.name());
+        if (it == symbols.end()) {
+            auto type = ModuleType::MODULE_DYNAMICS;
+            void *symbol = getSymbol(dyn, &type);
+            it = symbols.emplace(dyn.name(), std::make_pair(symbol, type))
+                     .first;
+        }
+
+        jobs.push_back(Job{coordinator.addModel(elem),
+                           &dyn,
+                           it->second.first,
+                           it->second.second,
+                           infinity});
+    }
+
+    //
+    // The constructors and the init functions of the dynamics run on the
+    // thread pool. The executives can change the coordinator: they are
+    // built and initialized sequentially.
+    //
+    auto build = [this, &coordinator, &jobs, &atomicmodellist](
+        std::size_t i) {
+        auto &job = jobs[i];
+        auto *model = atomicmodellist[i];
+
+        auto initValues =
+            buildInitEventList(mContext, mExperiment.conditions(),
+                               model->conditions());
+
+        job.simulator->addDynamics(buildDynamics(coordinator,
+                                                 job.simulator,
+                                                 *job.dynamic,
+                                                 initValues,
+                                                 model->observables(),
+                                                 job.symbol,
+                                                 job.type));
+    };
+
+    auto is_executive = [&jobs](std::size_t i) {
+        return jobs[i].type == ModuleType::MODULE_DYNAMICS_EXECUTIVE;
+    };
+
+    coordinator.parallelFor(jobs.size(), [&](std::size_t i) {
+        if (not is_executive(i))
+            build(i);
+    });
+
+    for (std::size_t i = 0, e = jobs.size(); i != e; ++i)
+        if (is_executive(i))
+            build(i);
+
+    for (std::size_t i = 0, e = jobs.size(); i != e; ++i)
+        attachObservables(coordinator,
+                          atomicmodellist[i],
+                          atomicmodellist[i]->observables());
+
+    const Time time = coordinator.getCurrentTime();
+
+    coordinator.parallelFor(jobs.size(), [&](std::size_t i) {
+        if (not is_executive(i))
+            jobs[i].tn = jobs[i].simulator->init(time);
+    });
+
+    for (std::size_t i = 0, e = jobs.size(); i != e; ++i)
+        if (is_executive(i))
+            jobs[i].tn = jobs[i].simulator->init(time);
+
+    //
+    // Finally, the scheduler is filled in the order of the models list to
+    // get the same simulation than the sequential construction.
+    //
+    for (auto &job : jobs)
+        coordinator.scheduleInit(job.simulator, job.tn);
+}
+
 void ModelFactory::createModels(Coordinator &coordinator,
                                 const vpz::Model &model)
 {
@@ -118,6 +265,11 @@ void ModelFactory::createModels(Coordinator &coordinator,
             vpz::BaseModel::getAtomicModelList(mdl, atomicmodellist);
         }
 
+        if (coordinator.parallelInit() and atomicmodellist.size() > 1) {
+            createModelsParallel(coordinator, atomicmodellist);
+            return;
+        }
+
         for (auto &elem : atomicmodellist) {
             createModel(coordinator,
                         mExperiment.conditions(),
@@ -158,7 +310,8 @@ std::unique_ptr<Dynamics> buildNewDynamicsWrapper(utils::ContextPtr context,
                                                   devs::Simulator *atom,
                                                   const vpz::Dynamic &dyn,
                                                   const InitEventList &events,
-                                                  void *symbol)
+                                                  void *symbol,
+                                                  std::uint64_t seed)
 {
     typedef Dynamics *(*fctdw)(const DynamicsWrapperInit &,
                                const InitEventList &);
@@ -172,7 +325,8 @@ std::unique_ptr<Dynamics> buildNewDynamicsWrapper(utils::ContextPtr context,
             fct(DynamicsWrapperInit{dyn.library(),
                                     context,
                                     *atom->getStructure(),
-                                    pkg_table.get(dyn.package())},
+                                    pkg_table.get(dyn.package()),
+                                    seed},
                 events));
     }
     catch (const std::exception &e) {
@@ -258,7 +412,8 @@ std::unique_ptr<Dynamics> buildNewDynamics(utils::ContextPtr context,
                                            devs::Simulator *atom,
                                            const vpz::Dynamic &dyn,
                                            const InitEventList &events,
-                                           void *symbol)
+                                           void *symbol,
+                                           std::uint64_t seed)
 {
     typedef Dynamics *(*fctdyn)(const DynamicsInit &, const InitEventList &);
 
@@ -267,8 +422,10 @@ std::unique_ptr<Dynamics> buildNewDynamics(utils::ContextPtr context,
     try {
         utils::PackageTable pkg_table;
 
-        DynamicsInit init{
-            context, *atom->getStructure(), pkg_table.get(dyn.package())};
+        DynamicsInit init{context,
+                          *atom->getStructure(),
+                          pkg_table.get(dyn.package()),
+                          seed};
         auto dynamics = std::unique_ptr<Dynamics>(fct(init, events));
 
         if (haveEventView(vpzviews, observable)) {
@@ -318,7 +475,8 @@ std::unique_ptr<Dynamics> buildNewExecutive(utils::ContextPtr context,
                                             devs::Simulator *atom,
                                             const vpz::Dynamic &dyn,
                                             const InitEventList &events,
-                                            void *symbol)
+                                            void *symbol,
+                                            std::uint64_t seed)
 {
     typedef Dynamics *(*fctexe)(const ExecutiveInit &, const InitEventList &);
 
@@ -330,10 +488,13 @@ std::unique_ptr<Dynamics> buildNewExecutive(utils::ContextPtr context,
         ExecutiveInit executiveinit{coordinator,
                                     context,
                                     *atom->getStructure(),
-                                    pkg_table.get(dyn.package())};
+                                    pkg_table.get(dyn.package()),
+                                    seed};
 
-        DynamicsInit init{
-            context, *atom->getStructure(), pkg_table.get(dyn.package())};
+        DynamicsInit init{context,
+                          *atom->getStructure(),
+                          pkg_table.get(dyn.package()),
+                          seed};
 
         auto executive = std::unique_ptr<Dynamics>(fct(executiveinit, events));
 
@@ -376,15 +537,11 @@ std::unique_ptr<Dynamics> buildNewExecutive(utils::ContextPtr context,
     }
 }
 
-std::unique_ptr<Dynamics>
-ModelFactory::attachDynamics(Coordinator &coordinator,
-                             devs::Simulator *atom,
-                             const vpz::Dynamic &dyn,
-                             const InitEventList &events,
-                             const std::string &observable)
+void *ModelFactory::getSymbol(const vpz::Dynamic &dyn,
+                              utils::Context::ModuleType *type)
 {
     void *symbol = nullptr;
-    auto type = utils::Context::ModuleType::MODULE_DYNAMICS;
+    *type = utils::Context::ModuleType::MODULE_DYNAMICS;
 
     try {
         /* If \e package is not empty we assume that library is the shared
@@ -398,17 +555,18 @@ ModelFactory::attachDynamics(Coordinator &coordinator,
                 dyn.package(),
                 dyn.library(),
                 utils::Context::ModuleType::MODULE_DYNAMICS,
-                &type);
+                type);
         }
         else {
             symbol = mContext->get_symbol(dyn.library());
 
             if (dyn.library().length() >= 4) {
                 if (dyn.library().compare(0, 4, "exe_") == 0)
-                    type =
+                    *type =
                         utils::Context::ModuleType::MODULE_DYNAMICS_EXECUTIVE;
                 else if (dyn.library().compare(0, 4, "wra_") == 0)
-                    type = utils::Context::ModuleType::MODULE_DYNAMICS_WRAPPER;
+                    *type =
+                        utils::Context::ModuleType::MODULE_DYNAMICS_WRAPPER;
             }
         }
     }
@@ -421,6 +579,32 @@ ModelFactory::attachDynamics(Coordinator &coordinator,
                 .str());
     }
 
+    return symbol;
+}
+
+std::unique_ptr<Dynamics>
+ModelFactory::attachDynamics(Coordinator &coordinator,
+                             devs::Simulator *atom,
+                             const vpz::Dynamic &dyn,
+                             const InitEventList &events,
+                             const std::string &observable)
+{
+    auto type = utils::Context::ModuleType::MODULE_DYNAMICS;
+    void *symbol = getSymbol(dyn, &type);
+
+    return buildDynamics(
+        coordinator, atom, dyn, events, observable, symbol, type);
+}
+
+std::unique_ptr<Dynamics>
+ModelFactory::buildDynamics(Coordinator &coordinator,
+                            devs::Simulator *atom,
+                            const vpz::Dynamic &dyn,
+                            const InitEventList &events,
+                            const std::string &observable,
+                            void *symbol,
+                            utils::Context::ModuleType type)
+{
     switch (type) {
     case utils::Context::ModuleType::MODULE_DYNAMICS:
         return buildNewDynamics(mContext,
@@ -430,7 +614,8 @@ ModelFactory::attachDynamics(Coordinator &coordinator,
                                 atom,
                                 dyn,
                                 events,
-                                symbol);
+                                symbol,
+                                mSeed);
     case utils::Context::ModuleType::MODULE_DYNAMICS_EXECUTIVE:
         return buildNewExecutive(mContext,
                                  mEventViews,
@@ -440,9 +625,11 @@ ModelFactory::attachDynamics(Coordinator &coordinator,
                                  atom,
                                  dyn,
                                  events,
-                                 symbol);
+                                 symbol,
+                                 mSeed);
     case utils::Context::ModuleType::MODULE_DYNAMICS_WRAPPER:
-        return buildNewDynamicsWrapper(mContext, atom, dyn, events, symbol);
+        return buildNewDynamicsWrapper(
+            mContext, atom, dyn, events, symbol, mSeed);
     default:
         throw utils::InternalError("Missing type");
     }
@@ -62,7 +62,7 @@ public:
                  std::map<std::string, View> &eventviews,
                  const vpz::Dynamics &dyn,
                  const vpz::Classes &cls,
-                 const vpz::Experiment &experiment);
+                 vpz::Experiment experiment);
 
     ModelFactory(const ModelFactory &other) = delete;
     ModelFactory &operator=(const ModelFactory &other) = delete;
@@ -183,7 +183,8 @@ public:
     /**
      * @brief Build a list of devs::Simulator from the dynamics library
      * corresponding to the atomic models from the specified graph
-     * hierarchy.
+     * hierarchy. If Coordinator::parallelInit() is true, the models are
+     * built and initialized on the simulation thread pool.
      * @param coordinator the coordinator where attach the simulator.
      * @param model the hierachy of model (coupled model) or atomic model.
      */
@@ -210,6 +211,7 @@ private:
     vpz::Classes mClasses;       /**< List of available vpz::Classes. */
     vpz::Experiment mExperiment; /**< A reference to the
                                    vpz::Experiment. */
+    std::uint64_t mSeed; /**< The seed of the random streams. */
 
     /**
      * Try to open the plug-in and return the type of opened plugin
@@ -241,6 +243,37 @@ private:
                                              const vpz::Dynamic &dyn,
                                              const InitEventList &events,
                                              const std::string &observable);
+
+    /**
+     * Get the symbol of the dynamics constructor and its type.
+     *
+     * @throw utils::ModellingError if the symbol is not found.
+     */
+    void *getSymbol(const vpz::Dynamic &dyn,
+                    utils::Context::ModuleType *type);
+
+    /**
+     * Call the dynamics constructor @e symbol and build the decorators
+     * (observation and debug). Thread safe except for the executives.
+     */
+    std::unique_ptr<Dynamics> buildDynamics(Coordinator &coordinator,
+                                            devs::Simulator *atom,
+                                            const vpz::Dynamic &dyn,
+                                            const InitEventList &events,
+                                            const std::string &observable,
+                                            void *symbol,
+                                            utils::Context::ModuleType type);
+
+    void attachObservables(Coordinator &coordinator,
+                           vpz::AtomicModel *model,
+                           const std::string &observable);
+
+    /**
+     * Build and initialize the models on the simulation thread pool. The
+     * views and the scheduler are filled in the order of the list.
+     */
+    void createModelsParallel(Coordinator &coordinator,
+                              const vpz::AtomicModelVector &atomicmodellist);
 };
 }
 } // namespace vle devs
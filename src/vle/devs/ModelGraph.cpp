@@ -0,0 +1,132 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <vle/devs/ModelGraph.hpp>
+#include <vle/devs/Simulator.hpp>
+#include <vle/vpz/AtomicModel.hpp>
+
+namespace vle {
+namespace devs {
+
+constexpr ModelGraph::PortId ModelGraph::no_port;
+
+ModelGraph::PortId ModelGraph::intern(const std::string &name)
+{
+    auto it = m_ids.find(name);
+    if (it != m_ids.end())
+        return it->second;
+
+    auto id = static_cast<PortId>(m_names.size());
+    m_names.emplace_back(name);
+    m_ids.emplace(name, id);
+
+    return id;
+}
+
+void ModelGraph::build(const std::vector<Simulator *> &simulators)
+{
+    clear();
+
+    m_simulator_ports.reserve(simulators.size() + 1);
+    vpz::ModelPortList result;
+    std::vector<std::pair<PortId, const std::string *>> ports;
+
+    for (auto *simulator : simulators) {
+        assert(simulator->order() == m_simulator_ports.size());
+        m_simulator_ports.emplace_back(
+            static_cast<std::uint32_t>(m_ports.size()));
+
+        ports.clear();
+        for (const auto &port :
+             simulator->getStructure()->getOutputPortList())
+            ports.emplace_back(intern(port.first), &port.first);
+
+        std::sort(ports.begin(), ports.end());
+
+        for (const auto &port : ports) {
+            m_ports.push_back(
+                Port{ port.first,
+                      static_cast<std::uint32_t>(m_targets.size()) });
+
+            result.clear();
+            simulator->getStructure()->getAtomicModelsTarget(*port.second,
+                                                             result);
+
+            for (auto &elem : result)
+                m_targets.push_back(
+                    Target{ static_cast<vpz::AtomicModel *>(elem.first)
+                              ->get_simulator(),
+                            intern(elem.second) });
+        }
+    }
+
+    m_simulator_ports.emplace_back(static_cast<std::uint32_t>(m_ports.size()));
+    m_ports.push_back(
+        Port{ 0, static_cast<std::uint32_t>(m_targets.size()) });
+}
+
+void ModelGraph::clear() noexcept
+{
+    m_names.clear();
+    m_ids.clear();
+    m_simulator_ports.clear();
+    m_ports.clear();
+    m_targets.clear();
+}
+
+ModelGraph::PortId ModelGraph::port(const std::string &name) const noexcept
+{
+    auto it = m_ids.find(name);
+
+    return it == m_ids.end() ? no_port : it->second;
+}
+
+bool ModelGraph::targets(const Simulator *simulator,
+                         PortId port,
+                         const Target **first,
+                         const Target **last) const noexcept
+{
+    const auto order = simulator->order();
+    assert(order + 1 < m_simulator_ports.size());
+
+    auto begin = m_ports.begin() + m_simulator_ports[order];
+    auto end = m_ports.begin() + m_simulator_ports[order + 1];
+    auto it = std::lower_bound(
+        begin, end, port, [](const Port &lhs, PortId rhs) {
+            return lhs.name < rhs;
+        });
+
+    if (it == end or it->name != port)
+        return false;
+
+    *first = m_targets.data() + it->first_target;
+    *last = m_targets.data() + (it + 1)->first_target;
+    return true;
+}
+}
+} // namespace vle devs
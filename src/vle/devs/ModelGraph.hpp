@@ -0,0 +1,138 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_DEVS_MODELGRAPH_HPP
+#define VLE_DEVS_MODELGRAPH_HPP
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <vle/DllDefines.hpp>
+
+namespace vle {
+namespace devs {
+
+class Simulator;
+
+/**
+ * @brief A compact and read-only view of the connections between the
+ * atomic models.
+ *
+ * For each simulator, the graph stores the atomic targets of its output
+ * ports in compressed sparse rows: the ports of the simulators are in one
+ * vector, the targets of the ports in another one. The names of the
+ * ports are interned into integer identifiers: the coordinator resolves
+ * the port of an output event once with @e port() then searches the
+ * ports of the simulator, sorted by identifier, with integer comparisons
+ * only. The graph is built once from the structure of the models and
+ * replaces the recursive search into the coupled models and the
+ * per-simulator lists of targets.
+ *
+ * The graph does not follow the changes of the structure: the coordinator
+ * uses it only without executive.
+ */
+class VLE_LOCAL ModelGraph
+{
+public:
+    using PortId = std::uint32_t;
+
+    /** The identifier of the names unknown by the graph. */
+    static constexpr PortId no_port = std::numeric_limits<PortId>::max();
+
+    struct Target {
+        Simulator *simulator;
+        PortId port;
+    };
+
+    /**
+     * @brief Build the graph.
+     * @param simulators The simulators sorted by creation order, without
+     * hole (@e Simulator::order() is the index in the vector).
+     */
+    void build(const std::vector<Simulator *> &simulators);
+
+    void clear() noexcept;
+
+    bool empty() const noexcept
+    {
+        return m_simulator_ports.empty();
+    }
+
+    /**
+     * @brief Get the identifier of the port name @e name.
+     * @return The identifier or @e no_port if no model of the graph has a
+     * port with this name.
+     */
+    PortId port(const std::string &name) const noexcept;
+
+    /**
+     * @brief Get the targets of the output port @e port of the simulator.
+     * @param port The identifier of the port from @e port().
+     * @param[out] first The first target.
+     * @param[out] last The end of the targets.
+     * @return false if the simulator does not have the output port.
+     */
+    bool targets(const Simulator *simulator,
+                 PortId port,
+                 const Target **first,
+                 const Target **last) const noexcept;
+
+    const std::string &name(PortId port) const noexcept
+    {
+        return m_names[port];
+    }
+
+    std::size_t size() const noexcept
+    {
+        return m_targets.size();
+    }
+
+private:
+    PortId intern(const std::string &name);
+
+    struct Port {
+        PortId name;
+        std::uint32_t first_target;
+    };
+
+    std::vector<std::string> m_names;
+    std::unordered_map<std::string, PortId> m_ids;
+
+    /* The ports of the simulator @e i are [m_simulator_ports[i],
+       m_simulator_ports[i + 1]), sorted by name identifier. */
+    std::vector<std::uint32_t> m_simulator_ports;
+
+    /* The targets of the port @e i are [m_ports[i].first_target,
+       m_ports[i + 1].first_target). The last port is a sentinel. */
+    std::vector<Port> m_ports;
+    std::vector<Target> m_targets;
+};
+}
+} // namespace vle devs
+
+#endif
@@ -0,0 +1,172 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/devs/Population.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <algorithm>
+#include <functional>
+
+namespace vle {
+namespace devs {
+
+Population::Population(const DynamicsInit &init,
+                       const InitEventList &events,
+                       std::size_t size)
+    : Dynamics(init, events)
+    , m_tn(size, infinity)
+    , m_last(0.0)
+    , m_next(infinity)
+{
+    if (size == 0)
+        throw utils::ArgError(_("Population: empty population"));
+}
+
+Time Population::init(Time time)
+{
+    m_last = time;
+    m_ta.resize(size());
+
+    initPopulation(time, m_ta.data());
+
+    m_heap.clear();
+    m_due.clear();
+
+    for (std::size_t i = 0, e = size(); i != e; ++i) {
+        m_tn[i] = time + m_ta[i];
+        push(i);
+    }
+
+    schedule();
+
+    return timeAdvance();
+}
+
+void Population::output(Time time, ExternalEventList &output) const
+{
+    outputPopulation(time, m_due.data(), m_due.size(), output);
+}
+
+Time Population::timeAdvance() const
+{
+    return m_next - m_last;
+}
+
+void Population::internalTransition(Time time)
+{
+    m_last = time;
+    m_ta.resize(m_due.size());
+
+    internalPopulation(time, m_due.data(), m_due.size(), m_ta.data());
+
+    for (std::size_t i = 0, e = m_due.size(); i != e; ++i) {
+        m_tn[m_due[i]] = time + m_ta[i];
+        push(m_due[i]);
+    }
+
+    m_due.clear();
+    schedule();
+}
+
+void Population::externalTransition(const ExternalEventList &events,
+                                    Time time)
+{
+    m_last = time;
+
+    // The due instances are not in the heap. They go back in the heap
+    // because the external transition may reschedule any instance.
+    for (auto i : m_due)
+        push(i);
+
+    m_due.clear();
+
+    externalPopulation(events, time);
+
+    schedule();
+}
+
+void Population::outputPopulation(Time /* time */,
+                                  const std::size_t * /* due */,
+                                  std::size_t /* count */,
+                                  ExternalEventList & /* output */) const
+{
+}
+
+void Population::externalPopulation(const ExternalEventList & /* events */,
+                                    Time /* time */)
+{
+}
+
+void Population::reschedule(std::size_t i, Time ta)
+{
+    if (i >= size())
+        throw utils::ArgError(_("Population: bad instance %zu"), i);
+
+    m_tn[i] = m_last + ta;
+    push(i);
+}
+
+void Population::push(std::size_t i)
+{
+    if (isInfinity(m_tn[i]))
+        return;
+
+    m_heap.emplace_back(m_tn[i], i);
+    std::push_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+}
+
+void Population::schedule()
+{
+    // The heap entries are not removed when an instance is rescheduled, so
+    // an entry is valid only if it matches the time of next internal event
+    // of the instance.
+    m_next = infinity;
+
+    while (not m_heap.empty()) {
+        auto top = m_heap.front();
+
+        if (m_tn[top.second] != top.first) {
+            std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+            m_heap.pop_back();
+            continue;
+        }
+
+        if (isInfinity(m_next))
+            m_next = top.first;
+        else if (top.first != m_next)
+            break;
+
+        m_due.push_back(top.second);
+        std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<>());
+        m_heap.pop_back();
+    }
+
+    std::sort(m_due.begin(), m_due.end());
+    m_due.erase(std::unique(m_due.begin(), m_due.end()), m_due.end());
+}
+}
+} // namespace vle devs
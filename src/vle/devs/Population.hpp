@@ -0,0 +1,175 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_DEVS_POPULATION_HPP
+#define VLE_DEVS_POPULATION_HPP 1
+
+#include <vle/DllDefines.hpp>
+#include <vle/devs/Dynamics.hpp>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace vle {
+namespace devs {
+
+/**
+ * @brief Population is a Dynamics that simulates @e size homogeneous
+ * instances of an atomic model with a single Simulator.
+ *
+ * The subclass stores the state of the instances in arrays (one array per
+ * variable, indexed by the instance) and the population schedules the
+ * instances: each instance has its own time of next internal event. The
+ * output and the internal transition functions are called once per bag
+ * with the sorted list of the instances whose internal event is due, so
+ * they can update the arrays in a single loop.
+ *
+ * @code
+ * class Sheep : public vle::devs::Population
+ * {
+ *     std::vector<double> energy;
+ *
+ * public:
+ *     Sheep(const DynamicsInit &init, const InitEventList &events)
+ *         : Population(init, events, events.getInt("size"))
+ *         , energy(size(), 1.0)
+ *     {}
+ *
+ *     void initPopulation(Time, Time *ta) override
+ *     {
+ *         std::fill(ta, ta + size(), 1.0);
+ *     }
+ *
+ *     void internalPopulation(Time, const std::size_t *due,
+ *                             std::size_t count, Time *ta) override
+ *     {
+ *         for (std::size_t i = 0; i != count; ++i) {
+ *             energy[due[i]] *= 0.9;
+ *             ta[i] = 1.0;
+ *         }
+ *     }
+ * };
+ * @endcode
+ */
+class VLE_API Population : public Dynamics {
+public:
+    /**
+     * @brief Build a population of @e size instances.
+     * @param init The initialiser of Dynamics.
+     * @param events The parameter from the experimental frame.
+     * @param size The number of instances.
+     */
+    Population(const DynamicsInit &init,
+               const InitEventList &events,
+               std::size_t size);
+
+    virtual ~Population() = default;
+
+    virtual Time init(Time time) override;
+
+    virtual void output(Time time,
+                        ExternalEventList &output) const override;
+
+    virtual Time timeAdvance() const override;
+
+    virtual void internalTransition(Time time) override;
+
+    virtual void externalTransition(const ExternalEventList &events,
+                                    Time time) override;
+
+    /**
+     * @brief Get the number of instances.
+     */
+    std::size_t size() const noexcept { return m_tn.size(); }
+
+    /**
+     * @brief Get the time of the next internal event of the instance @e i
+     * (infinity for a passive instance).
+     */
+    Time timeNext(std::size_t i) const noexcept { return m_tn[i]; }
+
+    /**
+     * @brief Get the sorted list of the instances whose internal event is
+     * the next internal event of the population.
+     */
+    const std::vector<std::size_t> &due() const noexcept { return m_due; }
+
+protected:
+    /**
+     * @brief Initialize the instances and assign the durations of their
+     * initial states into @e ta[0], ..., @e ta[size() - 1].
+     */
+    virtual void initPopulation(Time time, Time *ta) = 0;
+
+    /**
+     * @brief Compute the output function of the @e count instances @e due.
+     */
+    virtual void outputPopulation(Time time,
+                                  const std::size_t *due,
+                                  std::size_t count,
+                                  ExternalEventList &output) const;
+
+    /**
+     * @brief Compute the internal transition of the @e count instances @e
+     * due and assign the durations of their new states into @e ta[0], ...,
+     * @e ta[count - 1].
+     */
+    virtual void internalPopulation(Time time,
+                                    const std::size_t *due,
+                                    std::size_t count,
+                                    Time *ta) = 0;
+
+    /**
+     * @brief Compute the external transition of the population. Use
+     * reschedule() to change the time of next internal event of the
+     * instances updated by the @e events.
+     */
+    virtual void externalPopulation(const ExternalEventList &events,
+                                    Time time);
+
+    /**
+     * @brief Assign the duration @e ta of the new state of the instance @e
+     * i from the current time (in externalPopulation()).
+     */
+    void reschedule(std::size_t i, Time ta);
+
+private:
+    void push(std::size_t i);
+
+    void schedule();
+
+    std::vector<Time> m_tn;
+    std::vector<Time> m_ta;
+    std::vector<std::size_t> m_due;
+    std::vector<std::pair<Time, std::size_t>> m_heap;
+    Time m_last;
+    Time m_next;
+};
+}
+} // namespace vle devs
+
+#endif
@@ -26,6 +26,8 @@
 
 
 #include <vle/devs/RootCoordinator.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
 #include <cassert>
 
 namespace vle { namespace devs {
@@ -38,6 +40,9 @@ RootCoordinator::RootCoordinator(utils::ContextPtr context)
     , m_end(1.0)
     , m_coordinator(nullptr)
     , m_root(nullptr)
+    , m_bags(0)
+    , m_have_budget(false)
+    , m_interruption(Interruption::none)
 {
 }
 
@@ -59,6 +64,50 @@ void RootCoordinator::load(vpz::Vpz& io)
     m_root = io.project().model().graph();
 }
 
+void RootCoordinator::load(const vpz::ExperimentInstance& instance)
+{
+    const auto& project = instance.base().project();
+
+    m_begin = instance.begin();
+    m_end = m_begin + instance.duration();
+    m_currentTime = m_begin;
+
+    m_coordinator = std::make_unique<Coordinator>(m_context,
+                                                  project.dynamics(),
+                                                  project.classes(),
+                                                  instance.experiment());
+
+    vpz::Model model(project.model());
+    if (model.node())
+        model.node()->clearGraphics();
+    m_coordinator->init(model, m_currentTime, m_end);
+
+    m_root = model.graph();
+}
+
+void RootCoordinator::load(const vpz::ExperimentInstance& instance,
+                           const Checkpoint& checkpoint)
+{
+    const auto& project = instance.base().project();
+
+    m_begin = checkpoint.time;
+    m_end = instance.begin() + instance.duration();
+    m_currentTime = m_begin;
+
+    m_coordinator = std::make_unique<Coordinator>(m_context,
+                                                  project.dynamics(),
+                                                  project.classes(),
+                                                  instance.experiment());
+
+    vpz::Model model(project.model());
+    if (model.node())
+        model.node()->clearGraphics();
+    m_coordinator->init(model, m_currentTime, m_end);
+    m_coordinator->restore(checkpoint);
+
+    m_root = model.graph();
+}
+
 void RootCoordinator::init()
 {
     m_currentTime = m_begin;
@@ -74,12 +123,66 @@ bool RootCoordinator::run()
     if ((m_end - m_currentTime) < 0)
         return false;
 
-    m_coordinator->run();
+    if (m_have_budget) {
+        if (m_budget.token.cancelled())
+            m_interruption = Interruption::cancelled;
+        else if (m_budget.bags and m_bags >= m_budget.bags)
+            m_interruption = Interruption::bags;
+        else if (m_budget.wallclock != std::chrono::milliseconds::zero() and
+                 std::chrono::steady_clock::now() >= m_deadline)
+            m_interruption = Interruption::wallclock;
+
+        if (m_interruption != Interruption::none)
+            return false;
+
+        ++m_bags;
+    }
 
+    m_coordinator->run();
 
     return true;
 }
 
+void RootCoordinator::setBudget(const RunBudget& budget)
+{
+    m_budget = budget;
+    m_deadline = std::chrono::steady_clock::now() + budget.wallclock;
+    m_bags = 0;
+    m_have_budget = true;
+    m_interruption = Interruption::none;
+}
+
+std::unique_ptr<Checkpoint> RootCoordinator::checkpoint(Time time)
+{
+    advance(time);
+
+    return m_coordinator->checkpoint(time);
+}
+
+void RootCoordinator::advance(Time time)
+{
+    if (time > m_end)
+        throw utils::ArgError(
+            (fmt(_("%1% is after the end of the simulation")) % time).str());
+
+    while (m_coordinator->getCurrentTime() < time)
+        m_coordinator->run();
+
+    m_currentTime = time;
+}
+
+void RootCoordinator::inject(const std::string& model,
+                             const std::string& port,
+                             std::shared_ptr<value::Value> value)
+{
+    m_coordinator->inject(m_currentTime, model, port, std::move(value));
+}
+
+std::size_t RootCoordinator::mergedBags() const
+{
+    return m_coordinator ? m_coordinator->getMergedBags() : 0;
+}
+
 std::unique_ptr<value::Map> RootCoordinator::finish()
 {
     if (m_coordinator) {
@@ -97,4 +200,12 @@ std::unique_ptr<value::Map> RootCoordinator::outputs() const
     return {};
 }
 
+std::unique_ptr<value::Map> RootCoordinator::outputs(OutputCursor& cursor) const
+{
+    if (m_coordinator) {
+        return m_coordinator->getMap(cursor);
+    }
+    return {};
+}
+
 }} // namespace vle devs
@@ -29,10 +29,13 @@
 #define DEVS_ROOTCOORDINATOR_HPP
 
 #include <vle/DllDefines.hpp>
+#include <vle/devs/Checkpoint.hpp>
 #include <vle/devs/Coordinator.hpp>
+#include <vle/devs/RunBudget.hpp>
 #include <vle/utils/Context.hpp>
 #include <vle/utils/Rand.hpp>
 #include <vle/devs/Time.hpp>
+#include <vle/vpz/ExperimentInstance.hpp>
 #include <vle/vpz/Vpz.hpp>
 #include <memory>
 
@@ -76,6 +79,28 @@ public:
      */
     void load(vpz::Vpz& vp);
 
+    /**
+     * @brief initialiase a new Coordinator with the specified
+     * vpz::ExperimentInstance. The base vpz::Vpz is not modified: the
+     * model tree, the dynamics, the classes and the views are copied, only
+     * the condition values are shared with the base.
+     * @param instance a combination of an experimental frame.
+     */
+    void load(const vpz::ExperimentInstance& instance);
+
+    /**
+     * @brief initialiase a new Coordinator with the specified
+     * vpz::ExperimentInstance and restore the models and the scheduler
+     * from a snapshot: the simulation starts at the date of the snapshot.
+     * Models are built and initialized as usual (parameters come from the
+     * instance) then their state is restored with the
+     * devs::Dynamics::deserialize function.
+     * @param instance a combination of an experimental frame.
+     * @param checkpoint a snapshot of the same model.
+     */
+    void load(const vpz::ExperimentInstance& instance,
+              const Checkpoint& checkpoint);
+
     /**
      * @brief Initialise RootCoordinator and his Coordinator: initiale time
      * is define, coordinator init function is call.
@@ -85,10 +110,60 @@ public:
     /**
      * @brief Call the coordinator run function and test if current time is
      * the end of the simulation.
-     * @return false when simulation is finished, true otherwise.
+     * @return false when simulation is finished or interrupted by the
+     * budget, true otherwise.
      */
     bool run();
 
+    /**
+     * @brief Limit the simulation: @c run() checks the budget before each
+     * bag and returns false when a limit is reached. The outputs and @c
+     * finish() return the results until the current time.
+     * @param budget The limits, the wall-clock limit starts now.
+     */
+    void setBudget(const RunBudget& budget);
+
+    /**
+     * @brief Get the reason of the interruption of the simulation.
+     * @return @c Interruption::none if the budget does not stop the
+     * simulation.
+     */
+    Interruption interrupted() const noexcept
+    { return m_interruption; }
+
+    /**
+     * @brief Run all the bags before @e time and build a snapshot of the
+     * simulation at @e time.
+     * @param time The date of the snapshot, lower or equal to the end of
+     * the simulation.
+     * @return The snapshot.
+     * @throw utils::ArgError if time is after the end of the simulation.
+     * @throw utils::ModellingError if a model does not support the
+     * checkpoint.
+     */
+    std::unique_ptr<Checkpoint> checkpoint(Time time);
+
+    /**
+     * @brief Run all the bags before @e time. The simulation can be
+     * continued with @c run().
+     * @param time The date to reach, lower or equal to the end of the
+     * simulation.
+     * @throw utils::ArgError if time is after the end of the simulation.
+     */
+    void advance(Time time);
+
+    /**
+     * @brief Send an external event to the input port of an atomic model
+     * at the current date (for example, after @c advance()).
+     * @param model The complete name of the atomic model.
+     * @param port The name of the input port.
+     * @param value The value of the event.
+     * @throw utils::ArgError if the model or the port does not exist.
+     */
+    void inject(const std::string& model,
+                const std::string& port,
+                std::shared_ptr<value::Value> value);
+
     /**
      * @brief Call the coordinator finish function and delete the
      * coordinator and all attached data.
@@ -102,6 +177,13 @@ public:
     inline const Time& getCurrentTime()
     { return m_currentTime; }
 
+    /**
+     * @brief Return the number of bags merged by the time resolution of
+     * the experiment.
+     * @return 0 if the experiment does not define a resolution.
+     */
+    std::size_t mergedBags() const;
+
     /**
      * Return the simulation results.
      *
@@ -113,6 +195,26 @@ public:
      */
     std::unique_ptr<value::Map> outputs() const;
 
+    /**
+     * Return the simulation results appended since the previous call
+     * with the same cursor, without copying the rows already read. Use a
+     * new (empty) cursor to read the results from the beginning.
+     *
+     * @code
+     * devs::OutputCursor cursor;
+     * while (rc.run()) {
+     *     auto delta = rc.outputs(cursor);
+     *     ...
+     * }
+     * auto last = rc.finish();
+     * @endcode
+     *
+     * @param cursor the position of the reader, updated by this function.
+     * @return The new complete rows of each view or NULL if there is no
+     * new row.
+     */
+    std::unique_ptr<value::Map> outputs(OutputCursor& cursor) const;
+
     /**
      * @brief Return a reference to the random generator.
      * @return Return a reference to the random generator.
@@ -137,6 +239,12 @@ private:
 
     std::unique_ptr<Coordinator> m_coordinator;
     std::unique_ptr<vpz::BaseModel> m_root;
+
+    RunBudget m_budget;
+    std::chrono::steady_clock::time_point m_deadline;
+    std::uint64_t m_bags;
+    bool m_have_budget;
+    Interruption m_interruption;
 };
 
 }} // namespace vle devs
@@ -0,0 +1,108 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_DEVS_RUNBUDGET_HPP
+#define VLE_DEVS_RUNBUDGET_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace vle {
+namespace devs {
+
+/**
+ * @brief A @c devs::CancellationToken stops a simulation from another
+ * thread. The copies share the same state: keep a copy, give the other to
+ * the @c devs::RunBudget and call cancel().
+ */
+class CancellationToken
+{
+public:
+    CancellationToken()
+        : m_cancelled(std::make_shared<std::atomic<bool>>(false))
+    {
+    }
+
+    void cancel() noexcept
+    {
+        m_cancelled->store(true, std::memory_order_relaxed);
+    }
+
+    bool cancelled() const noexcept
+    {
+        return m_cancelled->load(std::memory_order_relaxed);
+    }
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
+
+/**
+ * @brief The limits of a simulation checked by the @c
+ * devs::RootCoordinator between two bags. A zero disables the limit.
+ *
+ * @code
+ * devs::RunBudget budget;
+ * budget.wallclock = std::chrono::milliseconds(30000);
+ * root.setBudget(budget);
+ * while (root.run())
+ *     ;
+ * auto partial = root.finish();
+ * if (root.interrupted() != devs::Interruption::none)
+ *     ...
+ * @endcode
+ */
+struct RunBudget
+{
+    /// The maximum duration of the simulation from the call of @c
+    /// devs::RootCoordinator::setBudget.
+    std::chrono::milliseconds wallclock = std::chrono::milliseconds::zero();
+
+    /// The maximum number of bags.
+    std::uint64_t bags = 0;
+
+    /// A token to stop the simulation from another thread.
+    CancellationToken token;
+};
+
+/**
+ * @brief Why the @c devs::RootCoordinator stops the simulation before its
+ * end.
+ */
+enum class Interruption
+{
+    none,      ///< The simulation is not interrupted.
+    cancelled, ///< The token of the budget is cancelled.
+    wallclock, ///< The wall-clock duration is exhausted.
+    bags       ///< The number of bags is exhausted.
+};
+}
+} // namespace vle devs
+
+#endif
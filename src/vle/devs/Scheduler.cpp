@@ -24,6 +24,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 #include <vector>
@@ -36,35 +37,108 @@ namespace devs {
 void Scheduler::init(Time time)
 {
     m_current_time = time;
-
-    m_current_bag.dynamics.clear();
-    m_current_bag.executives.clear();
-    m_current_bag.unique_simulators.clear();
+    newBag();
 
     while (not m_scheduler.empty() and
            m_scheduler.top().m_time <= m_current_time) {
 
         Simulator *sim = m_scheduler.top().m_simulator;
 
-        //
-        // Add the simulator pointer into the unordered_set and into the
-        // vector. In std::unordered_set to be sure that only one pointer is
-        // available after the Coordinator::dispatchExternalEvents' call and in
-        // std::vector to starts directly without merge vectors with
-        // unordered_set.
-        //
-
-        if (sim->dynamics()->isExecutive())
-            m_current_bag.executives.emplace_back(sim);
-        else
-            m_current_bag.dynamics.emplace_back(sim);
-
-        m_current_bag.unique_simulators.emplace(sim);
+        if (m_resolution > 0.0)
+            m_raw_times.emplace_back(m_scheduler.top().m_raw_time);
 
+        addToBag(sim);
         sim->setInternalEvent();
         sim->resetHandle();
         m_scheduler.pop();
     }
+
+    countMergedBags();
+}
+
+void Scheduler::countMergedBags()
+{
+    if (m_raw_times.empty())
+        return;
+
+    std::sort(m_raw_times.begin(), m_raw_times.end());
+    auto last = std::unique(m_raw_times.begin(), m_raw_times.end());
+    m_merged_bags += std::distance(m_raw_times.begin(), last) - 1;
+    m_raw_times.clear();
+}
+
+void Scheduler::newBag() noexcept
+{
+    m_current_bag.dynamics.clear();
+    m_current_bag.executives.clear();
+    ++m_epoch;
+}
+
+void Scheduler::addToBag(Simulator *simulator)
+{
+    //
+    // The epoch stamp ensures that only one pointer is available after the
+    // Coordinator::dispatchExternalEvents' call without hashing.
+    //
+
+    if (simulator->bagEpoch() == m_epoch)
+        return;
+
+    simulator->setBagEpoch(m_epoch);
+
+    if (simulator->dynamics()->isExecutive())
+        m_current_bag.executives.emplace_back(simulator);
+    else
+        m_current_bag.dynamics.emplace_back(simulator);
+}
+
+void Scheduler::clear()
+{
+    //
+    // The simulators can be scheduled by another Scheduler: the stamps
+    // of the current bag are removed.
+    //
+
+    for (auto *sim : m_current_bag.dynamics) {
+        sim->resetInternalEvent();
+        sim->setBagEpoch(0);
+    }
+
+    for (auto *sim : m_current_bag.executives) {
+        sim->resetInternalEvent();
+        sim->setBagEpoch(0);
+    }
+
+    for (auto &elem : m_scheduler)
+        elem.m_simulator->resetHandle();
+
+    newBag();
+    m_scheduler.clear();
+}
+
+void Scheduler::postpone(Time time)
+{
+    assert(time <= m_current_time && "postpone: time > m_current_time?");
+
+    if (time == m_current_time)
+        return;
+
+    auto reschedule = [this](Simulator *sim) {
+        sim->resetInternalEvent();
+
+        HandleT handle = m_scheduler.emplace(
+            m_current_time, m_current_time, sim, sim->order());
+        sim->setHandle(handle);
+    };
+
+    for (auto *sim : m_current_bag.dynamics)
+        reschedule(sim);
+
+    for (auto *sim : m_current_bag.executives)
+        reschedule(sim);
+
+    newBag();
+    m_current_time = time;
 }
 
 void Scheduler::addInternal(Simulator *simulator, Time time)
@@ -73,12 +147,20 @@ void Scheduler::addInternal(Simulator *simulator, Time time)
     assert(not isNegativeInfinity(time) && "addInternal: infinity time?");
     assert(time >= m_current_time && "addInternal: time < m_current_time?");
 
+    Time raw_time = time;
+    if (m_resolution > 0.0) {
+        time = std::max(quantize(time, m_resolution), m_current_time);
+        simulator->setTn(time);
+    }
+
     if (simulator->haveHandle()) {
         (*simulator->handle()).m_time = time;
+        (*simulator->handle()).m_raw_time = raw_time;
         m_scheduler.update(simulator->handle());
     }
     else {
-        HandleT handle = m_scheduler.emplace(time, simulator);
+        HandleT handle = m_scheduler.emplace(
+            time, raw_time, simulator, simulator->order());
         simulator->setHandle(handle);
     }
 }
@@ -88,18 +170,11 @@ void Scheduler::addExternal(Simulator *simulator,
                             const std::string &portname)
 {
     //
-    // Tries to insert the simulator into the std::unordered_set. If insertion
-    // success, (simulator does not exists with an internal transition), we add
-    // it into the appropriate std::vector.
+    // If the simulator is not in the bag (simulator does not exists with an
+    // internal transition), we add it into the appropriate std::vector.
     //
 
-    auto result = m_current_bag.unique_simulators.emplace(simulator);
-    if (result.second == true) {
-        if (simulator->dynamics()->isExecutive())
-            m_current_bag.executives.emplace_back(simulator);
-        else
-            m_current_bag.dynamics.emplace_back(simulator);
-    }
+    addToBag(simulator);
 
     simulator->addExternalEvents(values, portname);
 
@@ -118,24 +193,27 @@ void Scheduler::addExternal(Simulator *simulator,
 void Scheduler::delSimulator(Simulator *simulator)
 {
     //
-    // Tries to delete the simulator from the \c Bag objects (\c std::vector
-    // and/or \c std::unordered_set
+    // Tries to delete the simulator from the \c Bag objects (\c std::vector).
+    // The epoch stamp avoids the linear search for the simulators outside
+    // the current bag.
     //
 
-    if (simulator->dynamics()->isExecutive())
-        m_current_bag.executives.erase(
-            std::remove(m_current_bag.executives.begin(),
-                        m_current_bag.executives.end(),
-                        simulator),
-            m_current_bag.executives.end());
-    else
-        m_current_bag.dynamics.erase(
-            std::remove(m_current_bag.dynamics.begin(),
-                        m_current_bag.dynamics.end(),
-                        simulator),
-            m_current_bag.dynamics.end());
+    if (simulator->bagEpoch() == m_epoch) {
+        if (simulator->dynamics()->isExecutive())
+            m_current_bag.executives.erase(
+                std::remove(m_current_bag.executives.begin(),
+                            m_current_bag.executives.end(),
+                            simulator),
+                m_current_bag.executives.end());
+        else
+            m_current_bag.dynamics.erase(
+                std::remove(m_current_bag.dynamics.begin(),
+                            m_current_bag.dynamics.end(),
+                            simulator),
+                m_current_bag.dynamics.end());
 
-    m_current_bag.unique_simulators.erase(simulator);
+        simulator->setBagEpoch(0);
+    }
 
     if (simulator->haveHandle()) {
         m_scheduler.erase(simulator->handle());
@@ -146,35 +224,23 @@ void Scheduler::delSimulator(Simulator *simulator)
 void Scheduler::makeNextBag()
 {
     m_current_time = getNextTime();
-
-    m_current_bag.dynamics.clear();
-    m_current_bag.executives.clear();
-    m_current_bag.unique_simulators.clear();
+    newBag();
 
     while (not m_scheduler.empty() and
            m_scheduler.top().m_time == m_current_time) {
 
         Simulator *sim = m_scheduler.top().m_simulator;
 
-        //
-        // Add the simulator pointer into the unordered_set and into the
-        // vector. In std::unordered_set to be sure that only one pointer is
-        // available after the Coordinator::dispatchExternalEvents' call and in
-        // std::vector to starts directly without merge vectors with
-        // unordered_set.
-        //
-
-        if (sim->dynamics()->isExecutive())
-            m_current_bag.executives.emplace_back(sim);
-        else
-            m_current_bag.dynamics.emplace_back(sim);
-
-        m_current_bag.unique_simulators.emplace(sim);
+        if (m_resolution > 0.0)
+            m_raw_times.emplace_back(m_scheduler.top().m_raw_time);
 
+        addToBag(sim);
         sim->setInternalEvent();
         sim->resetHandle();
         m_scheduler.pop();
     }
+
+    countMergedBags();
 }
 }
 } // namespace vle devs
@@ -28,8 +28,8 @@
 #define VLE_DEVS_SCHEDULER_HPP
 
 #include <boost/heap/fibonacci_heap.hpp>
+#include <cstdint>
 #include <map>
-#include <unordered_set>
 #include <vector>
 #include <vle/DllDefines.hpp>
 #include <vle/devs/ExternalEvent.hpp>
@@ -89,24 +89,37 @@ void push(SchedulerT &scheduler, Args &&... args)
         scheduler.begin(), scheduler.end(), EventCompare<event_type>);
 }
 
+//
+// Simulators with the same time are sorted with their creation order: the
+// bags do not depend on the structure of the heap and two schedulers with
+// the same simulators build the same bags.
+//
 struct HeapElementCompare {
     template <typename HeapElementT>
     bool operator()(const HeapElementT &lhs, const HeapElementT &rhs) const
         noexcept
     {
-        return lhs.m_time >= rhs.m_time;
+        return lhs.m_time > rhs.m_time or
+               (lhs.m_time == rhs.m_time and lhs.m_order > rhs.m_order);
     }
 };
 
 struct HeapElement {
-    HeapElement(Time time, Simulator *Simulator)
+    HeapElement(Time time,
+                Time raw_time,
+                Simulator *Simulator,
+                std::size_t order)
         : m_time(time)
+        , m_raw_time(raw_time)
         , m_simulator(Simulator)
+        , m_order(order)
     {
     }
 
     Time m_time;
+    Time m_raw_time; // m_time before the quantization.
     Simulator *m_simulator;
+    std::size_t m_order;
 };
 
 using Heap =
@@ -120,20 +133,23 @@ using HandleT = Heap::handle_type;
  *
  */
 struct Bag {
-    std::vector<Simulator *> dynamics;
-    std::vector<Simulator *> executives;
-
     //
-    // \e unique_simulators is used to ensures that \e dynamics and \e
-    // executives vectors have unique pointer through a \e simulator object.
+    // The vectors are cleared but never released between two bags: after
+    // the first bags, building a bag does not allocate. The \e Scheduler
+    // stamps the simulators of the bag with its epoch to ensure that \e
+    // dynamics and \e executives vectors have unique pointers.
     //
-    std::unordered_set<Simulator *> unique_simulators;
+    std::vector<Simulator *> dynamics;
+    std::vector<Simulator *> executives;
 };
 
 class VLE_LOCAL Scheduler {
 public:
     Scheduler()
         : m_current_time(negativeInfinity)
+        , m_epoch(1)
+        , m_resolution(0.0)
+        , m_merged_bags(0)
     {
     }
 
@@ -146,6 +162,19 @@ public:
 
     void init(Time time);
 
+    /**
+     * Remove all the simulators from the scheduler and from the current
+     * bag. Use it to rebuild the scheduler from a checkpoint.
+     */
+    void clear();
+
+    /**
+     * Move the simulators of the current bag back into the scheduler and
+     * start an empty bag at @e time, before the current bag. Use it to
+     * inject external events between two bags.
+     */
+    void postpone(Time time);
+
     void addInternal(Simulator *simulator, Time time);
     void addExternal(Simulator *simulator,
                      std::shared_ptr<value::Value> values,
@@ -166,14 +195,50 @@ public:
 
     void makeNextBag();
 
+    /**
+     * Assign the time resolution of the scheduler. The dates of the
+     * internal events are rounded up to a multiple of @e resolution (see
+     * devs::quantize) and the simulators' tn are updated.
+     */
+    void setResolution(Time resolution) noexcept
+    {
+        m_resolution = resolution;
+    }
+
+    Time resolution() const noexcept { return m_resolution; }
+
+    /**
+     * Get the number of bags merged by the quantization: a bag built from
+     * @e n distinct dates counts for @e n - 1 merged bags.
+     */
+    std::size_t mergedBags() const noexcept { return m_merged_bags; }
+
 private:
+    void countMergedBags();
+
+    /**
+     * Clear the current bag and start a new epoch: the simulators stamped
+     * with an older epoch are not in the current bag.
+     */
+    void newBag() noexcept;
+
+    /**
+     * Add the simulator into the current bag if it is not already in.
+     */
+    void addToBag(Simulator *simulator);
+
     Bag m_current_bag;
     Heap m_scheduler;
+    std::vector<Time> m_raw_times;
     Time m_current_time;
+    std::uint64_t m_epoch; // 0 is reserved for the simulators without bag.
+    Time m_resolution;
+    std::size_t m_merged_bags;
 };
 
 class VLE_LOCAL TimedObservationScheduler {
     std::vector<ViewEvent> m_observation;
+    Time m_resolution = 0.0;
 
 public:
     void add(View *ptr, Time time, Time timestep)
@@ -182,7 +247,24 @@ public:
         assert(not isNegativeInfinity(time) &&
                "addObservation: negative infinity time");
 
-        push(m_observation, ptr, time, timestep);
+        push(m_observation, ptr, quantize(time, m_resolution), timestep);
+    }
+
+    /**
+     * Assign the time resolution of the observations. As for the @e
+     * Scheduler, the dates are rounded to a multiple of @e resolution.
+     */
+    void setResolution(Time resolution) noexcept
+    {
+        m_resolution = resolution;
+    }
+
+    Time getNextTime() const noexcept
+    {
+        if (m_observation.empty())
+            return infinity;
+
+        return m_observation[0].mTime;
     }
 
     bool haveObservationAtTime(Time time) noexcept
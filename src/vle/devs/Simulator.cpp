@@ -28,6 +28,7 @@
 #include <vle/devs/Dynamics.hpp>
 #include <vle/devs/Time.hpp>
 #include <vle/vpz/AtomicModel.hpp>
+#include <vle/vpz/CoupledModel.hpp>
 #include <vle/utils/Exception.hpp>
 #include <vle/utils/i18n.hpp>
 
@@ -39,6 +40,9 @@ namespace devs
 Simulator::Simulator(vpz::AtomicModel *atomic)
     : m_atomicModel(atomic)
     , m_tn(negativeInfinity)
+    , m_order(0)
+    , m_bag_epoch(0)
+    , m_depth(0)
     , m_have_handle(false)
     , m_have_internal(false)
 {
@@ -47,6 +51,17 @@ Simulator::Simulator(vpz::AtomicModel *atomic)
     m_atomicModel->m_simulator = this;
 }
 
+void Simulator::updateDepth() noexcept
+{
+    m_depth = 0;
+
+    const vpz::CoupledModel *parent = m_atomicModel->getParent();
+    while (parent != nullptr) {
+        parent = parent->getParent();
+        --m_depth;
+    }
+}
+
 void Simulator::updateSimulatorTargets(const std::string &port)
 {
     assert(m_atomicModel);
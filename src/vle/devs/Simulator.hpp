@@ -33,6 +33,7 @@
 #include <vle/devs/ObservationEvent.hpp>
 #include <vle/devs/ExternalEventList.hpp>
 #include <vle/devs/Scheduler.hpp>
+#include <vle/devs/SlotMap.hpp>
 #include <vle/devs/Dynamics.hpp>
 #include <vle/devs/View.hpp>
 #include <vle/vpz/AtomicModel.hpp>
@@ -163,6 +164,70 @@ public:
         return m_tn;
     }
 
+    inline void setTn(Time tn) noexcept
+    {
+        m_tn = tn;
+    }
+
+    /**
+     * @brief Get the creation order of the simulator in the coordinator.
+     * The scheduler uses it to sort the simulators of a bag.
+     */
+    inline std::size_t order() const noexcept
+    {
+        return m_order;
+    }
+
+    inline void setOrder(std::size_t order) noexcept
+    {
+        m_order = order;
+    }
+
+    /**
+     * @brief Get the depth of the atomic model in the hierarchy of
+     * coupled models (0 for the top model, -1 for its children, etc.).
+     * The value is computed by updateDepth().
+     */
+    inline int depth() const noexcept
+    {
+        return m_depth;
+    }
+
+    /**
+     * @brief Compute the depth of the atomic model from its parents. Call
+     * it when the atomic model is attached to the structure.
+     */
+    void updateDepth() noexcept;
+
+    /**
+     * @brief Get the epoch of the last bag of the scheduler where the
+     * simulator was added. The scheduler compares it with its current
+     * epoch to know if the simulator is already in the current bag.
+     */
+    inline std::uint64_t bagEpoch() const noexcept
+    {
+        return m_bag_epoch;
+    }
+
+    inline void setBagEpoch(std::uint64_t epoch) noexcept
+    {
+        m_bag_epoch = epoch;
+    }
+
+    /**
+     * @brief Get the handle of the simulator in the coordinator's list of
+     * simulators.
+     */
+    inline SlotHandle slot() const noexcept
+    {
+        return m_slot;
+    }
+
+    inline void setSlot(SlotHandle slot) noexcept
+    {
+        m_slot = slot;
+    }
+
     inline HandleT handle() const noexcept
     {
         assert(m_have_handle && "Simulator: handle is not defined");
@@ -225,6 +290,10 @@ private:
     std::vector<Observation> m_observations;
     std::string m_parents;
     Time m_tn;
+    std::size_t m_order;
+    std::uint64_t m_bag_epoch;
+    int m_depth;
+    SlotHandle m_slot;
     HandleT m_handle;
     bool m_have_handle;
     bool m_have_internal;
@@ -0,0 +1,158 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_DEVS_SLOTMAP_HPP
+#define VLE_DEVS_SLOTMAP_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace vle {
+namespace devs {
+
+/**
+ * @brief A stable reference to an element of a @e SlotMap. The generation
+ * detects a reference to a removed element, even if its slot is reused.
+ */
+struct SlotHandle {
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0;
+};
+
+/**
+ * @brief A generational slot map: insertion, deletion and lookup are O(1)
+ * and the elements are stored in a dense vector for the iteration.
+ *
+ * The deletion moves the last element in the place of the removed element:
+ * the order of the iteration is not the order of the insertion.
+ *
+ * @code
+ * SlotMap<Simulator> simulators;
+ * auto handle = simulators.insert(std::make_unique<Simulator>(atomic));
+ * assert(simulators.get(handle));
+ * simulators.erase(handle);
+ * assert(not simulators.get(handle));
+ * @endcode
+ */
+template <typename T> class SlotMap {
+    struct Slot {
+        std::uint32_t dense;      // The index in m_dense or the next free.
+        std::uint32_t generation; // Incremented when the slot is freed.
+    };
+
+    std::vector<std::unique_ptr<T>> m_dense;
+    std::vector<std::uint32_t> m_dense_to_slot;
+    std::vector<Slot> m_slots;
+    std::uint32_t m_free_head = none;
+
+    static constexpr std::uint32_t none = UINT32_MAX;
+
+public:
+    using iterator = typename std::vector<std::unique_ptr<T>>::iterator;
+    using const_iterator =
+        typename std::vector<std::unique_ptr<T>>::const_iterator;
+
+    /**
+     * @brief Insert the element into a free slot or into a new slot.
+     * @return A handle to retrieve or erase the element.
+     */
+    SlotHandle insert(std::unique_ptr<T> element)
+    {
+        std::uint32_t index;
+
+        if (m_free_head != none) {
+            index = m_free_head;
+            m_free_head = m_slots[index].dense;
+        }
+        else {
+            index = static_cast<std::uint32_t>(m_slots.size());
+            m_slots.push_back(Slot{ 0, 0 });
+        }
+
+        m_slots[index].dense = static_cast<std::uint32_t>(m_dense.size());
+        m_dense.emplace_back(std::move(element));
+        m_dense_to_slot.emplace_back(index);
+
+        return SlotHandle{ index, m_slots[index].generation };
+    }
+
+    /**
+     * @brief Get the element of the handle.
+     * @return nullptr if the element was removed.
+     */
+    T *get(SlotHandle handle) const noexcept
+    {
+        if (handle.index >= m_slots.size() or
+            m_slots[handle.index].generation != handle.generation)
+            return nullptr;
+
+        return m_dense[m_slots[handle.index].dense].get();
+    }
+
+    /**
+     * @brief Destroy the element of the handle and push its slot into the
+     * free list.
+     * @return false if the element was already removed.
+     */
+    bool erase(SlotHandle handle)
+    {
+        if (not get(handle))
+            return false;
+
+        auto &slot = m_slots[handle.index];
+        const auto dense = slot.dense;
+        const auto last = static_cast<std::uint32_t>(m_dense.size() - 1);
+
+        if (dense != last) {
+            m_dense[dense] = std::move(m_dense[last]);
+            m_dense_to_slot[dense] = m_dense_to_slot[last];
+            m_slots[m_dense_to_slot[dense]].dense = dense;
+        }
+
+        m_dense.pop_back();
+        m_dense_to_slot.pop_back();
+
+        ++slot.generation;
+        slot.dense = m_free_head;
+        m_free_head = handle.index;
+
+        return true;
+    }
+
+    std::size_t size() const noexcept { return m_dense.size(); }
+
+    bool empty() const noexcept { return m_dense.empty(); }
+
+    iterator begin() noexcept { return m_dense.begin(); }
+    iterator end() noexcept { return m_dense.end(); }
+    const_iterator begin() const noexcept { return m_dense.begin(); }
+    const_iterator end() const noexcept { return m_dense.end(); }
+};
+}
+} // namespace vle devs
+
+#endif
@@ -0,0 +1,190 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_DEVS_STATICDYNAMICS_HPP
+#define VLE_DEVS_STATICDYNAMICS_HPP 1
+
+#include <vle/devs/Dynamics.hpp>
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * Declare the port @e type_ of the @e name_ port of a StaticDynamics
+ * model.
+ *
+ * @code
+ * VLE_DEVS_PORT(Quanta, "Quanta");
+ * @endcode
+ */
+#define VLE_DEVS_PORT(type_, name_)                                           \
+    struct type_ {                                                            \
+        static const char *name() noexcept { return name_; }                  \
+    }
+
+namespace vle {
+namespace devs {
+
+namespace details {
+
+template <typename Port, typename... Ports>
+struct port_index;
+
+template <typename Port, typename... Ports>
+struct port_index<Port, Port, Ports...>
+  : std::integral_constant<std::size_t, 0> {
+};
+
+template <typename Port, typename Other, typename... Ports>
+struct port_index<Port, Other, Ports...>
+  : std::integral_constant<std::size_t,
+                           1 + port_index<Port, Ports...>::value> {
+};
+}
+
+/**
+ * @brief StaticDynamics is a Dynamics for the models with a compile-time
+ * list of input ports.
+ *
+ * The @e Derived class (CRTP) declares its input ports with the
+ * VLE_DEVS_PORT macro and a public @c on() function for each port. The
+ * external transition finds the index of the port of each event and calls
+ * the @c on() function through a table of functions, without virtual call
+ * and without string comparisons in the user code:
+ *
+ * @code
+ * VLE_DEVS_PORT(In, "in");
+ * VLE_DEVS_PORT(Reset, "reset");
+ *
+ * class Counter : public vle::devs::StaticDynamics<Counter, In, Reset>
+ * {
+ * public:
+ *     ...
+ *     void on(In, const vle::devs::ExternalEvent &event, vle::devs::Time);
+ *     void on(Reset, const vle::devs::ExternalEvent &, vle::devs::Time);
+ * };
+ * @endcode
+ *
+ * The events on undeclared ports are sent to @c onUnknown() and, after
+ * the events, @c onExternalEnd() is called. The Derived class hides these
+ * empty functions with public functions to use them.
+ */
+template <typename Derived, typename... InputPorts>
+class StaticDynamics : public Dynamics {
+public:
+    static_assert(sizeof...(InputPorts) > 0,
+                  "StaticDynamics needs at least one input port");
+
+    /** The number of input ports. */
+    static constexpr std::size_t input_size = sizeof...(InputPorts);
+
+    StaticDynamics(const DynamicsInit &init, const InitEventList &events)
+        : Dynamics(init, events)
+    {
+    }
+
+    virtual ~StaticDynamics() = default;
+
+    /**
+     * @brief Get the index of the input port @e Port at compile time.
+     */
+    template <typename Port>
+    static constexpr std::size_t index() noexcept
+    {
+        return details::port_index<Port, InputPorts...>::value;
+    }
+
+    /**
+     * @brief Get the index of the input port @e port or @c input_size if
+     * the port is not declared.
+     */
+    static std::size_t index(const std::string &port) noexcept
+    {
+        static const char *const names[] = { InputPorts::name()... };
+
+        for (std::size_t i = 0; i != input_size; ++i)
+            if (port == names[i])
+                return i;
+
+        return input_size;
+    }
+
+    /**
+     * @brief Check if the @e event is an event on the port @e Port.
+     */
+    template <typename Port>
+    static bool is(const ExternalEvent &event)
+    {
+        return event.getPortName() == Port::name();
+    }
+
+    /**
+     * @brief Append an event on the output port @e Port and return it.
+     */
+    template <typename Port>
+    static ExternalEvent &emit(ExternalEventList &output)
+    {
+        output.emplace_back(Port::name());
+        return output.back();
+    }
+
+    virtual void externalTransition(const ExternalEventList &events,
+                                    Time time) override
+    {
+        using handler = void (*)(Derived &, const ExternalEvent &, Time);
+
+        static const handler table[] = { &StaticDynamics::call<InputPorts>...,
+                                         &StaticDynamics::call_unknown };
+
+        auto &self = static_cast<Derived &>(*this);
+
+        for (const auto &event : events)
+            table[index(event.getPortName())](self, event, time);
+
+        self.onExternalEnd(time);
+    }
+
+    void onUnknown(const ExternalEvent & /* event */, Time /* time */) {}
+
+    void onExternalEnd(Time /* time */) {}
+
+private:
+    template <typename Port>
+    static void call(Derived &self, const ExternalEvent &event, Time time)
+    {
+        self.on(Port(), event, time);
+    }
+
+    static void
+    call_unknown(Derived &self, const ExternalEvent &event, Time time)
+    {
+        self.onUnknown(event, time);
+    }
+};
+}
+} // namespace vle devs
+
+#endif
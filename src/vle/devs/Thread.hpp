@@ -29,6 +29,11 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
 #include <thread>
 #include <vle/devs/Simulator.hpp>
 #include <vle/utils/Context.hpp>
@@ -65,39 +70,138 @@ class SimulatorProcessParallel {
     std::atomic<long int> m_block_count;
     std::atomic<bool> m_running_flag;
 
+    /* The idle workers wait for a new generation of blocks. */
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::uint64_t m_generation;
+
     std::vector<Simulator *> *m_jobs;
     Time m_time;
     long m_block_size;
 
+    /* The task processes the jobs [begin, end) of a block. */
+    std::function<void(std::size_t, std::size_t)> m_task;
+    std::size_t m_size;
+    long m_task_block_size;
+
+    void process(long block)
+    {
+        std::size_t begin = block * m_task_block_size;
+        std::size_t begin_plus_b = begin + m_task_block_size;
+        std::size_t end = std::min(m_size, begin_plus_b);
+
+        if (begin < end)
+            m_task(begin, end);
+
+        m_block_count.fetch_sub(1, std::memory_order_release);
+    }
+
+    /* Splits the @e size jobs into blocks and process the blocks with the
+       workers and the current thread. */
+    void run_blocks(std::size_t size, long block_size) noexcept
+    {
+        m_size = size;
+        m_task_block_size = block_size;
+
+        auto sz = (size / block_size) + ((size % block_size) ? 1 : 0);
+
+        m_block_count.store(sz, std::memory_order_relaxed);
+
+        if (m_workers.empty()) {
+            m_block_id.store(sz, std::memory_order_release);
+        }
+        else {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_block_id.store(sz, std::memory_order_release);
+                ++m_generation;
+            }
+
+            m_cv.notify_all();
+        }
+
+        for (;;) {
+            auto block = m_block_id.fetch_sub(1, std::memory_order_acq_rel);
+
+            if (block < 0)
+                break;
+
+            process(block);
+        }
+
+        while (m_block_count.load(std::memory_order_acquire) >= 0)
+            std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+    }
+
+    /* A worker processes the blocks then sleeps until the next call of
+       run_blocks(): an idle pool does not use the processors. */
     void run()
     {
-        while (m_running_flag.load(std::memory_order_relaxed)) {
-            auto block = m_block_id.fetch_sub(1, std::memory_order_relaxed);
+        std::uint64_t generation = 0;
 
-            if (block >= 0) {
-                std::size_t begin = block * m_block_size;
-                std::size_t begin_plus_b = begin + m_block_size;
-                std::size_t end = std::min(m_jobs->size(), begin_plus_b);
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [this, generation]() {
+                    return m_generation != generation or
+                           not m_running_flag.load(std::memory_order_relaxed);
+                });
 
-                for (; begin < end; ++begin)
-                    simulator_process((*m_jobs)[begin], m_time);
+                if (not m_running_flag.load(std::memory_order_relaxed))
+                    return;
 
-                m_block_count.fetch_sub(1, std::memory_order_relaxed);
+                generation = m_generation;
             }
-            else {
-                //
-                // TODO: Maybe we can use a yield instead of this
-                // sleep_for function to reduce the overhead of the
-                // current thread.
-                //
-                std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+
+            for (;;) {
+                auto block =
+                    m_block_id.fetch_sub(1, std::memory_order_acq_rel);
+
+                if (block < 0)
+                    break;
+
+                process(block);
             }
         }
     }
 
+    void stop() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running_flag.store(false, std::memory_order_relaxed);
+        }
+
+        m_cv.notify_all();
+
+        for (auto &thread : m_workers)
+            if (thread.joinable())
+                thread.join();
+    }
+
+    void start(long workers_count)
+    {
+        m_block_id.store(-1, std::memory_order_relaxed);
+        m_block_count.store(-1, std::memory_order_relaxed);
+        m_running_flag.store(true, std::memory_order_relaxed);
+        m_generation = 0;
+
+        try {
+            m_workers.reserve(workers_count);
+            for (long i = 0; i != workers_count; ++i)
+                m_workers.emplace_back(&SimulatorProcessParallel::run, this);
+        }
+        catch (...) {
+            stop();
+            throw;
+        }
+    }
+
 public:
     SimulatorProcessParallel(utils::ContextPtr context)
         : m_jobs(nullptr)
+        , m_size(0)
+        , m_task_block_size(1)
     {
         long block_size = 8;
         {
@@ -122,28 +226,25 @@ public:
               workers_count,
               m_block_size);
 
-        m_block_id.store(-1, std::memory_order_relaxed);
-        m_block_count.store(-1, std::memory_order_relaxed);
-        m_running_flag.store(true, std::memory_order_relaxed);
+        start(workers_count);
+    }
 
-        try {
-            m_workers.reserve(workers_count);
-            for (long i = 0; i != workers_count; ++i)
-                m_workers.emplace_back(&SimulatorProcessParallel::run, this);
-        }
-        catch (...) {
-            m_running_flag.store(false, std::memory_order_relaxed);
-            throw;
-        }
+    /**
+     * Start @e workers_count workers, the jobs are grouped by @e
+     * block_size. The workers are joined by the destructor.
+     */
+    SimulatorProcessParallel(long workers_count, long block_size)
+        : m_jobs(nullptr)
+        , m_block_size(block_size > 0 ? block_size : 8)
+        , m_size(0)
+        , m_task_block_size(1)
+    {
+        start(workers_count > 0 ? workers_count : 0l);
     }
 
     ~SimulatorProcessParallel() noexcept
     {
-        m_running_flag.store(false, std::memory_order_relaxed);
-
-        for (auto &thread : m_workers)
-            if (thread.joinable())
-                thread.join();
+        stop();
     }
 
     bool parallelize() const noexcept { return not m_workers.empty(); }
@@ -152,36 +253,53 @@ public:
     {
         m_jobs = &simulators;
         m_time = time;
-
-        auto sz = (simulators.size() / m_block_size) +
-                  ((simulators.size() % m_block_size) ? 1 : 0);
-
-        m_block_count.store(sz, std::memory_order_relaxed);
-        m_block_id.store(sz, std::memory_order_relaxed);
-
-        for (;;) {
-            auto block = m_block_id.fetch_sub(1, std::memory_order_relaxed);
-
-            if (block < 0)
-                break;
-
-            std::size_t begin = block * m_block_size;
-            std::size_t begin_plus_b = begin + m_block_size;
-            std::size_t end = std::min(m_jobs->size(), begin_plus_b);
-
+        m_task = [this](std::size_t begin, std::size_t end) {
             for (; begin < end; ++begin)
                 simulator_process((*m_jobs)[begin], m_time);
+        };
 
-            m_block_count.fetch_sub(1, std::memory_order_relaxed);
-        }
-
-        while (m_block_count.load(std::memory_order_relaxed) >= 0)
-            std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+        run_blocks(simulators.size(), m_block_size);
 
         m_jobs = nullptr;
 
         return true;
     }
+
+    /**
+     * Call @e function for each index in [0, size) with the workers and
+     * the current thread. If some calls throw, the exception of the lowest
+     * index is rethrown when all the calls are finished. The indices are
+     * grouped by @e block_size (0 to use the @e vle.simulation.block-size
+     * setting).
+     */
+    void for_each(std::size_t size,
+                  const std::function<void(std::size_t)> &function,
+                  long block_size = 0)
+    {
+        std::mutex mutex;
+        std::exception_ptr error;
+        std::size_t error_index = size;
+
+        m_task = [&](std::size_t begin, std::size_t end) {
+            for (; begin < end; ++begin) {
+                try {
+                    function(begin);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (begin < error_index) {
+                        error_index = begin;
+                        error = std::current_exception();
+                    }
+                }
+            }
+        };
+
+        run_blocks(size, block_size > 0 ? block_size : m_block_size);
+
+        if (error)
+            std::rethrow_exception(error);
+    }
 };
 }
 }
@@ -29,9 +29,10 @@
 #define VLE_DEVS_TIME_HPP
 
 #include <vle/DllDefines.hpp>
+#include <algorithm>
 #include <limits>
 #include <string>
-#include <cmath> /* for isnan */
+#include <cmath> /* for isnan, ceil and nearbyint */
 
 namespace vle { namespace devs {
 
@@ -104,6 +105,34 @@ inline static bool isNegativeInfinity(Time time)
     return time == negativeInfinity;
 }
 
+/**
+ * Round the @e time up to the next multiple of @e resolution: an event is
+ * never moved before its date. Two dates rounded to the same multiple are
+ * equal. A @e time distant from a multiple by the rounding errors of the
+ * floating point (0.1 + 0.2 for 0.3 for example) is rounded to this
+ * multiple. The infinities and a @e resolution of 0 keep the @e time
+ * unchanged.
+ *
+ * @param time The @e time to round.
+ * @param resolution The resolution of the time (0 for a continuous time).
+ *
+ * @return The rounded @e time.
+ */
+inline static Time quantize(Time time, Time resolution)
+{
+    if (resolution <= 0.0 or isInfinity(time) or isNegativeInfinity(time))
+        return time;
+
+    const Time steps = time / resolution;
+    const Time nearest = std::nearbyint(steps);
+
+    if (std::abs(steps - nearest) <= 1e-9 * std::max(Time(1.0),
+                                                      std::abs(steps)))
+        return nearest / (1.0 / resolution);
+
+    return std::ceil(steps) / (1.0 / resolution);
+}
+
 /**
  * Transform the @e Time time into @e an std::string.
  *
@@ -30,7 +30,12 @@
 #include <vle/vpz/CoupledModel.hpp>
 #include <vle/utils/Algo.hpp>
 #include <vle/utils/i18n.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 namespace vle { namespace devs {
 
@@ -72,6 +77,18 @@ void View::open(utils::ContextPtr ctx,
     m_plugin->onParameter(pluginname, location, file, std::move(parameters), time);
 }
 
+void View::setAggregation(vpz::View::Aggregation aggregation,
+                          Time window,
+                          Time begin)
+{
+    assert(aggregation == vpz::View::AGGREGATE_NONE or window > 0.0);
+
+    m_aggregation = aggregation;
+    m_window = window;
+    m_begin = begin;
+    m_windowbegin = begin;
+}
+
 void View::addObservable(Dynamics* dynamics,
                          const std::string& portname,
                          Time currenttime)
@@ -80,11 +97,16 @@ void View::addObservable(Dynamics* dynamics,
     assert(not exist(dynamics, portname));
     assert(m_plugin);
 
-    m_observableList.emplace(dynamics, portname);
+    auto it = m_observableList.emplace(
+        dynamics, oov::ObservableColumn{ dynamics->getModel().getName(),
+                                         dynamics->getModel().getParentName(),
+                                         portname, m_nextid++ });
 
-    m_plugin->onNewObservable(dynamics->getModel().getName(),
-                              dynamics->getModel().getParentName(),
-                              portname, m_name, currenttime);
+    m_columns.emplace_back(&it->second);
+    m_accumulators.emplace_back();
+
+    m_plugin->onNewObservable(it->second.simulator, it->second.parent,
+                              it->second.port, m_name, currenttime);
 }
 
 void View::removeObservable(Dynamics* dynamics)
@@ -94,23 +116,33 @@ void View::removeObservable(Dynamics* dynamics)
 
     auto result = m_observableList.equal_range(dynamics);
 
-    for (auto it = result.first; it != result.second; ++it)
-        m_plugin->onDelObservable(it->first->getModel().getName(),
-                                  it->first->getModel().getParentName(),
-                                  it->second, m_name, 0.0);
+    // The partial window of the observable is sent before the plug-in
+    // forgets the column: the other observables of the window are sent
+    // later, at the same date, by flushAggregates().
+    if (m_aggregation != vpz::View::AGGREGATE_NONE) {
+        for (auto it = result.first; it != result.second; ++it)
+            reduce(it->second.id);
+
+        if (not m_aggregates.empty()) {
+            m_plugin->onValues(m_name, m_windowbegin, m_aggregates.data(),
+                               m_aggregates.size());
+            m_aggregates.clear();
+        }
+    }
+
+    for (auto it = result.first; it != result.second; ++it) {
+        m_columns[it->second.id] = nullptr;
+
+        m_plugin->onDelObservable(it->second.simulator, it->second.parent,
+                                  it->second.port, m_name, 0.0);
+    }
 
     m_observableList.erase(result.first, result.second);
 }
 
 bool View::exist(Dynamics* dynamics, const std::string& portname) const
 {
-    auto result = m_observableList.equal_range(dynamics);
-
-    for (auto it = result.first; it != result.second; ++it)
-        if (it->second == portname)
-            return true;
-
-    return false;
+    return column(dynamics, portname) != nullptr;
 }
 
 bool View::exist(Dynamics* dynamics) const
@@ -118,17 +150,59 @@ bool View::exist(Dynamics* dynamics) const
     return m_observableList.find(dynamics) != m_observableList.end();
 }
 
+static bool toReal(const value::Value* value, double& result) noexcept
+{
+    if (not value)
+        return false;
+
+    switch (value->getType()) {
+    case value::Value::DOUBLE:
+        result = value->toDouble().value();
+        return true;
+    case value::Value::INTEGER:
+        result = static_cast<double>(value->toInteger().value());
+        return true;
+    case value::Value::BOOLEAN:
+        result = value->toBoolean().value() ? 1.0 : 0.0;
+        return true;
+    default:
+        return false;
+    }
+}
+
 void View::run(Time time)
 {
-    if (not m_observableList.empty()) {
+    if (not m_observableList.empty() and aggregated()) {
+        roll(time);
+
+        //
+        // The observations are reduced without allocation if the models
+        // provide real numbers.
+        //
+        for (auto & elem : m_observableList) {
+            ObservationEvent event(time, m_name, elem.second.port);
+
+            double x;
+            if (elem.first->realObservation(event, x)) {
+                accumulate(elem.second.id, x);
+            } else {
+                auto value = elem.first->observation(event);
+                if (toReal(value.get(), x))
+                    accumulate(elem.second.id, x);
+            }
+        }
+    } else if (not m_observableList.empty()) {
+        assert(m_values.empty());
+        m_values.reserve(m_observableList.size());
+
         for (auto & elem : m_observableList) {
-            ObservationEvent event(time, m_name, elem.second);
-            auto val = elem.first->observation(event);
-            m_plugin->onValue(elem.first->getModel().getName(),
-                              elem.first->getModel().getParentName(),
-                              elem.second, m_name, time,
-                              std::move(val));
+            ObservationEvent event(time, m_name, elem.second.port);
+            m_values.push_back(
+                oov::ColumnValue{ &elem.second,
+                                  elem.first->observation(event) });
         }
+
+        flush(time);
     } else {
         //
         // Strange behavior.
@@ -141,30 +215,191 @@ void View::run(Time time)
 void View::run(const Dynamics *dynamics, Time current, const std::string& port)
 {
     ObservationEvent event(current, m_name, port);
+
+    double x;
+    if (aggregated() and dynamics->realObservation(event, x)) {
+        const auto* col = column(dynamics, port);
+
+        assert(col && "View: run an observation of an unknown observable");
+
+        m_reals.emplace_back(col->id, x);
+        aggregate(current);
+        return;
+    }
+
     auto val = dynamics->observation(event);
 
-    m_plugin->onValue(dynamics->getModel().getName(),
-                      dynamics->getModel().getParentName(),
-                      port, m_name, current,
-                      std::move(val));
+    run(dynamics, current, port, std::move(val));
 }
 
 void View::run(const Dynamics *dynamics, Time current, const std::string& port,
                std::unique_ptr<value::Value> value)
 {
+    if (m_aggregation != vpz::View::AGGREGATE_NONE) {
+        push(dynamics, port, std::move(value));
+        aggregate(current);
+        return;
+    }
+
     m_plugin->onValue(dynamics->getModel().getName(),
                       dynamics->getModel().getParentName(),
                       port, m_name, current,
                       std::move(value));
 }
 
+void View::run(const Dynamics *dynamics, Time current,
+               Observation& observation)
+{
+    if (observation.isreal) {
+        push(dynamics, observation);
+        aggregate(current);
+        return;
+    }
+
+    run(dynamics, current, observation.portname,
+        std::move(observation.value));
+}
+
+void View::push(const Dynamics *dynamics, Observation& observation)
+{
+    if (observation.isreal) {
+        const auto* col = column(dynamics, observation.portname);
+
+        assert(col && "View: push an observation of an unknown observable");
+
+        m_reals.emplace_back(col->id, observation.real);
+        return;
+    }
+
+    push(dynamics, observation.portname, std::move(observation.value));
+}
+
+void View::push(const Dynamics *dynamics, const std::string& port,
+                std::unique_ptr<value::Value> value)
+{
+    const auto* col = column(dynamics, port);
+
+    assert(col && "View: push an observation of an unknown observable");
+
+    m_values.push_back(oov::ColumnValue{ col, std::move(value) });
+}
+
+void View::flush(Time current)
+{
+    if (m_values.empty() and m_reals.empty())
+        return;
+
+    if (m_aggregation != vpz::View::AGGREGATE_NONE) {
+        aggregate(current);
+        return;
+    }
+
+    m_plugin->onValues(m_name, current, m_values.data(), m_values.size());
+    m_values.clear();
+}
+
+void View::roll(Time current)
+{
+    if (current >= m_windowbegin + m_window) {
+        flushAggregates();
+        m_windowbegin = m_begin +
+            std::floor((current - m_begin) / m_window) * m_window;
+    }
+}
+
+void View::accumulate(std::size_t id, double x) noexcept
+{
+    auto& acc = m_accumulators[id];
+    if (acc.count == 0) {
+        acc.value = x;
+    } else {
+        switch (m_aggregation) {
+        case vpz::View::AGGREGATE_MIN:
+            acc.value = std::min(acc.value, x);
+            break;
+        case vpz::View::AGGREGATE_MAX:
+            acc.value = std::max(acc.value, x);
+            break;
+        default:
+            acc.value += x;
+            break;
+        }
+    }
+    ++acc.count;
+}
+
+void View::aggregate(Time current)
+{
+    roll(current);
+
+    for (auto& elem : m_values) {
+        double x;
+        if (toReal(elem.value.get(), x))
+            accumulate(elem.column->id, x);
+    }
+
+    for (const auto& elem : m_reals)
+        accumulate(elem.first, elem.second);
+
+    m_values.clear();
+    m_reals.clear();
+}
+
+void View::reduce(std::size_t id)
+{
+    auto& acc = m_accumulators[id];
+    if (acc.count == 0 or not m_columns[id])
+        return;
+
+    double result = acc.value;
+    if (m_aggregation == vpz::View::AGGREGATE_MEAN)
+        result /= static_cast<double>(acc.count);
+
+    m_aggregates.push_back(
+        oov::ColumnValue{ m_columns[id], value::Double::create(result) });
+    acc.count = 0;
+}
+
+void View::flushAggregates()
+{
+    for (std::size_t i = 0, e = m_accumulators.size(); i != e; ++i)
+        reduce(i);
+
+    if (not m_aggregates.empty()) {
+        m_plugin->onValues(m_name, m_windowbegin, m_aggregates.data(),
+                           m_aggregates.size());
+        m_aggregates.clear();
+    }
+}
+
+const oov::ObservableColumn* View::column(const Dynamics* dynamics,
+                                          const std::string& port) const
+{
+    auto result = m_observableList.equal_range(
+        const_cast<Dynamics*>(dynamics));
+
+    for (auto it = result.first; it != result.second; ++it)
+        if (it->second.port == port)
+            return &it->second;
+
+    return nullptr;
+}
+
 std::unique_ptr<value::Matrix> View::matrix() const
 {
     return m_plugin->matrix();
 }
 
+std::unique_ptr<value::Matrix> View::matrix(std::size_t first) const
+{
+    return m_plugin->matrixRows(first);
+}
+
 std::unique_ptr<value::Matrix> View::finish(Time current)
 {
+    if (m_aggregation != vpz::View::AGGREGATE_NONE)
+        flushAggregates();
+
     return m_plugin->finish(current);
 }
 
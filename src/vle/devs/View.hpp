@@ -33,7 +33,9 @@
 #include <vle/devs/Time.hpp>
 #include <vle/value/Matrix.hpp>
 #include <vle/oov/Plugin.hpp>
+#include <vle/vpz/View.hpp>
 #include <string>
+#include <vector>
 #include <map>
 
 namespace vle { namespace devs {
@@ -41,6 +43,12 @@ namespace vle { namespace devs {
 class Dynamics;
 class View;
 
+/**
+ * The position of a reader in the results of the simulation: for each
+ * view, the number of rows already read.
+ */
+using OutputCursor = std::map<std::string, std::size_t>;
+
 /**
  * A simple structure that stores observation values for a specific view
  * and portname tuple.
@@ -49,6 +57,11 @@ struct Observation {
     View *view = nullptr;
     std::string portname;
     std::unique_ptr<value::Value> value;
+
+    /** For an aggregated view, the observation computed by @c
+     * Dynamics::realObservation() instead of @e value. */
+    double real = 0.0;
+    bool isreal = false;
 };
 
 /**
@@ -80,6 +93,20 @@ public:
               Time time,
               std::unique_ptr<value::Value> parameters);
 
+    /**
+     * Reduce the observations over windows of duration \e window before
+     * sending them to the plug-in. The plug-in receives one value::Double
+     * per observable and window, dated by the begin of the window.
+     * Non numeric values are ignored.
+     *
+     * @param aggregation the reduction.
+     * @param window the duration of a window.
+     * @param begin the begin of the first window.
+     */
+    void setAggregation(vpz::View::Aggregation aggregation,
+                        Time window,
+                        Time begin);
+
     /**
      * Add new observable (\e Dynamics*, \e portname) into the View.
      *
@@ -95,10 +122,36 @@ public:
     void run(const Dynamics *dynamics, Time current, const std::string& port,
              std::unique_ptr<value::Value> value);
 
+    void run(const Dynamics *dynamics, Time current, Observation& observation);
+
+    /** Check if the view reduces its observations. */
+    bool aggregated() const noexcept
+    {
+        return m_aggregation != vpz::View::AGGREGATE_NONE;
+    }
+
+    /**
+     * Store the observation of a \e Dynamics until the next call to
+     * flush(). The coordinator uses it to send all the observations of a
+     * bag with one call to oov::Plugin::onValues.
+     */
+    void push(const Dynamics *dynamics, const std::string& port,
+              std::unique_ptr<value::Value> value);
+
+    void push(const Dynamics *dynamics, Observation& observation);
+
+    /**
+     * Send the observations stored by push() to the plug-in.
+     *
+     * @param current the date of the observations.
+     */
+    void flush(Time current);
+
     /**
      * Delete an observable for a specified Dynamics. If model does not
      * exist, nothing is produce otherwise, the stream receives a message
-     * that a observable is dead.
+     * that a observable is dead. For an aggregated view, the reduction of
+     * the current window of the observable is sent first.
      * @param model delete observable attached to the specified
      * Dynamics.
      */
@@ -130,6 +183,14 @@ public:
      */
     std::unique_ptr<value::Matrix> matrix() const;
 
+    /**
+     * Return the complete rows of the \c value::Matrix of the plug-in
+     * from the row \e first.
+     *
+     * @see oov::Plugin::matrixRows.
+     */
+    std::unique_ptr<value::Matrix> matrix(std::size_t first) const;
+
     /**
      * Retrieves the name of this \e View.
      *
@@ -145,11 +206,49 @@ public:
     std::unique_ptr<value::Matrix> finish(Time current) ;
 
 protected:
-    using ObservableList = std::multimap<Dynamics*, std::string>;
+    using ObservableList = std::multimap<Dynamics*, oov::ObservableColumn>;
+
+    /** The reduction of the observations of an observable in the current
+     * window. */
+    struct Accumulator {
+        double      value = 0.0;
+        std::size_t count = 0;
+    };
+
+    ObservableList                   m_observableList;
+    std::vector<oov::ColumnValue>    m_values;
+    std::string                      m_name;
+    oov::PluginPtr                   m_plugin;
+    std::size_t                      m_nextid = 0;
+
+    vpz::View::Aggregation           m_aggregation = vpz::View::AGGREGATE_NONE;
+    Time                             m_begin = 0.0;
+    Time                             m_window = 0.0;
+    Time                             m_windowbegin = 0.0;
+    std::vector<Accumulator>         m_accumulators;
+    std::vector<const oov::ObservableColumn*> m_columns;
+    std::vector<oov::ColumnValue>    m_aggregates;
+
+    /** The real observations (identifier of the column and value) stored
+     * by push() until the next aggregate(). */
+    std::vector<std::pair<std::size_t, double>> m_reals;
+
+    const oov::ObservableColumn* column(const Dynamics* dynamics,
+                                        const std::string& port) const;
+
+    /** Send the reductions of the current window if \e current is after
+     * it, and start the window of \e current. */
+    void roll(Time current);
+
+    void accumulate(std::size_t id, double x) noexcept;
+
+    void aggregate(Time current);
+
+    /** Move the reduction of the current window of the observable \e id,
+     * if any, into \e m_aggregates. */
+    void reduce(std::size_t id);
 
-    ObservableList m_observableList;
-    std::string    m_name;
-    oov::PluginPtr m_plugin;
+    void flushAggregates();
 };
 
 }} // namespace vle devs
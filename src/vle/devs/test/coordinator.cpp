@@ -32,7 +32,10 @@
 #include <vle/devs/Coordinator.hpp>
 #include <vle/devs/Dynamics.hpp>
 #include <vle/devs/Executive.hpp>
+#include <vle/devs/Population.hpp>
 #include <vle/devs/RootCoordinator.hpp>
+#include <vle/devs/SlotMap.hpp>
+#include <vle/devs/StaticDynamics.hpp>
 #include <vle/oov/Plugin.hpp>
 #include <vle/utils/unit-test.hpp>
 #include <vle/vpz/Classes.hpp>
@@ -216,7 +219,38 @@ public:
     virtual void finish() override {}
 };
 
+class Deleter : public vle::devs::Executive {
+    bool deleted;
+
+public:
+    Deleter(const vle::devs::ExecutiveInit &init,
+            const vle::devs::InitEventList &events)
+        : vle::devs::Executive(init, events)
+    {
+    }
+
+    virtual ~Deleter() = default;
+
+    virtual vle::devs::Time init(vle::devs::Time /* time */) override
+    {
+        deleted = false;
+        return 15.5;
+    }
+
+    virtual vle::devs::Time timeAdvance() const override
+    {
+        return deleted ? vle::devs::infinity : 15.5;
+    }
+
+    virtual void internalTransition(vle::devs::Time /* time */) override
+    {
+        delModel("ObservationModel");
+        deleted = true;
+    }
+};
+
 class ObservationModel : public vle::devs::Dynamics {
+protected:
     mutable int state;
 
 public:
@@ -271,6 +305,145 @@ public:
     virtual void finish() override { state++; }
 };
 
+/* The number of calls of RealObservationModel::observation(). */
+int value_observations = 0;
+
+/* The ObservationModel with the observation as a real number. */
+class RealObservationModel : public ObservationModel {
+public:
+    RealObservationModel(const vle::devs::DynamicsInit &init,
+                         const vle::devs::InitEventList &events)
+        : ObservationModel(init, events)
+    {
+    }
+
+    virtual std::unique_ptr<vle::value::Value>
+    observation(const vle::devs::ObservationEvent &event) const override
+    {
+        ++value_observations;
+        return ObservationModel::observation(event);
+    }
+
+    virtual bool realObservation(const vle::devs::ObservationEvent &,
+                                 double &value) const override
+    {
+        value = state;
+        return true;
+    }
+};
+
+class PopulationModel : public vle::devs::Population {
+    std::vector<int> count;
+    mutable int outputs;
+    int bags;
+
+public:
+    PopulationModel(const vle::devs::DynamicsInit &init,
+                    const vle::devs::InitEventList &events)
+        : vle::devs::Population(init, events, 999)
+        , count(size(), 0)
+        , outputs(0)
+        , bags(0)
+    {
+    }
+
+    // The period of the instance i is 1 + i % 3.
+    virtual void initPopulation(vle::devs::Time /* time */,
+                                vle::devs::Time *ta) override
+    {
+        for (std::size_t i = 0; i != size(); ++i)
+            ta[i] = 1 + i % 3;
+    }
+
+    virtual void outputPopulation(vle::devs::Time /* time */,
+                                  const std::size_t * /* due */,
+                                  std::size_t count,
+                                  vle::devs::ExternalEventList &output)
+      const override
+    {
+        outputs += static_cast<int>(count);
+        output.emplace_back("out");
+        output.back().addInteger(static_cast<int>(count));
+    }
+
+    virtual void internalPopulation(vle::devs::Time time,
+                                    const std::size_t *due,
+                                    std::size_t size,
+                                    vle::devs::Time *ta) override
+    {
+        bags++;
+
+        for (std::size_t i = 0; i != size; ++i) {
+            Ensures(i == 0 or due[i - 1] < due[i]);
+            Ensures(timeNext(due[i]) == time);
+            count[due[i]]++;
+            ta[i] = 1 + due[i] % 3;
+        }
+    }
+
+    virtual void finish() override
+    {
+        // Events at 1, 2, ..., 6: all the instances are due at 6.
+        EnsuresEqual(bags, 6);
+        EnsuresEqual(outputs, 333 * (6 + 3 + 2));
+        EnsuresEqual(count[0], 6);
+        EnsuresEqual(count[1], 3);
+        EnsuresEqual(count[998], 2);
+    }
+};
+
+VLE_DEVS_PORT(In, "in");
+VLE_DEVS_PORT(Reset, "reset");
+
+class StaticModel : public vle::devs::StaticDynamics<StaticModel, In, Reset> {
+    int in;
+    int reset;
+    int unknown;
+    int end;
+
+public:
+    StaticModel(const vle::devs::DynamicsInit &init,
+                const vle::devs::InitEventList &events)
+        : vle::devs::StaticDynamics<StaticModel, In, Reset>(init, events)
+        , in(0)
+        , reset(0)
+        , unknown(0)
+        , end(0)
+    {
+        static_assert(index<Reset>() == 1, "bad port index");
+        EnsuresEqual(index("reset"), (std::size_t)1);
+        EnsuresEqual(index("other"), input_size);
+    }
+
+    void on(In, const vle::devs::ExternalEvent &event, vle::devs::Time)
+    {
+        Ensures(is<In>(event));
+        in++;
+    }
+
+    void on(Reset, const vle::devs::ExternalEvent &, vle::devs::Time)
+    {
+        reset++;
+    }
+
+    void onUnknown(const vle::devs::ExternalEvent &event, vle::devs::Time)
+    {
+        Ensures(event.onPort("other"));
+        unknown++;
+    }
+
+    void onExternalEnd(vle::devs::Time) { end++; }
+
+    virtual void finish() override
+    {
+        // The model sends an event at 1, 2, ..., 10 on both ports.
+        EnsuresEqual(in, 10);
+        EnsuresEqual(reset, 0);
+        EnsuresEqual(unknown, 10);
+        EnsuresEqual(end, 10);
+    }
+};
+
 class OutputPluginSimple : public vle::oov::Plugin {
     struct data {
         std::unique_ptr<vle::value::Value> value;
@@ -387,6 +560,13 @@ exe_make_new_exe(const vle::devs::ExecutiveInit &init,
     return new ::Exe(init, events);
 }
 
+VLE_MODULE vle::devs::Dynamics *
+exe_make_new_deleter(const vle::devs::ExecutiveInit &init,
+                     const vle::devs::InitEventList &events)
+{
+    return new ::Deleter(init, events);
+}
+
 VLE_MODULE vle::devs::Dynamics *
 make_new_observation_model(const vle::devs::DynamicsInit &init,
                            const vle::devs::InitEventList &events)
@@ -394,6 +574,27 @@ make_new_observation_model(const vle::devs::DynamicsInit &init,
     return new ::ObservationModel(init, events);
 }
 
+VLE_MODULE vle::devs::Dynamics *
+make_new_real_observation_model(const vle::devs::DynamicsInit &init,
+                                const vle::devs::InitEventList &events)
+{
+    return new ::RealObservationModel(init, events);
+}
+
+VLE_MODULE vle::devs::Dynamics *
+make_new_population_model(const vle::devs::DynamicsInit &init,
+                          const vle::devs::InitEventList &events)
+{
+    return new ::PopulationModel(init, events);
+}
+
+VLE_MODULE vle::devs::Dynamics *
+make_new_static_model(const vle::devs::DynamicsInit &init,
+                      const vle::devs::InitEventList &events)
+{
+    return new ::StaticModel(init, events);
+}
+
 VLE_MODULE vle::oov::Plugin *make_oovplugin(const std::string &location)
 {
     return new ::OutputPluginSimple(location);
@@ -753,6 +954,390 @@ void test_observation_timed_disabled()
     }
 }
 
+void test_observation_aggregation()
+{
+    auto ctx = vle::utils::make_context();
+
+    for (auto aggregation :
+         { vpz::View::AGGREGATE_MAX, vpz::View::AGGREGATE_MEAN }) {
+        vpz::Vpz vpz;
+
+        vpz.project().experiment().setDuration(100.0);
+        vpz.project().experiment().setBegin(0.0);
+
+        vpz.project().experiment().views().addStreamOutput(
+            "output", "toto", "make_oovplugin_default", "");
+
+        auto &v = vpz.project().experiment().views().add(vpz::View(
+            "The_view", vle::vpz::View::Type::INTERNAL, "output"));
+        v.setAggregation(aggregation, 10.0);
+
+        vpz::Observable &obs =
+            vpz.project().experiment().views().addObservable(
+                vpz::Observable("obs"));
+        vpz::ObservablePort &port = obs.add("port");
+        port.add("The_view");
+
+        {
+            auto x = vpz.project().dynamics().dynamiclist().emplace(
+                "dyn_1", vpz::Dynamic("dyn_1"));
+            Ensures(x.second == true);
+            x.first->second.setLibrary("make_new_observation_model");
+        }
+
+        vpz::CoupledModel *depth0 = new vpz::CoupledModel("depth0", nullptr);
+        auto *atom = depth0->addAtomicModel("ObservationModel");
+        atom->setDynamics("dyn_1");
+        atom->addOutputPort("out");
+        atom->setObservables("obs");
+
+        vpz.project().model().setGraph(
+            std::unique_ptr<vpz::BaseModel>(depth0));
+
+        devs::RootCoordinator root(ctx);
+        root.load(vpz);
+        vpz.clear();
+        root.init();
+        while (root.run())
+            ;
+        std::unique_ptr<value::Map> out = root.outputs();
+
+        Ensures(out);
+
+        // The internal transition at time t observes 2 * t. The values
+        // are reduced over [0, 10), [10, 20), etc. and dated by the begin
+        // of the window.
+        value::Matrix &matrix = out->getMatrix("The_view");
+        EnsuresEqual(matrix.columns(), (std::size_t)2);
+
+        if (aggregation == vpz::View::AGGREGATE_MAX) {
+            EnsuresApproximatelyEqual(
+                value::toDouble(matrix(1, 0)), 18.0, 1e-10);
+            EnsuresApproximatelyEqual(
+                value::toDouble(matrix(1, 10)), 38.0, 1e-10);
+        } else {
+            EnsuresApproximatelyEqual(
+                value::toDouble(matrix(1, 0)), 10.0, 1e-10);
+            EnsuresApproximatelyEqual(
+                value::toDouble(matrix(1, 10)), 29.0, 1e-10);
+        }
+
+        Ensures(not matrix(1, 5));
+
+        root.finish();
+    }
+}
+
+void test_observation_timed_aggregation()
+{
+    auto ctx = vle::utils::make_context();
+    vpz::Vpz vpz;
+
+    vpz.project().experiment().setDuration(100.0);
+    vpz.project().experiment().setBegin(0.0);
+
+    vpz.project().experiment().views().addStreamOutput(
+        "output", "toto", "make_oovplugin_default", "");
+
+    auto &v = vpz.project().experiment().views().add(
+        vpz::View("The_view", vle::vpz::View::Type::TIMED, "output", 1.0));
+    v.setAggregation(vpz::View::AGGREGATE_MEAN, 10.0);
+
+    vpz::Observable &obs = vpz.project().experiment().views().addObservable(
+        vpz::Observable("obs"));
+    vpz::ObservablePort &port = obs.add("port");
+    port.add("The_view");
+
+    {
+        auto x = vpz.project().dynamics().dynamiclist().emplace(
+            "dyn_1", vpz::Dynamic("dyn_1"));
+        Ensures(x.second == true);
+        x.first->second.setLibrary("make_new_observation_model");
+    }
+
+    vpz::CoupledModel *depth0 = new vpz::CoupledModel("depth0", nullptr);
+    auto *atom = depth0->addAtomicModel("ObservationModel");
+    atom->setDynamics("dyn_1");
+    atom->addOutputPort("out");
+    atom->setObservables("obs");
+
+    vpz.project().model().setGraph(std::unique_ptr<vpz::BaseModel>(depth0));
+
+    devs::RootCoordinator root(ctx);
+    root.load(vpz);
+    vpz.clear();
+    root.init();
+    while (root.run())
+        ;
+    std::unique_ptr<value::Map> out = root.outputs();
+
+    Ensures(out);
+
+    value::Matrix &matrix = out->getMatrix("The_view");
+    EnsuresEqual(matrix.columns(), (std::size_t)2);
+
+    // The model observes 2 * t at each time step t: the mean of [0, 10)
+    // is 9, the mean of [10, 20) is 29.
+    EnsuresApproximatelyEqual(value::toDouble(matrix(1, 0)), 9.0, 1e-10);
+    EnsuresApproximatelyEqual(value::toDouble(matrix(1, 10)), 29.0, 1e-10);
+    Ensures(not matrix(1, 5));
+
+    root.finish();
+}
+
+void test_observation_real_aggregation()
+{
+    auto ctx = vle::utils::make_context();
+    vpz::Vpz vpz;
+
+    vpz.project().experiment().setDuration(100.0);
+    vpz.project().experiment().setBegin(0.0);
+
+    vpz.project().experiment().views().addStreamOutput(
+        "output", "toto", "make_oovplugin_default", "");
+
+    auto &internal = vpz.project().experiment().views().add(
+        vpz::View("internal", vle::vpz::View::Type::INTERNAL, "output"));
+    internal.setAggregation(vpz::View::AGGREGATE_MEAN, 10.0);
+
+    auto &timed = vpz.project().experiment().views().add(
+        vpz::View("timed", vle::vpz::View::Type::TIMED, "output", 1.0));
+    timed.setAggregation(vpz::View::AGGREGATE_MEAN, 10.0);
+
+    vpz::Observable &obs = vpz.project().experiment().views().addObservable(
+        vpz::Observable("obs"));
+    vpz::ObservablePort &port = obs.add("port");
+    port.add("internal");
+    port.add("timed");
+
+    {
+        auto x = vpz.project().dynamics().dynamiclist().emplace(
+            "dyn_1", vpz::Dynamic("dyn_1"));
+        Ensures(x.second == true);
+        x.first->second.setLibrary("make_new_real_observation_model");
+    }
+
+    vpz::CoupledModel *depth0 = new vpz::CoupledModel("depth0", nullptr);
+    auto *atom = depth0->addAtomicModel("ObservationModel");
+    atom->setDynamics("dyn_1");
+    atom->addOutputPort("out");
+    atom->setObservables("obs");
+
+    vpz.project().model().setGraph(std::unique_ptr<vpz::BaseModel>(depth0));
+
+    value_observations = 0;
+
+    devs::RootCoordinator root(ctx);
+    root.load(vpz);
+    vpz.clear();
+    root.init();
+    while (root.run())
+        ;
+    std::unique_ptr<value::Map> out = root.outputs();
+
+    // The views reduce the real observations: the models never build a
+    // value. The results are the ones of the value observations.
+    EnsuresEqual(value_observations, 0);
+    Ensures(out);
+
+    value::Matrix &events = out->getMatrix("internal");
+    EnsuresApproximatelyEqual(value::toDouble(events(1, 0)), 10.0, 1e-10);
+    EnsuresApproximatelyEqual(value::toDouble(events(1, 10)), 29.0, 1e-10);
+
+    value::Matrix &ticks = out->getMatrix("timed");
+    EnsuresApproximatelyEqual(value::toDouble(ticks(1, 0)), 9.0, 1e-10);
+    EnsuresApproximatelyEqual(value::toDouble(ticks(1, 10)), 29.0, 1e-10);
+
+    root.finish();
+}
+
+void test_observation_aggregation_deletion()
+{
+    auto ctx = vle::utils::make_context();
+    vpz::Vpz vpz;
+
+    vpz.project().experiment().setDuration(30.0);
+    vpz.project().experiment().setBegin(0.0);
+
+    vpz.project().experiment().views().addStreamOutput(
+        "output", "toto", "make_oovplugin_default", "");
+
+    auto &timed = vpz.project().experiment().views().add(
+        vpz::View("timed", vle::vpz::View::Type::TIMED, "output", 1.0));
+    timed.setAggregation(vpz::View::AGGREGATE_MEAN, 10.0);
+
+    auto &last = vpz.project().experiment().views().add(
+        vpz::View("last", vle::vpz::View::Type::FINISH, "output"));
+    last.setAggregation(vpz::View::AGGREGATE_MAX, 10.0);
+
+    vpz::Observable &obs = vpz.project().experiment().views().addObservable(
+        vpz::Observable("obs"));
+    vpz::ObservablePort &port = obs.add("port");
+    port.add("timed");
+    port.add("last");
+
+    {
+        auto x = vpz.project().dynamics().dynamiclist().emplace(
+            "dyn_1", vpz::Dynamic("dyn_1"));
+        Ensures(x.second == true);
+        x.first->second.setLibrary("make_new_observation_model");
+    }
+
+    {
+        auto x = vpz.project().dynamics().dynamiclist().emplace(
+            "dyn_2", vpz::Dynamic("dyn_2"));
+        Ensures(x.second == true);
+        x.first->second.setLibrary("exe_make_new_deleter");
+    }
+
+    vpz::CoupledModel *depth0 = new vpz::CoupledModel("depth0", nullptr);
+    auto *atom = depth0->addAtomicModel("ObservationModel");
+    atom->setDynamics("dyn_1");
+    atom->addOutputPort("out");
+    atom->setObservables("obs");
+
+    auto *exe = depth0->addAtomicModel("exe");
+    exe->setDynamics("dyn_2");
+
+    vpz.project().model().setGraph(std::unique_ptr<vpz::BaseModel>(depth0));
+
+    devs::RootCoordinator root(ctx);
+    root.load(vpz);
+    vpz.clear();
+    root.init();
+    while (root.run())
+        ;
+    std::unique_ptr<value::Map> out = root.outputs();
+
+    Ensures(out);
+
+    // The executive deletes the model at 15.5: the partial window [10,
+    // 15.5) of the timed view and the finish observation are kept.
+    value::Matrix &matrix = out->getMatrix("timed");
+    EnsuresEqual(matrix.columns(), (std::size_t)2);
+    EnsuresEqual(matrix.rows(), (std::size_t)11);
+    EnsuresApproximatelyEqual(value::toDouble(matrix(1, 0)), 9.0, 1e-10);
+    EnsuresApproximatelyEqual(value::toDouble(matrix(1, 10)), 25.0, 1e-10);
+
+    value::Matrix &finish = out->getMatrix("last");
+    EnsuresEqual(finish.columns(), (std::size_t)2);
+    EnsuresEqual(finish.rows(), (std::size_t)11);
+    EnsuresApproximatelyEqual(value::toDouble(finish(1, 10)), 31.0, 1e-10);
+
+    root.finish();
+}
+
+void test_population()
+{
+    auto ctx = vle::utils::make_context();
+    vpz::Vpz vpz;
+
+    vpz.project().experiment().setDuration(6.0);
+    vpz.project().experiment().setBegin(0.0);
+
+    {
+        auto x = vpz.project().dynamics().dynamiclist().emplace(
+            "dyn_1", vpz::Dynamic("dyn_1"));
+        Ensures(x.second == true);
+        x.first->second.setLibrary("make_new_population_model");
+    }
+
+    vpz::CoupledModel *depth0 = new vpz::CoupledModel("depth0", nullptr);
+    auto *atom = depth0->addAtomicModel("PopulationModel");
+    atom->setDynamics("dyn_1");
+    atom->addOutputPort("out");
+
+    vpz.project().model().setGraph(std::unique_ptr<vpz::BaseModel>(depth0));
+
+    devs::RootCoordinator root(ctx);
+    root.load(vpz);
+    vpz.clear();
+    root.init();
+    while (root.run())
+        ;
+    root.finish();
+}
+
+void test_static_dynamics()
+{
+    auto ctx = vle::utils::make_context();
+    vpz::Vpz vpz;
+
+    vpz.project().experiment().setDuration(10.0);
+    vpz.project().experiment().setBegin(0.0);
+
+    {
+        auto x = vpz.project().dynamics().dynamiclist().emplace(
+            "dyn_1", vpz::Dynamic("dyn_1"));
+        Ensures(x.second == true);
+        x.first->second.setLibrary("make_new_model");
+    }
+
+    {
+        auto x = vpz.project().dynamics().dynamiclist().emplace(
+            "dyn_2", vpz::Dynamic("dyn_2"));
+        Ensures(x.second == true);
+        x.first->second.setLibrary("make_new_static_model");
+    }
+
+    vpz::CoupledModel *depth0 = new vpz::CoupledModel("depth0", nullptr);
+    auto *atom1 = depth0->addAtomicModel("Model");
+    atom1->setDynamics("dyn_1");
+    atom1->addOutputPort("out");
+
+    auto *atom2 = depth0->addAtomicModel("StaticModel");
+    atom2->setDynamics("dyn_2");
+    atom2->addInputPort("in");
+    atom2->addInputPort("reset");
+    atom2->addInputPort("other");
+
+    depth0->addInternalConnection(atom1, "out", atom2, "in");
+    depth0->addInternalConnection(atom1, "out", atom2, "other");
+
+    vpz.project().model().setGraph(std::unique_ptr<vpz::BaseModel>(depth0));
+
+    devs::RootCoordinator root(ctx);
+    root.load(vpz);
+    vpz.clear();
+    root.init();
+    while (root.run())
+        ;
+    root.finish();
+}
+
+void test_slot_map()
+{
+    devs::SlotMap<int> map;
+
+    auto a = map.insert(std::make_unique<int>(1));
+    auto b = map.insert(std::make_unique<int>(2));
+    auto c = map.insert(std::make_unique<int>(3));
+    EnsuresEqual(map.size(), 3);
+
+    Ensures(map.erase(a));
+    Ensures(not map.erase(a));
+    Ensures(map.get(a) == nullptr);
+    EnsuresEqual(*map.get(b), 2);
+    EnsuresEqual(*map.get(c), 3);
+    EnsuresEqual(map.size(), 2);
+
+    // The slot of a is reused with a new generation.
+    auto d = map.insert(std::make_unique<int>(4));
+    EnsuresEqual(d.index, a.index);
+    Ensures(map.get(a) == nullptr);
+    EnsuresEqual(*map.get(d), 4);
+
+    int sum = 0;
+    for (const auto &elem : map)
+        sum += *elem;
+    EnsuresEqual(sum, 9);
+
+    Ensures(map.erase(c));
+    Ensures(map.erase(b));
+    Ensures(map.erase(d));
+    Ensures(map.empty());
+}
+
 int main()
 {
     vle::Init app;
@@ -763,6 +1348,13 @@ int main()
     test_observation_event();
     test_observation_event_disabled();
     test_observation_timed_disabled();
+    test_observation_aggregation();
+    test_observation_timed_aggregation();
+    test_observation_real_aggregation();
+    test_observation_aggregation_deletion();
+    test_population();
+    test_static_dynamics();
+    test_slot_map();
 
     return unit_test::report_errors();
 }
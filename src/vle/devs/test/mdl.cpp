@@ -32,19 +32,31 @@
 #include <sstream>
 #include <stack>
 #include <stdexcept>
+#include <thread>
 #include <vle/devs/Coordinator.hpp>
 #include <vle/devs/Dynamics.hpp>
 #include <vle/devs/DynamicsDbg.hpp>
 #include <vle/devs/Executive.hpp>
+#include <vle/devs/ModelGraph.hpp>
 #include <vle/devs/RootCoordinator.hpp>
+#include <vle/devs/RunBudget.hpp>
+#include <vle/devs/Simulator.hpp>
+#include <vle/manager/Simulation.hpp>
 #include <vle/oov/Plugin.hpp>
+#include <vle/utils/Exception.hpp>
 #include <vle/utils/Filesystem.hpp>
 #include <vle/utils/unit-test.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Mapped.hpp>
+#include <vle/value/Null.hpp>
 #include <vle/value/Set.hpp>
+#include <vle/value/String.hpp>
 #include <vle/vpz/Classes.hpp>
 #include <vle/vpz/CoupledModel.hpp>
 #include <vle/vpz/Dynamics.hpp>
 #include <vle/vpz/Experiment.hpp>
+#include <vle/vpz/ExperimentInstance.hpp>
 
 using namespace vle;
 
@@ -98,6 +110,11 @@ public:
     {
         output.emplace_back("out");
     }
+
+    virtual std::unique_ptr<value::Value> serialize() const override
+    {
+        return value::Null::create();
+    }
 };
 
 class Branch : public devs::Executive {
@@ -195,11 +212,52 @@ public:
         return {};
     }
 
+    virtual std::unique_ptr<value::Value> serialize() const override
+    {
+        auto ret = std::make_unique<value::Map>();
+        ret->addInt("counter", m_counter);
+        ret->addBoolean("active", m_active);
+        return ret;
+    }
+
+    virtual void deserialize(const value::Value &state) override
+    {
+        m_counter = state.toMap().getInt("counter");
+        m_active = state.toMap().getBoolean("active");
+    }
+
 private:
     long m_counter;
     bool m_active;
 };
 
+class Ticker : public devs::Dynamics {
+public:
+    Ticker(const devs::DynamicsInit &model, const devs::InitEventList &events)
+        : devs::Dynamics(model, events)
+        , m_period(events.getDouble("period"))
+    {
+    }
+
+    virtual devs::Time init(devs::Time /* time */) override
+    {
+        return m_period;
+    }
+
+    virtual devs::Time timeAdvance() const override { return m_period; }
+
+    virtual void output(devs::Time /* time */,
+                        devs::ExternalEventList &output) const override
+    {
+        output.emplace_back("out");
+    }
+
+    virtual devs::Time lookahead() const override { return m_period; }
+
+private:
+    devs::Time m_period;
+};
+
 class DeleteConnection : public devs::Executive {
 public:
     DeleteConnection(const devs::ExecutiveInit &init,
@@ -666,6 +724,7 @@ public:
 DECLARE_DYNAMICS_SYMBOL(dynamics_MyBeep, MyBeep)
 DECLARE_DYNAMICS_SYMBOL(dynamics_counter, Counter)
 DECLARE_DYNAMICS_SYMBOL(dynamics_transform, Transform)
+DECLARE_DYNAMICS_SYMBOL(dynamics_ticker, Ticker)
 DECLARE_DYNAMICS_SYMBOL(dynamics_confluent_transitionA, Confluent_transitionA)
 DECLARE_DYNAMICS_SYMBOL(dynamics_confluent_transitionB, Confluent_transitionB)
 DECLARE_DYNAMICS_SYMBOL(dynamics_confluent_transitionC, Confluent_transitionC)
@@ -877,6 +936,512 @@ void test_confluent_transition_2()
     }
 }
 
+void test_model_graph()
+{
+    /* top: exe, gen, sink, sub and the atomic models a and b into sub. The
+     * executive is an atomic model like the others for the graph. */
+    vpz::CoupledModel top("top", nullptr);
+    auto exe = top.addAtomicModel("exe");
+    exe->setDynamics("executive");
+    exe->addOutputPort("out");
+
+    auto gen = top.addAtomicModel("gen");
+    gen->addInputPort("in");
+    gen->addOutputPort("out");
+    gen->addOutputPort("unused");
+
+    auto sink = top.addAtomicModel("sink");
+    sink->addInputPort("in");
+    sink->addInputPort("other");
+
+    auto sub = top.addCoupledModel("sub");
+    sub->addInputPort("in");
+    sub->addOutputPort("out");
+
+    auto a = sub->addAtomicModel("a");
+    a->addInputPort("in");
+    a->addOutputPort("out");
+
+    auto b = sub->addAtomicModel("b");
+    b->addInputPort("in");
+
+    sub->addInputConnection("in", a, "in");
+    sub->addInputConnection("in", b, "in");
+    sub->addOutputConnection(a, "out", "out");
+    top.addInternalConnection(exe, "out", gen, "in");
+    top.addInternalConnection(gen, "out", sub, "in");
+    top.addInternalConnection(gen, "out", sink, "in");
+    top.addInternalConnection(sub, "out", sink, "other");
+
+    std::vector<std::unique_ptr<devs::Simulator>> owners;
+    std::vector<devs::Simulator *> simulators;
+    for (auto *atom : { exe, gen, sink, a, b }) {
+        owners.emplace_back(new devs::Simulator(atom));
+        owners.back()->setOrder(simulators.size());
+        simulators.emplace_back(owners.back().get());
+    }
+
+    devs::ModelGraph graph;
+    graph.build(simulators);
+    EnsuresEqual(graph.size(), 5);
+
+    using target = std::pair<devs::Simulator *, std::string>;
+
+    for (auto *simulator : simulators) {
+        for (const auto &port :
+             simulator->getStructure()->getOutputPortList()) {
+            std::vector<target> expected;
+            auto x = simulator->targets(port.first);
+            for (auto it = x.first; it != x.second; ++it)
+                expected.emplace_back(it->second.first, it->second.second);
+
+            const devs::ModelGraph::Target *first, *last;
+            Ensures(graph.targets(
+                simulator, graph.port(port.first), &first, &last));
+
+            std::vector<target> found;
+            for (; first != last; ++first)
+                found.emplace_back(first->simulator,
+                                   graph.name(first->port));
+
+            std::sort(expected.begin(), expected.end());
+            std::sort(found.begin(), found.end());
+            Ensures(expected == found);
+        }
+
+        const devs::ModelGraph::Target *first, *last;
+        Ensures(not graph.targets(
+            simulator, graph.port("missing"), &first, &last));
+        Ensures(not graph.targets(simulator, graph.port("in"), &first, &last));
+    }
+
+    EnsuresEqual(graph.port("missing"), devs::ModelGraph::no_port);
+
+    /* The graph does not need the connections of the models. */
+    top.clearConnections();
+    EnsuresEqual(gen->getOutPort("out").size(), 0);
+    EnsuresEqual(sub->getInPort("in").size(), 0);
+    Ensures(sub->existInternalOutputPort("out"));
+    EnsuresEqual(sub->getInternalOutputPortList().at("out").size(), 0);
+
+    const devs::ModelGraph::Target *first, *last;
+    Ensures(graph.targets(
+        gen->get_simulator(), graph.port("out"), &first, &last));
+    EnsuresEqual(last - first, 3);
+    Ensures(graph.targets(
+        gen->get_simulator(), graph.port("unused"), &first, &last));
+    EnsuresEqual(last - first, 0);
+    Ensures(graph.targets(
+        a->get_simulator(), graph.port("out"), &first, &last));
+    EnsuresEqual(last - first, 1);
+    Ensures(first->simulator == sink->get_simulator());
+    EnsuresEqual(graph.name(first->port), "other");
+}
+
+void test_mapped_lazy()
+{
+    auto ctx = vle::utils::make_context();
+    vle::utils::Path p(DEVS_TEST_DIR);
+    vle::utils::Path::current_path(p);
+
+    /* A missing file in a condition used by no model is not an error. */
+    {
+        vpz::Vpz file(DEVS_TEST_DIR "/checkpoint.vpz");
+        vpz::Condition unused("unused");
+        unused.addValueToPort(
+            "data", value::Mapped::create("", "missing-unused.bin"));
+        file.project().experiment().conditions().add(unused);
+
+        devs::RootCoordinator root(ctx);
+        root.load(file);
+        file.clear();
+        root.init();
+        while (root.run())
+            ;
+        root.finish();
+    }
+
+    /* The file is mapped when a model uses the condition. */
+    {
+        vpz::Vpz file(DEVS_TEST_DIR "/checkpoint.vpz");
+        vpz::Condition used("used");
+        used.addValueToPort("data",
+                            value::Mapped::create("", "missing-used.bin"));
+        file.project().experiment().conditions().add(used);
+
+        auto *counter = dynamic_cast<vpz::AtomicModel *>(
+            file.project().model().node()->findModel("counter"));
+        Ensures(counter);
+        if (counter)
+            counter->addCondition("used");
+
+        devs::RootCoordinator root(ctx);
+        EnsuresThrow(root.load(file), vle::utils::FileError);
+    }
+}
+
+void test_checkpoint()
+{
+    auto ctx = vle::utils::make_context();
+    vle::utils::Path p(DEVS_TEST_DIR);
+    vle::utils::Path::current_path(p);
+
+    auto file = std::make_shared<const vpz::Vpz>(DEVS_TEST_DIR
+                                                 "/checkpoint.vpz");
+    vpz::ExperimentInstance instance(file, 0);
+
+    std::unique_ptr<value::Map> reference;
+    {
+        devs::RootCoordinator root(ctx);
+        root.load(instance);
+        root.init();
+        while (root.run())
+            ;
+        reference = root.outputs();
+        root.finish();
+    }
+
+    std::unique_ptr<devs::Checkpoint> checkpoint;
+    {
+        devs::RootCoordinator root(ctx);
+        root.load(instance);
+        root.init();
+        checkpoint = root.checkpoint(10.0);
+    }
+
+    Ensures(checkpoint);
+    EnsuresEqual(checkpoint->time, 10.0);
+    EnsuresEqual(checkpoint->models.size(), 2);
+
+    std::unique_ptr<value::Map> out;
+    {
+        devs::RootCoordinator root(ctx);
+        root.load(instance, *checkpoint);
+        root.init();
+        while (root.run())
+            ;
+        out = root.outputs();
+        root.finish();
+    }
+
+    Ensures(reference);
+    Ensures(out);
+
+    value::Matrix &ref = reference->getMatrix("view1");
+    value::Matrix &res = out->getMatrix("view1");
+
+    /* the test plugin stores the observation at the row of its date: the
+     * rows before the checkpoint are empty. */
+    EnsuresEqual(ref.rows(), (std::size_t)21);
+    EnsuresEqual(res.rows(), (std::size_t)21);
+    Ensures(not res(1, 9));
+
+    for (std::size_t i = 10; i != res.rows(); ++i) {
+        EnsuresEqual(value::toDouble(res(0, i)), value::toDouble(ref(0, i)));
+        EnsuresEqual(value::toDouble(res(1, i)), value::toDouble(ref(1, i)));
+    }
+}
+
+void test_inject()
+{
+    auto ctx = vle::utils::make_context();
+    vle::utils::Path p(DEVS_TEST_DIR);
+    vle::utils::Path::current_path(p);
+
+    auto file = std::make_shared<const vpz::Vpz>(DEVS_TEST_DIR
+                                                 "/checkpoint.vpz");
+    vpz::ExperimentInstance instance(file, 0);
+
+    devs::RootCoordinator root(ctx);
+    root.load(instance);
+    root.init();
+    root.advance(10.5);
+
+    EnsuresThrow(root.inject("top,unknown", "in", value::Null::create()),
+                 utils::ArgError);
+    EnsuresThrow(root.inject("top,counter", "unknown", value::Null::create()),
+                 utils::ArgError);
+
+    root.inject("top,counter", "in", value::Null::create());
+    root.inject("top,counter", "in", value::Null::create());
+
+    while (root.run())
+        ;
+
+    auto out = root.outputs();
+    root.finish();
+
+    Ensures(out);
+    value::Matrix &res = out->getMatrix("view1");
+
+    /* the beep sends 21 events in [0, 20] */
+    EnsuresEqual(value::toDouble(res(1, 10)), 11);
+    EnsuresEqual(value::toDouble(res(1, 11)), 14);
+    EnsuresEqual(value::toDouble(res(1, 20)), 23);
+}
+
+void test_branch()
+{
+    auto ctx = vle::utils::make_context();
+    vle::utils::Path p(DEVS_TEST_DIR);
+    vle::utils::Path::current_path(p);
+
+    auto file = std::make_shared<const vpz::Vpz>(DEVS_TEST_DIR
+                                                 "/checkpoint.vpz");
+    vpz::ExperimentInstance instance(file, 0);
+
+    std::vector<manager::Branch> branches(3);
+    branches[1].push_back({ "top,counter", "in", value::Null::create() });
+    branches[2].push_back({ "top,counter", "in", value::Null::create() });
+    branches[2].push_back({ "top,counter", "in", value::Null::create() });
+
+    manager::Simulation sim(ctx,
+                            manager::LOG_NONE,
+                            manager::SIMULATION_NONE,
+                            std::chrono::milliseconds(0),
+                            nullptr);
+    manager::Error error;
+
+    auto results = sim.branch(instance, 10.5, branches, &error);
+
+#ifdef __linux__
+    EnsuresEqual(error.code, 0);
+    EnsuresEqual(results.size(), 3);
+
+    for (std::size_t i = 0; i != results.size(); ++i) {
+        Ensures(results[i]);
+        if (not results[i])
+            continue;
+
+        value::Matrix &res = results[i]->getMatrix("view1");
+        EnsuresEqual(value::toDouble(res(1, 10)), 11);
+        EnsuresEqual(value::toDouble(res(1, 20)), 21 + i);
+    }
+
+    branches[1].front().port = "unknown";
+    results = sim.branch(instance, 10.5, branches, &error);
+
+    EnsuresEqual(error.code, -1);
+    Ensures(results[0]);
+    Ensures(not results[1]);
+    Ensures(results[2]);
+
+    /* The children of a context with an asynchronous log do not use the
+     * background thread of the parent. */
+    ctx->set_log_asynchronous(64);
+    branches[1].front().port = "in";
+    results = sim.branch(instance, 10.5, branches, &error);
+    EnsuresEqual(error.code, 0);
+    EnsuresEqual(results.size(), 3);
+    ctx->flush_log();
+#else
+    EnsuresEqual(error.code, -1);
+#endif
+}
+
+void test_run_budget()
+{
+    auto ctx = vle::utils::make_context();
+    vle::utils::Path p(DEVS_TEST_DIR);
+    vle::utils::Path::current_path(p);
+
+    auto file = std::make_shared<const vpz::Vpz>(DEVS_TEST_DIR
+                                                 "/checkpoint.vpz");
+    vpz::ExperimentInstance instance(file, 0);
+
+    {
+        devs::RunBudget budget;
+        budget.bags = 5;
+
+        devs::RootCoordinator root(ctx);
+        root.load(instance);
+        root.init();
+        root.setBudget(budget);
+
+        int bags = 0;
+        while (root.run())
+            ++bags;
+
+        EnsuresEqual(bags, 5);
+        Ensures(root.interrupted() == devs::Interruption::bags);
+        Ensures(root.getCurrentTime() < 20.0);
+
+        auto out = root.outputs();
+        root.finish();
+        Ensures(out);
+    }
+
+    {
+        devs::RunBudget budget;
+        budget.token.cancel();
+
+        devs::RootCoordinator root(ctx);
+        root.load(instance);
+        root.init();
+        root.setBudget(budget);
+
+        Ensures(not root.run());
+        Ensures(root.interrupted() == devs::Interruption::cancelled);
+        root.finish();
+    }
+
+    {
+        devs::RunBudget budget;
+        budget.wallclock = std::chrono::milliseconds(1);
+
+        devs::RootCoordinator root(ctx);
+        root.load(instance);
+        root.init();
+        root.setBudget(budget);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        Ensures(not root.run());
+        Ensures(root.interrupted() == devs::Interruption::wallclock);
+        root.finish();
+    }
+
+    {
+        devs::RunBudget budget;
+        budget.bags = 5;
+
+        manager::Simulation sim(ctx,
+                                manager::LOG_NONE,
+                                manager::SIMULATION_NONE,
+                                std::chrono::milliseconds(0),
+                                nullptr);
+        sim.setBudget(budget);
+
+        manager::Error error;
+        auto result = sim.run(instance, &error);
+        EnsuresEqual(error.code, manager::ERROR_CANCELLED);
+        Ensures(result);
+    }
+}
+
+std::string run_vpz(vle::utils::ContextPtr ctx, const std::string &filename)
+{
+    vpz::Vpz file(filename);
+    devs::RootCoordinator root(ctx);
+
+    root.load(file);
+    file.clear();
+    root.init();
+
+    while (root.run())
+        ;
+
+    auto out = root.outputs();
+    root.finish();
+
+    return out ? out->writeToString() : std::string();
+}
+
+void test_parallel_init()
+{
+    auto ctx = vle::utils::make_context();
+    vle::utils::Path p(DEVS_TEST_DIR);
+    vle::utils::Path::current_path(p);
+
+    auto sequential_gens = run_vpz(ctx, DEVS_TEST_DIR "/gens.vpz");
+    auto sequential_checkpoint = run_vpz(ctx, DEVS_TEST_DIR "/checkpoint.vpz");
+
+    ctx->set_setting("vle.simulation.thread", 2l);
+    ctx->set_setting("vle.simulation.parallel-init", true);
+
+    auto parallel_gens = run_vpz(ctx, DEVS_TEST_DIR "/gens.vpz");
+    auto parallel_checkpoint = run_vpz(ctx, DEVS_TEST_DIR "/checkpoint.vpz");
+
+    Ensures(not sequential_gens.empty());
+    Ensures(not sequential_checkpoint.empty());
+    EnsuresEqual(sequential_gens, parallel_gens);
+    EnsuresEqual(sequential_checkpoint, parallel_checkpoint);
+}
+
+void test_partition()
+{
+    auto ctx = vle::utils::make_context();
+    vle::utils::Path p(DEVS_TEST_DIR);
+    vle::utils::Path::current_path(p);
+
+    auto sequential = run_vpz(ctx, DEVS_TEST_DIR "/partition.vpz");
+
+    ctx->set_setting("vle.simulation.thread", 2l);
+    ctx->set_setting("vle.simulation.partition", true);
+
+    auto partitioned = run_vpz(ctx, DEVS_TEST_DIR "/partition.vpz");
+
+    Ensures(not sequential.empty());
+    EnsuresEqual(sequential, partitioned);
+
+    {
+        vpz::Vpz file(DEVS_TEST_DIR "/partition.vpz");
+        devs::RootCoordinator root(ctx);
+
+        root.load(file);
+        file.clear();
+        root.init();
+
+        EnsuresThrow(root.checkpoint(10.0), vle::utils::InternalError);
+        root.finish();
+    }
+}
+
+std::size_t run_resolution(vle::utils::ContextPtr ctx,
+                           double resolution,
+                           std::size_t *merged)
+{
+    vpz::Vpz file(DEVS_TEST_DIR "/partition.vpz");
+    auto &cnds = file.project().experiment().conditions();
+    cnds.get("fast").setValueToPort("period", value::Double::create(0.1));
+    cnds.get("medium").setValueToPort("period", value::Double::create(0.3));
+    file.project().experiment().setResolution(resolution);
+
+    devs::RootCoordinator root(ctx);
+    root.load(file);
+    file.clear();
+    root.init();
+
+    std::size_t bags = 0;
+    while (root.run())
+        ++bags;
+
+    *merged = root.mergedBags();
+    root.finish();
+
+    return bags;
+}
+
+void test_resolution()
+{
+    auto ctx = vle::utils::make_context();
+    vle::utils::Path p(DEVS_TEST_DIR);
+    vle::utils::Path::current_path(p);
+
+    std::size_t merged = 0;
+    auto bags = run_resolution(ctx, 0.0, &merged);
+    EnsuresEqual(merged, 0);
+
+    auto quantized_bags = run_resolution(ctx, 0.1, &merged);
+    Ensures(merged > 0);
+    Ensures(quantized_bags < bags);
+
+    {
+        vpz::Vpz file(DEVS_TEST_DIR "/partition.vpz");
+        EnsuresEqual(file.project().experiment().resolution(), 0.0);
+        EnsuresThrow(file.project().experiment().setResolution(-1.0),
+                     vle::utils::ArgError);
+
+        auto &engine = file.project().experiment().conditions().get(
+            vpz::Experiment::defaultSimulationEngineCondName());
+        engine.setValueToPort("time-resolution", value::Integer::create(2));
+        EnsuresEqual(file.project().experiment().resolution(), 2.0);
+
+        engine.setValueToPort("time-resolution", value::String::create("1"));
+        EnsuresThrow(file.project().experiment().resolution(),
+                     vle::utils::ArgError);
+    }
+}
+
 int main()
 {
     vle::Init app;
@@ -887,6 +1452,15 @@ int main()
     test_gensvpz();
     test_gens_delete_connection();
     test_gens_ordereddeleter();
+    test_model_graph();
+    test_mapped_lazy();
+    test_checkpoint();
+    test_inject();
+    test_branch();
+    test_run_budget();
+    test_parallel_init();
+    test_partition();
+    test_resolution();
 
     return unit_test::report_errors();
 }
@@ -30,6 +30,7 @@
 #include <cassert>
 #include <cmath>
 #include <memory>
+#include <vector>
 #include <vle/oov/Plugin.hpp>
 #include <vle/value/Double.hpp>
 
@@ -60,6 +61,7 @@ class OutputPlugin : public vle::oov::Plugin {
         std::vector<std::pair<double, std::unique_ptr<vle::value::Value>>>>;
 
     data_type ppD;
+    std::vector<data_type::mapped_type *> ppColumns;
 
 public:
     OutputPlugin(const std::string &location)
@@ -103,6 +105,15 @@ public:
         return matrix;
     }
 
+    virtual std::unique_ptr<vle::value::Matrix>
+    finish(const double & /*time*/) override
+    {
+        if (ppD.empty())
+            return {};
+
+        return matrix();
+    }
+
     virtual std::string name() const override { return "OutputPlugin"; }
 
     virtual bool isCairo() const override { return false; }
@@ -133,6 +144,7 @@ public:
         assert(ppD.find(id) == ppD.cend());
 
         ppD[id].reserve(100);
+        ppColumns.emplace_back(&ppD[id]);
     }
 
     virtual void onDelObservable(const std::string &simulator,
@@ -166,6 +178,19 @@ public:
 
         ppD[id].emplace_back(time, std::move(value));
     }
+
+    virtual void onValues(const std::string & /*view*/,
+                          const double &time,
+                          vle::oov::ColumnValue *values,
+                          std::size_t size) override
+    {
+        for (std::size_t i = 0; i != size; ++i) {
+            assert(values[i].column->id < ppColumns.size());
+
+            ppColumns[values[i].column->id]->emplace_back(
+                time, std::move(values[i].value));
+        }
+    }
 };
 
 } // namespace vletest
@@ -181,6 +181,27 @@ void prefix_and_postfix_operator()
     EnsuresEqual(a, 0.0);
 }
 
+void quantize()
+{
+    EnsuresEqual(devs::quantize(0.25, 0.0), 0.25);
+    EnsuresEqual(devs::quantize(0.3, 0.1), 0.3);
+    EnsuresEqual(devs::quantize(0.1 + 0.2, 0.1), 0.3);
+
+    /* A date is rounded up: an event never occurs before its date. */
+    EnsuresEqual(devs::quantize(0.21, 0.1), 0.3);
+    EnsuresEqual(devs::quantize(0.25, 0.1), 0.3);
+    EnsuresEqual(devs::quantize(-0.25, 0.1), -0.2);
+
+    devs::Time sum = 0.0;
+    for (int i = 0; i != 30; ++i)
+        sum += 0.1;
+    EnsuresEqual(devs::quantize(sum, 0.1), 3.0);
+
+    EnsuresEqual(devs::quantize(devs::infinity, 0.1), devs::infinity);
+    EnsuresEqual(devs::quantize(devs::negativeInfinity, 0.1),
+                 devs::negativeInfinity);
+}
+
 int main()
 {
     vle::Init app;
@@ -189,6 +210,7 @@ int main()
     modify();
     modify_and_infinity();
     prefix_and_postfix_operator();
+    quantize();
 
     return unit_test::report_errors();
 }
@@ -42,6 +42,7 @@
 #include <vle/value/Double.hpp>
 #include <vle/value/Integer.hpp>
 #include <vle/value/Map.hpp>
+#include <vle/value/Mapped.hpp>
 #include <vle/value/Matrix.hpp>
 #include <vle/value/Null.hpp>
 #include <vle/value/Set.hpp>
@@ -576,6 +577,12 @@ VleValueWidget::getValueDisplay(const vle::value::Value& v,
         type = "user";
         toStd = "nil";
         break;
+    } case vle::value::Value::MAPPED: {
+        type = QString("mapped %1")
+                .arg(vle::value::Mapped::elementName(
+                        v.toMapped().elementType()));
+        toStd = v.writeToString().c_str();
+        break;
     }}
 
     switch (displayType) {
@@ -33,6 +33,7 @@
 #include <vle/value/Map.hpp>
 #include <vle/value/Matrix.hpp>
 #include <vle/value/Table.hpp>
+#include <vle/value/Mapped.hpp>
 #include "dom_tools.hpp"
 #include "vle_dom.hpp"
 
@@ -290,6 +291,9 @@ vleDomStatic::buildEmptyValueFromDoc(QDomDocument& domDoc,
     } case vle::value::Value::MATRIX: {
         elem = domDoc.createElement("matrix");
         break;
+    } case vle::value::Value::MAPPED: {
+        elem = domDoc.createElement("mapped");
+        break;
     } default: {
         qDebug() << "Internal error in buildEmptyValueFromDoc ";
         break;
@@ -378,6 +382,20 @@ vleDomStatic::buildValue(const QDomNode& node, bool buildText)
         res->toTable().fill(qv.toStdString());
         return res;
     }
+    if (node.nodeName() == "mapped") {
+        QString type = DomFunctions::attributeValue(node, "type");
+        if (type.isEmpty()) {
+            type = "double";
+        }
+        int columns = QVariant(
+                DomFunctions::attributeValue(node, "columns")).toInt();
+
+        return vle::value::Mapped::create(
+                DomFunctions::attributeValue(node, "package").toStdString(),
+                DomFunctions::attributeValue(node, "file").toStdString(),
+                vle::value::Mapped::elementType(type.toStdString()),
+                columns);
+    }
     if (node.nodeName() == "#text") {
         if (buildText) {
             return value::String::create(node.nodeValue().toStdString());
@@ -613,6 +631,22 @@ vleDomStatic::fillWithValue(QDomDocument& domDoc, QDomNode node,
             }
         }
         break;
+    } case vle::value::Value::MAPPED: {
+        if (node.nodeName() != "mapped") {
+            return false;
+        }
+        const vle::value::Mapped& mapped = val.toMapped();
+        DomFunctions::setAttributeValue(node, "package",
+                mapped.package().c_str());
+        DomFunctions::setAttributeValue(node, "file",
+                mapped.file().c_str());
+        DomFunctions::setAttributeValue(node, "type",
+                vle::value::Mapped::elementName(mapped.elementType()));
+        if (mapped.columns() > 0) {
+            DomFunctions::setAttributeValue(node, "columns",
+                    QVariant((int) mapped.columns()).toString());
+        }
+        break;
     } default: {
         qDebug() << "Internal error in fillWithValue (nnn)";
         return false;
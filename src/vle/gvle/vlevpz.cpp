@@ -1690,6 +1690,9 @@ vleVpz::addValuePortCondToDoc(const QString& condName, const QString& portName,
     case vle::value::Value::USER:
         tagName = "user";
         break;
+    case vle::value::Value::MAPPED:
+        tagName = "mapped";
+        break;
     }
     QDomNode child = getDomDoc().createElement(tagName);
     fillWithValue(child, val);
@@ -3287,14 +3290,14 @@ vleVpz::getOutputPlugin(QDomNode node)
 }
 
 //enum type { BOOLEAN, INTEGER, DOUBLE, STRING, SET, MAP, TUPLE, TABLE,
-//    XMLTYPE, NIL, MATRIX, USER };
+//    XMLTYPE, NIL, MATRIX, USER, MAPPED };
 
 vle::value::Value::type
 vleVpz::valueType(const QString& condName,
         const QString& portName, int index) const
 {
     //    BOOLEAN, INTEGER, DOUBLE, STRING, SET, MAP, TUPLE, TABLE,
-    //                XMLTYPE, NIL, MATRIX, USER
+    //                XMLTYPE, NIL, MATRIX, USER, MAPPED
     QDomNode port = portFromDoc(condName, portName);
     QDomNode valNode = port.childNodes().at(index);
     if (valNode.nodeName() == "boolean") {
@@ -3319,6 +3322,8 @@ vleVpz::valueType(const QString& condName,
         return vle::value::Value::NIL;
     } else if(valNode.nodeName() == "matrix") {
         return vle::value::Value::MATRIX;
+    } else if(valNode.nodeName() == "mapped") {
+        return vle::value::Value::MAPPED;
     }
     return vle::value::Value::USER;
 }
@@ -25,6 +25,7 @@
  */
 
 #include <vle/manager/ExperimentGenerator.hpp>
+#include <vle/manager/Plan.hpp>
 #include <vle/utils/Exception.hpp>
 #include <vle/utils/i18n.hpp>
 #include <vle/value/Boolean.hpp>
@@ -53,49 +54,9 @@ class ExperimentGenerator::Pimpl {
     Pimpl(const Pimpl &other);
     Pimpl &operator=(const Pimpl &other);
 
-    int computeMaximumValue()
-    {
-        int result = 0;
-
-        const vpz::Conditions &cnds(mVpz.project().experiment().conditions());
-
-        auto it = cnds.conditionlist().begin();
-        while (it != cnds.conditionlist().end()) {
-            const vpz::Condition &cnd(it->second);
-            vpz::ConditionValues::const_iterator jt;
-
-            if (not cnd.conditionvalues().empty()) {
-                for (jt = cnd.conditionvalues().begin();
-                     jt != cnd.conditionvalues().end();
-                     ++jt) {
-
-                    int conditionsize = jt->second.size();
-
-                    if (result == 0 or result == 1) {
-                        result = conditionsize;
-                    }
-                    else {
-                        if (conditionsize != 0 and conditionsize != 1 and
-                            result != conditionsize) {
-                            throw utils::InternalError(
-                                (fmt(_("ExperimentGenerator: bad combination "
-                                       "size for the condition `%1%' port "
-                                       "`%2%': %3%")) %
-                                 it->first % jt->first % conditionsize)
-                                    .str());
-                        }
-                    }
-                }
-                ++it;
-            }
-        }
-
-        return result;
-    }
-
     void computeRange()
     {
-        mCompleteSize = computeMaximumValue();
+        mCompleteSize = mPlan->size();
 
         uint32_t number = mCompleteSize / mWorld;
         uint32_t modulo = mCompleteSize % mWorld;
@@ -108,7 +69,8 @@ class ExperimentGenerator::Pimpl {
     }
 
 public:
-    vpz::Vpz mVpz;
+    std::shared_ptr<const vpz::Vpz> mVpz;
+    std::unique_ptr<Plan> mPlan;
     uint32_t mRank;
     uint32_t mWorld;
     uint32_t mCompleteSize;
@@ -116,7 +78,8 @@ public:
     uint32_t mMax;
 
     Pimpl(const std::string &filename, uint32_t rank, uint32_t size)
-        : mVpz(filename)
+        : mVpz(std::make_shared<const vpz::Vpz>(filename))
+        , mPlan(Plan::create(*mVpz))
         , mRank(rank)
         , mWorld(size)
         , mCompleteSize(0)
@@ -130,8 +93,12 @@ public:
         computeRange();
     }
 
-    Pimpl(const vpz::Vpz &vpz, uint32_t rank, uint32_t size)
-        : mVpz(vpz)
+    Pimpl(std::shared_ptr<const vpz::Vpz> vpz,
+          std::unique_ptr<Plan> plan,
+          uint32_t rank,
+          uint32_t size)
+        : mVpz(std::move(vpz))
+        , mPlan(plan ? std::move(plan) : Plan::create(*mVpz))
         , mRank(rank)
         , mWorld(size)
         , mCompleteSize(0)
@@ -147,42 +114,31 @@ public:
 
     void get(uint32_t index, vpz::Conditions *conditions)
     {
-        const vpz::Conditions &cnds(mVpz.project().experiment().conditions());
+        auto cnds = instance(index).conditions();
         conditions->deleteValueSet();
         vpz::ConditionList &cdldst(conditions->conditionlist());
 
-        vpz::ConditionList::const_iterator it;
-        for (it = cnds.begin(); it != cnds.end(); ++it) {
-
-            std::pair<vpz::ConditionList::iterator, bool> r = cdldst.insert(
-                std::make_pair(it->first, vpz::Condition(it->first)));
+        for (auto &elem : cnds.conditionlist()) {
+            auto r = cdldst.insert(
+                std::make_pair(elem.first, vpz::Condition(elem.first)));
 
-            const vpz::ConditionValues &cnvsrc = it->second.conditionvalues();
             vpz::ConditionValues &cnvdst = r.first->second.conditionvalues();
-
-            for (const auto &elem : cnvsrc) {
-                std::vector<std::shared_ptr<value::Value>> cpy;
-
-                if (elem.second.size() == 1) {
-                    cpy.emplace_back(elem.second[0]);
-                }
-                else if (elem.second.size() > 1 and
-                         elem.second.size() > index) {
-                    cpy.emplace_back(elem.second[index]);
-                }
-                else {
-                    throw utils::InternalError(
-                        (fmt(_(
-                             "ExperimentGenerator can not access to the index"
-                             " `%1%' of the condition `%2%' port `%3%' ")) %
-                         index % it->first % elem.first)
-                            .str());
-                }
-
-                cnvdst[elem.first] = std::move(cpy);
-            }
+            for (auto &port : elem.second.conditionvalues())
+                cnvdst[port.first] = std::move(port.second);
         }
     }
+
+    vpz::ExperimentInstance instance(uint32_t index) const
+    {
+        vpz::ExperimentInstance ret(mVpz, index);
+
+        ret.setName(
+            (fmt("%1%-%2%") % mVpz->project().experiment().name() % index)
+                .str());
+        mPlan->assign(index, ret);
+
+        return ret;
+    }
 };
 
 //
@@ -199,7 +155,25 @@ ExperimentGenerator::ExperimentGenerator(const std::string &vpz,
 ExperimentGenerator::ExperimentGenerator(const vpz::Vpz &vpz,
                                          uint32_t rank,
                                          uint32_t size)
-    : mPimpl(new ExperimentGenerator::Pimpl(vpz, rank, size))
+    : mPimpl(new ExperimentGenerator::Pimpl(
+          std::make_shared<const vpz::Vpz>(vpz), nullptr, rank, size))
+{
+}
+
+ExperimentGenerator::ExperimentGenerator(std::shared_ptr<const vpz::Vpz> vpz,
+                                         uint32_t rank,
+                                         uint32_t size)
+    : mPimpl(new ExperimentGenerator::Pimpl(
+          std::move(vpz), nullptr, rank, size))
+{
+}
+
+ExperimentGenerator::ExperimentGenerator(std::shared_ptr<const vpz::Vpz> vpz,
+                                         std::unique_ptr<Plan> plan,
+                                         uint32_t rank,
+                                         uint32_t size)
+    : mPimpl(new ExperimentGenerator::Pimpl(
+          std::move(vpz), std::move(plan), rank, size))
 {
 }
 
@@ -213,6 +187,11 @@ void ExperimentGenerator::get(uint32_t index, vpz::Conditions *conditions)
     mPimpl->get(index, conditions);
 }
 
+vpz::ExperimentInstance ExperimentGenerator::instance(uint32_t index) const
+{
+    return mPimpl->instance(index);
+}
+
 uint32_t ExperimentGenerator::min() const
 {
     return mPimpl->mMin;
@@ -30,8 +30,10 @@
 
 #include <vle/DllDefines.hpp>
 
+#include <vle/manager/Plan.hpp>
 #include <vle/vpz/Vpz.hpp>
 #include <vle/vpz/Conditions.hpp>
+#include <vle/vpz/ExperimentInstance.hpp>
 #include <string>
 
 namespace vle { namespace manager {
@@ -58,6 +60,10 @@ namespace vle { namespace manager {
  * }
  * @endcode
  *
+ * The combinations are decoded on the fly by a @e manager::Plan (see the
+ * @e combination attribute of the experiment), only the range of indices
+ * [@e min(), @e max()[ of the worker @e rank is used.
+ *
  * The class ExperimentGenerator is no copyable and nonassignable and uses the
  * Pimpl idiom.
  */
@@ -84,6 +90,32 @@ public:
      */
     ExperimentGenerator(const vpz::Vpz& vpz, uint32_t rank, uint32_t size);
 
+    /**
+     * Prepare the ExperimentGenerator to build @e vpz::ExperimentInstance.
+     *
+     * @param vpz A shared VPZ file (not cloned, never modified).
+     * @param rank The id of the worker.
+     * @param size The number of workers for this experimental frame.
+     */
+    ExperimentGenerator(std::shared_ptr<const vpz::Vpz> vpz,
+                        uint32_t rank,
+                        uint32_t size);
+
+    /**
+     * Prepare the ExperimentGenerator to build @e vpz::ExperimentInstance
+     * with a user defined plan.
+     *
+     * @param vpz A shared VPZ file (not cloned, never modified).
+     * @param plan The plan to decode the combinations (if null, the plan
+     * of the experiment is used).
+     * @param rank The id of the worker.
+     * @param size The number of workers for this experimental frame.
+     */
+    ExperimentGenerator(std::shared_ptr<const vpz::Vpz> vpz,
+                        std::unique_ptr<Plan> plan,
+                        uint32_t rank,
+                        uint32_t size);
+
     ~ExperimentGenerator();
 
     /**
@@ -97,6 +129,17 @@ public:
      */
     void get(uint32_t index, vpz::Conditions *conditions);
 
+    /**
+     * Get the combination of the specified index. The returned instance
+     * shares the VPZ of the ExperimentGenerator and stores only the
+     * condition values of the index. The experiment name is suffixed with
+     * the index.
+     *
+     * @param[in] index The index in the experiment generator table.
+     * @return The combination @e index.
+     */
+    vpz::ExperimentInstance instance(uint32_t index) const;
+
     /**
      * The minimal index of experiences produce by the object.
      *
@@ -26,13 +26,18 @@
 
 #include <vle/manager/Manager.hpp>
 #include <vle/manager/ExperimentGenerator.hpp>
+#include <vle/manager/Reducer.hpp>
 #include <vle/manager/Simulation.hpp>
+#include <vle/manager/WorkerPool.hpp>
 #include <vle/utils/Tools.hpp>
 #include <vle/utils/Exception.hpp>
 #include <vle/utils/i18n.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
 #include <vle/value/Matrix.hpp>
 #include <vle/vpz/Vpz.hpp>
 #include <vle/vpz/BaseModel.hpp>
+#include <mutex>
 #include <sstream>
 #include <thread>
 
@@ -81,26 +86,142 @@ struct vle_log_manager_thread : vle::utils::Context::LogFunctor
 };
 
 /**
- * Assign an new name to the experiment.
+ * Get the duration of the spin-up period (the @e spinup port of the
+ * simulation engine condition): the common prefix of all the combinations
+ * simulated once and restored for each combination.
  *
- * This function assign a new name to the experiment file.
- *
- * @param destination The experiment where change the name.
- * @param name The base name of the experiment.
- * @param number The combination number.
+ * @return 0 if the port does not exist.
+ * @throw utils::ArgError if the port is not an integer or a real.
+ */
+static double spinupDuration(const vpz::ExperimentInstance& instance)
+{
+    const auto& name = vpz::Experiment::defaultSimulationEngineCondName();
+    const auto& cnds = instance.base().project().experiment().conditions();
+
+    if (not cnds.exist(name))
+        return 0.0;
+
+    const auto& values = cnds.get(name).conditionvalues();
+    auto it = values.find("spinup");
+    if (it == values.end() or it->second.empty())
+        return 0.0;
+
+    auto value = instance.value(name, "spinup");
+    if (value and value->isInteger())
+        return static_cast<double>(value->toInteger().value());
+
+    if (value and value->isDouble())
+        return value->toDouble().value();
+
+    throw utils::ArgError(_("Manager: the spin-up must be a number"));
+}
+
+/**
+ * Run the simulation of the combination @e index, from the checkpoint if
+ * it exists, with the budget if it exists.
+ */
+static std::unique_ptr<value::Map>
+runCombination(Simulation&                sim,
+               const ExperimentGenerator& expgen,
+               uint32_t                   index,
+               const devs::Checkpoint    *checkpoint,
+               const devs::RunBudget     *budget,
+               Error                     *error)
+{
+    auto instance = expgen.instance(index);
+
+    if (budget)
+        sim.setBudget(*budget);
+
+    if (checkpoint)
+        return sim.run(instance, *checkpoint, error);
+
+    return sim.run(instance, error);
+}
+
+/**
+ * Reduce the result of the combination @e index or store its error if it
+ * is the first. The partial results of the cancelled simulations are
+ * reduced too.
+ */
+static void
+reduceCombination(Reducer&                    reducer,
+                  uint32_t                    index,
+                  std::unique_ptr<value::Map> result,
+                  const Error&                err,
+                  Error                      *error)
+{
+    if (err.code and not error->code) {
+        error->code = err.code;
+        error->message = err.message;
+    }
+
+    if (not err.code or (err.code == ERROR_CANCELLED and result))
+        reducer.reduce(index, std::move(result));
+}
+
+/**
+ * Store the cancellation of the experimental frame if there is no error.
  */
-static void setExperimentName(const std::unique_ptr<vpz::Vpz>& destination,
-                              const std::string&  name,
-                              uint32_t            number)
+static bool
+isCancelled(const devs::RunBudget *budget, Error *error)
 {
-    std::string result(name.size() + 12, '-');
+    if (not budget or not budget->token.cancelled())
+        return false;
 
-    result.replace(0, name.size(), name);
-    result.replace(name.size() + 1, std::string::npos,
-                   utils::to < uint32_t >(number));
+    if (not error->code) {
+        error->code = ERROR_CANCELLED;
+        error->message = _("Manager: the experimental frame is cancelled");
+    }
 
-    destination->project().setInstance(number);
-    destination->project().experiment().setName(result);
+    return true;
+}
+
+/**
+ * The @c MatrixReducer stores all the simulation results into a @c
+ * value::Matrix. It is the @c manager::Reducer used by the @c
+ * Manager::run function without reducer.
+ */
+class MatrixReducer : public Reducer
+{
+public:
+    MatrixReducer(uint32_t size)
+        : mResult(new value::Matrix(size, 1, size, 1))
+    {
+    }
+
+    void reduce(uint32_t index, std::unique_ptr<value::Map> result) override
+    {
+        mResult->add(index, 0, std::move(result));
+    }
+
+    std::unique_ptr<value::Map> finish() override
+    {
+        return {};
+    }
+
+    std::unique_ptr<value::Matrix> mResult;
+};
+
+static void checkRunParameters(uint32_t thread, uint32_t rank, uint32_t world)
+{
+    if (thread <= 0) {
+        throw vle::utils::ArgError(
+            (fmt(_("Manager error: thread must be superior to 0 (%1%)"))
+             % thread).str());
+    }
+
+    if (world <= rank) {
+        throw vle::utils::ArgError(
+            (fmt(_("Manager error: rank (%1%) must be inferior"
+                   " to world (%2%)"))  % rank % world).str());
+    }
+
+    if (world <= 0) {
+        throw vle::utils::ArgError(
+            (fmt(_("Manager error: world (%1%) must be superior to 0."))
+             % world).str());
+    }
 }
 
 class Manager::Pimpl
@@ -117,7 +238,8 @@ public:
         , mLogOption(logoptions)
         , mSimulationOption(simulationoptions)
     {
-        if (timeout != std::chrono::milliseconds::zero())
+        if (timeout != std::chrono::milliseconds::zero() and
+            not (simulationoptions & SIMULATION_IN_PROCESS_TIMEOUT))
             mSimulationOption |= vle::manager::SIMULATION_SPAWN_PROCESS;
     }
 
@@ -143,36 +265,45 @@ public:
     struct worker
     {
         utils::ContextPtr                 context;
-        const std::unique_ptr<vpz::Vpz>&  vpz;
         std::chrono::milliseconds         mTimeout;
         ExperimentGenerator              &expgen;
+        const devs::Checkpoint           *checkpoint;
         LogOptions                        mLogOption;
         SimulationOptions                 mSimulationOption;
         uint32_t                          index;
         uint32_t                          threads;
-        value::Matrix                    *result;
+        Reducer                          &reducer;
+        std::mutex                       &mutex;
         Error                            *error;
+        WorkerPool                       *pool;
+        const devs::RunBudget            *budget;
 
         worker(utils::ContextPtr                 context,
-               const std::unique_ptr<vpz::Vpz>&  vpz,
                std::chrono::milliseconds         timeout,
                ExperimentGenerator&              expgen,
+               const devs::Checkpoint           *checkpoint,
                LogOptions                        logoptions,
                SimulationOptions                 simulationoptions,
                uint32_t                          index,
                uint32_t                          threads,
-               value::Matrix                    *result,
-               Error                            *error)
+               Reducer                          &reducer,
+               std::mutex                       &mutex,
+               Error                            *error,
+               WorkerPool                       *pool,
+               const devs::RunBudget            *budget)
           : context(context)
-          , vpz(vpz)
           , mTimeout(timeout)
           , expgen(expgen)
+          , checkpoint(checkpoint)
           , mLogOption(logoptions)
           , mSimulationOption(simulationoptions)
           , index(index)
           , threads(threads)
-          , result(result)
+          , reducer(reducer)
+          , mutex(mutex)
           , error(error)
+          , pool(pool)
+          , budget(budget)
         {
         }
 
@@ -182,123 +313,180 @@ public:
 
         void operator()()
         {
-            std::string vpzname(vpz->project().experiment().name());
-
             for (uint32_t i = expgen.min() + index; i < expgen.max();
                  i += threads) {
-                Simulation sim(context, mLogOption, mSimulationOption, mTimeout,
-                               nullptr);
-                Error err;
-
-                auto file =
-                    std::unique_ptr<vpz::Vpz>(
-                        new vpz::Vpz(*vpz));
-                setExperimentName(file, vpzname, i);
-                expgen.get(i, &file->project().experiment().conditions());
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (isCancelled(budget, error))
+                        break;
+                }
 
-                auto simresult = sim.run(std::move(file), &err);
+                Error err;
+                std::unique_ptr<value::Map> simresult;
 
-                if (err.code) {
-                    if (not error->code) {
-                        error->code = -1;
-                        error->message = err.message;
-                    }
+                if (pool) {
+                    simresult =
+                        pool->run(i, &err, budget ? &budget->token : nullptr);
                 } else {
-                    result->add(i, 0, std::move(simresult));
+                    Simulation sim(context, mLogOption, mSimulationOption,
+                                   mTimeout, nullptr);
+                    simresult = runCombination(sim, expgen, i, checkpoint,
+                                               budget, &err);
                 }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                reduceCombination(reducer, i, std::move(simresult), err,
+                                  error);
             }
         }
     };
 
-    std::unique_ptr<value::Matrix>
-    runManagerThread(std::unique_ptr<vpz::Vpz> vpz,
-                     uint32_t               threads,
-                     uint32_t               rank,
-                     uint32_t               world,
-                     Error                 *error)
+    void runManagerThread(ExperimentGenerator&             expgen,
+                          const devs::Checkpoint          *checkpoint,
+                          uint32_t                         threads,
+                          Reducer&                         reducer,
+                          Error                           *error,
+                          WorkerPool                      *pool,
+                          const devs::RunBudget           *budget)
     {
-        ExperimentGenerator expgen(*vpz, rank, world);
-        std::string vpzname(vpz->project().experiment().name());
-
-        auto result = std::unique_ptr<value::Matrix>(
-            new value::Matrix(expgen.size(), 1, expgen.size(), 1));
-
+        std::mutex mutex;
         std::vector<std::thread> gp;
         for (uint32_t i = 0; i < threads; ++i) {
             utils::ContextPtr ctx = mContext->clone();
             ctx->set_log_function(
                     std::unique_ptr<utils::Context::LogFunctor>(
                             new vle_log_manager_thread(i)));
-            gp.emplace_back(worker(ctx, vpz, mTimeout, expgen,
+
+            long log_capacity = 0;
+            if (ctx->get_setting("vle.log.asynchronous", &log_capacity) and
+                log_capacity > 0)
+                ctx->set_log_asynchronous(
+                    static_cast<std::size_t>(log_capacity));
+
+            gp.emplace_back(worker(ctx, mTimeout, expgen, checkpoint,
                        mLogOption, mSimulationOption,
-                       i, threads, result.get(), error));
+                       i, threads, reducer, mutex, error, pool, budget));
         }
 
         for (uint32_t i = 0; i < threads; ++i)
             gp[i].join();
-
-        return result;
     }
 
-    std::unique_ptr<value::Matrix>
-    runManagerMono(std::unique_ptr<vpz::Vpz> vpz,
-                   uint32_t rank,
-                   uint32_t world,
-                   Error *error)
+    void runManagerMono(ExperimentGenerator&             expgen,
+                        const devs::Checkpoint          *checkpoint,
+                        Reducer&                         reducer,
+                        Error                           *error,
+                        WorkerPool                      *pool,
+                        const devs::RunBudget           *budget)
     {
         Simulation sim(mContext, mLogOption, mSimulationOption, mTimeout,
                        nullptr);
-        ExperimentGenerator expgen(*vpz, rank, world);
-        std::string vpzname(vpz->project().experiment().name());
-        std::unique_ptr<value::Matrix> result;
 
-        error->code = 0;
-        error->message.clear();
+        for (uint32_t i = expgen.min(); i < expgen.max(); ++i) {
+            if (isCancelled(budget, error))
+                break;
 
-        if (mSimulationOption == manager::SIMULATION_NO_RETURN) {
-            for (uint32_t i = expgen.min(); i < expgen.max(); ++i) {
-                Error err;
-                auto file = std::unique_ptr<vpz::Vpz>(new vpz::Vpz(*vpz));
-                setExperimentName(file, vpzname, i);
-                expgen.get(i, &file->project().experiment().conditions());
+            Error err;
+            auto simresult =
+                pool ? pool->run(i, &err, budget ? &budget->token : nullptr)
+                     : runCombination(sim, expgen, i, checkpoint, budget,
+                                      &err);
 
-                sim.run(std::move(file), &err);
+            if (err.code)
+                writeRunLog(err.message);
 
-                if (err.code) {
-                    writeRunLog(err.message);
+            reduceCombination(reducer, i, std::move(simresult), err, error);
+        }
+    }
 
-                    if (not error->code) {
-                        error->code = -1;
-                        error->message = err.message;
-                    }
-                }
-            }
-        } else {
-            result = std::unique_ptr<value::Matrix>(
-                new value::Matrix(expgen.size(), 1, expgen.size(), 1));
+    /**
+     * With a timeout, the simulations run in the processes of a @c
+     * WorkerPool instead of a new @e vle process per simulation. Set the
+     * @e vle.simulation.worker-pool setting to false to start a new @e vle
+     * process per simulation.
+     */
+    bool usePool() const
+    {
+#ifdef __linux__
+        bool pool = true;
+        mContext->get_setting("vle.simulation.worker-pool", &pool);
+
+        return pool and mTimeout != std::chrono::milliseconds::zero() and
+               (mSimulationOption & SIMULATION_SPAWN_PROCESS);
+#else
+        return false;
+#endif
+    }
 
-            for (uint32_t i = expgen.min(); i < expgen.max(); ++i) {
-                Error err;
-                auto file = std::unique_ptr<vpz::Vpz>(new vpz::Vpz(*vpz));
-                setExperimentName(file, vpzname, i);
-                expgen.get(i, &file->project().experiment().conditions());
+    /**
+     * Build the pool before the threads of the manager: fork() copies
+     * only the calling thread. The workers get a copy of the budget, the
+     * cancellation of the token is forwarded by the pool which kills the
+     * running worker.
+     */
+    std::unique_ptr<WorkerPool> buildPool(const ExperimentGenerator& expgen,
+                                          const devs::Checkpoint *checkpoint)
+    {
+        auto context = mContext;
+        auto options = mSimulationOption & ~SIMULATION_SPAWN_PROCESS;
+        auto budget = mBudget.get();
+
+        return std::make_unique<WorkerPool>(
+            context,
+            [context, options, &expgen, checkpoint, budget](uint32_t index,
+                                                            Error *error) {
+                Simulation sim(context, LOG_NONE, options,
+                               std::chrono::milliseconds::zero(), nullptr);
+
+                return runCombination(sim, expgen, index, checkpoint, budget,
+                                      error);
+            },
+            mTimeout);
+    }
+
+    void run(ExperimentGenerator&      expgen,
+             uint32_t                  thread,
+             Reducer&                  reducer,
+             Error                    *error)
+    {
+        error->code = 0;
+        error->message.clear();
 
-                auto simresult = sim.run(std::move(file), &err);
+        writeSummaryLog(_("Manager started"));
 
-                if (err.code) {
-                    writeRunLog(err.message);
+        reducer.start(expgen.min(), expgen.max());
 
-                    if (not error->code) {
-                        error->code = -1;
-                        error->message = err.message;
-                    }
-                } else {
-                    result->add(i, 0, std::move(simresult));
+        std::shared_ptr<const devs::Checkpoint> checkpoint;
+        if (expgen.min() < expgen.max()) {
+            auto first = expgen.instance(expgen.min());
+            double spinup = spinupDuration(first);
+
+            if (spinup > 0.0) {
+                writeSummaryLog(_("Spin-up simulation"));
+
+                Simulation sim(mContext, mLogOption, mSimulationOption,
+                               mTimeout, nullptr);
+                checkpoint = sim.checkpoint(first, first.begin() + spinup,
+                                            error);
+                if (error->code) {
+                    writeRunLog(error->message);
+                    return;
                 }
             }
         }
 
-        return result;
+        std::unique_ptr<WorkerPool> pool;
+        if (usePool())
+            pool = buildPool(expgen, checkpoint.get());
+
+        if (thread > 1)
+            runManagerThread(expgen, checkpoint.get(), thread, reducer,
+                             error, pool.get(), mBudget.get());
+        else
+            runManagerMono(expgen, checkpoint.get(), reducer, error,
+                           pool.get(), mBudget.get());
+
+        writeSummaryLog(_("Manager ended"));
     }
 
     utils::ContextPtr          mContext;
@@ -306,6 +494,7 @@ public:
     std::ostream              *mOutputStream;
     LogOptions                 mLogOption;
     SimulationOptions          mSimulationOption;
+    std::unique_ptr<devs::RunBudget> mBudget;
 };
 
 Manager::Manager(utils::ContextPtr     context,
@@ -332,6 +521,11 @@ Manager::Manager(utils::ContextPtr     context,
 
 Manager::~Manager() = default;
 
+void Manager::setBudget(const devs::RunBudget& budget)
+{
+    mPimpl->mBudget = std::make_unique<devs::RunBudget>(budget);
+}
+
 std::unique_ptr<value::Matrix>
 Manager::run(std::unique_ptr<vpz::Vpz>  exp,
              uint32_t                   thread,
@@ -339,39 +533,46 @@ Manager::run(std::unique_ptr<vpz::Vpz>  exp,
              uint32_t                   world,
              Error                     *error)
 {
-    std::unique_ptr<value::Matrix> result;
+    checkRunParameters(thread, rank, world);
 
-    if (thread <= 0) {
-        throw vle::utils::ArgError(
-            (fmt(_("Manager error: thread must be superior to 0 (%1%)"))
-             % thread).str());
-    }
+    /* The simulations are headless: the graphics of the models are
+       useless. */
+    if (exp->project().model().node())
+        exp->project().model().node()->clearGraphics();
 
-    if (world <= rank) {
-        throw vle::utils::ArgError(
-            (fmt(_("Manager error: rank (%1%) must be inferior"
-                   " to world (%2%)"))  % rank % world).str());
-    }
+    ExperimentGenerator expgen(
+        std::shared_ptr<const vpz::Vpz>(std::move(exp)), rank, world);
+    MatrixReducer reducer(expgen.size());
 
-    if (world <= 0) {
-        throw vle::utils::ArgError(
-            (fmt(_("Manager error: world (%1%) must be superior to 0."))
-             % world).str());
-    }
+    mPimpl->run(expgen, thread, reducer, error);
 
-    mPimpl->writeSummaryLog(_("Manager started"));
+    if (thread <= 1 and
+        (mPimpl->mSimulationOption & manager::SIMULATION_NO_RETURN))
+        return {};
 
-    if (thread > 1) {
-        result = mPimpl->runManagerThread(std::move(exp), thread, rank,
-                                          world, error);
-    } else {
-        result = mPimpl->runManagerMono(std::move(exp), rank,
-                                        world, error);
-    }
+    return std::move(reducer.mResult);
+}
+
+std::unique_ptr<value::Map>
+Manager::run(std::unique_ptr<vpz::Vpz>  exp,
+             uint32_t                   thread,
+             uint32_t                   rank,
+             uint32_t                   world,
+             Reducer&                   reducer,
+             Error                     *error)
+{
+    checkRunParameters(thread, rank, world);
+
+    /* The simulations are headless: the graphics of the models are
+       useless. */
+    if (exp->project().model().node())
+        exp->project().model().node()->clearGraphics();
 
-    mPimpl->writeSummaryLog(_("Manager ended"));
+    ExperimentGenerator expgen(
+        std::shared_ptr<const vpz::Vpz>(std::move(exp)), rank, world);
+    mPimpl->run(expgen, thread, reducer, error);
 
-    return result;
+    return reducer.finish();
 }
 
 }} // namespace vle manager
@@ -29,7 +29,9 @@
 #define VLE_MANAGER_MANAGER_HPP
 
 #include <vle/DllDefines.hpp>
+#include <vle/devs/RunBudget.hpp>
 #include <vle/utils/Context.hpp>
+#include <vle/manager/Reducer.hpp>
 #include <vle/manager/Types.hpp>
 #include <vle/vpz/Vpz.hpp>
 #include <chrono>
@@ -46,6 +48,12 @@ namespace vle { namespace manager {
  * value is a @c value::Matrix or NULL if the @c value::Matrix is
  * empty.
  *
+ * If the simulation engine condition defines a @e spinup port, the
+ * common prefix [begin, begin + spinup] of the experimental frame is
+ * simulated once with the first combination, checkpointed and each
+ * combination restarts from this checkpoint. All the models must
+ * implement @c devs::Dynamics::serialize().
+ *
  * @attention You are in charge to freed the manager result @c
  * value::Matrix.
  */
@@ -72,6 +80,15 @@ public:
     Manager(Manager&& other) = delete;
     Manager& operator=(Manager&& other) = delete;
 
+    /**
+     * Limit each simulation of the experimental frames (see @c
+     * Simulation::setBudget). The combinations not yet started when the
+     * token is cancelled are not simulated.
+     *
+     * @param budget The limits of each simulation.
+     */
+    void setBudget(const devs::RunBudget& budget);
+
     /**
      * Run an part or a complete experimental frames with mono thread
      * or multi-thread.
@@ -96,6 +113,28 @@ public:
             uint32_t world,
             Error *error);
 
+    /**
+     * Run an part or a complete experimental frames with mono thread
+     * or multi-thread and fold each simulation result into the @e
+     * reducer as soon as the simulation finishes. The memory used by
+     * the results is then independent of the number of combinations.
+     *
+     * @param exp
+     * @param thread
+     * @param rank
+     * @param world
+     * @param reducer The @c manager::Reducer to fold the results.
+     *
+     * @return The result of the @c Reducer::finish() function.
+     */
+    std::unique_ptr<value::Map>
+        run(std::unique_ptr<vpz::Vpz> exp,
+            uint32_t thread,
+            uint32_t rank,
+            uint32_t world,
+            Reducer& reducer,
+            Error *error);
+
 private:
     class Pimpl;
     std::unique_ptr<Pimpl> mPimpl;
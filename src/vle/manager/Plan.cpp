@@ -0,0 +1,484 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/manager/Plan.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/vpz/Condition.hpp>
+#include <limits>
+#include <map>
+
+namespace vle {
+namespace manager {
+
+namespace {
+
+/* Sorts the conditions and the ports by name: the unordered_map order must
+   not change the combination index. */
+using SortedPorts =
+    std::map<std::pair<std::string, std::string>,
+             const std::vector<std::shared_ptr<value::Value>> *>;
+
+SortedPorts sorted_ports(const vpz::Vpz &vpz)
+{
+    SortedPorts ret;
+
+    for (const auto &cnd : vpz.project().experiment().conditions())
+        for (const auto &port : cnd.second.conditionvalues())
+            ret[std::make_pair(cnd.first, port.first)] = &port.second;
+
+    return ret;
+}
+
+std::vector<PlanDiscreteFactor> discrete_factors(const vpz::Vpz &vpz)
+{
+    std::vector<PlanDiscreteFactor> ret;
+
+    for (const auto &elem : sorted_ports(vpz))
+        if (elem.second->size() > 1)
+            ret.emplace_back(PlanDiscreteFactor{
+                elem.first.first, elem.first.second, *elem.second });
+
+    return ret;
+}
+
+bool is_number(const std::shared_ptr<value::Value> &value)
+{
+    return value and (value->isDouble() or value->isInteger());
+}
+
+double to_number(const std::shared_ptr<value::Value> &value)
+{
+    return value->isDouble() ? value->toDouble().value()
+                             : value->toInteger().value();
+}
+
+std::vector<PlanContinuousFactor> continuous_factors(const vpz::Vpz &vpz)
+{
+    std::vector<PlanContinuousFactor> ret;
+
+    for (const auto &elem : sorted_ports(vpz)) {
+        const auto &values = *elem.second;
+
+        if (values.size() <= 1)
+            continue;
+
+        if (values.size() != 2 or not is_number(values[0]) or
+            not is_number(values[1]))
+            throw utils::ArgError(
+                (fmt(_("Plan: the condition `%1%' port `%2%' must have two "
+                       "real values (the bounds of the interval)")) %
+                 elem.first.first % elem.first.second)
+                    .str());
+
+        ret.emplace_back(PlanContinuousFactor{ elem.first.first,
+                                               elem.first.second,
+                                               to_number(values[0]),
+                                               to_number(values[1]) });
+    }
+
+    return ret;
+}
+
+uint64_t simulation_engine_integer(const vpz::Vpz &vpz,
+                                   const std::string &port,
+                                   uint64_t default_value)
+{
+    const auto &cnds = vpz.project().experiment().conditions();
+    const auto &name = vpz::Experiment::defaultSimulationEngineCondName();
+
+    if (not cnds.exist(name))
+        return default_value;
+
+    const auto &values = cnds.get(name).conditionvalues();
+    auto it = values.find(port);
+    if (it == values.end() or it->second.empty())
+        return default_value;
+
+    if (not is_number(it->second.front()) or
+        to_number(it->second.front()) < 0)
+        throw utils::ArgError(
+            (fmt(_("Plan: the port `%1%' of the simulation engine condition "
+                   "must be a positive number")) %
+             port)
+                .str());
+
+    return static_cast<uint64_t>(to_number(it->second.front()));
+}
+
+uint32_t checked_size(uint64_t size)
+{
+    if (size > std::numeric_limits<uint32_t>::max())
+        throw utils::ArgError(
+            (fmt(_("Plan: too many combinations (%1%)")) % size).str());
+
+    return static_cast<uint32_t>(size);
+}
+
+void check_index(uint32_t index, uint32_t size)
+{
+    if (index >= size)
+        throw utils::ArgError(
+            (fmt(_("Plan: the index `%1%' is out of range [0, %2%[")) %
+             index % size)
+                .str());
+}
+
+uint64_t splitmix64(uint64_t x)
+{
+    x += UINT64_C(0x9E3779B97F4A7C15);
+    x = (x ^ (x >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    x = (x ^ (x >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return x ^ (x >> 31);
+}
+
+/* A keyed bijection of [0, n[: four rounds of xor, odd multiplication and
+   xorshift are bijections of [0, 2^bits[ and the cycle walking keeps the
+   result in [0, n[ (less than two rounds on average). */
+uint32_t permute(uint32_t x, uint32_t n, uint64_t key)
+{
+    if (n <= 1)
+        return 0;
+
+    uint32_t bits = 0;
+    while ((UINT64_C(1) << bits) < n)
+        ++bits;
+
+    const uint64_t mask = (UINT64_C(1) << bits) - 1;
+    const uint32_t shift = (bits + 1) / 2;
+    uint64_t y = x;
+
+    do {
+        for (uint64_t round = 0; round < 4; ++round) {
+            const uint64_t k = splitmix64(key + round);
+            y = (y ^ k) & mask;
+            y = (y * ((k >> 32) | 1)) & mask;
+            y ^= y >> shift;
+        }
+    } while (y >= n);
+
+    return static_cast<uint32_t>(y);
+}
+
+/* Direction numbers of the Sobol sequence for the dimensions 2 to 21 from
+   Joe and Kuo (new-joe-kuo-6.21201): degree s, coefficient a and initial
+   numbers m. */
+struct SobolPrimitive {
+    uint32_t s;
+    uint32_t a;
+    uint32_t m[7];
+};
+
+const SobolPrimitive sobol_primitives[] = {
+    { 1, 0, { 1 } },
+    { 2, 1, { 1, 3 } },
+    { 3, 1, { 1, 3, 1 } },
+    { 3, 2, { 1, 1, 1 } },
+    { 4, 1, { 1, 1, 3, 3 } },
+    { 4, 4, { 1, 3, 5, 13 } },
+    { 5, 2, { 1, 1, 5, 5, 17 } },
+    { 5, 4, { 1, 1, 5, 5, 5 } },
+    { 5, 7, { 1, 1, 7, 11, 19 } },
+    { 5, 11, { 1, 1, 5, 1, 1 } },
+    { 5, 13, { 1, 1, 1, 3, 11 } },
+    { 5, 14, { 1, 3, 5, 5, 31 } },
+    { 6, 1, { 1, 3, 3, 9, 7, 49 } },
+    { 6, 13, { 1, 1, 1, 15, 21, 21 } },
+    { 6, 16, { 1, 3, 1, 13, 27, 49 } },
+    { 6, 19, { 1, 1, 1, 15, 7, 5 } },
+    { 6, 22, { 1, 3, 1, 15, 13, 25 } },
+    { 6, 25, { 1, 1, 5, 5, 19, 61 } },
+    { 7, 1, { 1, 3, 7, 11, 23, 15, 103 } },
+    { 7, 4, { 1, 3, 7, 13, 13, 15, 69 } },
+};
+
+constexpr uint32_t sobol_dimensions =
+    1 + sizeof(sobol_primitives) / sizeof(sobol_primitives[0]);
+
+struct SobolDirections {
+    uint32_t v[sobol_dimensions][32];
+
+    SobolDirections()
+    {
+        for (uint32_t k = 0; k < 32; ++k)
+            v[0][k] = UINT32_C(1) << (31 - k);
+
+        for (uint32_t d = 1; d < sobol_dimensions; ++d) {
+            const auto &p = sobol_primitives[d - 1];
+
+            for (uint32_t k = 0; k < 32; ++k) {
+                if (k < p.s) {
+                    v[d][k] = p.m[k] << (31 - k);
+                }
+                else {
+                    v[d][k] = v[d][k - p.s] ^ (v[d][k - p.s] >> p.s);
+                    for (uint32_t j = 1; j < p.s; ++j)
+                        if ((p.a >> (p.s - 1 - j)) & 1)
+                            v[d][k] ^= v[d][k - j];
+                }
+            }
+        }
+    }
+};
+
+} // anonymous namespace
+
+//
+// Plan
+//
+
+std::unique_ptr<Plan> Plan::create(const vpz::Vpz &vpz)
+{
+    const auto &combination = vpz.project().experiment().combination();
+
+    if (combination.empty() or combination == "linear")
+        return std::unique_ptr<Plan>(new LinearPlan(vpz));
+
+    if (combination == "total")
+        return std::unique_ptr<Plan>(new TotalPlan(vpz));
+
+    if (combination == "lhs")
+        return std::unique_ptr<Plan>(new LatinHypercubePlan(
+            continuous_factors(vpz),
+            checked_size(simulation_engine_integer(vpz, "samples", 0)),
+            simulation_engine_integer(vpz, "seed", 1)));
+
+    if (combination == "saltelli")
+        return std::unique_ptr<Plan>(new SaltelliPlan(
+            continuous_factors(vpz),
+            checked_size(simulation_engine_integer(vpz, "samples", 0))));
+
+    throw utils::ArgError(
+        (fmt(_("Plan: unknown combination `%1%'")) % combination).str());
+}
+
+//
+// LinearPlan
+//
+
+LinearPlan::LinearPlan(std::vector<PlanDiscreteFactor> factors)
+    : m_factors(std::move(factors))
+    , m_size(1)
+{
+    if (m_factors.empty())
+        return;
+
+    m_size = checked_size(m_factors.front().values.size());
+
+    for (const auto &factor : m_factors)
+        if (factor.values.size() != m_size)
+            throw utils::ArgError(
+                (fmt(_("ExperimentGenerator: bad combination size for the "
+                       "condition `%1%' port `%2%': %3%")) %
+                 factor.condition % factor.port % factor.values.size())
+                    .str());
+}
+
+LinearPlan::LinearPlan(const vpz::Vpz &vpz)
+    : LinearPlan(discrete_factors(vpz))
+{
+}
+
+uint32_t LinearPlan::size() const
+{
+    return m_size;
+}
+
+void LinearPlan::assign(uint32_t index,
+                        vpz::ExperimentInstance &instance) const
+{
+    check_index(index, m_size);
+
+    for (const auto &factor : m_factors)
+        instance.overlay(factor.condition, factor.port, factor.values[index]);
+}
+
+//
+// TotalPlan
+//
+
+TotalPlan::TotalPlan(std::vector<PlanDiscreteFactor> factors)
+    : m_factors(std::move(factors))
+    , m_size(1)
+{
+    uint64_t size = 1;
+
+    for (const auto &factor : m_factors) {
+        if (factor.values.empty())
+            throw utils::ArgError(
+                (fmt(_("Plan: the condition `%1%' port `%2%' is empty")) %
+                 factor.condition % factor.port)
+                    .str());
+
+        size = checked_size(size * factor.values.size());
+    }
+
+    m_size = static_cast<uint32_t>(size);
+}
+
+TotalPlan::TotalPlan(const vpz::Vpz &vpz)
+    : TotalPlan(discrete_factors(vpz))
+{
+}
+
+uint32_t TotalPlan::size() const
+{
+    return m_size;
+}
+
+void TotalPlan::assign(uint32_t index, vpz::ExperimentInstance &instance) const
+{
+    check_index(index, m_size);
+
+    for (auto it = m_factors.rbegin(); it != m_factors.rend(); ++it) {
+        const auto radix = static_cast<uint32_t>(it->values.size());
+
+        instance.overlay(it->condition, it->port, it->values[index % radix]);
+        index /= radix;
+    }
+}
+
+//
+// LatinHypercubePlan
+//
+
+LatinHypercubePlan::LatinHypercubePlan(
+    std::vector<PlanContinuousFactor> factors,
+    uint32_t samples,
+    uint64_t seed)
+    : m_factors(std::move(factors))
+    , m_samples(samples)
+    , m_seed(seed)
+{
+    if (m_samples == 0)
+        throw utils::ArgError(_("Plan: the number of samples is null"));
+}
+
+uint32_t LatinHypercubePlan::size() const
+{
+    return m_samples;
+}
+
+double LatinHypercubePlan::unit(uint32_t index, uint32_t factor) const
+{
+    const uint64_t key = splitmix64(m_seed ^ splitmix64(factor));
+    const uint32_t stratum = permute(index, m_samples, key);
+    const double jitter =
+        (splitmix64(key ^ (UINT64_C(0xA0761D6478BD642F) + index)) >> 11) *
+        (1.0 / (UINT64_C(1) << 53));
+
+    return (stratum + jitter) / m_samples;
+}
+
+void LatinHypercubePlan::assign(uint32_t index,
+                                vpz::ExperimentInstance &instance) const
+{
+    check_index(index, m_samples);
+
+    for (uint32_t i = 0, e = m_factors.size(); i != e; ++i) {
+        const auto &factor = m_factors[i];
+
+        instance.overlay(
+            factor.condition,
+            factor.port,
+            value::Double::create(factor.min +
+                                  unit(index, i) * (factor.max - factor.min)));
+    }
+}
+
+//
+// SaltelliPlan
+//
+
+SaltelliPlan::SaltelliPlan(std::vector<PlanContinuousFactor> factors,
+                           uint32_t samples)
+    : m_factors(std::move(factors))
+    , m_samples(samples)
+{
+    if (m_samples == 0)
+        throw utils::ArgError(_("Plan: the number of samples is null"));
+
+    if (m_factors.size() * 2 > sobol_dimensions)
+        throw utils::ArgError(
+            (fmt(_("Plan: the saltelli plan allows at most %1% factors")) %
+             (sobol_dimensions / 2))
+                .str());
+
+    checked_size(uint64_t(m_samples) * (m_factors.size() + 2));
+}
+
+uint32_t SaltelliPlan::size() const
+{
+    return m_samples * static_cast<uint32_t>(m_factors.size() + 2);
+}
+
+double SaltelliPlan::sobol(uint32_t index, uint32_t dimension)
+{
+    static const SobolDirections directions;
+
+    if (dimension >= sobol_dimensions)
+        throw utils::ArgError(
+            (fmt(_("Plan: the Sobol sequence has %1% dimensions")) %
+             sobol_dimensions)
+                .str());
+
+    uint32_t x = 0;
+    for (uint32_t k = 0; index; ++k, index >>= 1)
+        if (index & 1)
+            x ^= directions.v[dimension][k];
+
+    return x * (1.0 / (UINT64_C(1) << 32));
+}
+
+double SaltelliPlan::unit(uint32_t index, uint32_t factor) const
+{
+    const auto k = static_cast<uint32_t>(m_factors.size());
+    const uint32_t point = index / (k + 2);
+    const uint32_t column = index % (k + 2);
+    const bool from_b = column == k + 1 or column == factor + 1;
+
+    return sobol(point, from_b ? k + factor : factor);
+}
+
+void SaltelliPlan::assign(uint32_t index,
+                          vpz::ExperimentInstance &instance) const
+{
+    check_index(index, size());
+
+    for (uint32_t i = 0, e = m_factors.size(); i != e; ++i) {
+        const auto &factor = m_factors[i];
+
+        instance.overlay(
+            factor.condition,
+            factor.port,
+            value::Double::create(factor.min +
+                                  unit(index, i) * (factor.max - factor.min)));
+    }
+}
+}
+} // namespace vle manager
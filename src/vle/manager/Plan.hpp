@@ -0,0 +1,242 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_MANAGER_PLAN_HPP
+#define VLE_MANAGER_PLAN_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/value/Value.hpp>
+#include <vle/vpz/ExperimentInstance.hpp>
+#include <vle/vpz/Vpz.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vle {
+namespace manager {
+
+/**
+ * A @c manager::Plan decodes a combination index into the values of the
+ * ports of the conditions. The combinations are never enumerated: the
+ * values of an index are computed on the fly by @c assign(), so the
+ * memory used by a plan does not depend on the number of combinations and
+ * the @c manager::ExperimentGenerator can split the plan between several
+ * workers (@e rank and @e world) without building it.
+ *
+ * The plan is selected with the @e combination attribute of the
+ * experiment:
+ * - @e linear (default): each multi-valued port has the same number of
+ *   values, the combination @e i uses the value @e i of each port.
+ * - @e total: cartesian product of the multi-valued ports.
+ * - @e lhs: Latin hypercube sampling, each multi-valued port has two real
+ *   values, the bounds of the interval.
+ * - @e saltelli: Saltelli design (Sobol sequence) for sensitivity
+ *   analysis, each multi-valued port has two real values, the bounds of
+ *   the interval.
+ *
+ * The number of samples of the @e lhs and @e saltelli plans is read in the
+ * @e samples port of the simulation engine condition and the seed of the
+ * @e lhs plan in the @e seed port.
+ */
+class VLE_API Plan
+{
+public:
+    virtual ~Plan() = default;
+
+    /**
+     * Get the number of combinations of the plan.
+     */
+    virtual uint32_t size() const = 0;
+
+    /**
+     * Overlay the values of the combination @e index in @e instance.
+     *
+     * @param index The combination index, lower than @c size().
+     * @param[out] instance The instance to fill.
+     * @throw utils::ArgError if index is out of range.
+     */
+    virtual void assign(uint32_t index,
+                        vpz::ExperimentInstance &instance) const = 0;
+
+    /**
+     * Build the plan described by the experiment of @e vpz.
+     *
+     * @throw utils::ArgError if the combination is unknown or if the
+     * conditions do not fit the plan.
+     */
+    static std::unique_ptr<Plan> create(const vpz::Vpz &vpz);
+};
+
+/**
+ * A factor of a plan with discrete values.
+ */
+struct VLE_API PlanDiscreteFactor
+{
+    std::string condition;
+    std::string port;
+    std::vector<std::shared_ptr<value::Value>> values;
+};
+
+/**
+ * A factor of a plan with a real interval [min, max].
+ */
+struct VLE_API PlanContinuousFactor
+{
+    std::string condition;
+    std::string port;
+    double min;
+    double max;
+};
+
+/**
+ * The @e linear plan: the combination @e i uses the value @e i of each
+ * factor.
+ */
+class VLE_API LinearPlan : public Plan
+{
+public:
+    /**
+     * @throw utils::ArgError if the factors do not have the same size.
+     */
+    LinearPlan(std::vector<PlanDiscreteFactor> factors);
+
+    /**
+     * Use each multi-valued port of the experiment as factor.
+     */
+    LinearPlan(const vpz::Vpz &vpz);
+
+    uint32_t size() const override;
+    void assign(uint32_t index,
+                vpz::ExperimentInstance &instance) const override;
+
+private:
+    std::vector<PlanDiscreteFactor> m_factors;
+    uint32_t m_size;
+};
+
+/**
+ * The @e total plan: the cartesian product of the factors. The last factor
+ * varies the fastest.
+ */
+class VLE_API TotalPlan : public Plan
+{
+public:
+    /**
+     * @throw utils::ArgError if a factor is empty or if the product
+     * overflows.
+     */
+    TotalPlan(std::vector<PlanDiscreteFactor> factors);
+
+    /**
+     * Use each multi-valued port of the experiment as factor.
+     */
+    TotalPlan(const vpz::Vpz &vpz);
+
+    uint32_t size() const override;
+    void assign(uint32_t index,
+                vpz::ExperimentInstance &instance) const override;
+
+private:
+    std::vector<PlanDiscreteFactor> m_factors;
+    uint32_t m_size;
+};
+
+/**
+ * The @e lhs plan: a Latin hypercube of @e samples points. For each
+ * factor, the interval is split into @e samples strata and each stratum is
+ * used once. The strata are shuffled by a keyed bijection of [0, samples[
+ * so a point is computed without storing the permutations.
+ */
+class VLE_API LatinHypercubePlan : public Plan
+{
+public:
+    /**
+     * @throw utils::ArgError if samples is null.
+     */
+    LatinHypercubePlan(std::vector<PlanContinuousFactor> factors,
+                       uint32_t samples,
+                       uint64_t seed);
+
+    uint32_t size() const override;
+    void assign(uint32_t index,
+                vpz::ExperimentInstance &instance) const override;
+
+    /**
+     * Get the value in [0, 1[ of the factor @e factor for the point
+     * @e index.
+     */
+    double unit(uint32_t index, uint32_t factor) const;
+
+private:
+    std::vector<PlanContinuousFactor> m_factors;
+    uint32_t m_samples;
+    uint64_t m_seed;
+};
+
+/**
+ * The @e saltelli plan: the design of Saltelli (2002) to estimate the first
+ * and total order Sobol indices. With @e k factors and @e samples base
+ * points, the plan has @e samples * (@e k + 2) combinations. For each base
+ * point @e j, the combinations @e j * (@e k + 2) + @e c are: @e c = 0 the
+ * matrix A, @e c in [1, k] the matrix A with the column @e c - 1 from B,
+ * @e c = @e k + 1 the matrix B. A and B are the first and last @e k
+ * dimensions of a Sobol sequence (Joe and Kuo direction numbers), so at
+ * most 10 factors are allowed.
+ */
+class VLE_API SaltelliPlan : public Plan
+{
+public:
+    /**
+     * @throw utils::ArgError if samples is null, if there are more than 10
+     * factors or if the size overflows.
+     */
+    SaltelliPlan(std::vector<PlanContinuousFactor> factors, uint32_t samples);
+
+    uint32_t size() const override;
+    void assign(uint32_t index,
+                vpz::ExperimentInstance &instance) const override;
+
+    /**
+     * Get the value in [0, 1[ of the factor @e factor for the combination
+     * @e index.
+     */
+    double unit(uint32_t index, uint32_t factor) const;
+
+    /**
+     * Get the coordinate @e dimension of the point @e index of the Sobol
+     * sequence.
+     */
+    static double sobol(uint32_t index, uint32_t dimension);
+
+private:
+    std::vector<PlanContinuousFactor> m_factors;
+    uint32_t m_samples;
+};
+}
+} // namespace vle manager
+
+#endif
@@ -0,0 +1,607 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/manager/Reducer.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Tools.hpp>
+#include <vle/utils/i18n.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace vle {
+namespace manager {
+
+namespace {
+
+/**
+ * Try to convert the value into a real.
+ *
+ * @return false if the value is not a @c value::Double, a @c
+ * value::Integer or a @c value::Boolean.
+ */
+bool get_real(const std::unique_ptr<value::Value> &v, double *out) noexcept
+{
+    if (not v)
+        return false;
+
+    switch (v->getType()) {
+    case value::Value::DOUBLE:
+        *out = v->toDouble().value();
+        return true;
+    case value::Value::INTEGER:
+        *out = v->toInteger().value();
+        return true;
+    case value::Value::BOOLEAN:
+        *out = v->toBoolean().value() ? 1.0 : 0.0;
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * A dense grid of accumulators, one per cell of a view's matrix. The grid
+ * grows if a simulation produces a bigger matrix than the previous ones.
+ * Non-numeric cells (the header of the storage plug-in for example) are
+ * stored once into @e labels.
+ */
+template <typename State> struct Grid {
+    std::size_t columns = 0;
+    std::size_t rows = 0;
+    std::vector<State> cells;
+    std::vector<std::unique_ptr<value::Value>> labels;
+
+    void fit(std::size_t newcolumns, std::size_t newrows)
+    {
+        if (newcolumns <= columns and newrows <= rows)
+            return;
+
+        newcolumns = std::max(newcolumns, columns);
+        newrows = std::max(newrows, rows);
+
+        std::vector<State> newcells(newcolumns * newrows);
+        std::vector<std::unique_ptr<value::Value>> newlabels(newcolumns *
+                                                             newrows);
+
+        for (std::size_t r = 0; r != rows; ++r) {
+            for (std::size_t c = 0; c != columns; ++c) {
+                newcells[r * newcolumns + c] = std::move(cells[r * columns + c]);
+                newlabels[r * newcolumns + c] =
+                    std::move(labels[r * columns + c]);
+            }
+        }
+
+        cells.swap(newcells);
+        labels.swap(newlabels);
+        columns = newcolumns;
+        rows = newrows;
+    }
+
+    State &at(std::size_t column, std::size_t row)
+    {
+        return cells[row * columns + column];
+    }
+
+    const State &at(std::size_t column, std::size_t row) const
+    {
+        return cells[row * columns + column];
+    }
+
+    std::unique_ptr<value::Value> &label(std::size_t column, std::size_t row)
+    {
+        return labels[row * columns + column];
+    }
+
+    const std::unique_ptr<value::Value> &label(std::size_t column,
+                                               std::size_t row) const
+    {
+        return labels[row * columns + column];
+    }
+};
+
+/**
+ * Fold all the numeric cells of the @e result into the grids using the @e
+ * fold functor.
+ */
+template <typename State, typename Function>
+void fold(std::map<std::string, Grid<State>> &grids,
+          const std::unique_ptr<value::Map> &result,
+          Function fold)
+{
+    if (not result)
+        return;
+
+    for (const auto &view : *result) {
+        if (not view.second or not view.second->isMatrix())
+            continue;
+
+        const auto &matrix = view.second->toMatrix();
+        auto &grid = grids[view.first];
+        grid.fit(matrix.columns(), matrix.rows());
+
+        for (std::size_t r = 0, re = matrix.rows(); r != re; ++r) {
+            for (std::size_t c = 0, ce = matrix.columns(); c != ce; ++c) {
+                const auto &cell = matrix.get(c, r);
+                double real;
+
+                if (get_real(cell, &real))
+                    fold(grid.at(c, r), real);
+                else if (cell and not grid.label(c, r))
+                    grid.label(c, r) = cell->clone();
+            }
+        }
+    }
+}
+
+/**
+ * Build a @c value::Matrix from a grid. The @e make functor returns a null
+ * pointer if the accumulator of the cell is empty, in this case, the label
+ * of the cell is cloned.
+ */
+template <typename State, typename Function>
+std::unique_ptr<value::Matrix> make_matrix(const Grid<State> &grid,
+                                           Function make)
+{
+    auto matrix = std::unique_ptr<value::Matrix>(new value::Matrix(
+        grid.columns, grid.rows, grid.columns, grid.rows, 1, 1));
+
+    for (std::size_t r = 0; r != grid.rows; ++r) {
+        for (std::size_t c = 0; c != grid.columns; ++c) {
+            auto cell = make(grid.at(c, r));
+
+            if (cell)
+                matrix->add(c, r, std::move(cell));
+            else if (grid.label(c, r))
+                matrix->add(c, r, grid.label(c, r)->clone());
+        }
+    }
+
+    return matrix;
+}
+
+struct Welford {
+    std::uint64_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+
+    void add(double x) noexcept
+    {
+        ++count;
+        const double delta = x - mean;
+        mean += delta / count;
+        m2 += delta * (x - mean);
+    }
+
+    double variance() const noexcept
+    {
+        return count > 1 ? m2 / (count - 1) : 0.0;
+    }
+};
+
+struct Extremum {
+    bool seen = false;
+    double min = 0.0;
+    double max = 0.0;
+
+    void add(double x) noexcept
+    {
+        if (not seen) {
+            seen = true;
+            min = max = x;
+        }
+        else {
+            min = std::min(min, x);
+            max = std::max(max, x);
+        }
+    }
+};
+
+/**
+ * The P-square estimator of a quantile: five markers (heights @e q and
+ * positions @e n) updated for each observation.
+ */
+struct PSquare {
+    double p;
+    std::uint64_t count;
+    double q[5];
+    double n[5];
+    double np[5];
+    double dn[5];
+
+    PSquare(double probability) noexcept
+        : p(probability)
+        , count(0)
+    {
+    }
+
+    double parabolic(int i, double d) const noexcept
+    {
+        return q[i] + d / (n[i + 1] - n[i - 1]) *
+                          ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) /
+                               (n[i + 1] - n[i]) +
+                           (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) /
+                               (n[i] - n[i - 1]));
+    }
+
+    double linear(int i, int d) const noexcept
+    {
+        return q[i] + d * (q[i + d] - q[i]) / (n[i + d] - n[i]);
+    }
+
+    void add(double x) noexcept
+    {
+        if (count < 5) {
+            q[count++] = x;
+
+            if (count == 5) {
+                std::sort(q, q + 5);
+                for (int i = 0; i != 5; ++i)
+                    n[i] = i + 1;
+
+                np[0] = 1.0;
+                np[1] = 1.0 + 2.0 * p;
+                np[2] = 1.0 + 4.0 * p;
+                np[3] = 3.0 + 2.0 * p;
+                np[4] = 5.0;
+
+                dn[0] = 0.0;
+                dn[1] = p / 2.0;
+                dn[2] = p;
+                dn[3] = (1.0 + p) / 2.0;
+                dn[4] = 1.0;
+            }
+
+            return;
+        }
+
+        ++count;
+
+        int k;
+        if (x < q[0]) {
+            q[0] = x;
+            k = 0;
+        }
+        else if (x < q[1])
+            k = 0;
+        else if (x < q[2])
+            k = 1;
+        else if (x < q[3])
+            k = 2;
+        else if (x <= q[4])
+            k = 3;
+        else {
+            q[4] = x;
+            k = 3;
+        }
+
+        for (int i = k + 1; i != 5; ++i)
+            n[i] += 1.0;
+
+        for (int i = 0; i != 5; ++i)
+            np[i] += dn[i];
+
+        for (int i = 1; i != 4; ++i) {
+            const double d = np[i] - n[i];
+
+            if ((d >= 1.0 and n[i + 1] - n[i] > 1.0) or
+                (d <= -1.0 and n[i - 1] - n[i] < -1.0)) {
+                const int ds = d > 0.0 ? 1 : -1;
+                const double qp = parabolic(i, ds);
+
+                if (q[i - 1] < qp and qp < q[i + 1])
+                    q[i] = qp;
+                else
+                    q[i] = linear(i, ds);
+
+                n[i] += ds;
+            }
+        }
+    }
+
+    double value() const noexcept
+    {
+        if (count >= 5)
+            return q[2];
+
+        double sorted[5];
+        std::copy(q, q + count, sorted);
+        std::sort(sorted, sorted + count);
+
+        return sorted[static_cast<std::size_t>(
+            std::floor(p * (count - 1) + 0.5))];
+    }
+};
+
+} // anonymous namespace
+
+//
+// MeanVarianceReducer
+//
+
+class MeanVarianceReducer::Pimpl
+{
+public:
+    std::map<std::string, Grid<Welford>> grids;
+};
+
+MeanVarianceReducer::MeanVarianceReducer()
+    : mPimpl(std::make_unique<MeanVarianceReducer::Pimpl>())
+{
+}
+
+MeanVarianceReducer::~MeanVarianceReducer() = default;
+
+void MeanVarianceReducer::reduce(uint32_t /* index */,
+                                 std::unique_ptr<value::Map> result)
+{
+    fold(mPimpl->grids, result, [](Welford &state, double x) {
+        state.add(x);
+    });
+}
+
+std::unique_ptr<value::Map> MeanVarianceReducer::finish()
+{
+    auto result = std::unique_ptr<value::Map>(new value::Map());
+
+    for (const auto &elem : mPimpl->grids) {
+        if (elem.second.columns == 0 or elem.second.rows == 0)
+            continue;
+
+        auto &view = result->addMap(elem.first);
+
+        view.add("mean",
+                 make_matrix(elem.second,
+                             [](const Welford &state) {
+                                 return state.count
+                                            ? value::Double::create(state.mean)
+                                            : nullptr;
+                             }));
+
+        view.add("variance",
+                 make_matrix(elem.second, [](const Welford &state) {
+                     return state.count
+                                ? value::Double::create(state.variance())
+                                : nullptr;
+                 }));
+
+        view.add("count",
+                 make_matrix(elem.second, [](const Welford &state) {
+                     return state.count ? value::Integer::create(
+                                             static_cast<int32_t>(state.count))
+                                        : nullptr;
+                 }));
+    }
+
+    mPimpl->grids.clear();
+
+    return result;
+}
+
+//
+// MinMaxReducer
+//
+
+class MinMaxReducer::Pimpl
+{
+public:
+    std::map<std::string, Grid<Extremum>> grids;
+};
+
+MinMaxReducer::MinMaxReducer()
+    : mPimpl(std::make_unique<MinMaxReducer::Pimpl>())
+{
+}
+
+MinMaxReducer::~MinMaxReducer() = default;
+
+void MinMaxReducer::reduce(uint32_t /* index */,
+                           std::unique_ptr<value::Map> result)
+{
+    fold(mPimpl->grids, result, [](Extremum &state, double x) {
+        state.add(x);
+    });
+}
+
+std::unique_ptr<value::Map> MinMaxReducer::finish()
+{
+    auto result = std::unique_ptr<value::Map>(new value::Map());
+
+    for (const auto &elem : mPimpl->grids) {
+        if (elem.second.columns == 0 or elem.second.rows == 0)
+            continue;
+
+        auto &view = result->addMap(elem.first);
+
+        view.add("min", make_matrix(elem.second, [](const Extremum &state) {
+                     return state.seen ? value::Double::create(state.min)
+                                       : nullptr;
+                 }));
+
+        view.add("max", make_matrix(elem.second, [](const Extremum &state) {
+                     return state.seen ? value::Double::create(state.max)
+                                       : nullptr;
+                 }));
+    }
+
+    mPimpl->grids.clear();
+
+    return result;
+}
+
+//
+// QuantileReducer
+//
+
+class QuantileReducer::Pimpl
+{
+public:
+    std::vector<double> probabilities;
+    std::map<std::string, Grid<std::vector<PSquare>>> grids;
+};
+
+QuantileReducer::QuantileReducer(std::vector<double> probabilities)
+    : mPimpl(std::make_unique<QuantileReducer::Pimpl>())
+{
+    for (auto p : probabilities)
+        if (not(p > 0.0 and p < 1.0))
+            throw utils::ArgError(
+                (fmt(_("QuantileReducer: bad probability %1%")) % p).str());
+
+    mPimpl->probabilities = std::move(probabilities);
+}
+
+QuantileReducer::~QuantileReducer() = default;
+
+void QuantileReducer::reduce(uint32_t /* index */,
+                             std::unique_ptr<value::Map> result)
+{
+    const auto &probabilities = mPimpl->probabilities;
+
+    fold(mPimpl->grids,
+         result,
+         [&probabilities](std::vector<PSquare> &state, double x) {
+             if (state.empty())
+                 state.assign(probabilities.begin(), probabilities.end());
+
+             for (auto &estimator : state)
+                 estimator.add(x);
+         });
+}
+
+std::unique_ptr<value::Map> QuantileReducer::finish()
+{
+    auto result = std::unique_ptr<value::Map>(new value::Map());
+
+    for (const auto &elem : mPimpl->grids) {
+        if (elem.second.columns == 0 or elem.second.rows == 0)
+            continue;
+
+        auto &view = result->addMap(elem.first);
+
+        for (std::size_t i = 0, e = mPimpl->probabilities.size(); i != e;
+             ++i) {
+            view.add(
+                utils::format("%g", mPimpl->probabilities[i]),
+                make_matrix(elem.second,
+                            [i](const std::vector<PSquare> &state) {
+                                return state.empty() ? nullptr
+                                                     : value::Double::create(
+                                                           state[i].value());
+                            }));
+        }
+    }
+
+    mPimpl->grids.clear();
+
+    return result;
+}
+
+//
+// LastRowReducer
+//
+
+class LastRowReducer::Pimpl
+{
+public:
+    using Row = std::vector<std::unique_ptr<value::Value>>;
+
+    uint32_t min = 0;
+    uint32_t max = 0;
+    std::map<std::string, std::vector<Row>> views;
+};
+
+LastRowReducer::LastRowReducer()
+    : mPimpl(std::make_unique<LastRowReducer::Pimpl>())
+{
+}
+
+LastRowReducer::~LastRowReducer() = default;
+
+void LastRowReducer::start(uint32_t min, uint32_t max)
+{
+    mPimpl->min = min;
+    mPimpl->max = max;
+    mPimpl->views.clear();
+}
+
+void LastRowReducer::reduce(uint32_t index, std::unique_ptr<value::Map> result)
+{
+    if (not result or index < mPimpl->min or index >= mPimpl->max)
+        return;
+
+    for (auto &view : *result) {
+        if (not view.second or not view.second->isMatrix())
+            continue;
+
+        auto &matrix = view.second->toMatrix();
+        if (matrix.rows() == 0)
+            continue;
+
+        auto &rows = mPimpl->views[view.first];
+        if (rows.empty())
+            rows.resize(mPimpl->max - mPimpl->min);
+
+        auto &row = rows[index - mPimpl->min];
+        row.resize(matrix.columns());
+
+        for (std::size_t c = 0, e = matrix.columns(); c != e; ++c)
+            row[c] = matrix.give(c, matrix.rows() - 1);
+    }
+}
+
+std::unique_ptr<value::Map> LastRowReducer::finish()
+{
+    auto result = std::unique_ptr<value::Map>(new value::Map());
+
+    for (auto &elem : mPimpl->views) {
+        std::size_t columns = 0;
+        for (const auto &row : elem.second)
+            columns = std::max(columns, row.size());
+
+        if (columns == 0)
+            continue;
+
+        auto matrix = std::unique_ptr<value::Matrix>(new value::Matrix(
+            columns, elem.second.size(), columns, elem.second.size(), 1, 1));
+
+        for (std::size_t r = 0, re = elem.second.size(); r != re; ++r)
+            for (std::size_t c = 0, ce = elem.second[r].size(); c != ce; ++c)
+                if (elem.second[r][c])
+                    matrix->add(c, r, std::move(elem.second[r][c]));
+
+        result->add(elem.first, std::move(matrix));
+    }
+
+    mPimpl->views.clear();
+
+    return result;
+}
+}
+} // namespace vle manager
@@ -0,0 +1,207 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_MANAGER_REDUCER_HPP
+#define VLE_MANAGER_REDUCER_HPP
+
+#include <vle/DllDefines.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Matrix.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vle {
+namespace manager {
+
+/**
+ * @c manager::Reducer folds the results of the simulations of an
+ * experimental frame on-line.
+ *
+ * The @c manager::Manager calls @c reduce() as soon as a simulation
+ * finishes and then frees its result. Calls to @c reduce() are serialized
+ * by the @c manager::Manager but the order of the indices depends on the
+ * number of threads. A @c manager::Reducer must keep a memory footprint
+ * independent of the number of combinations.
+ *
+ * The @c value::Map given to @c reduce() is the @c value::Map returned by
+ * @c manager::Simulation: the key is the name of the @c devs::View and the
+ * value is a @c value::Matrix.
+ */
+class VLE_API Reducer
+{
+public:
+    virtual ~Reducer() = default;
+
+    /**
+     * Called by the @c manager::Manager before the first simulation.
+     *
+     * @param min The first combination index of this worker.
+     * @param max The last combination index (excluded) of this worker.
+     */
+    virtual void start(uint32_t /* min */, uint32_t /* max */) {}
+
+    /**
+     * Fold the result of the combination @e index.
+     *
+     * @param index The combination index from the @c
+     * manager::ExperimentGenerator.
+     * @param result The result of the simulation (can be null if the
+     * simulation has no storage view).
+     */
+    virtual void reduce(uint32_t index, std::unique_ptr<value::Map> result) = 0;
+
+    /**
+     * Build the reduced result when all simulations are finished.
+     *
+     * @return A @c value::Map where the key is the name of the @c
+     * devs::View.
+     */
+    virtual std::unique_ptr<value::Map> finish() = 0;
+};
+
+/**
+ * Compute, cell by cell, the mean and the variance (Welford's algorithm) of
+ * the numeric values of each view. The result of a view is a @c value::Map
+ * with three @c value::Matrix: @e mean, @e variance and @e count.
+ * Non-numeric cells (header for example) are copied from the first result.
+ */
+class VLE_API MeanVarianceReducer : public Reducer
+{
+public:
+    MeanVarianceReducer();
+    ~MeanVarianceReducer();
+
+    void reduce(uint32_t index, std::unique_ptr<value::Map> result) override;
+    std::unique_ptr<value::Map> finish() override;
+
+private:
+    class Pimpl;
+    std::unique_ptr<Pimpl> mPimpl;
+};
+
+/**
+ * Compute, cell by cell, the minimum and the maximum of the numeric values
+ * of each view. The result of a view is a @c value::Map with two @c
+ * value::Matrix: @e min and @e max.
+ */
+class VLE_API MinMaxReducer : public Reducer
+{
+public:
+    MinMaxReducer();
+    ~MinMaxReducer();
+
+    void reduce(uint32_t index, std::unique_ptr<value::Map> result) override;
+    std::unique_ptr<value::Map> finish() override;
+
+private:
+    class Pimpl;
+    std::unique_ptr<Pimpl> mPimpl;
+};
+
+/**
+ * Estimate, cell by cell, the quantiles of the numeric values of each view
+ * with the P-square algorithm (Jain and Chlamtac, 1985): five markers per
+ * cell and per quantile, whatever the number of combinations. The result
+ * of a view is a @c value::Map with one @c value::Matrix per probability
+ * (the key is the probability written with the "%g" format).
+ */
+class VLE_API QuantileReducer : public Reducer
+{
+public:
+    /**
+     * @param probabilities The probabilities in ]0, 1[ to estimate.
+     * @throw utils::ArgError if a probability is not in ]0, 1[.
+     */
+    QuantileReducer(std::vector<double> probabilities);
+    ~QuantileReducer();
+
+    void reduce(uint32_t index, std::unique_ptr<value::Map> result) override;
+    std::unique_ptr<value::Map> finish() override;
+
+private:
+    class Pimpl;
+    std::unique_ptr<Pimpl> mPimpl;
+};
+
+/**
+ * Keep only the last row of each view. The result of a view is a @c
+ * value::Matrix where the row @e i is the last row of the combination @e i
+ * (index relative to the first combination of this worker).
+ */
+class VLE_API LastRowReducer : public Reducer
+{
+public:
+    LastRowReducer();
+    ~LastRowReducer();
+
+    void start(uint32_t min, uint32_t max) override;
+    void reduce(uint32_t index, std::unique_ptr<value::Map> result) override;
+    std::unique_ptr<value::Map> finish() override;
+
+private:
+    class Pimpl;
+    std::unique_ptr<Pimpl> mPimpl;
+};
+
+/**
+ * A user-provided @c manager::Reducer built from two functors.
+ */
+class VLE_API FunctionReducer : public Reducer
+{
+public:
+    using reduce_function =
+        std::function<void(uint32_t, std::unique_ptr<value::Map>)>;
+    using finish_function = std::function<std::unique_ptr<value::Map>()>;
+
+    FunctionReducer(reduce_function reduce, finish_function finish)
+        : m_reduce(std::move(reduce))
+        , m_finish(std::move(finish))
+    {
+    }
+
+    void reduce(uint32_t index, std::unique_ptr<value::Map> result) override
+    {
+        m_reduce(index, std::move(result));
+    }
+
+    std::unique_ptr<value::Map> finish() override
+    {
+        if (m_finish)
+            return m_finish();
+
+        return {};
+    }
+
+private:
+    reduce_function m_reduce;
+    finish_function m_finish;
+};
+}
+} // namespace vle manager
+
+#endif
@@ -26,16 +26,27 @@
 
 #include <boost/progress.hpp>
 #include <boost/timer.hpp>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <vle/DllDefines.hpp>
 #include <vle/devs/RootCoordinator.hpp>
 #include <vle/manager/Simulation.hpp>
 #include <vle/utils/ContextPrivate.hpp>
+#include <vle/utils/Exception.hpp>
 #include <vle/utils/Spawn.hpp>
 #include <vle/utils/Tools.hpp>
 #include <vle/utils/i18n.hpp>
 
+#ifdef __linux__
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 namespace vle {
 namespace manager {
 
@@ -57,23 +68,216 @@ utils::Path make_temp(const char *format)
  TODO perhaps check if pointer counter is 1, and release and build the
  std::unique_ptr.
  */
+static std::unique_ptr<value::Map> parse_value(const std::string &buffer)
+{
+    auto v = vpz::Vpz::parseValue(buffer);
+    if (v and v->isMap()) {
+        return std::unique_ptr<value::Map>(new value::Map(v->toMap()));
+    }
+
+    return std::unique_ptr<value::Map>{};
+}
+
 std::unique_ptr<value::Map> read_value(const utils::Path &p)
 {
     std::ifstream ifs(p.string());
     if (ifs.is_open()) {
         std::stringstream ss;
         ss << ifs.rdbuf();
-        std::string buffer(ss.str());
 
-        auto v = vpz::Vpz::parseValue(buffer);
-        if (v and v->isMap()) {
-            return std::unique_ptr<value::Map>(new value::Map(v->toMap()));
-        }
+        return parse_value(ss.str());
     }
 
     return std::unique_ptr<value::Map>{};
 }
 
+#ifdef __linux__
+static bool write_all(int fd, const std::string &buffer)
+{
+    const char *ptr = buffer.data();
+    std::size_t size = buffer.size();
+
+    while (size > 0) {
+        ssize_t nb = ::write(fd, ptr, size);
+        if (nb < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        ptr += nb;
+        size -= nb;
+    }
+
+    return true;
+}
+
+/* Continue the simulation in the child process and send the result ('V'
+   followed by the value) or the error ('E' followed by the message) into
+   the pipe. The child leaves with _exit() to not run the destructors of the
+   objects of the parent process. */
+[[noreturn]] static void
+run_branch(devs::RootCoordinator &root, const Branch &branch, int fd)
+{
+    std::string buffer;
+    int status = EXIT_SUCCESS;
+
+    try {
+        for (const auto &event : branch)
+            root.inject(event.model, event.port, event.value);
+
+        while (root.run())
+            ;
+
+        auto result = root.finish();
+        buffer = "V";
+        if (result)
+            buffer += result->writeToXml();
+    }
+    catch (const std::exception &e) {
+        buffer = (fmt("E%1%: %2%") % utils::demangle(typeid(e)) % e.what())
+                     .str();
+        status = EXIT_FAILURE;
+    }
+
+    if (not write_all(fd, buffer))
+        status = EXIT_FAILURE;
+
+    ::close(fd);
+    ::_exit(status);
+}
+
+/* Read all the pipes until the children close them. The pipes are read
+   together to avoid a dead lock on a full pipe. */
+static void read_pipes(const std::vector<int> &fds,
+                       std::vector<std::string> &buffers)
+{
+    std::vector<pollfd> polls(fds.size());
+    for (std::size_t i = 0, e = fds.size(); i != e; ++i) {
+        polls[i].fd = fds[i];
+        polls[i].events = POLLIN;
+        polls[i].revents = 0;
+    }
+
+    std::size_t opened = fds.size();
+    char buffer[BUFSIZ];
+
+    while (opened > 0) {
+        if (::poll(polls.data(), polls.size(), -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        for (std::size_t i = 0, e = polls.size(); i != e; ++i) {
+            if (polls[i].fd < 0 or polls[i].revents == 0)
+                continue;
+
+            ssize_t nb = ::read(polls[i].fd, buffer, sizeof(buffer));
+            if (nb > 0) {
+                buffers[i].append(buffer, nb);
+            }
+            else if (nb == 0 or errno != EINTR) {
+                ::close(polls[i].fd);
+                polls[i].fd = -1;
+                --opened;
+            }
+        }
+    }
+
+    for (auto &elem : polls)
+        if (elem.fd >= 0)
+            ::close(elem.fd);
+}
+#endif
+
+/* The simulation runners accept either a complete vpz::Vpz or a
+   vpz::ExperimentInstance. The following functions hide the differences. */
+static const std::string &input_name(const std::unique_ptr<vpz::Vpz> &vpz)
+{
+    return vpz->filename();
+}
+
+static const std::string &input_name(const vpz::ExperimentInstance &instance)
+{
+    return instance.name();
+}
+
+static double input_begin(const std::unique_ptr<vpz::Vpz> &vpz)
+{
+    return vpz->project().experiment().begin();
+}
+
+static double input_begin(const vpz::ExperimentInstance &instance)
+{
+    return instance.begin();
+}
+
+static double input_duration(const std::unique_ptr<vpz::Vpz> &vpz)
+{
+    return vpz->project().experiment().duration();
+}
+
+static double input_duration(const vpz::ExperimentInstance &instance)
+{
+    return instance.duration();
+}
+
+static void input_load(devs::RootCoordinator &root,
+                       const std::unique_ptr<vpz::Vpz> &vpz)
+{
+    root.load(*vpz);
+}
+
+static void input_load(devs::RootCoordinator &root,
+                       const vpz::ExperimentInstance &instance)
+{
+    root.load(instance);
+}
+
+static void input_release(std::unique_ptr<vpz::Vpz> &vpz)
+{
+    vpz->clear();
+    vpz.reset(nullptr);
+}
+
+static void input_release(const vpz::ExperimentInstance &)
+{
+    /* The base vpz::Vpz is shared with other instances. */
+}
+
+/* An instance restored from a checkpoint: the simulation starts at the date
+   of the checkpoint. */
+struct WarmInstance {
+    const vpz::ExperimentInstance &instance;
+    const devs::Checkpoint &checkpoint;
+};
+
+static const std::string &input_name(const WarmInstance &warm)
+{
+    return warm.instance.name();
+}
+
+static double input_begin(const WarmInstance &warm)
+{
+    return warm.checkpoint.time;
+}
+
+static double input_duration(const WarmInstance &warm)
+{
+    return warm.instance.begin() + warm.instance.duration() -
+           warm.checkpoint.time;
+}
+
+static void input_load(devs::RootCoordinator &root, const WarmInstance &warm)
+{
+    root.load(warm.instance, warm.checkpoint);
+}
+
+static void input_release(const WarmInstance &)
+{
+}
+
 class Simulation::Pimpl {
 public:
     utils::ContextPtr m_context;
@@ -83,6 +287,8 @@ public:
     utils::Path m_output_file;
     LogOptions m_logoptions;
     SimulationOptions m_simulationoptions;
+    devs::RunBudget m_budget;
+    bool m_have_budget;
 
     Pimpl(utils::ContextPtr context,
           LogOptions logoptions,
@@ -96,9 +302,61 @@ public:
         , m_output_file(make_temp("vle-%%%%-%%%%-%%%%-%%%%.value"))
         , m_logoptions(logoptions)
         , m_simulationoptions(simulationoptionts)
+        , m_have_budget(false)
     {
-        if (timeout != std::chrono::milliseconds::zero())
-            m_simulationoptions |= vle::manager::SIMULATION_SPAWN_PROCESS;
+        if (timeout != std::chrono::milliseconds::zero()) {
+            if (m_simulationoptions & SIMULATION_IN_PROCESS_TIMEOUT) {
+                m_budget.wallclock = timeout;
+                m_have_budget = true;
+            } else {
+                m_simulationoptions |= vle::manager::SIMULATION_SPAWN_PROCESS;
+            }
+        }
+    }
+
+    void setBudget(const devs::RunBudget &budget)
+    {
+        m_budget = budget;
+        m_have_budget = true;
+
+        if (m_simulationoptions & SIMULATION_IN_PROCESS_TIMEOUT and
+            m_timeout != std::chrono::milliseconds::zero() and
+            (budget.wallclock == std::chrono::milliseconds::zero() or
+             budget.wallclock > m_timeout))
+            m_budget.wallclock = m_timeout;
+    }
+
+    /* The wall-clock limit starts before the loading of the models. */
+    void applyBudget(devs::RootCoordinator &root)
+    {
+        if (m_have_budget)
+            root.setBudget(m_budget);
+    }
+
+    /* Fill the error if the budget stops the simulation. */
+    void checkInterruption(devs::RootCoordinator &root, Error *error)
+    {
+        const char *reason = nullptr;
+
+        switch (root.interrupted()) {
+        case devs::Interruption::none:
+            error->code = 0;
+            return;
+        case devs::Interruption::cancelled:
+            reason = _("the simulation is cancelled");
+            break;
+        case devs::Interruption::wallclock:
+            reason = _("the simulation exceeds the timeout");
+            break;
+        case devs::Interruption::bags:
+            reason = _("the simulation exceeds the number of bags");
+            break;
+        }
+
+        error->code = ERROR_CANCELLED;
+        error->message = (fmt(_("%1% at time %2%")) % reason %
+                          root.getCurrentTime())
+                             .str();
     }
 
     template <typename T> void write(const T &t)
@@ -107,28 +365,28 @@ public:
             (*m_out) << t;
     }
 
-    std::unique_ptr<value::Map> runVerboseRun(std::unique_ptr<vpz::Vpz> vpz,
-                                              Error *error)
+    template <typename Input>
+    std::unique_ptr<value::Map> runVerboseRun(Input &vpz, Error *error)
     {
         std::unique_ptr<value::Map> result;
         boost::timer timer;
 
         try {
             devs::RootCoordinator root(m_context);
+            applyBudget(root);
 
-            const double duration = vpz->project().experiment().duration();
-            const double begin = vpz->project().experiment().begin();
+            const double duration = input_duration(vpz);
+            const double begin = input_begin(vpz);
 
-            write(fmt(_("[%1%]\n")) % vpz->filename());
+            write(fmt(_("[%1%]\n")) % input_name(vpz));
             write(_(" - Coordinator load models ......: "));
 
-            root.load(*vpz);
+            input_load(root, vpz);
 
             write(_("ok\n"));
 
             write(_(" - Clean project file ...........: "));
-            vpz->clear();
-            vpz.reset(nullptr);
+            input_release(vpz);
             write(_("ok\n"));
 
             write(_(" - Coordinator initializing .....: "));
@@ -158,37 +416,37 @@ public:
             write(fmt(_(" - Time spent in kernel .........: %1% s")) %
                   timer.elapsed());
 
-            error->code = 0;
+            checkInterruption(root, error);
         }
         catch (const std::exception &e) {
             error->message = (fmt(_("\n/!\\ vle error reported: %1%\n%2%")) %
                               utils::demangle(typeid(e)) % e.what())
                                  .str();
-            error->code = -1;
+            error->code = ERROR_FAILURE;
         }
 
         return result;
     }
 
-    std::unique_ptr<value::Map>
-    runVerboseSummary(std::unique_ptr<vpz::Vpz> vpz, Error *error)
+    template <typename Input>
+    std::unique_ptr<value::Map> runVerboseSummary(Input &vpz, Error *error)
     {
         std::unique_ptr<value::Map> result;
         boost::timer timer;
 
         try {
             devs::RootCoordinator root(m_context);
+            applyBudget(root);
 
-            write(fmt(_("[%1%]\n")) % vpz->filename());
+            write(fmt(_("[%1%]\n")) % input_name(vpz));
             write(_(" - Coordinator load models ......: "));
 
-            root.load(*vpz);
+            input_load(root, vpz);
 
             write(_("ok\n"));
 
             write(_(" - Clean project file ...........: "));
-            vpz->clear();
-            vpz.reset(nullptr);
+            input_release(vpz);
             write(_("ok\n"));
 
             write(_(" - Coordinator initializing .....: "));
@@ -208,54 +466,54 @@ public:
             write(fmt(_(" - Time spent in kernel .........: %1% s")) %
                   timer.elapsed());
 
-            error->code = 0;
+            checkInterruption(root, error);
         }
         catch (const std::exception &e) {
             error->message = (fmt(_("\n/!\\ vle error reported: %1%\n%2%")) %
                               utils::demangle(typeid(e)) % e.what())
                                  .str();
-            error->code = -1;
+            error->code = ERROR_FAILURE;
         }
 
         return result;
     }
 
-    std::unique_ptr<value::Map> runQuiet(std::unique_ptr<vpz::Vpz> vpz,
-                                         Error *error)
+    template <typename Input>
+    std::unique_ptr<value::Map> runQuiet(Input &vpz, Error *error)
     {
         std::unique_ptr<value::Map> result;
 
         try {
             devs::RootCoordinator root(m_context);
+            applyBudget(root);
 
-            root.load(*vpz);
-            vpz->clear();
-            vpz.reset(nullptr);
+            input_load(root, vpz);
+            input_release(vpz);
 
             root.init();
             while (root.run()) {
             }
             result = root.finish();
 
-            error->code = 0;
+            checkInterruption(root, error);
         }
         catch (const std::exception &e) {
             error->message = (fmt(_("\n/!\\ vle error reported: %1%\n%2%")) %
                               utils::demangle(typeid(e)) % e.what())
                                  .str();
-            error->code = -1;
+            error->code = ERROR_FAILURE;
         }
 
         return result;
     }
 
-    std::unique_ptr<value::Map> runSubProcess(std::unique_ptr<vpz::Vpz> vpz,
+    std::unique_ptr<value::Map> runSubProcess(vpz::Vpz &vpz,
                                               Error *error)
     {
         auto pwd = utils::Path::current_path();
         std::string command;
 
-        vpz->write(m_vpz_file.string());
+        vpz.write(m_vpz_file.string());
 
         try {
             m_context->get_setting("vle.command.vle.simulation", &command);
@@ -269,7 +527,7 @@ public:
             argv.erase(argv.begin());
 
             if (not spawn.start(exe, pwd.string(), argv, m_timeout)) {
-                error->code = -1;
+                error->code = ERROR_FAILURE;
                 error->message = "fail to spawn";
                 return {};
             }
@@ -277,6 +535,7 @@ public:
             std::string output, err;
             std::string message;
             bool success;
+            bool killed = false;
 
             if (m_timeout != std::chrono::milliseconds::zero()) {
                 auto duration = m_timeout;
@@ -297,6 +556,7 @@ public:
                         if (elapsed > duration) {
                             printf("kill process. Too long\n");
                             spawn.kill();
+                            killed = true;
                             break;
                         }
                     }
@@ -325,9 +585,17 @@ public:
             spawn.wait();
             spawn.status(&message, &success);
 
+            if (killed) {
+                error->code = ERROR_CANCELLED;
+                error->message = _("Simulation: the simulation exceeds the "
+                                   "timeout");
+
+                return {};
+            }
+
             if (not success and not message.empty()) {
                 vErr(m_context, "VLE failure: %s\n", message.c_str());
-                error->code = -1;
+                error->code = ERROR_FAILURE;
                 error->message = message;
 
                 return {};
@@ -344,12 +612,15 @@ public:
                  pwd.string().c_str(),
                  command.c_str());
 
-            error->code = -1;
+            error->code = ERROR_FAILURE;
             error->message = "fail to run";
         }
 
         return {};
     }
+
+    template <typename Input>
+    std::unique_ptr<value::Map> runLocal(Input &vpz, Error *error);
 };
 
 Simulation::Simulation(utils::ContextPtr context,
@@ -364,27 +635,62 @@ Simulation::Simulation(utils::ContextPtr context,
 
 Simulation::~Simulation() = default;
 
+void Simulation::setBudget(const devs::RunBudget &budget)
+{
+    mPimpl->setBudget(budget);
+}
+
+template <typename Input>
+std::unique_ptr<value::Map>
+Simulation::Pimpl::runLocal(Input &vpz, Error *error)
+{
+    if (m_logoptions != manager::LOG_NONE) {
+        if (m_logoptions & manager::LOG_RUN and m_out)
+            return runVerboseRun(vpz, error);
+        else
+            return runVerboseSummary(vpz, error);
+    }
+
+    return runQuiet(vpz, error);
+}
+
 std::unique_ptr<value::Map> Simulation::run(std::unique_ptr<vpz::Vpz> vpz,
                                             Error *error)
 {
     error->code = 0;
     std::unique_ptr<value::Map> result;
 
+    /* The simulation is headless: the graphics of the models are useless. */
+    if (vpz->project().model().node())
+        vpz->project().model().node()->clearGraphics();
+
+    if (mPimpl->m_simulationoptions & SIMULATION_SPAWN_PROCESS)
+        result = mPimpl->runSubProcess(*vpz, error);
+    else
+        result = mPimpl->runLocal(vpz, error);
+
+    if (mPimpl->m_simulationoptions & manager::SIMULATION_NO_RETURN) {
+        return {};
+    }
+    else {
+        return result;
+    }
+}
+
+std::unique_ptr<value::Map>
+Simulation::run(const vpz::ExperimentInstance &instance,
+                const devs::Checkpoint &checkpoint,
+                Error *error)
+{
+    error->code = 0;
+    std::unique_ptr<value::Map> result;
+
     if (mPimpl->m_simulationoptions & SIMULATION_SPAWN_PROCESS) {
-        result = mPimpl->runSubProcess(std::move(vpz), error);
+        result = mPimpl->runSubProcess(*instance.vpz(), error);
     }
     else {
-        if (mPimpl->m_logoptions != manager::LOG_NONE) {
-            if (mPimpl->m_logoptions & manager::LOG_RUN and mPimpl->m_out) {
-                result = mPimpl->runVerboseRun(std::move(vpz), error);
-            }
-            else {
-                result = mPimpl->runVerboseSummary(std::move(vpz), error);
-            }
-        }
-        else {
-            result = mPimpl->runQuiet(std::move(vpz), error);
-        }
+        WarmInstance warm{ instance, checkpoint };
+        result = mPimpl->runLocal(warm, error);
     }
 
     if (mPimpl->m_simulationoptions & manager::SIMULATION_NO_RETURN) {
@@ -394,5 +700,152 @@ std::unique_ptr<value::Map> Simulation::run(std::unique_ptr<vpz::Vpz> vpz,
         return result;
     }
 }
+
+std::shared_ptr<const devs::Checkpoint>
+Simulation::checkpoint(const vpz::ExperimentInstance &instance,
+                       double time,
+                       Error *error)
+{
+    error->code = 0;
+
+    try {
+        devs::RootCoordinator root(mPimpl->m_context);
+        root.load(instance);
+        root.init();
+
+        return root.checkpoint(time);
+    }
+    catch (const std::exception &e) {
+        error->message = (fmt(_("\n/!\\ vle error reported: %1%\n%2%")) %
+                          utils::demangle(typeid(e)) % e.what())
+                             .str();
+        error->code = ERROR_FAILURE;
+    }
+
+    return {};
+}
+
+std::unique_ptr<value::Map>
+Simulation::run(const vpz::ExperimentInstance &instance, Error *error)
+{
+    error->code = 0;
+    std::unique_ptr<value::Map> result;
+
+    if (mPimpl->m_simulationoptions & SIMULATION_SPAWN_PROCESS)
+        result = mPimpl->runSubProcess(*instance.vpz(), error);
+    else
+        result = mPimpl->runLocal(instance, error);
+
+    if (mPimpl->m_simulationoptions & manager::SIMULATION_NO_RETURN) {
+        return {};
+    }
+    else {
+        return result;
+    }
+}
+
+std::vector<std::unique_ptr<value::Map>>
+Simulation::branch(const vpz::ExperimentInstance &instance,
+                   double time,
+                   const std::vector<Branch> &branches,
+                   Error *error)
+{
+    error->code = 0;
+    std::vector<std::unique_ptr<value::Map>> results(branches.size());
+
+#ifdef __linux__
+    long threads = 0;
+    mPimpl->m_context->get_setting("vle.simulation.thread", &threads);
+    if (threads > 0) {
+        error->code = ERROR_FAILURE;
+        error->message = _("Branch: the parallel kernel can not be forked");
+        return results;
+    }
+
+    std::vector<pid_t> pids;
+    std::vector<int> fds;
+
+    try {
+        devs::RootCoordinator root(mPimpl->m_context);
+        root.load(instance);
+        root.init();
+        root.advance(time);
+
+        /* Flush the buffers before the fork to not write them twice. */
+        std::fflush(nullptr);
+
+        for (std::size_t i = 0, e = branches.size(); i != e; ++i) {
+            int fd[2];
+            if (::pipe(fd))
+                throw utils::InternalError(
+                    (fmt(_("Branch: pipe failed: %1%")) % strerror(errno))
+                        .str());
+
+            pid_t pid = ::fork();
+            if (pid == -1) {
+                ::close(fd[0]);
+                ::close(fd[1]);
+                throw utils::InternalError(
+                    (fmt(_("Branch: fork failed: %1%")) % strerror(errno))
+                        .str());
+            }
+
+            if (pid == 0) {
+                ::close(fd[0]);
+                for (int previous : fds)
+                    ::close(previous);
+
+                mPimpl->m_context->reset_log_after_fork();
+                run_branch(root, branches[i], fd[1]);
+            }
+
+            ::close(fd[1]);
+            pids.push_back(pid);
+            fds.push_back(fd[0]);
+        }
+    }
+    catch (const std::exception &e) {
+        error->message = (fmt(_("\n/!\\ vle error reported: %1%\n%2%")) %
+                          utils::demangle(typeid(e)) % e.what())
+                             .str();
+        error->code = ERROR_FAILURE;
+    }
+
+    std::vector<std::string> buffers(fds.size());
+    read_pipes(fds, buffers);
+
+    for (auto pid : pids) {
+        int status;
+        while (::waitpid(pid, &status, 0) == -1 and errno == EINTR)
+            ;
+    }
+
+    for (std::size_t i = 0, e = buffers.size(); i != e; ++i) {
+        if (not buffers[i].empty() and buffers[i][0] == 'V') {
+            if (buffers[i].size() > 1)
+                results[i] = parse_value(buffers[i].substr(1));
+            continue;
+        }
+
+        error->code = ERROR_FAILURE;
+        error->message += (fmt(_("Branch %1%: %2%\n")) % i %
+                           (buffers[i].empty()
+                                ? std::string(_("no result"))
+                                : buffers[i].substr(1)))
+                              .str();
+    }
+#else
+    (void)instance;
+    (void)time;
+
+    error->code = ERROR_FAILURE;
+    error->message = _("Branch: fork() is only available on Linux");
+#endif
+
+    if (mPimpl->m_simulationoptions & manager::SIMULATION_NO_RETURN)
+        return std::vector<std::unique_ptr<value::Map>>(branches.size());
+
+    return results;
+}
 }
 }
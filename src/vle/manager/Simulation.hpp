@@ -29,13 +29,33 @@
 #define VLE_MANGER_SIMULATION_HPP
 
 #include <vle/DllDefines.hpp>
+#include <vle/devs/Checkpoint.hpp>
+#include <vle/devs/RunBudget.hpp>
 #include <vle/utils/Context.hpp>
 #include <vle/manager/Types.hpp>
+#include <vle/vpz/ExperimentInstance.hpp>
 #include <vle/vpz/Vpz.hpp>
 #include <chrono>
+#include <vector>
 
 namespace vle { namespace manager {
 
+/**
+ * An external event sent to the input port of an atomic model at the
+ * beginning of a branch.
+ */
+struct VLE_API BranchEvent
+{
+    std::string model; /**< The complete name of the atomic model. */
+    std::string port; /**< The name of the input port. */
+    std::shared_ptr<value::Value> value;
+};
+
+/**
+ * The external events which define a branch of a scenario tree.
+ */
+using Branch = std::vector<BranchEvent>;
+
 /**
  * @c manager::Simulation permits to run single simulation.
  *
@@ -62,10 +82,104 @@ public:
 
     ~Simulation();
 
+    /**
+     * Limit the next simulations: the kernel checks the budget between
+     * the bags. A simulation stopped by the budget returns the results
+     * until the date of the interruption and the @c ERROR_CANCELLED error
+     * code.
+     *
+     * With the @e SIMULATION_IN_PROCESS_TIMEOUT option, the timeout of
+     * the constructor is the wall-clock limit (if it is lower than the
+     * one of the budget). The budget is not available with the @e
+     * SIMULATION_SPAWN_PROCESS option, where the process which exceeds
+     * the timeout is killed: the error code is @c ERROR_CANCELLED too
+     * but there is no result.
+     *
+     * @param budget The limits of the simulations.
+     */
+    void setBudget(const devs::RunBudget &budget);
+
     std::unique_ptr<value::Map>
         run(std::unique_ptr<vpz::Vpz> vpz,
             Error *error);
 
+    /**
+     * Run the simulation of a combination of an experimental frame. The
+     * base @e vpz::Vpz of the instance is not modified and can be shared
+     * between several threads.
+     *
+     * @param instance The combination to simulate.
+     * @param[out] error Filled with the error if any.
+     */
+    std::unique_ptr<value::Map>
+        run(const vpz::ExperimentInstance &instance,
+            Error *error);
+
+    /**
+     * Run the simulation of a combination of an experimental frame from a
+     * checkpoint (a warm start): the models are built with the conditions
+     * of the instance, their states are restored from the checkpoint and
+     * the simulation starts at the date of the checkpoint.
+     *
+     * With the @e SIMULATION_SPAWN_PROCESS option, the checkpoint can not
+     * be sent to the sub-process and the complete simulation is run.
+     *
+     * @param instance The combination to simulate.
+     * @param checkpoint The snapshot of the common prefix.
+     * @param[out] error Filled with the error if any.
+     */
+    std::unique_ptr<value::Map>
+        run(const vpz::ExperimentInstance &instance,
+            const devs::Checkpoint &checkpoint,
+            Error *error);
+
+    /**
+     * Run the simulation of a combination until @e time (always in this
+     * process) and build a snapshot of the models.
+     *
+     * @param instance The combination to simulate.
+     * @param time The date of the snapshot.
+     * @param[out] error Filled with the error if any (for example, a
+     * model without the @e devs::Dynamics::serialize function).
+     *
+     * @return The snapshot or a null pointer if an error occurred.
+     */
+    std::shared_ptr<const devs::Checkpoint>
+        checkpoint(const vpz::ExperimentInstance &instance,
+                   double time,
+                   Error *error);
+
+    /**
+     * Run the simulation of a combination until @e time then @e fork() a
+     * child process per branch. Each child sends the events of its branch
+     * and continues the simulation. The memory of the common prefix is
+     * shared copy-on-write by the children and the models do not need the
+     * @e devs::Dynamics::serialize function. The results are sent back
+     * through pipes in the XML value format.
+     *
+     * Only available on Linux and with the sequential kernel (the @e
+     * vle.simulation.thread setting equals 0). An asynchronous log
+     * function is replaced by a synchronous one in the children (see @c
+     * utils::Context::reset_log_after_fork).
+     *
+     * The output plug-ins are opened before the fork: the plug-ins which
+     * write files (for example @e vle.output/file) of the sibling branches
+     * write into the same files. Use plug-ins which store the results in
+     * memory (@e vle.output/storage).
+     *
+     * @param instance The combination to simulate.
+     * @param time The date of the branching.
+     * @param branches The events of each branch.
+     * @param[out] error Filled with the errors if any.
+     *
+     * @return A result per branch (null if the branch failed).
+     */
+    std::vector<std::unique_ptr<value::Map>>
+        branch(const vpz::ExperimentInstance &instance,
+               double time,
+               const std::vector<Branch> &branches,
+               Error *error);
+
 private:
     class Pimpl;
     std::unique_ptr<Pimpl> mPimpl;
@@ -79,6 +79,17 @@ struct Error
     std::string message;
 };
 
+/**
+ * The codes of the @c vle::manager::Error.
+ */
+enum ErrorCode {
+    ERROR_NONE      = 0,  /**< No error. */
+    ERROR_FAILURE   = -1, /**< The simulation fails. */
+    ERROR_CANCELLED = -2  /**< The simulation is stopped by a timeout, a
+                           * budget or a cancellation token: the results
+                           * are partial. */
+};
+
 /**
  * Defines the type of log
  *
@@ -99,7 +110,11 @@ enum SimulationOptions {
     SIMULATION_NONE          = 0, /**< Default option. */
     SIMULATION_SPAWN_PROCESS = 1 << 0, /**< Launch the simulation in a
                                         * subprocess.  */
-    SIMULATION_NO_RETURN     = 1 << 1 /**< The simulation result are empty. */
+    SIMULATION_NO_RETURN     = 1 << 1, /**< The simulation result are empty. */
+    SIMULATION_IN_PROCESS_TIMEOUT = 1 << 2 /**< Check the timeout between
+                                            * the bags of the simulation
+                                            * instead of launching a
+                                            * subprocess. */
 };
 
 inline LogOptions operator|(LogOptions lhs, LogOptions rhs)
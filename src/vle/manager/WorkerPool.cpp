@@ -0,0 +1,491 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/manager/WorkerPool.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Tools.hpp>
+#include <vle/utils/i18n.hpp>
+#include <vle/vpz/Vpz.hpp>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#ifdef __linux__
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace vle {
+namespace manager {
+
+#ifdef __linux__
+
+namespace {
+
+bool write_all(int fd, const void *data, std::size_t size)
+{
+    auto *ptr = static_cast<const char *>(data);
+
+    while (size > 0) {
+        ssize_t nb = ::send(fd, ptr, size, MSG_NOSIGNAL);
+        if (nb < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        ptr += nb;
+        size -= nb;
+    }
+
+    return true;
+}
+
+enum class ReadStatus { success, closed, timeout, cancelled };
+
+/* The period of the check of the cancellation token while a worker
+   runs. */
+const int cancellation_period = 50;
+
+/* Read @e size bytes before the @e deadline or without limit if the
+   deadline is the maximum of the clock. The read stops if the @e token
+   (if any) is cancelled. */
+ReadStatus read_all(int fd,
+                    void *data,
+                    std::size_t size,
+                    std::chrono::steady_clock::time_point deadline =
+                        std::chrono::steady_clock::time_point::max(),
+                    const devs::CancellationToken *token = nullptr)
+{
+    auto *ptr = static_cast<char *>(data);
+
+    while (size > 0) {
+        if (token and token->cancelled())
+            return ReadStatus::cancelled;
+
+        int wait = -1;
+        if (deadline != std::chrono::steady_clock::time_point::max()) {
+            auto remaining =
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0)
+                return ReadStatus::timeout;
+            wait = static_cast<int>(remaining.count());
+        }
+
+        if (token and (wait < 0 or wait > cancellation_period))
+            wait = cancellation_period;
+
+        pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+
+        int ret = ::poll(&pfd, 1, wait);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            return ReadStatus::closed;
+        }
+
+        if (ret == 0) {
+            if (std::chrono::steady_clock::now() >= deadline)
+                return ReadStatus::timeout;
+            continue;
+        }
+
+        ssize_t nb = ::read(fd, ptr, size);
+        if (nb < 0) {
+            if (errno == EINTR)
+                continue;
+            return ReadStatus::closed;
+        }
+
+        if (nb == 0)
+            return ReadStatus::closed;
+
+        ptr += nb;
+        size -= nb;
+    }
+
+    return ReadStatus::success;
+}
+
+/* Send the @e pid of a worker and its socket @e fd (if positive) with the
+   SCM_RIGHTS ancillary data. */
+bool send_worker(int sock, int pid, int fd)
+{
+    msghdr msg;
+    iovec iov;
+    char control[CMSG_SPACE(sizeof(int))];
+
+    std::memset(&msg, 0, sizeof(msg));
+    std::memset(control, 0, sizeof(control));
+
+    iov.iov_base = &pid;
+    iov.iov_len = sizeof(pid);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    if (fd >= 0) {
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+    }
+
+    for (;;) {
+        ssize_t nb = ::sendmsg(sock, &msg, MSG_NOSIGNAL);
+        if (nb < 0 and errno == EINTR)
+            continue;
+        return nb == static_cast<ssize_t>(sizeof(pid));
+    }
+}
+
+bool receive_worker(int sock, int *pid, int *fd)
+{
+    msghdr msg;
+    iovec iov;
+    char control[CMSG_SPACE(sizeof(int))];
+
+    std::memset(&msg, 0, sizeof(msg));
+    iov.iov_base = pid;
+    iov.iov_len = sizeof(*pid);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t nb;
+    do {
+        nb = ::recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+    } while (nb < 0 and errno == EINTR);
+
+    if (nb != static_cast<ssize_t>(sizeof(*pid)))
+        return false;
+
+    *fd = -1;
+    for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg;
+         cmsg = CMSG_NXTHDR(&msg, cmsg))
+        if (cmsg->cmsg_level == SOL_SOCKET and cmsg->cmsg_type == SCM_RIGHTS)
+            std::memcpy(fd, CMSG_DATA(cmsg), sizeof(int));
+
+    return *pid > 0 and *fd >= 0;
+}
+
+bool write_string(int fd, const std::string &str)
+{
+    const uint64_t size = str.size();
+
+    return write_all(fd, &size, sizeof(size)) and
+           write_all(fd, str.data(), str.size());
+}
+
+ReadStatus read_string(int fd,
+                       std::string &str,
+                       std::chrono::steady_clock::time_point deadline,
+                       const devs::CancellationToken *token)
+{
+    uint64_t size = 0;
+    auto status = read_all(fd, &size, sizeof(size), deadline, token);
+    if (status != ReadStatus::success)
+        return status;
+
+    str.resize(size);
+    return read_all(fd, &str[0], size, deadline, token);
+}
+
+/* Run the jobs read from the socket until the pool closes it. The answer
+   is the error code, the error message and the XML result (partial if the
+   simulation is cancelled). The process leaves with _exit() to not run the
+   destructors of the objects of the parent process. */
+[[noreturn]] void worker_loop(int fd, const WorkerPool::job_type &job)
+{
+    for (;;) {
+        uint32_t index;
+        if (read_all(fd, &index, sizeof(index)) != ReadStatus::success)
+            ::_exit(EXIT_SUCCESS);
+
+        std::string message, xml;
+        int32_t code = 0;
+
+        try {
+            Error error;
+            auto result = job(index, &error);
+
+            code = error.code;
+            message = error.message;
+            if (result)
+                xml = result->writeToXml();
+        } catch (const std::exception &e) {
+            code = ERROR_FAILURE;
+            message =
+                (fmt("%1%: %2%") % utils::demangle(typeid(e)) % e.what()).str();
+        }
+
+        if (not write_all(fd, &code, sizeof(code)) or
+            not write_string(fd, message) or not write_string(fd, xml))
+            ::_exit(EXIT_FAILURE);
+    }
+}
+
+/* The zygote forks a worker for each byte read from the socket and sends
+   back its pid and its socket. The workers are reaped by the system. */
+[[noreturn]] void zygote_loop(int sock, const WorkerPool::job_type &job)
+{
+    ::signal(SIGCHLD, SIG_IGN);
+
+    for (;;) {
+        char request;
+        if (read_all(sock, &request, 1) != ReadStatus::success)
+            ::_exit(EXIT_SUCCESS);
+
+        int sv[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+            if (not send_worker(sock, -1, -1))
+                ::_exit(EXIT_FAILURE);
+            continue;
+        }
+
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            ::signal(SIGCHLD, SIG_DFL);
+            ::close(sock);
+            ::close(sv[0]);
+            worker_loop(sv[1], job);
+        }
+
+        ::close(sv[1]);
+        bool sent = send_worker(sock, pid, pid > 0 ? sv[0] : -1);
+        ::close(sv[0]);
+
+        if (not sent)
+            ::_exit(EXIT_FAILURE);
+    }
+}
+
+} // anonymous namespace
+
+WorkerPool::WorkerPool(utils::ContextPtr context,
+                       job_type job,
+                       std::chrono::milliseconds timeout)
+    : m_job(std::move(job))
+    , m_timeout(timeout)
+    , m_recycled(0)
+    , m_zygote_pid(-1)
+    , m_zygote_fd(-1)
+{
+    int sv[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) < 0)
+        throw utils::InternalError(
+            _("Worker pool: fail to build the socket of the zygote: %s"),
+            std::strerror(errno));
+
+    pid_t pid = ::fork();
+    if (pid < 0) {
+        ::close(sv[0]);
+        ::close(sv[1]);
+        throw utils::InternalError(
+            _("Worker pool: fail to fork the zygote: %s"),
+            std::strerror(errno));
+    }
+
+    if (pid == 0) {
+        ::close(sv[0]);
+        context->reset_log_after_fork();
+        zygote_loop(sv[1], m_job);
+    }
+
+    ::close(sv[1]);
+    m_zygote_pid = pid;
+    m_zygote_fd = sv[0];
+}
+
+WorkerPool::~WorkerPool()
+{
+    for (auto &worker : m_idle)
+        ::close(worker.fd);
+
+    ::close(m_zygote_fd);
+
+    int status;
+    while (::waitpid(m_zygote_pid, &status, 0) < 0 and errno == EINTR)
+        ;
+}
+
+bool WorkerPool::acquire(Worker *worker)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (not m_idle.empty()) {
+        *worker = m_idle.back();
+        m_idle.pop_back();
+        return true;
+    }
+
+    const char request = 'F';
+    if (not write_all(m_zygote_fd, &request, 1))
+        return false;
+
+    return receive_worker(m_zygote_fd, &worker->pid, &worker->fd);
+}
+
+void WorkerPool::release(const Worker &worker)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_idle.push_back(worker);
+}
+
+void WorkerPool::discard(const Worker &worker, bool kill)
+{
+    if (kill)
+        ::kill(worker.pid, SIGKILL);
+
+    ::close(worker.fd);
+    ++m_recycled;
+}
+
+std::unique_ptr<value::Map> WorkerPool::run(uint32_t index,
+                                            Error *error,
+                                            const devs::CancellationToken *token)
+{
+    error->code = 0;
+    error->message.clear();
+
+    Worker worker;
+    if (not acquire(&worker)) {
+        error->code = ERROR_FAILURE;
+        error->message = _("Worker pool: fail to start a worker process");
+        return {};
+    }
+
+    auto deadline = std::chrono::steady_clock::time_point::max();
+    if (m_timeout != std::chrono::milliseconds::zero())
+        deadline = std::chrono::steady_clock::now() + m_timeout;
+
+    int32_t code = 0;
+    std::string message, xml;
+
+    auto status = ReadStatus::closed;
+    if (write_all(worker.fd, &index, sizeof(index))) {
+        status = read_all(worker.fd, &code, sizeof(code), deadline, token);
+
+        if (status == ReadStatus::success)
+            status = read_string(worker.fd, message, deadline, token);
+
+        if (status == ReadStatus::success)
+            status = read_string(worker.fd, xml, deadline, token);
+    }
+
+    if (status == ReadStatus::cancelled) {
+        discard(worker, true);
+        error->code = ERROR_CANCELLED;
+        error->message =
+            (fmt(_("Worker pool: the simulation %1% is cancelled")) % index)
+                .str();
+        return {};
+    }
+
+    if (status == ReadStatus::timeout) {
+        discard(worker, true);
+        error->code = ERROR_CANCELLED;
+        error->message =
+            (fmt(_("Worker pool: the simulation %1% exceeds the timeout")) %
+             index)
+                .str();
+        return {};
+    }
+
+    if (status == ReadStatus::closed) {
+        discard(worker, true);
+        error->code = ERROR_FAILURE;
+        error->message =
+            (fmt(_("Worker pool: the worker of the simulation %1% crashed")) %
+             index)
+                .str();
+        return {};
+    }
+
+    release(worker);
+
+    error->code = code;
+    error->message = message;
+
+    if (xml.empty())
+        return {};
+
+    try {
+        auto value = vpz::Vpz::parseValue(xml);
+        if (value and value->isMap())
+            return std::unique_ptr<value::Map>(
+                new value::Map(value->toMap()));
+    } catch (const std::exception &e) {
+        error->code = ERROR_FAILURE;
+        error->message = e.what();
+    }
+
+    return {};
+}
+
+#else
+
+WorkerPool::WorkerPool(utils::ContextPtr /*context*/,
+                       job_type job,
+                       std::chrono::milliseconds timeout)
+    : m_job(std::move(job))
+    , m_timeout(timeout)
+    , m_recycled(0)
+    , m_zygote_pid(-1)
+    , m_zygote_fd(-1)
+{
+    throw utils::InternalError(_("Worker pool: only available on Linux"));
+}
+
+WorkerPool::~WorkerPool() = default;
+
+std::unique_ptr<value::Map>
+WorkerPool::run(uint32_t, Error *error, const devs::CancellationToken *)
+{
+    error->code = ERROR_FAILURE;
+    error->message = _("Worker pool: only available on Linux");
+
+    return {};
+}
+
+#endif
+}
+} // namespace vle manager
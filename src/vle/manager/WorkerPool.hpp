@@ -0,0 +1,159 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_MANAGER_WORKERPOOL_HPP
+#define VLE_MANAGER_WORKERPOOL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <vle/DllDefines.hpp>
+#include <vle/devs/RunBudget.hpp>
+#include <vle/manager/Types.hpp>
+#include <vle/utils/Context.hpp>
+#include <vle/value/Map.hpp>
+
+namespace vle {
+namespace manager {
+
+/**
+ * @c manager::WorkerPool runs simulations in long-lived sandbox processes.
+ *
+ * The constructor @e fork() a zygote process which is a copy of the
+ * caller: the experimental frame, the checkpoint and the loaded packages
+ * are shared copy-on-write. The zygote forks a worker process when a
+ * caller does not find an idle worker. A worker reads the index of a
+ * combination from its socket, calls the job and writes back the result
+ * in the XML value format. The processes do not exec a new @e vle and the
+ * vpz is never written nor parsed.
+ *
+ * A worker which crashes or exceeds the timeout is killed and replaced at
+ * the next call of run(). The run() function can be called by several
+ * threads, each call uses its own worker.
+ *
+ * fork() copies only the calling thread: no other thread may exist when
+ * the constructor is called, the threads which use the pool must be
+ * started after. The only exception is the background thread of an
+ * asynchronous log (utils::Context::set_log_asynchronous()): the zygote
+ * replaces it by the synchronous log function of the @e context. Only
+ * available on Linux.
+ *
+ * @code
+ * manager::WorkerPool pool(
+ *     ctx,
+ *     [&expgen, &ctx](uint32_t index, manager::Error *error) {
+ *         manager::Simulation sim(ctx, manager::LOG_NONE,
+ *                                 manager::SIMULATION_NONE,
+ *                                 std::chrono::milliseconds(0), nullptr);
+ *         return sim.run(expgen.instance(index), error);
+ *     }, std::chrono::milliseconds(1000));
+ *
+ * manager::Error error;
+ * auto result = pool.run(0, &error);
+ * @endcode
+ */
+class VLE_API WorkerPool
+{
+public:
+    using job_type =
+        std::function<std::unique_ptr<value::Map>(uint32_t, Error *)>;
+
+    /**
+     * Build the zygote process.
+     *
+     * @param context The context of the jobs, its log function is made
+     * synchronous in the zygote and the workers.
+     * @param job The function called by the workers.
+     * @param timeout The maximum duration of a job, 0 for no limit.
+     *
+     * @throw utils::InternalError if the zygote can not be built.
+     */
+    WorkerPool(utils::ContextPtr context,
+               job_type job,
+               std::chrono::milliseconds timeout);
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    /**
+     * Close the sockets: the zygote and the workers leave.
+     */
+    ~WorkerPool();
+
+    /**
+     * Run the job @e index in a worker.
+     *
+     * @param index The parameter of the job.
+     * @param[out] error Filled with the error of the job, the crash of
+     * the worker (@c ERROR_FAILURE), the timeout or the cancellation (@c
+     * ERROR_CANCELLED, without result since the worker is killed).
+     * @param token A token checked while the worker runs. The worker
+     * process is a copy and never sees the cancellation of a token of the
+     * caller: the pool kills it instead.
+     *
+     * @return The result of the job or a null pointer.
+     */
+    std::unique_ptr<value::Map>
+    run(uint32_t index,
+        Error *error,
+        const devs::CancellationToken *token = nullptr);
+
+    /**
+     * Get the number of workers killed or crashed since the construction.
+     */
+    uint64_t recycled() const noexcept
+    {
+        return m_recycled.load();
+    }
+
+private:
+    struct Worker
+    {
+        int pid;
+        int fd;
+    };
+
+    bool acquire(Worker *worker);
+    void release(const Worker &worker);
+    void discard(const Worker &worker, bool kill);
+
+    job_type m_job;
+    std::chrono::milliseconds m_timeout;
+    std::mutex m_mutex;
+    std::vector<Worker> m_idle;
+    std::atomic<uint64_t> m_recycled;
+    int m_zygote_pid;
+    int m_zygote_fd;
+};
+}
+} // namespace vle manager
+
+#endif
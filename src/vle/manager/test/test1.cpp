@@ -25,10 +25,25 @@
  */
 
 #include <boost/lexical_cast.hpp>
+#include <csignal>
+#include <cstdarg>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <stdexcept>
+#include <thread>
+#include <vle/devs/Dynamics.hpp>
+#include <vle/devs/RunBudget.hpp>
 #include <vle/manager/ExperimentGenerator.hpp>
 #include <vle/manager/Manager.hpp>
+#include <vle/manager/Plan.hpp>
+#include <vle/manager/Reducer.hpp>
+#include <vle/manager/Simulation.hpp>
+#include <vle/manager/WorkerPool.hpp>
+#include <vle/oov/Plugin.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Filesystem.hpp>
 #include <vle/utils/unit-test.hpp>
 #include <vle/value/Boolean.hpp>
 #include <vle/value/Double.hpp>
@@ -46,6 +61,7 @@
 #include <vle/value/XML.hpp>
 #include <vle/vle.hpp>
 #include <vle/vpz/BaseModel.hpp>
+#include <vle/vpz/ExperimentInstance.hpp>
 #include <vle/vpz/Vpz.hpp>
 
 using namespace vle;
@@ -220,6 +236,847 @@ void experimentgenerator_max_1_max_1()
     EnsuresEqual(expgen1.size(), 7);
 }
 
+void experimentgenerator_instance()
+{
+    auto vpz = std::make_shared<vpz::Vpz>();
+    vpz->parseMemory(xml);
+
+    vpz::Condition &cnd1(
+        vpz->project().experiment().conditions().get("cond1"));
+    cnd1.clearValueOfPort("init1");
+    for (int i = 0; i < 5; ++i)
+        cnd1.addValueToPort("init1", value::Double::create(i));
+    cnd1.clearValueOfPort("init2");
+    cnd1.addValueToPort("init2", value::Double::create(42));
+
+    vpz::Condition &cnd2(
+        vpz->project().experiment().conditions().get("cond2"));
+    cnd2.permanent();
+    cnd2.clearValueOfPort("init3");
+    for (int i = 4; i >= 0; --i)
+        cnd2.addValueToPort("init3", value::Double::create(i));
+    cnd2.clearValueOfPort("init4");
+    cnd2.addValueToPort("init4", value::Double::create(7));
+
+    manager::ExperimentGenerator expgen(
+        std::shared_ptr<const vpz::Vpz>(vpz), 0, 1);
+    EnsuresEqual(expgen.size(), 5);
+
+    auto instance = expgen.instance(3);
+    EnsuresEqual(instance.index(), 3);
+    EnsuresEqual(instance.name(), "test1-3");
+    EnsuresEqual(&instance.base(), vpz.get());
+    EnsuresEqual(instance.value("cond1", "init1")->toDouble().value(), 3.0);
+    EnsuresEqual(instance.value("cond2", "init3")->toDouble().value(), 1.0);
+
+    /* Values are shared, not cloned, with the base. */
+    EnsuresEqual(instance.value("cond1", "init2").get(),
+                 cnd1.getSetValues("init2")[0].get());
+
+    auto exp = instance.experiment();
+    EnsuresEqual(exp.name(), "test1-3");
+    EnsuresEqual(
+        exp.conditions().get("cond1").getSetValues("init1").size(), 1);
+    EnsuresEqual(exp.conditions()
+                     .get("cond1")
+                     .getSetValues("init1")[0]
+                     ->toDouble()
+                     .value(),
+                 3.0);
+    Ensures(not exp.conditions().get("cond1").isPermanent());
+    Ensures(exp.conditions().get("cond2").isPermanent());
+    EnsuresEqual(instance.duration(), vpz->project().experiment().duration());
+
+    /* The base is never modified. */
+    EnsuresEqual(cnd1.getSetValues("init1").size(), 5);
+    EnsuresEqual(vpz->project().experiment().name(), "test1");
+
+    auto file = instance.vpz();
+    EnsuresEqual(file->project().instance(), 3);
+    EnsuresEqual(file->project().experiment().name(), "test1-3");
+
+    EnsuresThrow(instance.overlay("cond1", "unknown", value::Null::create()),
+                 utils::ArgError);
+}
+
+void plan_total()
+{
+    auto vpz = std::make_shared<vpz::Vpz>();
+    vpz->parseMemory(xml);
+    vpz->project().experiment().setCombination("total");
+
+    vpz::Conditions &cnds(vpz->project().experiment().conditions());
+    vpz::Condition &cnd1(cnds.get("cond1"));
+    vpz::Condition &cnd2(cnds.get("cond2"));
+    cnd1.clearValueOfPort("init1");
+    cnd1.clearValueOfPort("init2");
+    cnd2.clearValueOfPort("init3");
+    cnd2.clearValueOfPort("init4");
+    for (int i = 0; i < 3; ++i)
+        cnd1.addValueToPort("init1", value::Integer::create(i));
+    cnd1.addValueToPort("init2", value::Integer::create(0));
+    for (int i = 0; i < 4; ++i)
+        cnd2.addValueToPort("init3", value::Integer::create(i));
+    cnd2.addValueToPort("init4", value::Integer::create(0));
+
+    manager::ExperimentGenerator expgen(
+        std::shared_ptr<const vpz::Vpz>(vpz), 1, 2);
+    EnsuresEqual(expgen.size(), 12);
+    EnsuresEqual(expgen.min(), 6);
+    EnsuresEqual(expgen.max(), 12);
+
+    for (uint32_t i = 0; i < 12; ++i) {
+        auto instance = expgen.instance(i);
+        EnsuresEqual(instance.value("cond1", "init1")->toInteger().value(),
+                     static_cast<int>(i / 4));
+        EnsuresEqual(instance.value("cond2", "init3")->toInteger().value(),
+                     static_cast<int>(i % 4));
+    }
+
+    vpz::Conditions conds;
+    expgen.get(7, &conds);
+    EnsuresEqual(
+        conds.get("cond2").getSetValues("init3")[0]->toInteger().value(), 3);
+}
+
+void plan_latin_hypercube()
+{
+    auto vpz = std::make_shared<vpz::Vpz>();
+    vpz->parseMemory(xml);
+    vpz->project().experiment().setCombination("lhs");
+
+    vpz::Conditions &cnds(vpz->project().experiment().conditions());
+    cnds.get(vpz::Experiment::defaultSimulationEngineCondName())
+        .setValueToPort("samples", value::Integer::create(50));
+    vpz::Condition &cnd1(cnds.get("cond1"));
+    cnd1.clearValueOfPort("init2");
+    cnd1.addValueToPort("init2", value::Double::create(1));
+    vpz::Condition &cnd2(cnds.get("cond2"));
+    cnd2.clearValueOfPort("init3");
+    cnd2.clearValueOfPort("init4");
+    cnd2.addValueToPort("init3", value::Double::create(-10.0));
+    cnd2.addValueToPort("init3", value::Double::create(10.0));
+    cnd2.addValueToPort("init4", value::Double::create(0));
+
+    /* init1 has the values 123.0 and 1: the interval [123, 1]. */
+    manager::ExperimentGenerator expgen(
+        std::shared_ptr<const vpz::Vpz>(vpz), 0, 1);
+    EnsuresEqual(expgen.size(), 50);
+
+    std::vector<int> strata1(50, 0), strata3(50, 0);
+    for (uint32_t i = 0; i < 50; ++i) {
+        auto instance = expgen.instance(i);
+        double x1 = instance.value("cond1", "init1")->toDouble().value();
+        double x3 = instance.value("cond2", "init3")->toDouble().value();
+
+        Ensures(x1 <= 123.0 and x1 > 1.0);
+        Ensures(x3 >= -10.0 and x3 < 10.0);
+        strata1[static_cast<int>((123.0 - x1) / 122.0 * 50)]++;
+        strata3[static_cast<int>((x3 + 10.0) / 20.0 * 50)]++;
+    }
+
+    for (int i = 0; i < 50; ++i) {
+        EnsuresEqual(strata1[i], 1);
+        EnsuresEqual(strata3[i], 1);
+    }
+
+    cnd1.addValueToPort("init1", value::Double::create(2));
+    EnsuresThrow(manager::Plan::create(*vpz), utils::ArgError);
+}
+
+void plan_saltelli()
+{
+    EnsuresEqual(manager::SaltelliPlan::sobol(0, 0), 0.0);
+    EnsuresEqual(manager::SaltelliPlan::sobol(1, 0), 0.5);
+    EnsuresEqual(manager::SaltelliPlan::sobol(2, 0), 0.25);
+    EnsuresEqual(manager::SaltelliPlan::sobol(3, 0), 0.75);
+    EnsuresEqual(manager::SaltelliPlan::sobol(2, 1), 0.75);
+
+    /* The 2^m first points of each dimension are stratified and the two
+       first dimensions are a (0, m, 2)-net. */
+    for (uint32_t d = 0; d < 20; ++d) {
+        std::vector<int> strata(64, 0);
+        for (uint32_t i = 0; i < 64; ++i) {
+            double x = manager::SaltelliPlan::sobol(i, d);
+            strata[static_cast<int>(x * 64)]++;
+        }
+
+        for (int i = 0; i < 64; ++i)
+            EnsuresEqual(strata[i], 1);
+    }
+
+    std::vector<int> boxes(64, 0);
+    for (uint32_t i = 0; i < 64; ++i) {
+        int x = manager::SaltelliPlan::sobol(i, 0) * 8;
+        int y = manager::SaltelliPlan::sobol(i, 1) * 8;
+        boxes[x * 8 + y]++;
+    }
+    for (int i = 0; i < 64; ++i)
+        EnsuresEqual(boxes[i], 1);
+
+    std::vector<manager::PlanContinuousFactor> factors = {
+        { "cond1", "init1", 0.0, 1.0 }, { "cond2", "init3", 10.0, 20.0 }
+    };
+    manager::SaltelliPlan plan(factors, 8);
+    EnsuresEqual(plan.size(), 32);
+
+    for (uint32_t j = 0; j < 8; ++j) {
+        uint32_t base = j * 4;
+        /* A */
+        EnsuresEqual(plan.unit(base, 0), manager::SaltelliPlan::sobol(j, 0));
+        EnsuresEqual(plan.unit(base, 1), manager::SaltelliPlan::sobol(j, 1));
+        /* AB_0 */
+        EnsuresEqual(plan.unit(base + 1, 0),
+                     manager::SaltelliPlan::sobol(j, 2));
+        EnsuresEqual(plan.unit(base + 1, 1),
+                     manager::SaltelliPlan::sobol(j, 1));
+        /* AB_1 */
+        EnsuresEqual(plan.unit(base + 2, 0),
+                     manager::SaltelliPlan::sobol(j, 0));
+        EnsuresEqual(plan.unit(base + 2, 1),
+                     manager::SaltelliPlan::sobol(j, 3));
+        /* B */
+        EnsuresEqual(plan.unit(base + 3, 0),
+                     manager::SaltelliPlan::sobol(j, 2));
+        EnsuresEqual(plan.unit(base + 3, 1),
+                     manager::SaltelliPlan::sobol(j, 3));
+    }
+
+    std::vector<manager::PlanContinuousFactor> many(11, factors[0]);
+    EnsuresThrow(manager::SaltelliPlan p(many, 8), utils::ArgError);
+}
+
+std::unique_ptr<value::Map> make_simulation_result(double x)
+{
+    auto matrix = std::unique_ptr<value::Matrix>(
+        new value::Matrix(2, 3, 2, 3, 1, 1));
+
+    matrix->add(0, 0, value::String::create("time"));
+    matrix->add(1, 0, value::String::create("top:A.x"));
+    for (int i = 1; i < 3; ++i) {
+        matrix->add(0, i, value::Double::create(i));
+        matrix->add(1, i, value::Double::create(x * i));
+    }
+
+    auto result = std::unique_ptr<value::Map>(new value::Map());
+    result->add("view", std::move(matrix));
+
+    return result;
+}
+
+void reducer_mean_variance()
+{
+    manager::MeanVarianceReducer reducer;
+    reducer.start(0, 101);
+
+    for (int i = 0; i <= 100; ++i)
+        reducer.reduce(i, make_simulation_result(i));
+
+    auto result = reducer.finish();
+    Ensures(result);
+
+    const auto &view = result->getMap("view");
+    const auto &mean = view.getMatrix("mean");
+    const auto &variance = view.getMatrix("variance");
+    const auto &count = view.getMatrix("count");
+
+    EnsuresEqual(mean.getString(1, 0), "top:A.x");
+    EnsuresApproximatelyEqual(mean.getDouble(0, 1), 1.0, 1e-8);
+    EnsuresApproximatelyEqual(mean.getDouble(1, 1), 50.0, 1e-8);
+    EnsuresApproximatelyEqual(mean.getDouble(1, 2), 100.0, 1e-8);
+    EnsuresApproximatelyEqual(variance.getDouble(0, 1), 0.0, 1e-8);
+    EnsuresApproximatelyEqual(variance.getDouble(1, 1), 858.5, 1e-8);
+    EnsuresEqual(count.getInt(1, 2), 101);
+}
+
+void reducer_min_max_quantile()
+{
+    manager::MinMaxReducer minmax;
+    manager::QuantileReducer quantile({ 0.5, 0.9 });
+
+    minmax.start(0, 1001);
+    quantile.start(0, 1001);
+
+    for (int i = 0; i <= 1000; ++i) {
+        double x = (i * 7919) % 1001;
+        minmax.reduce(i, make_simulation_result(x));
+        quantile.reduce(i, make_simulation_result(x));
+    }
+
+    auto result = minmax.finish();
+    EnsuresApproximatelyEqual(
+        result->getMap("view").getMatrix("min").getDouble(1, 1), 0.0, 1e-8);
+    EnsuresApproximatelyEqual(
+        result->getMap("view").getMatrix("max").getDouble(1, 1), 1000.0, 1e-8);
+
+    result = quantile.finish();
+    EnsuresApproximatelyEqual(
+        result->getMap("view").getMatrix("0.5").getDouble(1, 1), 500.0, 10.0);
+    EnsuresApproximatelyEqual(
+        result->getMap("view").getMatrix("0.9").getDouble(1, 1), 900.0, 10.0);
+
+    std::vector<double> bad = { 0.5, 1.5 };
+    EnsuresThrow(manager::QuantileReducer q(bad), utils::ArgError);
+}
+
+void reducer_last_row()
+{
+    manager::LastRowReducer reducer;
+    reducer.start(10, 15);
+
+    for (int i = 10; i < 15; ++i)
+        reducer.reduce(i, make_simulation_result(i));
+
+    auto result = reducer.finish();
+    const auto &matrix = result->getMatrix("view");
+
+    EnsuresEqual(matrix.columns(), 2);
+    EnsuresEqual(matrix.rows(), 5);
+    EnsuresApproximatelyEqual(matrix.getDouble(0, 0), 2.0, 1e-8);
+    EnsuresApproximatelyEqual(matrix.getDouble(1, 4), 28.0, 1e-8);
+}
+
+/* A model of the experimental frame of the manager tests: its observation
+ * is a straight line through the origin of the slope read from the
+ * conditions. */
+class Linear : public devs::Dynamics
+{
+public:
+    Linear(const devs::DynamicsInit &init, const devs::InitEventList &events)
+        : devs::Dynamics(init, events)
+        , m_slope(events.getDouble("slope"))
+    {
+    }
+
+    /* A bag per unit of time: the budget of the manager is checked
+     * between two bags. */
+    virtual devs::Time init(devs::Time /*time*/) override { return 1.0; }
+
+    virtual devs::Time timeAdvance() const override { return 1.0; }
+
+    virtual std::unique_ptr<value::Value>
+    observation(const devs::ObservationEvent &event) const override
+    {
+        return value::Double::create(m_slope * event.getTime());
+    }
+
+    /* The model is stateless: the slope comes from the conditions. */
+    virtual std::unique_ptr<value::Value> serialize() const override
+    {
+        return std::unique_ptr<value::Value>(new value::Map());
+    }
+
+    virtual void deserialize(const value::Value & /*state*/) override {}
+
+private:
+    double m_slope;
+};
+
+/* An output plug-in which stores the time and the unique observation of
+ * the view into a two columns matrix. */
+class Storage : public oov::Plugin
+{
+public:
+    Storage(const std::string &location)
+        : oov::Plugin(location)
+    {
+    }
+
+    virtual std::unique_ptr<value::Matrix> matrix() const override
+    {
+        auto matrix = std::unique_ptr<value::Matrix>(
+            new value::Matrix(2, m_values.size(), 2, 100));
+
+        for (std::size_t i = 0; i != m_values.size(); ++i) {
+            matrix->add(0, i, value::Double::create(m_values[i].first));
+            matrix->add(1, i, value::Double::create(m_values[i].second));
+        }
+
+        return matrix;
+    }
+
+    virtual void onParameter(const std::string & /*plugin*/,
+                             const std::string & /*location*/,
+                             const std::string & /*file*/,
+                             std::unique_ptr<value::Value> /*parameters*/,
+                             const double & /*time*/) override
+    {
+    }
+
+    virtual void onNewObservable(const std::string & /*simulator*/,
+                                 const std::string & /*parent*/,
+                                 const std::string & /*port*/,
+                                 const std::string & /*view*/,
+                                 const double & /*time*/) override
+    {
+    }
+
+    virtual void onDelObservable(const std::string & /*simulator*/,
+                                 const std::string & /*parent*/,
+                                 const std::string & /*port*/,
+                                 const std::string & /*view*/,
+                                 const double & /*time*/) override
+    {
+    }
+
+    virtual void onValue(const std::string & /*simulator*/,
+                         const std::string & /*parent*/,
+                         const std::string & /*port*/,
+                         const std::string & /*view*/,
+                         const double &time,
+                         std::unique_ptr<value::Value> value) override
+    {
+        if (value)
+            m_values.emplace_back(time, value->toDouble().value());
+    }
+
+    virtual std::unique_ptr<value::Matrix>
+    finish(const double & /*time*/) override
+    {
+        return matrix();
+    }
+
+private:
+    std::vector<std::pair<double, double>> m_values;
+};
+
+extern "C" {
+VLE_MODULE vle::devs::Dynamics *
+dynamics_linear(const vle::devs::DynamicsInit &init,
+                const vle::devs::InitEventList &events)
+{
+    return new Linear(init, events);
+}
+
+VLE_MODULE vle::oov::Plugin *
+oov_storage(const std::string &location)
+{
+    return new Storage(location);
+}
+}
+
+const char *linear_xml =
+    "<?xml version=\"1.0\"?>\n"
+    "<vle_project version=\"2.0\" author=\"Gauthier Quesnel\""
+    " date=\"Mon, 19 Oct 2026\" >\n"
+    " <structures>\n"
+    "  <model name=\"top\" type=\"coupled\" >\n"
+    "   <submodels>\n"
+    "    <model name=\"line\" type=\"atomic\" dynamics=\"linear\""
+    " conditions=\"cond\" observables=\"obs\" />\n"
+    "   </submodels>\n"
+    "  </model>\n"
+    " </structures>\n"
+    " <dynamics>\n"
+    "  <dynamic name=\"linear\" package=\"\" library=\"dynamics_linear\" />\n"
+    " </dynamics>\n"
+    " <experiment name=\"linear\" combination=\"linear\" >\n"
+    "  <conditions>\n"
+    "   <condition name=\"simulation_engine\" >\n"
+    "    <port name=\"begin\" ><double>0</double></port>\n"
+    "    <port name=\"duration\" ><double>10</double></port>\n"
+    "   </condition>\n"
+    "   <condition name=\"cond\" >\n"
+    "    <port name=\"slope\" >\n"
+    "     <double>1</double><double>2</double><double>3</double>"
+    "<double>4</double><double>5</double><double>6</double>"
+    "<double>7</double><double>8</double>\n"
+    "    </port>\n"
+    "   </condition>\n"
+    "  </conditions>\n"
+    "  <views>\n"
+    "   <outputs>\n"
+    "    <output name=\"o\" location=\"\" format=\"local\" package=\"\""
+    " plugin=\"oov_storage\" />\n"
+    "   </outputs>\n"
+    "   <observables>\n"
+    "    <observable name=\"obs\" >\n"
+    "     <port name=\"x\" ><attachedview name=\"view\" /></port>\n"
+    "    </observable>\n"
+    "   </observables>\n"
+    "   <view name=\"view\" output=\"o\" type=\"timed\" timestep=\"1\" />\n"
+    "  </views>\n"
+    " </experiment>\n"
+    "</vle_project>\n";
+
+std::unique_ptr<vpz::Vpz> make_linear_vpz()
+{
+    auto vpz = std::unique_ptr<vpz::Vpz>(new vpz::Vpz());
+    vpz->parseMemory(linear_xml);
+
+    return vpz;
+}
+
+void manager_reducer()
+{
+    auto ctx = utils::make_context();
+
+    manager::Error error;
+    manager::Manager matrixmanager(ctx,
+                                   manager::LOG_NONE,
+                                   manager::SIMULATION_NONE,
+                                   nullptr);
+
+    auto matrix = matrixmanager.run(
+        make_linear_vpz(), 2, 0, 1, &error);
+
+    EnsuresEqual(error.code, 0);
+    Ensures(matrix);
+    EnsuresEqual(matrix->columns(), 8);
+
+    manager::MeanVarianceReducer reducer;
+    manager::Manager reducermanager(ctx,
+                                    manager::LOG_NONE,
+                                    manager::SIMULATION_NONE,
+                                    nullptr);
+
+    auto reduced = reducermanager.run(
+        make_linear_vpz(), 2, 0, 1, reducer, &error);
+
+    EnsuresEqual(error.code, 0);
+    Ensures(reduced);
+
+    const auto &mean = reduced->getMap("view").getMatrix("mean");
+    const auto &count = reduced->getMap("view").getMatrix("count");
+
+    const auto &first = matrix->getMap(0, 0).getMatrix("view");
+    EnsuresEqual(mean.rows(), first.rows());
+    EnsuresEqual(mean.columns(), first.columns());
+
+    for (std::size_t row = 0; row != mean.rows(); ++row) {
+        for (std::size_t col = 0; col != mean.columns(); ++col) {
+            double sum = 0.0;
+            for (std::size_t i = 0; i != matrix->columns(); ++i)
+                sum += matrix->getMap(i, 0).getMatrix("view").getDouble(col,
+                                                                        row);
+
+            EnsuresApproximatelyEqual(mean.getDouble(col, row),
+                                      sum / matrix->columns(), 1e-8);
+            EnsuresEqual(count.getInt(col, row), 8);
+        }
+    }
+
+    EnsuresApproximatelyEqual(mean.getDouble(1, 10), 45.0, 1e-8);
+}
+
+void manager_spinup()
+{
+    auto ctx = utils::make_context();
+
+    /* The spin-up port accepts an integer as well as a real. */
+    for (int type = 0; type != 2; ++type) {
+        auto vpz = make_linear_vpz();
+        auto &engine = vpz->project().experiment().conditions().get(
+            vpz::Experiment::defaultSimulationEngineCondName());
+
+        if (type == 0)
+            engine.addValueToPort("spinup", value::Integer::create(3));
+        else
+            engine.addValueToPort("spinup", value::Double::create(3.0));
+
+        manager::Error error;
+        manager::Manager manager(ctx,
+                                 manager::LOG_NONE,
+                                 manager::SIMULATION_NONE,
+                                 nullptr);
+
+        auto matrix = manager.run(std::move(vpz), 1, 0, 1, &error);
+        EnsuresEqual(error.code, 0);
+        Ensures(matrix);
+        if (matrix) {
+            const auto &view = matrix->getMap(7, 0).getMatrix("view");
+            EnsuresApproximatelyEqual(
+                view.getDouble(1, view.rows() - 1), 80.0, 1e-8);
+        }
+    }
+
+    auto vpz = make_linear_vpz();
+    vpz->project()
+        .experiment()
+        .conditions()
+        .get(vpz::Experiment::defaultSimulationEngineCondName())
+        .addValueToPort("spinup", value::String::create("3"));
+
+    manager::Error error;
+    manager::Manager manager(ctx,
+                             manager::LOG_NONE,
+                             manager::SIMULATION_NONE,
+                             nullptr);
+
+    EnsuresThrow(manager.run(std::move(vpz), 1, 0, 1, &error),
+                 utils::ArgError);
+}
+
+/* The linear model of make_linear_vpz() with a simulation too long to
+ * finish during the tests. */
+std::unique_ptr<vpz::Vpz> make_endless_linear_vpz()
+{
+    auto vpz = make_linear_vpz();
+    vpz->project()
+        .experiment()
+        .conditions()
+        .get(vpz::Experiment::defaultSimulationEngineCondName())
+        .setValueToPort("duration", value::Double::create(1e12));
+
+    return vpz;
+}
+
+void manager_timeout()
+{
+    auto ctx = utils::make_context();
+
+    manager::Error error;
+    manager::Manager manager(ctx,
+                             manager::LOG_NONE,
+                             manager::SIMULATION_IN_PROCESS_TIMEOUT,
+                             std::chrono::milliseconds(50),
+                             nullptr);
+
+    auto matrix = manager.run(make_endless_linear_vpz(), 1, 0, 1, &error);
+
+    /* Each combination is stopped by the timeout and its partial result
+     * is kept. */
+    EnsuresEqual(error.code, manager::ERROR_CANCELLED);
+    Ensures(matrix);
+    if (matrix) {
+        EnsuresEqual(matrix->columns(), 8);
+
+        for (std::size_t i = 0; i != matrix->columns(); ++i) {
+            const auto &view = matrix->getMap(i, 0).getMatrix("view");
+            Ensures(view.rows() > 0);
+            Ensures(view.getDouble(0, view.rows() - 1) < 1e12);
+        }
+    }
+}
+
+void manager_cancel()
+{
+    auto ctx = utils::make_context();
+
+    /* A token cancelled during the run stops the current combination and
+     * the combinations not yet started are not simulated. */
+    {
+        devs::RunBudget budget;
+        manager::Manager manager(ctx,
+                                 manager::LOG_NONE,
+                                 manager::SIMULATION_NONE,
+                                 nullptr);
+        manager.setBudget(budget);
+
+        std::thread canceller([&budget]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            budget.token.cancel();
+        });
+
+        manager::Error error;
+        auto matrix =
+            manager.run(make_endless_linear_vpz(), 1, 0, 1, &error);
+        canceller.join();
+
+        EnsuresEqual(error.code, manager::ERROR_CANCELLED);
+        Ensures(matrix);
+        if (matrix) {
+            const auto &view = matrix->getMap(0, 0).getMatrix("view");
+            Ensures(view.rows() > 0);
+            Ensures(not matrix->get(7, 0));
+        }
+    }
+
+    /* A token cancelled before the run. */
+    {
+        devs::RunBudget budget;
+        budget.token.cancel();
+
+        manager::Manager manager(ctx,
+                                 manager::LOG_NONE,
+                                 manager::SIMULATION_NONE,
+                                 nullptr);
+        manager.setBudget(budget);
+
+        manager::Error error;
+        auto matrix = manager.run(make_linear_vpz(), 1, 0, 1, &error);
+
+        EnsuresEqual(error.code, manager::ERROR_CANCELLED);
+        if (matrix)
+            for (std::size_t i = 0; i != matrix->columns(); ++i)
+                Ensures(not matrix->get(i, 0));
+    }
+}
+
+void worker_pool()
+{
+#ifdef __linux__
+    auto ctx = utils::make_context();
+    std::shared_ptr<const vpz::Vpz> file = make_linear_vpz();
+    vpz::ExperimentInstance instance(file, 0);
+
+    manager::WorkerPool pool(
+        ctx,
+        [ctx, &instance](uint32_t index, manager::Error *error) {
+            if (index == 1)
+                std::raise(SIGKILL);
+
+            if (index == 2)
+                std::this_thread::sleep_for(std::chrono::seconds(60));
+
+            if (index == 3)
+                throw utils::ModellingError("bad model");
+
+            manager::Simulation sim(ctx,
+                                    manager::LOG_NONE,
+                                    manager::SIMULATION_NONE,
+                                    std::chrono::milliseconds(0),
+                                    nullptr);
+
+            return sim.run(instance, error);
+        },
+        std::chrono::milliseconds(1000));
+
+    manager::Error error;
+    auto result = pool.run(0, &error);
+    EnsuresEqual(error.code, 0);
+    Ensures(result);
+    if (result)
+        EnsuresApproximatelyEqual(
+            result->getMatrix("view").getDouble(1, 10), 10.0, 1e-8);
+
+    result = pool.run(1, &error);
+    EnsuresEqual(error.code, manager::ERROR_FAILURE);
+    Ensures(not result);
+    EnsuresEqual(pool.recycled(), 1u);
+
+    result = pool.run(2, &error);
+    EnsuresEqual(error.code, manager::ERROR_CANCELLED);
+    EnsuresEqual(pool.recycled(), 2u);
+
+    result = pool.run(3, &error);
+    EnsuresEqual(error.code, manager::ERROR_FAILURE);
+    Ensures(error.message.find("bad model") != std::string::npos);
+    EnsuresEqual(pool.recycled(), 2u);
+
+    std::vector<std::thread> threads;
+    std::vector<manager::Error> errors(4);
+    std::vector<std::unique_ptr<value::Map>> results(4);
+
+    for (std::size_t i = 0; i != 4; ++i)
+        threads.emplace_back([&pool, &errors, &results, i]() {
+            results[i] = pool.run(0, &errors[i]);
+        });
+
+    for (auto &th : threads)
+        th.join();
+
+    for (std::size_t i = 0; i != 4; ++i) {
+        EnsuresEqual(errors[i].code, 0);
+        Ensures(results[i]);
+    }
+#endif
+}
+
+void worker_pool_cancel()
+{
+#ifdef __linux__
+    auto ctx = utils::make_context();
+
+    manager::WorkerPool pool(
+        ctx,
+        [](uint32_t /*index*/, manager::Error * /*error*/) {
+            std::this_thread::sleep_for(std::chrono::seconds(60));
+            return std::unique_ptr<value::Map>();
+        },
+        std::chrono::milliseconds(60000));
+
+    /* The worker copies the token: the pool kills the running worker
+     * when the token of the caller is cancelled, long before the
+     * timeout. */
+    devs::CancellationToken token;
+    std::thread canceller([&token]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        token.cancel();
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    manager::Error error;
+    auto result = pool.run(0, &error, &token);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    canceller.join();
+
+    EnsuresEqual(error.code, manager::ERROR_CANCELLED);
+    Ensures(not result);
+    Ensures(elapsed < std::chrono::seconds(10));
+    EnsuresEqual(pool.recycled(), 1u);
+
+    /* A token cancelled before the run. */
+    result = pool.run(1, &error, &token);
+    EnsuresEqual(error.code, manager::ERROR_CANCELLED);
+    Ensures(not result);
+#endif
+}
+
+/* Appends the messages to a file: the workers of a pool write into the
+   file of the test process. */
+struct FileLog : utils::Context::LogFunctor
+{
+    std::string filename;
+
+    explicit FileLog(std::string name)
+        : filename(std::move(name))
+    {
+    }
+
+    virtual void write(const utils::Context & /*ctx*/,
+                       int /*priority*/,
+                       const char * /*file*/,
+                       int /*line*/,
+                       const char * /*fn*/,
+                       const char *format,
+                       va_list args) noexcept override
+    {
+        if (FILE *f = std::fopen(filename.c_str(), "a")) {
+            std::vfprintf(f, format, args);
+            std::fclose(f);
+        }
+    }
+};
+
+void worker_pool_log()
+{
+#ifdef __linux__
+    auto ctx = utils::make_context();
+    auto filename = (utils::Path::temp_directory_path() /
+                     utils::Path::unique_path("vle-%%%%-%%%%-%%%%.log"))
+                        .string();
+
+    ctx->set_log_priority(7);
+    ctx->set_log_function(std::make_unique<FileLog>(filename));
+    ctx->set_log_asynchronous(64);
+
+    {
+        manager::WorkerPool pool(
+            ctx,
+            [ctx](uint32_t index, manager::Error * /*error*/) {
+                ctx->log(3, __FILE__, __LINE__, __FUNCTION__,
+                         "worker job %d\n", static_cast<int>(index));
+                return std::unique_ptr<value::Map>();
+            },
+            std::chrono::milliseconds(10000));
+
+        manager::Error error;
+        pool.run(42, &error);
+        EnsuresEqual(error.code, 0);
+    }
+
+    ctx->flush_log();
+
+    std::ifstream ifs(filename);
+    std::stringstream content;
+    content << ifs.rdbuf();
+    Ensures(content.str().find("worker job 42") != std::string::npos);
+
+    std::remove(filename.c_str());
+#endif
+}
+
 int main()
 {
     vle::Init app;
@@ -227,6 +1084,20 @@ int main()
     experimentgenerator_lower_than_exp();
     experimentgenerator_greater_than_exp();
     experimentgenerator_max_1_max_1();
+    experimentgenerator_instance();
+    plan_total();
+    plan_latin_hypercube();
+    plan_saltelli();
+    reducer_mean_variance();
+    reducer_min_max_quantile();
+    reducer_last_row();
+    manager_reducer();
+    manager_spinup();
+    manager_timeout();
+    manager_cancel();
+    worker_pool();
+    worker_pool_cancel();
+    worker_pool_log();
 
     return unit_test::report_errors();
 }
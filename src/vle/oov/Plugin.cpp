@@ -29,6 +29,35 @@
 
 namespace vle { namespace oov {
 
+std::unique_ptr<value::Matrix> Plugin::matrixRows(std::size_t first) const
+{
+    auto full = matrix();
+    if (not full or first + 1 >= full->rows())
+        return {};
 
+    const auto rows = full->rows() - 1 - first;
+    std::unique_ptr<value::Matrix> result(
+        new value::Matrix(full->columns(), rows, full->resizeColumn(),
+                          full->resizeRow()));
+
+    for (std::size_t row = 0; row != rows; ++row)
+        for (std::size_t col = 0, end = full->columns(); col != end; ++col)
+            if (full->get(col, first + row))
+                result->set(col, row, full->give(col, first + row));
+
+    return result;
+}
+
+void Plugin::onValues(const std::string& view,
+                      const double& time,
+                      ColumnValue* values,
+                      std::size_t size)
+{
+    for (std::size_t i = 0; i != size; ++i)
+        onValue(values[i].column->simulator,
+                values[i].column->parent,
+                values[i].column->port,
+                view, time, std::move(values[i].value));
+}
 
 }} // namespace vle oov
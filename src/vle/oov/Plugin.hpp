@@ -27,8 +27,10 @@
 #ifndef VLE_OOV_PLUGIN_HPP
 #define VLE_OOV_PLUGIN_HPP
 
+#include <cstddef>
 #include <map>
 #include <memory>
+#include <string>
 #include <vle/DllDefines.hpp>
 #include <vle/utils/Types.hpp>
 #include <vle/value/Matrix.hpp>
@@ -56,6 +58,30 @@
 namespace vle {
 namespace oov {
 
+/**
+ * \c vle::oov::ObservableColumn identifies an observable (the
+ * devs::Simulator and port name) of a view. The \e id is the rank of the
+ * \c Plugin::onNewObservable call for this observable: the first
+ * observable of the view has the identifier 0, the second 1, etc.
+ * Identifiers are never reused, even after a \c
+ * Plugin::onDelObservable.
+ */
+struct ObservableColumn {
+    std::string simulator;
+    std::string parent;
+    std::string port;
+    std::size_t id;
+};
+
+/**
+ * \c vle::oov::ColumnValue associates a value to an observable for the
+ * \c Plugin::onValues batch interface.
+ */
+struct ColumnValue {
+    const ObservableColumn *column;
+    std::unique_ptr<value::Value> value;
+};
+
 /**
  * \c vle::oov::Plugin permit to build output plug-ins.
  *
@@ -103,6 +129,22 @@ public:
      */
     virtual std::unique_ptr<value::Matrix> matrix() const { return {}; }
 
+    /**
+     * Return a clone of the rows of the \c value::Matrix from the row \e
+     * first to the last complete row. The last row of the \c
+     * value::Matrix is not complete while the simulation runs: values can
+     * still be added at the same date.
+     *
+     * Callers keep the number of rows already read as a cursor to only
+     * get the rows appended since the previous call. The default
+     * implementation copies the whole \c value::Matrix returned by
+     * matrix(), plug-ins that store results should override it.
+     *
+     * @return NULL if the plug-in does not manage \c value::Matrix or
+     * if there is no new complete row.
+     */
+    virtual std::unique_ptr<value::Matrix> matrixRows(std::size_t first) const;
+
     /**
      * Get the name of the Plugin class.
      *
@@ -164,6 +206,21 @@ public:
                          const double &time,
                          std::unique_ptr<value::Value> value) = 0;
 
+    /**
+     * Call when several values are send to the view at the same time:
+     * all the observables of a timed view or all the observations of a
+     * bag for an event view. The plug-in takes the ownership of the
+     * values.
+     *
+     * The default implementation calls \c onValue for each value.
+     * Plug-ins can override it to use the \c ObservableColumn::id instead
+     * of the names of the observables.
+     */
+    virtual void onValues(const std::string &view,
+                          const double &time,
+                          ColumnValue *values,
+                          std::size_t size);
+
     /**
      * Call when the simulation is finished.
      * Return a pointer to the Matrix built during simulation, or NULL.
@@ -30,6 +30,7 @@
 #include <boost/graph/grid_graph.hpp>
 #include <boost/graph/plod_generator.hpp>
 #include <boost/graph/small_world_generator.hpp>
+#include <cstdlib>
 #include <random>
 #include <vle/translator/GraphTranslator.hpp>
 #include <vle/utils/Exception.hpp>
@@ -67,6 +68,35 @@ graph_generator::graph_metrics init_metrics(const graphT &g)
     return ret;
 }
 
+void connect(graph_generator::connectivity type,
+             vle::devs::Executive &executive,
+             const std::string &src,
+             const std::string &dst)
+{
+    switch (type) {
+    case graph_generator::connectivity::IN_OUT:
+        executive.addOutputPort(src, "out");
+        executive.addInputPort(dst, "in");
+        executive.addConnection(src, "out", dst, "in");
+        break;
+    case graph_generator::connectivity::IN:
+        executive.addOutputPort(src, dst);
+        executive.addInputPort(dst, "in");
+        executive.addConnection(src, dst, dst, "in");
+        break;
+    case graph_generator::connectivity::OUT:
+        executive.addOutputPort(src, "out");
+        executive.addInputPort(dst, src);
+        executive.addConnection(src, "out", dst, src);
+        break;
+    case graph_generator::connectivity::OTHER:
+        executive.addOutputPort(src, dst);
+        executive.addInputPort(dst, src);
+        executive.addConnection(src, dst, dst, src);
+        break;
+    }
+}
+
 void build(const graph_generator::parameter &params,
            vle::devs::Executive &executive,
            graphT &g)
@@ -97,63 +127,72 @@ void build(const graph_generator::parameter &params,
     }
 
     {
-        std::string src, dst;
         graphT::vertex_iterator i;
         graphT::out_edge_iterator ei, ei_end;
 
-        switch (params.type) {
-        case graph_generator::connectivity::IN_OUT:
-            for (i = vi; i != vi_end; ++i) {
-                std::tie(ei, ei_end) = boost::out_edges(*i, g);
-                for (; ei != ei_end; ++ei) {
-                    src = modelnames[boost::source(*ei, g)];
-                    dst = modelnames[boost::target(*ei, g)];
-                    executive.addOutputPort(src, "out");
-                    executive.addInputPort(dst, "in");
-                    executive.addConnection(src, "out", dst, "in");
-                }
-            }
-            break;
-        case graph_generator::connectivity::IN:
-            for (i = vi; i != vi_end; ++i) {
-                std::tie(ei, ei_end) = boost::out_edges(*i, g);
-                for (; ei != ei_end; ++ei) {
-                    src = modelnames[boost::source(*ei, g)];
-                    dst = modelnames[boost::target(*ei, g)];
-                    executive.addOutputPort(src, dst);
-                    executive.addInputPort(dst, "in");
-                    executive.addConnection(src, dst, dst, "in");
-                }
-            }
-            break;
-        case graph_generator::connectivity::OUT:
-            for (i = vi; i != vi_end; ++i) {
-                std::tie(ei, ei_end) = boost::out_edges(*i, g);
-                for (; ei != ei_end; ++ei) {
-                    src = modelnames[boost::source(*ei, g)];
-                    dst = modelnames[boost::target(*ei, g)];
-                    executive.addOutputPort(src, "out");
-                    executive.addInputPort(dst, src);
-                    executive.addConnection(src, "out", dst, src);
-                }
-            }
-            break;
-        case graph_generator::connectivity::OTHER:
-            for (i = vi; i != vi_end; ++i) {
-                std::tie(ei, ei_end) = boost::out_edges(*i, g);
-                for (; ei != ei_end; ++ei) {
-                    src = modelnames[boost::source(*ei, g)];
-                    dst = modelnames[boost::target(*ei, g)];
-                    executive.addOutputPort(src, dst);
-                    executive.addInputPort(dst, src);
-                    executive.addConnection(src, dst, dst, src);
-                }
-            }
-            break;
+        for (i = vi; i != vi_end; ++i) {
+            std::tie(ei, ei_end) = boost::out_edges(*i, g);
+            for (; ei != ei_end; ++ei)
+                connect(params.type,
+                        executive,
+                        modelnames[boost::source(*ei, g)],
+                        modelnames[boost::target(*ei, g)]);
         }
     }
 }
 
+/**
+ * Build the models and the connections of a sparse graph. The function
+ * @c for_each_edge(f) calls @c f(source, destination) for each edge and
+ * is called twice: to compute the metrics, and to build the connections.
+ */
+template <typename EdgeFunction>
+graph_generator::graph_metrics
+build_sparse(const graph_generator::parameter &params,
+             vle::devs::Executive &executive,
+             int number,
+             EdgeFunction for_each_edge)
+{
+    if (number <= 0)
+        throw vle::utils::ArgError(_("graph_generator: bad model number"));
+
+    std::vector<int> in_degree(number, 0), out_degree(number, 0);
+    graph_generator::graph_metrics ret{number, 0, 0};
+
+    for_each_edge([&](std::int32_t src, std::int32_t dst) {
+        if (src < 0 or src >= number or dst < 0 or dst >= number)
+            throw vle::utils::ArgError(
+                _("graph_generator: bad edge %d -> %d"), src, dst);
+
+        ++out_degree[src];
+        ++in_degree[dst];
+        ++ret.edges;
+        ret.bandwidth = std::max(ret.bandwidth, std::abs(src - dst));
+    });
+
+    std::vector<std::string> modelnames(number);
+
+    {
+        std::string classname;
+        graph_generator::node_metrics metrics{0, 0, 0};
+
+        for (int id = 0; id != number; ++id) {
+            metrics.id = id;
+            metrics.out_degree = out_degree[id];
+            metrics.in_degree = in_degree[id];
+
+            params.make_model(metrics, modelnames[id], classname);
+            executive.createModelFromClass(classname, modelnames[id]);
+        }
+    }
+
+    for_each_edge([&](std::int32_t src, std::int32_t dst) {
+        connect(params.type, executive, modelnames[src], modelnames[dst]);
+    });
+
+    return ret;
+}
+
 void graph_generator::make_graph(vle::devs::Executive &executive,
                                  int number,
                                  const vle::utils::Array<bool> &matrix)
@@ -179,6 +218,47 @@ void graph_generator::make_graph(vle::devs::Executive &executive,
     build(m_params, executive, g);
 }
 
+void graph_generator::make_graph(vle::devs::Executive &executive,
+                                 int number,
+                                 const std::int32_t *edges,
+                                 std::size_t edges_number)
+{
+    if (edges_number > 0 and not edges)
+        throw vle::utils::ArgError(_("graph_generator: missing edges"));
+
+    m_metrics = build_sparse(
+        m_params, executive, number, [edges, edges_number](auto function) {
+            for (std::size_t i = 0; i != edges_number; ++i)
+                function(edges[2 * i], edges[2 * i + 1]);
+        });
+}
+
+void graph_generator::make_csr_graph(vle::devs::Executive &executive,
+                                     int number,
+                                     const std::int32_t *offsets,
+                                     const std::int32_t *targets)
+{
+    if (number <= 0)
+        throw vle::utils::ArgError(_("graph_generator: bad model number"));
+
+    if (not offsets or offsets[0] != 0)
+        throw vle::utils::ArgError(_("graph_generator: bad offsets"));
+
+    for (int i = 0; i != number; ++i)
+        if (offsets[i + 1] < offsets[i])
+            throw vle::utils::ArgError(_("graph_generator: bad offsets"));
+
+    if (offsets[number] > 0 and not targets)
+        throw vle::utils::ArgError(_("graph_generator: missing targets"));
+
+    m_metrics = build_sparse(
+        m_params, executive, number, [number, offsets, targets](auto function) {
+            for (std::int32_t i = 0; i != number; ++i)
+                for (auto j = offsets[i], e = offsets[i + 1]; j != e; ++j)
+                    function(i, targets[j]);
+        });
+}
+
 void graph_generator::make_smallworld(vle::devs::Executive &executive,
                                       std::mt19937 &gen,
                                       int number,
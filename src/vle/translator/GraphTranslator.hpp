@@ -28,6 +28,7 @@
 #define VLE_TRANSLATOR_GRAPHTRANSLATOR_HPP
 
 #include <array>
+#include <cstdint>
 #include <random>
 #include <vle/DllDefines.hpp>
 #include <vle/devs/Executive.hpp>
@@ -91,6 +92,33 @@ public:
                     int number,
                     const vle::utils::Array<bool> &graph);
 
+    /**
+     * Build a graph of @c number models from a list of edges. The @c
+     * edges array stores @c edges_number pairs (source, destination) of
+     * model identifiers in [0, number). The edges are streamed into the
+     * executive: neither a dense matrix nor a boost graph is built.
+     *
+     * @throw utils::ArgError if an identifier is out of range.
+     */
+    void make_graph(vle::devs::Executive &executive,
+                    int number,
+                    const std::int32_t *edges,
+                    std::size_t edges_number);
+
+    /**
+     * Build a graph of @c number models from a compressed sparse row
+     * adjacency: the destinations of the model @c i are @c
+     * targets[offsets[i]] to @c targets[offsets[i + 1] - 1]. The @c
+     * offsets array stores @c number + 1 increasing values.
+     *
+     * @throw utils::ArgError if the offsets are not increasing or if an
+     * identifier is out of range.
+     */
+    void make_csr_graph(vle::devs::Executive &executive,
+                        int number,
+                        const std::int32_t *offsets,
+                        const std::int32_t *targets);
+
     void make_smallworld(vle::devs::Executive &executive,
                          std::mt19937 &gen,
                          int number,
@@ -25,9 +25,17 @@
  */
 
 #include <vle/translator/MatrixTranslator.hpp>
+#include <vle/devs/Thread.hpp>
 #include <vle/utils/Exception.hpp>
 #include <vle/utils/Tools.hpp>
 #include <vle/utils/i18n.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Table.hpp>
+#include <vle/value/Tuple.hpp>
+#include <numeric>
+#include <system_error>
 
 namespace vle
 {
@@ -360,5 +368,316 @@ void regular_graph_generator::make_2d(vle::devs::Executive &executive,
                                 x_mask,
                                 y_mask);
 }
+
+void regular_graph_generator::make_grid(
+    vle::devs::Executive &executive,
+    const std::string &name,
+    const std::string &dynamics,
+    const std::array<int, 2> &length,
+    const std::array<bool, 2> &wrap,
+    const std::vector<std::string> &conditions,
+    const std::string &observable)
+{
+    if (length[0] <= 0 or length[1] <= 0)
+        throw vle::utils::ArgError(
+            _("regular_graph_generator: bad parameters"));
+
+    vpz::Condition grid(name + "-grid");
+    grid.addValueToPort("grid-width", value::Integer::create(length[0]));
+    grid.addValueToPort("grid-height", value::Integer::create(length[1]));
+    grid.addValueToPort("grid-wrap-x", value::Boolean::create(wrap[0]));
+    grid.addValueToPort("grid-wrap-y", value::Boolean::create(wrap[1]));
+    executive.conditions().add(grid);
+
+    std::vector<std::string> conds{grid.name()};
+    conds.insert(conds.end(), conditions.begin(), conditions.end());
+
+    executive.createModel(name, {"set"}, {"out"}, dynamics, conds, observable);
+
+    m_metrics.vertices = length[0] * length[1];
+}
+
+grid_dynamics::grid_dynamics(const vle::devs::DynamicsInit &init,
+                             const vle::devs::InitEventList &events)
+    : vle::devs::Dynamics(init, events)
+    , m_output(output_type::cells)
+    , m_width(events.getInt("grid-width"))
+    , m_height(events.getInt("grid-height"))
+    , m_threads(0)
+    , m_border(0.0)
+    , m_time_step(1.0)
+    , m_last(0.0)
+    , m_next_step(0.0)
+    , m_steps(0)
+    , m_wrap_x(false)
+    , m_wrap_y(false)
+{
+    if (m_width <= 0 or m_height <= 0)
+        throw vle::utils::ArgError(_("grid_dynamics: bad grid size"));
+
+    if (events.exist("grid-wrap-x"))
+        m_wrap_x = events.getBoolean("grid-wrap-x");
+    if (events.exist("grid-wrap-y"))
+        m_wrap_y = events.getBoolean("grid-wrap-y");
+    if (events.exist("grid-border"))
+        m_border = events.getDouble("grid-border");
+    if (events.exist("grid-threads"))
+        m_threads = std::max(0, events.getInt("grid-threads"));
+    if (events.exist("grid-time-step"))
+        m_time_step = events.getDouble("grid-time-step");
+
+    if (not(m_time_step > 0.0))
+        throw vle::utils::ArgError(_("grid_dynamics: bad time step"));
+
+    if (events.exist("grid-output")) {
+        const auto &type = events.getString("grid-output");
+
+        if (type == "none")
+            m_output = output_type::none;
+        else if (type == "cells")
+            m_output = output_type::cells;
+        else if (type == "sum")
+            m_output = output_type::sum;
+        else if (type == "mean")
+            m_output = output_type::mean;
+        else
+            throw vle::utils::ArgError(
+                _("grid_dynamics: unknown grid-output `%s'"), type.c_str());
+    }
+
+    m_stride = static_cast<std::size_t>(m_width) + 2;
+    m_current.resize(m_stride * (static_cast<std::size_t>(m_height) + 2),
+                     m_border);
+    m_next.resize(m_current.size(), m_border);
+
+    if (events.exist("grid-init")) {
+        const auto &value = events.get("grid-init");
+
+        if (value->isTuple()) {
+            const auto &tuple = value->toTuple().value();
+            if (tuple.size() != static_cast<std::size_t>(m_width) * m_height)
+                throw vle::utils::ArgError(
+                    _("grid_dynamics: bad grid-init size"));
+
+            for (int y = 0; y != m_height; ++y)
+                std::copy_n(tuple.begin() + static_cast<std::size_t>(y) *
+                                                m_width,
+                            m_width,
+                            &cell(0, y));
+        }
+        else {
+            const double init = value->toDouble().value();
+
+            for (int y = 0; y != m_height; ++y)
+                std::fill_n(&cell(0, y), m_width, init);
+        }
+    }
+
+    // The workers live as long as the model. Without threads, the steps
+    // are computed by the simulation thread.
+    if (std::min(m_threads, m_height - 1) > 0) {
+        try {
+            m_pool.reset(new vle::devs::SimulatorProcessParallel(
+                std::min(m_threads, m_height - 1), 1));
+            m_block_changed.resize(
+                static_cast<std::size_t>(std::min(m_threads + 1, m_height)));
+        }
+        catch (const std::system_error &) {
+        }
+    }
+}
+
+grid_dynamics::~grid_dynamics() = default;
+
+vle::devs::Time grid_dynamics::init(vle::devs::Time time)
+{
+    m_last = time;
+    m_next_step = time + m_time_step;
+    m_steps = 0;
+
+    return m_time_step;
+}
+
+vle::devs::Time grid_dynamics::timeAdvance() const
+{
+    return m_next_step - m_last;
+}
+
+void grid_dynamics::output(vle::devs::Time /*time*/,
+                           vle::devs::ExternalEventList &output) const
+{
+    switch (m_output) {
+    case output_type::none:
+        break;
+    case output_type::cells:
+        if (not m_changed.empty()) {
+            output.emplace_back("out");
+            auto &tuple = output.back().addTuple(m_changed.size() * 3, 0.0);
+
+            for (std::size_t i = 0, e = m_changed.size(); i != e; ++i) {
+                const auto index = m_changed[i];
+                tuple[i * 3] = static_cast<double>(index % m_stride) - 1;
+                tuple[i * 3 + 1] = static_cast<double>(index / m_stride) - 1;
+                tuple[i * 3 + 2] = m_current[index];
+            }
+        }
+        break;
+    case output_type::sum:
+        output.emplace_back("out");
+        output.back().addDouble(sum());
+        break;
+    case output_type::mean:
+        output.emplace_back("out");
+        output.back().addDouble(sum() /
+                                (static_cast<double>(m_width) * m_height));
+        break;
+    }
+}
+
+void grid_dynamics::internalTransition(vle::devs::Time time)
+{
+    m_changed.clear();
+    step();
+
+    m_last = time;
+    m_next_step = time + m_time_step;
+}
+
+void grid_dynamics::externalTransition(
+    const vle::devs::ExternalEventList &events,
+    vle::devs::Time time)
+{
+    m_last = time;
+
+    for (const auto &event : events) {
+        if (event.getPortName() != "set" or not event.attributes() or
+            not event.attributes()->isTuple())
+            continue;
+
+        const auto &tuple = event.attributes()->toTuple();
+        if (tuple.size() == 0 or tuple.size() % 3 != 0)
+            throw vle::utils::ArgError(
+                _("grid_dynamics: set needs a tuple (x, y, value, ...)"));
+
+        for (std::size_t i = 0, e = tuple.size(); i != e; i += 3) {
+            const int x = static_cast<int>(tuple[i]);
+            const int y = static_cast<int>(tuple[i + 1]);
+            if (x < 0 or x >= m_width or y < 0 or y >= m_height)
+                throw vle::utils::ArgError(
+                    _("grid_dynamics: bad cell %d %d"), x, y);
+
+            cell(x, y) = tuple[i + 2];
+
+            if (m_output == output_type::cells)
+                m_changed.emplace_back(index(x, y));
+        }
+    }
+}
+
+std::unique_ptr<value::Value>
+grid_dynamics::observation(const vle::devs::ObservationEvent &event) const
+{
+    if (event.onPort("grid")) {
+        auto table = value::Table::create(m_width, m_height);
+        auto &values = table->toTable().value();
+
+        for (int y = 0; y != m_height; ++y)
+            std::copy_n(row(y),
+                        m_width,
+                        values.begin() + static_cast<std::size_t>(y) * m_width);
+
+        return table;
+    }
+
+    if (event.onPort("sum"))
+        return value::Double::create(sum());
+
+    if (event.onPort("mean"))
+        return value::Double::create(
+            sum() / (static_cast<double>(m_width) * m_height));
+
+    return vle::devs::Dynamics::observation(event);
+}
+
+void grid_dynamics::fill_border() noexcept
+{
+    for (int y = 0; y != m_height; ++y) {
+        cell(-1, y) = m_wrap_x ? cell(m_width - 1, y) : m_border;
+        cell(m_width, y) = m_wrap_x ? cell(0, y) : m_border;
+    }
+
+    // The rows of the border are copied with their corners, so the corners
+    // of a torus are the opposite corners of the grid.
+    if (m_wrap_y) {
+        std::copy_n(&cell(-1, m_height - 1), m_stride, &cell(-1, -1));
+        std::copy_n(&cell(-1, 0), m_stride, &cell(-1, m_height));
+    }
+    else {
+        std::fill_n(&cell(-1, -1), m_stride, m_border);
+        std::fill_n(&cell(-1, m_height), m_stride, m_border);
+    }
+}
+
+double grid_dynamics::sum() const noexcept
+{
+    double ret = 0.0;
+
+    for (int y = 0; y != m_height; ++y)
+        ret = std::accumulate(row(y), row(y) + m_width, ret);
+
+    return ret;
+}
+
+void grid_dynamics::changes(int begin,
+                            int end,
+                            std::vector<std::size_t> &changed) const
+{
+    for (int y = begin; y != end; ++y) {
+        const auto first = index(0, y);
+
+        for (auto i = first, e = first + m_width; i != e; ++i)
+            if (m_next[i] != m_current[i])
+                changed.emplace_back(i);
+    }
+}
+
+void grid_dynamics::step()
+{
+    fill_border();
+
+    const bool cells = m_output == output_type::cells;
+
+    if (not m_pool) {
+        update(0, m_height);
+
+        if (cells)
+            changes(0, m_height, m_changed);
+    }
+    else {
+        const int blocks = static_cast<int>(m_block_changed.size());
+
+        m_pool->for_each(static_cast<std::size_t>(blocks),
+                         [this, blocks, cells](std::size_t block) {
+                             const int b = static_cast<int>(block);
+                             const int begin = m_height * b / blocks;
+                             const int end = m_height * (b + 1) / blocks;
+
+                             update(begin, end);
+
+                             if (cells) {
+                                 m_block_changed[block].clear();
+                                 changes(begin, end, m_block_changed[block]);
+                             }
+                         },
+                         1);
+
+        if (cells)
+            for (const auto &elem : m_block_changed)
+                m_changed.insert(m_changed.end(), elem.begin(), elem.end());
+    }
+
+    std::swap(m_current, m_next);
+    ++m_steps;
+}
 }
 }
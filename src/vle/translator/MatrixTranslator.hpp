@@ -31,9 +31,17 @@
 #include <vle/devs/Executive.hpp>
 #include <vle/utils/Array.hpp>
 #include <vle/vpz/Condition.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
 
 namespace vle
 {
+namespace devs
+{
+class SimulatorProcessParallel;
+}
+
 namespace translator
 {
 
@@ -88,10 +96,152 @@ public:
                  int x_mask,
                  int y_mask);
 
+    /**
+     * Build a single atomic model @e name, with the @e dynamics (a @c
+     * grid_dynamics), to simulate the grid instead of one model per cell.
+     * The condition @c name-grid stores the size and the wrap of the grid
+     * and is attached before the @e conditions. The model has an input
+     * port @c set and an output port @c out to connect the grid to the
+     * other models.
+     */
+    void make_grid(vle::devs::Executive &executive,
+                   const std::string &name,
+                   const std::string &dynamics,
+                   const std::array<int, 2> &length,
+                   const std::array<bool, 2> &wrap,
+                   const std::vector<std::string> &conditions = {},
+                   const std::string &observable = {});
+
 private:
     parameter m_params;
     graph_metrics m_metrics;
 };
+
+/**
+ * A dense two dimensional grid of cells simulated by a single atomic
+ * model.
+ *
+ * The states of the cells are stored in two contiguous row-major arrays
+ * (the current and the next states) surrounded by a border of one cell.
+ * Before each step, this border is filled with the opposite edges of the
+ * grid (wrap) or with the @c grid-border value, so update() reads the
+ * eight neighbours of any cell without test. The rows are updated by
+ * blocks on @c grid-threads additional threads, started with the model
+ * and asleep between two steps.
+ *
+ * The conditions of the model:
+ * - @c grid-width, @c grid-height (integer): the size of the grid.
+ * - @c grid-wrap-x, @c grid-wrap-y (boolean, false): torus borders.
+ * - @c grid-border (double, 0): the state outside a grid without wrap.
+ * - @c grid-init (double or tuple of width * height values, 0).
+ * - @c grid-time-step (double, 1): the duration between two steps.
+ * - @c grid-threads (integer, 0): the number of additional threads.
+ * - @c grid-output (string, "cells"): the events of the output port @c
+ *   out, sent before each step: "cells" sends a tuple (x0, y0, value0,
+ *   x1, y1, value1, ...) of the cells changed since the previous event,
+ *   "sum" or "mean" send the aggregate of the grid (a Double) and "none"
+ *   sends nothing.
+ *
+ * An event on the input port @c set with a tuple (x, y, value) or several
+ * triples as above assigns the state of cells: the @c out port of a grid
+ * can be connected to the @c set port of another one. The observation
+ * ports are @c grid (a Table), @c sum and @c mean.
+ */
+class VLE_API grid_dynamics : public vle::devs::Dynamics
+{
+public:
+    grid_dynamics(const vle::devs::DynamicsInit &init,
+                  const vle::devs::InitEventList &events);
+
+    virtual ~grid_dynamics();
+
+    virtual vle::devs::Time init(vle::devs::Time time) override;
+
+    virtual vle::devs::Time timeAdvance() const override;
+
+    virtual void output(vle::devs::Time time,
+                        vle::devs::ExternalEventList &output) const override;
+
+    virtual void internalTransition(vle::devs::Time time) override;
+
+    virtual void
+    externalTransition(const vle::devs::ExternalEventList &events,
+                       vle::devs::Time time) override;
+
+    virtual std::unique_ptr<value::Value>
+    observation(const vle::devs::ObservationEvent &event) const override;
+
+    int width() const noexcept { return m_width; }
+
+    int height() const noexcept { return m_height; }
+
+    /** Get the number of steps since the beginning of the simulation. */
+    std::uint64_t steps() const noexcept { return m_steps; }
+
+    /**
+     * Get the current state of the cell (x, y). The border of the grid is
+     * accessible with -1 <= x <= width() and -1 <= y <= height().
+     */
+    double cell(int x, int y) const noexcept { return m_current[index(x, y)]; }
+
+    double &cell(int x, int y) noexcept { return m_current[index(x, y)]; }
+
+    /**
+     * Get the current states of the row @e y. row(y)[-1] and
+     * row(y)[width()] are the border of the grid.
+     */
+    const double *row(int y) const noexcept
+    {
+        return &m_current[index(0, y)];
+    }
+
+    /** Get the next states of the row @e y. */
+    double *next_row(int y) noexcept { return &m_next[index(0, y)]; }
+
+protected:
+    /**
+     * Compute the next states of the rows [begin, end) from the current
+     * states. The function is called concurrently on disjoint blocks of
+     * rows and must only write next_row(y) for y in [begin, end).
+     */
+    virtual void update(int begin, int end) = 0;
+
+private:
+    std::size_t index(int x, int y) const noexcept
+    {
+        return static_cast<std::size_t>(y + 1) * m_stride + (x + 1);
+    }
+
+    enum class output_type { none, cells, sum, mean };
+
+    void fill_border() noexcept;
+
+    /** Append to @e changed the cells of the rows [begin, end) updated by
+     * the current step. */
+    void changes(int begin, int end, std::vector<std::size_t> &changed) const;
+
+    double sum() const noexcept;
+
+    void step();
+
+    std::vector<double> m_current;
+    std::vector<double> m_next;
+    std::vector<std::size_t> m_changed;
+    std::vector<std::vector<std::size_t>> m_block_changed;
+    std::unique_ptr<vle::devs::SimulatorProcessParallel> m_pool;
+    output_type m_output;
+    std::size_t m_stride;
+    int m_width;
+    int m_height;
+    int m_threads;
+    double m_border;
+    double m_time_step;
+    vle::devs::Time m_last;
+    vle::devs::Time m_next_step;
+    std::uint64_t m_steps;
+    bool m_wrap_x;
+    bool m_wrap_y;
+};
 }
 }
 
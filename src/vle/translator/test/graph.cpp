@@ -30,6 +30,8 @@
 #include <vle/translator/GraphTranslator.hpp>
 #include <vle/translator/MatrixTranslator.hpp>
 #include <vle/utils/unit-test.hpp>
+#include <vle/value/Table.hpp>
+#include <vle/value/Tuple.hpp>
 #include <vle/vpz/Vpz.hpp>
 
 using namespace vle;
@@ -129,6 +131,92 @@ private:
     int m_counter;
 };
 
+std::map<std::string, std::vector<double>> grid_results;
+
+class Diffusion : public translator::grid_dynamics {
+public:
+    Diffusion(const devs::DynamicsInit &init,
+              const devs::InitEventList &events)
+        : translator::grid_dynamics(init, events)
+    {
+    }
+
+    virtual devs::Time init(devs::Time time) override
+    {
+        auto duration = translator::grid_dynamics::init(time);
+        cell(3, 4) = 100.0;
+        return duration;
+    }
+
+    virtual void update(int begin, int end) override
+    {
+        for (int y = begin; y != end; ++y) {
+            const double *up = row(y - 1);
+            const double *current = row(y);
+            const double *down = row(y + 1);
+            double *next = next_row(y);
+
+            for (int x = 0; x != width(); ++x)
+                next[x] = 0.2 * (current[x - 1] + current[x] +
+                                 current[x + 1] + up[x] + down[x]);
+        }
+    }
+
+    virtual void finish() override
+    {
+        Ensures(steps() == 5);
+
+        auto sum = observation(devs::ObservationEvent(5.0, "view", "sum"));
+        EnsuresApproximatelyEqual(sum->toDouble().value(), 100.0, 1e-9);
+
+        auto grid = observation(devs::ObservationEvent(5.0, "view", "grid"));
+        EnsuresEqual(grid->toTable().width(), 20u);
+        EnsuresEqual(grid->toTable().height(), 10u);
+
+        grid_results[getModelName()] = grid->toTable().value();
+    }
+};
+
+/* The cells of the grid @c grid2 received by its output port. */
+std::vector<double> grid_watched;
+int grid_watched_events = 0;
+
+class GridWatcher : public devs::Dynamics {
+public:
+    GridWatcher(const devs::DynamicsInit &init,
+                const devs::InitEventList &events)
+        : devs::Dynamics(init, events)
+        , m_cells(20 * 10, 0.0)
+        , m_events(0)
+    {
+    }
+
+    virtual void externalTransition(const devs::ExternalEventList &events,
+                                    devs::Time /* time */) override
+    {
+        for (const auto &event : events) {
+            const auto &tuple = event.attributes()->toTuple();
+            Ensures(tuple.size() % 3 == 0);
+
+            for (std::size_t i = 0; i + 2 < tuple.size(); i += 3)
+                m_cells[static_cast<std::size_t>(tuple[i + 1]) * 20 +
+                        static_cast<std::size_t>(tuple[i])] = tuple[i + 2];
+
+            ++m_events;
+        }
+    }
+
+    virtual void finish() override
+    {
+        grid_watched = m_cells;
+        grid_watched_events = m_events;
+    }
+
+private:
+    std::vector<double> m_cells;
+    int m_events;
+};
+
 class GraphGenerator : public devs::Executive {
     std::mt19937 generator;
     std::string generator_type;
@@ -213,6 +301,70 @@ public:
             Ensures(metrics.edges > 0);
             Ensures(metrics.bandwidth > 0);
         }
+        else if (generator_type == "edgelist") {
+            auto gg = make_gg();
+
+            // A chain 0 -> 1 -> ... -> 999.
+            std::vector<std::int32_t> edges;
+            for (std::int32_t i = 0; i != 999; ++i) {
+                edges.push_back(i);
+                edges.push_back(i + 1);
+            }
+
+            gg.make_graph(*this, 1000, edges.data(), edges.size() / 2);
+
+            auto metrics = gg.metrics();
+
+            Ensures(metrics.vertices == 1000);
+            Ensures(metrics.edges == 999);
+            Ensures(metrics.bandwidth == 1);
+        }
+        else if (generator_type == "csr") {
+            auto gg = make_gg();
+
+            // A chain 0 -> 1 -> ... -> 999.
+            std::vector<std::int32_t> offsets, targets;
+            for (std::int32_t i = 0; i != 1000; ++i) {
+                offsets.push_back(static_cast<std::int32_t>(targets.size()));
+                if (i != 999)
+                    targets.push_back(i + 1);
+            }
+            offsets.push_back(static_cast<std::int32_t>(targets.size()));
+
+            gg.make_csr_graph(*this, 1000, offsets.data(), targets.data());
+
+            auto metrics = gg.metrics();
+
+            Ensures(metrics.vertices == 1000);
+            Ensures(metrics.edges == 999);
+            Ensures(metrics.bandwidth == 1);
+
+            std::vector<std::int32_t> bad{ 0, 1000 };
+            EnsuresThrow(gg.make_graph(*this, 1000, bad.data(), 1),
+                         utils::ArgError);
+        }
+        else if (generator_type == "grid") {
+            auto rgg = make_rgg();
+
+            vpz::Condition threads("threads");
+            threads.addValueToPort("grid-threads", value::Integer::create(3));
+            conditions().add(threads);
+
+            std::array<int, 2> length{{20, 10}};
+            std::array<bool, 2> wrap{{true, true}};
+            rgg.make_grid(*this, "grid1", "diffusion", length, wrap);
+            rgg.make_grid(
+                *this, "grid2", "diffusion", length, wrap, {"threads"});
+
+            auto metrics = rgg.metrics();
+            Ensures(metrics.vertices == 200);
+            Ensures(coupledmodel().getModelList().size() == 3);
+
+            createModel("watcher", {"in"}, {}, "watcher");
+            addConnection("grid2", "out", "watcher", "in");
+
+            return devs::Executive::init(time);
+        }
         else if (generator_type == "1d") {
             auto rgg = make_rgg();
             std::vector<std::string> mask{"left", "", "right"};
@@ -273,6 +425,8 @@ public:
 
 DECLARE_DYNAMICS_SYMBOL(dynamics_Beep, Beep)
 DECLARE_DYNAMICS_SYMBOL(dynamics_transform, Transform)
+DECLARE_DYNAMICS_SYMBOL(dynamics_diffusion, Diffusion)
+DECLARE_DYNAMICS_SYMBOL(dynamics_watcher, GridWatcher)
 DECLARE_EXECUTIVE_SYMBOL(exe_graph, GraphGenerator)
 
 void test_smallworld()
@@ -339,6 +493,40 @@ void test_scalefree()
     Ensures(not out);
 }
 
+void test_sparse()
+{
+    auto ctx = vle::utils::make_context();
+    vle::utils::Path p(TRANSLATOR_TEST_DIR);
+    vle::utils::Path::current_path(p);
+
+    for (auto type : { "edgelist", "csr" }) {
+        vpz::Vpz file(TRANSLATOR_TEST_DIR "/graph.vpz");
+        devs::RootCoordinator root(ctx);
+
+        auto &cond = file.project()
+                         .experiment()
+                         .conditions()
+                         .get("cond")
+                         .getSetValues("generator")[0]
+                         ->toString()
+                         .value();
+
+        cond = type;
+
+        root.load(file);
+        file.clear();
+        root.init();
+
+        while (root.run())
+            ;
+
+        auto out = root.outputs();
+        root.finish();
+
+        Ensures(not out);
+    }
+}
+
 void test_sorted_erdos_renyi()
 {
     auto ctx = vle::utils::make_context();
@@ -499,6 +687,60 @@ void test_regular_2d_wrap()
     Ensures(not out);
 }
 
+void test_grid()
+{
+    auto ctx = vle::utils::make_context();
+    vle::utils::Path p(TRANSLATOR_TEST_DIR);
+    vle::utils::Path::current_path(p);
+
+    vpz::Vpz file(TRANSLATOR_TEST_DIR "/graph.vpz");
+    devs::RootCoordinator root(ctx);
+
+    auto &cond = file.project()
+                     .experiment()
+                     .conditions()
+                     .get("cond")
+                     .getSetValues("generator")[0]
+                     ->toString()
+                     .value();
+
+    cond = "grid";
+
+    root.load(file);
+    file.clear();
+    root.init();
+
+    while (root.run())
+        ;
+
+    root.finish();
+
+    EnsuresEqual(grid_results.size(), 2u);
+    Ensures(grid_results["grid1"] == grid_results["grid2"]);
+    Ensures(grid_results["grid1"][4 * 20 + 3] < 100.0);
+
+    /* The grid sends before each step the cells changed by the previous
+     * one: the watcher receives the grid of the fourth step. */
+    std::vector<double> cells(20 * 10, 0.0), next(cells.size());
+    cells[4 * 20 + 3] = 100.0;
+    for (int step = 0; step != 4; ++step) {
+        for (int y = 0; y != 10; ++y)
+            for (int x = 0; x != 20; ++x)
+                next[y * 20 + x] =
+                    0.2 * (cells[y * 20 + (x + 19) % 20] + cells[y * 20 + x] +
+                           cells[y * 20 + (x + 1) % 20] +
+                           cells[(y + 9) % 10 * 20 + x] +
+                           cells[(y + 1) % 10 * 20 + x]);
+        std::swap(cells, next);
+    }
+
+    EnsuresEqual(grid_watched_events, 4);
+    EnsuresEqual(grid_watched.size(), cells.size());
+    for (std::size_t i = 0; i != cells.size() and i != grid_watched.size();
+         ++i)
+        EnsuresApproximatelyEqual(grid_watched[i], cells[i], 1e-9);
+}
+
 int main()
 {
     vle::Init app;
@@ -506,11 +748,13 @@ int main()
     test_smallworld();
     test_scalefree();
     test_sorted_erdos_renyi();
+    test_sparse();
 
     test_regular_1d();
     test_regular_2d();
     test_regular_1d_wrap();
     test_regular_2d_wrap();
+    test_grid();
 
     return unit_test::report_errors();
 }
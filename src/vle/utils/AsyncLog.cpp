@@ -0,0 +1,610 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vle/utils/AsyncLog.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace {
+
+enum class Length { none, hh, h, l, ll, j, z, t, L };
+
+struct Spec
+{
+    const char *end;  /**< The first character after the specification. */
+    char conversion;  /**< The conversion character or 0 if unsupported. */
+    Length length;
+};
+
+/* Parse the conversion specification which starts at @e str (a '%'). The
+ * conversion is 0 if the arguments can not be copied: a '*' width or
+ * precision, a %n, a long double, a wide character or string. */
+Spec parse(const char *str) noexcept
+{
+    Spec ret{ str + 1, 0, Length::none };
+    const char *p = str + 1;
+
+    if (*p == '%') {
+        ret.end = p + 1;
+        ret.conversion = '%';
+        return ret;
+    }
+
+    while (*p and std::strchr("-+ #0'", *p))
+        ++p;
+
+    if (*p == '*')
+        return ret;
+    while (*p >= '0' and *p <= '9')
+        ++p;
+
+    if (*p == '.') {
+        ++p;
+        if (*p == '*')
+            return ret;
+        while (*p >= '0' and *p <= '9')
+            ++p;
+    }
+
+    switch (*p) {
+    case 'h':
+        ++p;
+        ret.length = (*p == 'h') ? (++p, Length::hh) : Length::h;
+        break;
+    case 'l':
+        ++p;
+        ret.length = (*p == 'l') ? (++p, Length::ll) : Length::l;
+        break;
+    case 'j':
+        ++p;
+        ret.length = Length::j;
+        break;
+    case 'z':
+        ++p;
+        ret.length = Length::z;
+        break;
+    case 't':
+        ++p;
+        ret.length = Length::t;
+        break;
+    case 'L':
+        ++p;
+        ret.length = Length::L;
+        break;
+    default:
+        break;
+    }
+
+    if (*p == '\0' or ret.length == Length::L or
+        not std::strchr("diouxXcfFeEgGaAsp", *p) or
+        ((*p == 'c' or *p == 's') and ret.length != Length::none))
+        return ret;
+
+    ret.end = p + 1;
+    ret.conversion = *p;
+    return ret;
+}
+
+bool is_signed(char c) noexcept
+{
+    return c == 'd' or c == 'i' or c == 'c';
+}
+
+bool is_unsigned(char c) noexcept
+{
+    return c == 'o' or c == 'u' or c == 'x' or c == 'X';
+}
+
+bool is_real(char c) noexcept
+{
+    return std::strchr("fFeEgGaA", c) != nullptr;
+}
+
+using ssize_type = std::make_signed<std::size_t>::type;
+using uptrdiff_type = std::make_unsigned<std::ptrdiff_t>::type;
+
+/* Append to @e out the formatting of the @e value with the specification
+ * [@e begin, @e end). */
+template <typename T>
+void append(std::string &out, const char *begin, const char *end, T value)
+{
+    char spec[32];
+    char buffer[256];
+
+    const auto size = std::min<std::size_t>(end - begin, sizeof(spec) - 1);
+    std::memcpy(spec, begin, size);
+    spec[size] = '\0';
+
+    int ret = std::snprintf(buffer, sizeof(buffer), spec, value);
+    if (ret < 0)
+        return;
+
+    if (static_cast<std::size_t>(ret) < sizeof(buffer)) {
+        out.append(buffer, ret);
+    } else {
+        std::string tmp(ret + 1, '\0');
+        std::snprintf(&tmp[0], tmp.size(), spec, value);
+        out.append(tmp.data(), ret);
+    }
+}
+
+void forward(vle::utils::Context::LogFunctor &sink,
+             const vle::utils::Context &ctx,
+             int priority,
+             const char *file,
+             int line,
+             const char *fn,
+             const char *format,
+             ...) noexcept
+{
+    va_list args;
+
+    va_start(args, format);
+    sink.write(ctx, priority, file, line, fn, format, args);
+    va_end(args);
+}
+
+std::atomic<std::uint64_t> async_log_id(1);
+
+} // anonymous namespace
+
+namespace vle {
+namespace utils {
+
+/*
+ * A message: the pointers to the file, the function and the format and
+ * the arguments. The strings are copied into the text buffer. If the
+ * format is null, the text buffer stores the formatted message.
+ */
+struct AsyncLog::Record
+{
+    static const std::size_t max_args = 12;
+    static const std::size_t text_size = 352;
+
+    union Value {
+        long long i;
+        unsigned long long u;
+        double d;
+        const void *p;
+        std::size_t offset;
+    };
+
+    const Context *ctx;
+    const char *file;
+    const char *fn;
+    const char *format;
+    int priority;
+    int line;
+    Value args[max_args];
+    char text[text_size];
+};
+
+struct AsyncLog::Ring
+{
+    explicit Ring(std::size_t capacity)
+        : records(capacity)
+        , owner(std::this_thread::get_id())
+        , head(0)
+        , tail(0)
+    {
+    }
+
+    std::vector<Record> records;
+    std::thread::id owner;
+
+    // The consumer reads head and writes tail, the producer the opposite:
+    // keep the two counters on different cache lines.
+    std::atomic<std::uint64_t> head;
+    char padding[64];
+    std::atomic<std::uint64_t> tail;
+};
+
+namespace {
+
+/* Copy the arguments of the @e format into the record. Returns false if
+ * the format needs an unsupported conversion or too many arguments. */
+bool capture(AsyncLog::Record &rec, const char *format, va_list args) noexcept
+{
+    std::size_t nargs = 0;
+    std::size_t text = 0;
+
+    for (const char *p = format; *p; ++p) {
+        if (*p != '%')
+            continue;
+
+        Spec spec = parse(p);
+        if (spec.conversion == 0 or spec.end - p >= 32)
+            return false;
+
+        p = spec.end - 1;
+        if (spec.conversion == '%')
+            continue;
+
+        if (nargs == AsyncLog::Record::max_args)
+            return false;
+
+        auto &value = rec.args[nargs++];
+        const char c = spec.conversion;
+
+        if (is_signed(c)) {
+            switch (spec.length) {
+            case Length::l:
+                value.i = va_arg(args, long);
+                break;
+            case Length::ll:
+                value.i = va_arg(args, long long);
+                break;
+            case Length::j:
+                value.i = va_arg(args, std::intmax_t);
+                break;
+            case Length::z:
+                value.i = va_arg(args, ssize_type);
+                break;
+            case Length::t:
+                value.i = va_arg(args, std::ptrdiff_t);
+                break;
+            default:
+                value.i = va_arg(args, int);
+                break;
+            }
+        } else if (is_unsigned(c)) {
+            switch (spec.length) {
+            case Length::l:
+                value.u = va_arg(args, unsigned long);
+                break;
+            case Length::ll:
+                value.u = va_arg(args, unsigned long long);
+                break;
+            case Length::j:
+                value.u = va_arg(args, std::uintmax_t);
+                break;
+            case Length::z:
+                value.u = va_arg(args, std::size_t);
+                break;
+            case Length::t:
+                value.u = va_arg(args, uptrdiff_type);
+                break;
+            default:
+                value.u = va_arg(args, unsigned int);
+                break;
+            }
+        } else if (is_real(c)) {
+            value.d = va_arg(args, double);
+        } else if (c == 'p') {
+            value.p = va_arg(args, void *);
+        } else { // 's'
+            const char *str = va_arg(args, const char *);
+            if (not str)
+                str = "(null)";
+
+            const std::size_t available =
+                AsyncLog::Record::text_size - text - 1;
+            const std::size_t size = std::min(std::strlen(str), available);
+
+            std::memcpy(rec.text + text, str, size);
+            rec.text[text + size] = '\0';
+            value.offset = text;
+            text += std::min(size + 1, available);
+        }
+    }
+
+    return true;
+}
+
+/* Format the record into @e out. */
+void format_record(const AsyncLog::Record &rec, std::string &out)
+{
+    out.clear();
+
+    if (not rec.format) {
+        out.assign(rec.text);
+        return;
+    }
+
+    std::size_t nargs = 0;
+    const char *p = rec.format;
+
+    while (*p) {
+        if (*p != '%') {
+            const char *next = std::strchr(p, '%');
+            if (not next)
+                next = p + std::strlen(p);
+            out.append(p, next);
+            p = next;
+            continue;
+        }
+
+        Spec spec = parse(p);
+        const char c = spec.conversion;
+
+        if (c == '%') {
+            out.push_back('%');
+            p = spec.end;
+            continue;
+        }
+
+        const auto &value = rec.args[nargs++];
+
+        if (is_signed(c)) {
+            switch (spec.length) {
+            case Length::l:
+                append(out, p, spec.end, static_cast<long>(value.i));
+                break;
+            case Length::ll:
+                append(out, p, spec.end, value.i);
+                break;
+            case Length::j:
+                append(out, p, spec.end, static_cast<std::intmax_t>(value.i));
+                break;
+            case Length::z:
+                append(out, p, spec.end, static_cast<ssize_type>(value.i));
+                break;
+            case Length::t:
+                append(
+                    out, p, spec.end, static_cast<std::ptrdiff_t>(value.i));
+                break;
+            default:
+                append(out, p, spec.end, static_cast<int>(value.i));
+                break;
+            }
+        } else if (is_unsigned(c)) {
+            switch (spec.length) {
+            case Length::l:
+                append(out, p, spec.end, static_cast<unsigned long>(value.u));
+                break;
+            case Length::ll:
+                append(out, p, spec.end, value.u);
+                break;
+            case Length::j:
+                append(
+                    out, p, spec.end, static_cast<std::uintmax_t>(value.u));
+                break;
+            case Length::z:
+                append(out, p, spec.end, static_cast<std::size_t>(value.u));
+                break;
+            case Length::t:
+                append(out, p, spec.end, static_cast<uptrdiff_type>(value.u));
+                break;
+            default:
+                append(out, p, spec.end, static_cast<unsigned int>(value.u));
+                break;
+            }
+        } else if (is_real(c)) {
+            append(out, p, spec.end, value.d);
+        } else if (c == 'p') {
+            append(out, p, spec.end, value.p);
+        } else {
+            append(out, p, spec.end,
+                   static_cast<const char *>(rec.text + value.offset));
+        }
+
+        p = spec.end;
+    }
+}
+
+} // anonymous namespace
+
+AsyncLog::AsyncLog(std::unique_ptr<Context::LogFunctor> sink,
+                   std::size_t capacity)
+    : m_sink(std::move(sink))
+    , m_capacity(std::max<std::size_t>(capacity, 2))
+    , m_id(async_log_id.fetch_add(1))
+    , m_dropped(0)
+    , m_reported(0)
+    , m_last(nullptr)
+    , m_request(0)
+    , m_done(0)
+    , m_stop(false)
+{
+    m_thread = std::thread(&AsyncLog::run, this);
+}
+
+AsyncLog::~AsyncLog()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_cv.notify_one();
+    m_thread.join();
+}
+
+AsyncLog::Ring *AsyncLog::ring() noexcept
+{
+    struct Cache
+    {
+        std::uint64_t id;
+        Ring *ring;
+    };
+
+    static thread_local Cache cache = { 0, nullptr };
+
+    if (cache.id == m_id)
+        return cache.ring;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto id = std::this_thread::get_id();
+
+    // A ring of a finished thread is reused by the threads with the same
+    // identifier, the number of rings is bounded by the number of threads
+    // running at the same time.
+    auto it = std::find_if(
+        m_rings.begin(), m_rings.end(), [id](const std::unique_ptr<Ring> &r) {
+            return r->owner == id;
+        });
+
+    Ring *ret = nullptr;
+    if (it != m_rings.end()) {
+        ret = it->get();
+    } else {
+        try {
+            m_rings.emplace_back(new Ring(m_capacity));
+            ret = m_rings.back().get();
+        } catch (...) {
+            return nullptr;
+        }
+    }
+
+    cache.id = m_id;
+    cache.ring = ret;
+
+    return ret;
+}
+
+void AsyncLog::write(const Context &ctx,
+                     int priority,
+                     const char *file,
+                     int line,
+                     const char *fn,
+                     const char *format,
+                     va_list args) noexcept
+{
+    Ring *r = ring();
+    if (not r) {
+        m_last.store(&ctx, std::memory_order_relaxed);
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const auto tail = r->tail.load(std::memory_order_relaxed);
+    const auto head = r->head.load(std::memory_order_acquire);
+    const auto used = tail - head;
+
+    if (used >= m_capacity) {
+        m_last.store(&ctx, std::memory_order_relaxed);
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto &rec = r->records[tail % m_capacity];
+    rec.ctx = &ctx;
+    rec.file = file;
+    rec.fn = fn;
+    rec.format = format;
+    rec.priority = priority;
+    rec.line = line;
+
+    va_list copy;
+    va_copy(copy, args);
+    const bool captured = capture(rec, format, copy);
+    va_end(copy);
+
+    if (not captured) {
+        rec.format = nullptr;
+        std::vsnprintf(rec.text, Record::text_size, format, args);
+    }
+
+    r->tail.store(tail + 1, std::memory_order_release);
+
+    // Wake up the background thread before the ring becomes full.
+    if (used + 1 == m_capacity / 2)
+        m_cv.notify_one();
+}
+
+void AsyncLog::drain() noexcept
+{
+    std::vector<Ring *> rings;
+    std::string message;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        rings.reserve(m_rings.size());
+        for (auto &r : m_rings)
+            rings.push_back(r.get());
+    }
+
+    for (auto *r : rings) {
+        auto head = r->head.load(std::memory_order_relaxed);
+        const auto tail = r->tail.load(std::memory_order_acquire);
+
+        for (; head != tail; ++head) {
+            const auto &rec = r->records[head % m_capacity];
+
+            try {
+                format_record(rec, message);
+            } catch (...) {
+                message.assign(rec.format ? rec.format : rec.text);
+            }
+
+            ::forward(*m_sink, *rec.ctx, rec.priority, rec.file, rec.line,
+                      rec.fn, "%s", message.c_str());
+        }
+
+        r->head.store(head, std::memory_order_release);
+    }
+
+    const auto dropped = m_dropped.load(std::memory_order_relaxed);
+    const auto *ctx = m_last.load(std::memory_order_relaxed);
+    if (dropped != m_reported and ctx) {
+        ::forward(*m_sink, *ctx, 4, __FILE__, __LINE__, __FUNCTION__,
+                  "%llu log messages dropped\n",
+                  static_cast<unsigned long long>(dropped - m_reported));
+        m_reported = dropped;
+    }
+}
+
+void AsyncLog::run() noexcept
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for (;;) {
+        m_cv.wait_for(lock, std::chrono::milliseconds(50), [this]() {
+            return m_stop or m_request != m_done;
+        });
+
+        const auto request = m_request;
+        const bool stop = m_stop;
+
+        lock.unlock();
+        drain();
+        lock.lock();
+
+        m_done = request;
+        m_flushed.notify_all();
+
+        if (stop)
+            break;
+    }
+}
+
+void AsyncLog::flush() noexcept
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const auto request = ++m_request;
+
+    m_cv.notify_one();
+    m_flushed.wait(lock, [this, request]() { return m_done >= request; });
+}
+}
+} // namespace vle utils
@@ -0,0 +1,146 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef VLE_UTILS_ASYNCLOG_HPP
+#define VLE_UTILS_ASYNCLOG_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <vle/DllDefines.hpp>
+#include <vle/utils/Context.hpp>
+
+namespace vle {
+namespace utils {
+
+/**
+ * @brief An asynchronous Context::LogFunctor. The calling thread copies
+ * the format pointer and the raw arguments of the message into a ring
+ * buffer of its own (a single producer, single consumer lock-free queue)
+ * and returns. A background thread formats the messages and sends them to
+ * the wrapped Context::LogFunctor.
+ *
+ * The memory is bounded: when the ring buffer of a thread is full, the
+ * message is dropped and a counter is incremented. The background thread
+ * reports the number of dropped messages to the wrapped functor.
+ *
+ * The format must be a literal string (or a string of the i18n catalog)
+ * since only its pointer is stored. The strings (@c %s) are copied and
+ * truncated to the remaining size of the record. A format that uses @c *
+ * for a width or a precision, @c %n or a @c long @c double is formatted
+ * by the calling thread.
+ *
+ * @code
+ * auto ctx = vle::utils::make_context();
+ * ctx->set_log_priority(7);
+ * ctx->set_log_asynchronous(4096);
+ * @endcode
+ */
+class VLE_API AsyncLog : public Context::LogFunctor
+{
+public:
+    /**
+     * @brief Build the background thread.
+     * @param sink The Context::LogFunctor which writes the messages.
+     * @param capacity The number of messages of the ring buffer of each
+     * thread.
+     */
+    AsyncLog(std::unique_ptr<Context::LogFunctor> sink, std::size_t capacity);
+
+    /**
+     * @brief Write the pending messages and join the background thread.
+     */
+    virtual ~AsyncLog();
+
+    AsyncLog(const AsyncLog &) = delete;
+    AsyncLog &operator=(const AsyncLog &) = delete;
+
+    virtual void write(const Context &ctx,
+                       int priority,
+                       const char *file,
+                       int line,
+                       const char *fn,
+                       const char *format,
+                       va_list args) noexcept override;
+
+    /**
+     * @brief Wait until the background thread writes all the messages
+     * pushed before the call.
+     */
+    void flush() noexcept;
+
+    /**
+     * @brief Take the wrapped Context::LogFunctor. Only for the child
+     * process of a fork(): the background thread is not copied into the
+     * child and the mutex may be locked, so the AsyncLog of the child
+     * must be leaked, never used nor destroyed.
+     */
+    std::unique_ptr<Context::LogFunctor> release_sink() noexcept
+    {
+        return std::move(m_sink);
+    }
+
+    /**
+     * @brief Get the number of messages dropped since the construction.
+     */
+    std::uint64_t dropped() const noexcept
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    struct Record;
+    struct Ring;
+
+private:
+    Ring *ring() noexcept;
+    void drain() noexcept;
+    void run() noexcept;
+
+    std::unique_ptr<Context::LogFunctor> m_sink;
+    std::vector<std::unique_ptr<Ring>> m_rings;
+    std::size_t m_capacity;
+    std::uint64_t m_id;
+    std::atomic<std::uint64_t> m_dropped;
+    std::uint64_t m_reported;
+    std::atomic<const Context *> m_last; /**< A context to report drops. */
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::condition_variable m_flushed;
+    std::uint64_t m_request;
+    std::uint64_t m_done;
+    bool m_stop;
+    std::thread m_thread;
+};
+}
+} // namespace vle utils
+
+#endif
@@ -26,6 +26,7 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
+#include <vle/utils/AsyncLog.hpp>
 #include <vle/utils/Context.hpp>
 #include <vle/utils/ContextPrivate.hpp>
 #include <vle/utils/Exception.hpp>
@@ -336,6 +337,31 @@ void Context::set_log_function(std::unique_ptr<LogFunctor> fn) noexcept
     vInfo(this, "custom logging function registered\n");
 }
 
+void Context::set_log_asynchronous(std::size_t capacity)
+{
+    if (dynamic_cast<AsyncLog *>(m_pimpl->log_fn.get()))
+        return;
+
+    m_pimpl->log_fn =
+        std::make_unique<AsyncLog>(std::move(m_pimpl->log_fn), capacity);
+}
+
+void Context::flush_log() noexcept
+{
+    if (auto *async = dynamic_cast<AsyncLog *>(m_pimpl->log_fn.get()))
+        async->flush();
+}
+
+void Context::reset_log_after_fork() noexcept
+{
+    if (auto *async = dynamic_cast<AsyncLog *>(m_pimpl->log_fn.get())) {
+        // The AsyncLog is leaked: its destructor would join a thread of
+        // the parent process.
+        m_pimpl->log_fn.release();
+        m_pimpl->log_fn = async->release_sink();
+    }
+}
+
 void Context::set_log_priority(int priority) noexcept
 {
     m_pimpl->log_priority = priority % 8;
@@ -436,6 +436,30 @@ public:
 
     void set_log_function(std::unique_ptr<LogFunctor> fn) noexcept;
 
+    /**
+     * Wrap the current log function into a utils::AsyncLog: the messages
+     * are copied into a ring buffer of @e capacity messages per thread and
+     * formatted by a background thread. Nothing is done if the log
+     * function is already asynchronous.
+     *
+     * @throw std::system_error if the background thread can not be built.
+     */
+    void set_log_asynchronous(std::size_t capacity);
+
+    /**
+     * Wait until the asynchronous log function writes all the pending
+     * messages.
+     */
+    void flush_log() noexcept;
+
+    /**
+     * Replace an asynchronous log function by the log function it wraps.
+     * To call in the child process of a fork(), before any message: the
+     * background thread of the utils::AsyncLog only exists in the parent
+     * and the messages of the child would be lost.
+     */
+    void reset_log_after_fork() noexcept;
+
     void set_log_priority(int priority) noexcept;
 
     int get_log_priority() const noexcept;
@@ -103,6 +103,10 @@ void Context::reset_settings() noexcept
         {"gvle.graphics.line-width", 3.0},
         {"vle.simulation.thread", 0l},
         {"vle.simulation.block-size", 8l},
+        {"vle.simulation.parallel-init", false},
+        {"vle.simulation.partition", false},
+        {"vle.simulation.worker-pool", true},
+        {"vle.log.asynchronous", 0l},
         {"vle.packages.configure", std::string(VLE_PACKAGE_COMMAND_CONFIGURE)},
         {"vle.packages.test", std::string(VLE_PACKAGE_COMMAND_TEST)},
         {"vle.packages.build", std::string(VLE_PACKAGE_COMMAND_BUILD)},
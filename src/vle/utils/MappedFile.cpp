@@ -0,0 +1,157 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fstream>
+#include <mutex>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unordered_map>
+#include <vector>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/MappedFile.hpp>
+#include <vle/utils/i18n.hpp>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace vle {
+namespace utils {
+
+struct MappedFile::Pimpl
+{
+#ifndef _WIN32
+    void *mapped = nullptr;
+    std::size_t length = 0;
+
+    ~Pimpl()
+    {
+        if (mapped)
+            ::munmap(mapped, length);
+    }
+#else
+    std::vector<char> buffer;
+#endif
+};
+
+MappedFile::MappedFile(const std::string &filename)
+    : m_pimpl(new Pimpl())
+    , m_filename(filename)
+    , m_data(nullptr)
+    , m_size(0)
+{
+#ifndef _WIN32
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw FileError(
+            (fmt(_("MappedFile: cannot open file '%1%'")) % filename).str());
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw FileError(
+            (fmt(_("MappedFile: cannot stat file '%1%'")) % filename).str());
+    }
+
+    if (st.st_size > 0) {
+        auto length = static_cast<std::size_t>(st.st_size);
+        void *ptr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (ptr == MAP_FAILED) {
+            ::close(fd);
+            throw FileError(
+                (fmt(_("MappedFile: cannot map file '%1%'")) % filename)
+                    .str());
+        }
+
+        m_pimpl->mapped = ptr;
+        m_pimpl->length = length;
+        m_data = static_cast<const char *>(ptr);
+        m_size = length;
+    }
+
+    ::close(fd);
+#else
+    std::ifstream ifs(filename, std::ios::binary);
+    if (not ifs.is_open())
+        throw FileError(
+            (fmt(_("MappedFile: cannot open file '%1%'")) % filename).str());
+
+    m_pimpl->buffer.assign(std::istreambuf_iterator<char>(ifs),
+                           std::istreambuf_iterator<char>());
+    m_data = m_pimpl->buffer.data();
+    m_size = m_pimpl->buffer.size();
+#endif
+}
+
+MappedFile::~MappedFile() = default;
+
+std::shared_ptr<const MappedFile> MappedFile::open(const std::string &filename)
+{
+    struct Entry
+    {
+        std::weak_ptr<const MappedFile> file;
+        off_t size;
+        time_t mtime;
+    };
+
+    static std::mutex mutex;
+    static std::unordered_map<std::string, Entry> files;
+
+    struct stat st;
+    if (::stat(filename.c_str(), &st) != 0)
+        throw FileError(
+            (fmt(_("MappedFile: cannot open file '%1%'")) % filename).str());
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = files.find(filename);
+    if (it != files.end() and it->second.size == st.st_size and
+        it->second.mtime == st.st_mtime) {
+        auto file = it->second.file.lock();
+        if (file)
+            return file;
+    }
+
+    auto file = std::make_shared<const MappedFile>(filename);
+
+    // Forget the mappings released by all their users before adding a new
+    // one: the table does not grow with the number of files ever opened.
+    for (auto jt = files.begin(); jt != files.end();) {
+        if (jt->second.file.expired())
+            jt = files.erase(jt);
+        else
+            ++jt;
+    }
+
+    files[filename] = Entry{file, st.st_size, st.st_mtime};
+
+    return file;
+}
+}
+} // namespace vle utils
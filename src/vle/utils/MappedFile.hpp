@@ -0,0 +1,104 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_UTILS_MAPPEDFILE_HPP
+#define VLE_UTILS_MAPPEDFILE_HPP
+
+#include <memory>
+#include <string>
+#include <vle/DllDefines.hpp>
+
+namespace vle {
+namespace utils {
+
+/**
+ * @brief A read only view of the whole content of a file. The file is
+ * mapped in memory when the system provides @c mmap, otherwise it is read
+ * into a buffer.
+ *
+ * @code
+ * auto file = vle::utils::MappedFile::open("weather.bin");
+ * auto *ptr = reinterpret_cast<const double *>(file->data());
+ * auto size = file->size() / sizeof(double);
+ * @endcode
+ */
+class VLE_API MappedFile
+{
+public:
+    /**
+     * @brief Map the file @e filename.
+     * @param filename The file to map.
+     * @throw utils::FileError if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string &filename);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * @brief Get a mapping of the file @e filename shared by all the
+     * callers of the process. The mapping is kept while a caller holds it
+     * and is rebuilt if the size or the modification time of the file
+     * change. The released mappings are forgotten. This function is thread
+     * safe.
+     * @param filename The file to map.
+     * @throw utils::FileError if the file cannot be opened or mapped.
+     */
+    static std::shared_ptr<const MappedFile> open(const std::string &filename);
+
+    const std::string &filename() const noexcept
+    {
+        return m_filename;
+    }
+
+    const char *data() const noexcept
+    {
+        return m_data;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+private:
+    struct Pimpl;
+    std::unique_ptr<Pimpl> m_pimpl;
+    std::string m_filename;
+    const char *m_data;
+    std::size_t m_size;
+};
+}
+} // namespace vle utils
+
+#endif
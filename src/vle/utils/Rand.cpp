@@ -25,6 +25,7 @@
  */
 
 #include <vle/utils/Rand.hpp>
+#include <algorithm>
 
 #define _USE_MATH_DEFINES
 #include <cmath>
@@ -34,6 +35,39 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+namespace {
+
+const std::uint32_t philox_m0 = 0xD2511F53;
+const std::uint32_t philox_m1 = 0xCD9E8D57;
+const std::uint32_t philox_w0 = 0x9E3779B9;
+const std::uint32_t philox_w1 = 0xBB67AE85;
+
+inline std::uint64_t splitmix64(std::uint64_t x) noexcept
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/* Build a real [0, 1) from the 53 high bits of two integers. */
+inline double to_double(std::uint64_t high, std::uint64_t low) noexcept
+{
+    return static_cast<double>(((high << 32) | low) >> 11) *
+           (1.0 / 9007199254740992.0);
+}
+
+inline std::array<std::uint32_t, 4>
+philox_counter(std::uint64_t position, std::uint64_t stream) noexcept
+{
+    return { { static_cast<std::uint32_t>(position),
+               static_cast<std::uint32_t>(position >> 32),
+               static_cast<std::uint32_t>(stream),
+               static_cast<std::uint32_t>(stream >> 32) } };
+}
+
+} // anonymous namespace
+
 namespace vle { namespace utils {
 
 Rand::Rand(result_type seed)
@@ -44,6 +78,7 @@ Rand::Rand(result_type seed)
 void Rand::seed(result_type seed)
 {
     m_rand.seed(seed);
+    m_normal.reset();
 }
 
 bool Rand::getBool()
@@ -77,8 +112,10 @@ double Rand::getDouble(double begin, double end)
 
 double Rand::normal(double mean, double sigma)
 {
-    std::normal_distribution<double> distrib(mean, sigma);
-    return distrib(m_rand);
+    // The member distribution keeps the second variate of its pair
+    // between calls whatever the parameters.
+    using param_type = std::normal_distribution<double>::param_type;
+    return m_normal(m_rand, param_type(mean, sigma));
 }
 
 double Rand::logNormal(double mean, double sigma)
@@ -186,4 +223,202 @@ double Rand::weibull3(const double a, const double b, const double c)
     return c + b * x;
 }
 
+/*
+ * Philox
+ */
+
+Philox::Philox(std::uint64_t key, std::uint64_t stream) noexcept
+    : m_output()
+    , m_key({ { static_cast<result_type>(key),
+                static_cast<result_type>(key >> 32) } })
+    , m_stream(stream)
+    , m_position(0)
+    , m_index(4)
+{
+}
+
+std::array<Philox::result_type, 4>
+Philox::block(std::array<result_type, 4> ctr,
+              std::array<result_type, 2> key) noexcept
+{
+    for (int round = 0; round != 10; ++round) {
+        if (round) {
+            key[0] += philox_w0;
+            key[1] += philox_w1;
+        }
+
+        const std::uint64_t p0 = static_cast<std::uint64_t>(philox_m0) * ctr[0];
+        const std::uint64_t p1 = static_cast<std::uint64_t>(philox_m1) * ctr[2];
+
+        ctr = { { static_cast<result_type>(p1 >> 32) ^ ctr[1] ^ key[0],
+                  static_cast<result_type>(p1),
+                  static_cast<result_type>(p0 >> 32) ^ ctr[3] ^ key[1],
+                  static_cast<result_type>(p0) } };
+    }
+
+    return ctr;
+}
+
+void Philox::next() noexcept
+{
+    m_output = block(philox_counter(m_position, m_stream), m_key);
+    ++m_position;
+    m_index = 0;
+}
+
+void Philox::discard(std::uint64_t n) noexcept
+{
+    // The absolute position of the next integer in the stream.
+    const std::uint64_t current = m_position * 4 - 4 + m_index;
+    const std::uint64_t target = current + n;
+
+    m_position = target / 4;
+    m_index = 4;
+
+    if (target % 4) {
+        next();
+        m_index = static_cast<unsigned int>(target % 4);
+    }
+}
+
+void Philox::fill(result_type* out, std::size_t n) noexcept
+{
+    while (n and m_index != 4) {
+        *out++ = m_output[m_index++];
+        --n;
+    }
+
+    for (; n >= 4; n -= 4, out += 4) {
+        const auto ret = block(philox_counter(m_position++, m_stream), m_key);
+        std::copy(ret.begin(), ret.end(), out);
+    }
+
+    while (n--)
+        *out++ = operator()();
+}
+
+Philox Philox::split(std::uint64_t stream) const noexcept
+{
+    Philox ret(0, splitmix64(splitmix64(m_stream) ^ (stream + 1)));
+    ret.m_key = m_key;
+
+    return ret;
+}
+
+/*
+ * RandStream
+ */
+
+RandStream::RandStream(std::uint64_t seed,
+                       const std::string& name,
+                       std::uint64_t stream)
+    : m_gen(key(seed, name), stream)
+    , m_normal(0.0)
+    , m_have_normal(false)
+{
+}
+
+RandStream::RandStream(const Philox& gen) noexcept
+    : m_gen(gen)
+    , m_normal(0.0)
+    , m_have_normal(false)
+{
+}
+
+std::uint64_t RandStream::key(std::uint64_t seed,
+                              const std::string& name) noexcept
+{
+    std::uint64_t hash = 0xCBF29CE484222325ULL; // FNV-1a 64 bits.
+    for (auto c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001B3ULL;
+    }
+
+    return splitmix64(splitmix64(seed) ^ hash);
+}
+
+RandStream RandStream::split(std::uint64_t stream) const noexcept
+{
+    return RandStream(m_gen.split(stream));
+}
+
+int RandStream::getInt(int begin, int end) noexcept
+{
+    const std::uint64_t range = static_cast<std::uint64_t>(
+        static_cast<std::int64_t>(end) - begin) + 1;
+
+    if (range > 0xFFFFFFFF)
+        return static_cast<int>(begin + static_cast<std::int64_t>(m_gen()));
+
+    // Lemire's nearly divisionless method: the rejection removes the
+    // bias of the multiplication.
+    const auto r = static_cast<std::uint32_t>(range);
+    std::uint64_t m = static_cast<std::uint64_t>(m_gen()) * r;
+    auto low = static_cast<std::uint32_t>(m);
+
+    if (low < r) {
+        const std::uint32_t threshold = (0u - r) % r;
+        while (low < threshold) {
+            m = static_cast<std::uint64_t>(m_gen()) * r;
+            low = static_cast<std::uint32_t>(m);
+        }
+    }
+
+    return static_cast<int>(begin + static_cast<std::int64_t>(m >> 32));
+}
+
+double RandStream::getDouble() noexcept
+{
+    const std::uint64_t high = m_gen();
+
+    return to_double(high, m_gen());
+}
+
+double RandStream::normal(double mean, double sigma) noexcept
+{
+    if (m_have_normal) {
+        m_have_normal = false;
+        return mean + sigma * m_normal;
+    }
+
+    // Box-Muller transform: 1 - u is in (0, 1] to avoid log(0).
+    const double radius = std::sqrt(-2.0 * std::log(1.0 - getDouble()));
+    const double theta = 2.0 * M_PI * getDouble();
+
+    m_normal = radius * std::sin(theta);
+    m_have_normal = true;
+
+    return mean + sigma * radius * std::cos(theta);
+}
+
+double RandStream::exponential(double rate) noexcept
+{
+    return -std::log(1.0 - getDouble()) / rate;
+}
+
+void RandStream::fillDouble(double* out, std::size_t n) noexcept
+{
+    std::uint32_t buffer[256];
+
+    while (n) {
+        const std::size_t size = std::min<std::size_t>(n, 128);
+        m_gen.fill(buffer, size * 2);
+
+        for (std::size_t i = 0; i != size; ++i)
+            out[i] = to_double(buffer[2 * i], buffer[2 * i + 1]);
+
+        out += size;
+        n -= size;
+    }
+}
+
+void RandStream::fillNormal(double* out,
+                            std::size_t n,
+                            double mean,
+                            double sigma) noexcept
+{
+    for (std::size_t i = 0; i != n; ++i)
+        out[i] = normal(mean, sigma);
+}
+
 }} // namespace vle utils
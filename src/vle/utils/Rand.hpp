@@ -29,7 +29,10 @@
 #define VLE_UTILS_RAND_HPP
 
 #include <vle/DllDefines.hpp>
+#include <array>
+#include <cstdint>
 #include <random>
+#include <string>
 
 namespace vle { namespace utils {
 
@@ -259,6 +262,176 @@ public:
 
 private:
     std::mt19937  m_rand;
+    std::normal_distribution<double> m_normal;
+};
+
+/**
+ * @brief vle::utils::Philox is the Philox4x32-10 counter-based PRNG. The
+ * n-th block of four integers is a bijection of the counter (the position
+ * n and the stream) and of the key: any part of a stream is computed
+ * without the previous parts and two streams or keys give independent
+ * sequences. It models the UniformRandomBitGenerator of the standard.
+ *
+ * @note "Parallel random numbers: as easy as 1, 2, 3", J. K. Salmon, M.
+ * A. Moraes, R. O. Dror and D. E. Shaw, SC'11, 2011.
+ */
+class VLE_API Philox
+{
+public:
+    using result_type = std::uint32_t;
+
+    /**
+     * @brief Create the generator of the @e stream of the @e key.
+     */
+    explicit Philox(std::uint64_t key = 0, std::uint64_t stream = 0) noexcept;
+
+    static constexpr result_type min() { return 0; }
+
+    static constexpr result_type max() { return 0xFFFFFFFF; }
+
+    result_type operator()() noexcept
+    {
+        if (m_index == 4)
+            next();
+
+        return m_output[m_index++];
+    }
+
+    /**
+     * @brief Skip the @e n next integers in constant time.
+     */
+    void discard(std::uint64_t n) noexcept;
+
+    /**
+     * @brief Fill [@e out, @e out + @e n) with the next integers.
+     */
+    void fill(result_type* out, std::size_t n) noexcept;
+
+    /**
+     * @brief Build the generator of a sub-stream: it uses the same key and
+     * a stream computed from the current stream and @e stream.
+     */
+    Philox split(std::uint64_t stream) const noexcept;
+
+    /**
+     * @brief Compute the block of the @e counter with the @e key.
+     */
+    static std::array<result_type, 4>
+    block(std::array<result_type, 4> counter,
+          std::array<result_type, 2> key) noexcept;
+
+private:
+    void next() noexcept;
+
+    std::array<result_type, 4> m_output;
+    std::array<result_type, 2> m_key;
+    std::uint64_t m_stream;
+    std::uint64_t m_position; /**< The position of the next block. */
+    unsigned int m_index;
+};
+
+/**
+ * @brief vle::utils::RandStream provides the main distributions over a
+ * vle::utils::Philox stream. A stream is defined by a seed and a name (the
+ * complete name of a model for instance) so the values drawn by a model
+ * do not depend on the other models, on the number of threads or on the
+ * scheduling. The normal distribution keeps its second variate.
+ *
+ * @code
+ * vle::utils::RandStream r(seed, "top,sheep:sheep-12");
+ * r.getDouble(); // double [0.0, 1.0)
+ * std::vector<double> v(1000);
+ * r.fillNormal(v.data(), v.size(), 0.0, 1.0);
+ * auto child = r.split(1); // an independent sub-stream.
+ * @endcode
+ */
+class VLE_API RandStream
+{
+public:
+    /**
+     * @brief Create the stream @e stream of the model @e name for the
+     * @e seed of the experiment.
+     */
+    RandStream(std::uint64_t seed,
+               const std::string& name,
+               std::uint64_t stream = 0);
+
+    explicit RandStream(const Philox& gen) noexcept;
+
+    /**
+     * @brief Compute the key of a Philox generator from a @e seed and a
+     * @e name.
+     */
+    static std::uint64_t key(std::uint64_t seed,
+                             const std::string& name) noexcept;
+
+    /**
+     * @brief Build an independent sub-stream (see Philox::split).
+     */
+    RandStream split(std::uint64_t stream) const noexcept;
+
+    /**
+     * @brief Gererate an unsigned int value [0..2^32-1].
+     */
+    std::uint32_t getInt() noexcept { return m_gen(); }
+
+    /**
+     * @brief Generate an unbiased integer from begin to end [begin..end].
+     */
+    int getInt(int begin, int end) noexcept;
+
+    /**
+     * @brief Generate a real value [0, 1) with 53 random bits.
+     */
+    double getDouble() noexcept;
+
+    /**
+     * @brief Generate a real from begin to end [begin..end).
+     */
+    double getDouble(double begin, double end) noexcept
+    {
+        return begin + (end - begin) * getDouble();
+    }
+
+    /**
+     * @brief Generate a real using the normal law.
+     */
+    double normal(double mean, double sigma) noexcept;
+
+    /**
+     * @brief Generate a real using an exponential distribution.
+     */
+    double exponential(double rate) noexcept;
+
+    /**
+     * @brief Fill [@e out, @e out + @e n) with integers [0..2^32-1].
+     */
+    void fill(std::uint32_t* out, std::size_t n) noexcept
+    {
+        m_gen.fill(out, n);
+    }
+
+    /**
+     * @brief Fill [@e out, @e out + @e n) with reals [0, 1).
+     */
+    void fillDouble(double* out, std::size_t n) noexcept;
+
+    /**
+     * @brief Fill [@e out, @e out + @e n) with reals of the normal law.
+     */
+    void fillNormal(double* out, std::size_t n, double mean, double sigma)
+        noexcept;
+
+    /**
+     * @brief Get a reference to the Philox PRNG to use the distributions
+     * of the standard library.
+     */
+    Philox& gen() noexcept { return m_gen; }
+
+private:
+    Philox m_gen;
+    double m_normal;
+    bool m_have_normal;
 };
 
 }} // namespace vle utils
@@ -26,6 +26,11 @@
 
 #include <boost/config.hpp>
 #include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <iterator>
@@ -35,9 +40,11 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 #include <vle/utils/Algo.hpp>
 #include <vle/utils/Array.hpp>
+#include <vle/utils/AsyncLog.hpp>
 #include <vle/utils/Context.hpp>
 #include <vle/utils/DateTime.hpp>
 #include <vle/utils/Package.hpp>
@@ -183,6 +190,173 @@ void test_generator()
     r.getDouble(-1.0, 1.0);
 }
 
+void test_philox()
+{
+    {
+        // Known answer of the Random123 library for a null counter and key.
+        auto ret = vle::utils::Philox::block({ { 0, 0, 0, 0 } }, { { 0, 0 } });
+        EnsuresEqual(ret[0], 0x6627e8d5u);
+        EnsuresEqual(ret[1], 0xe169c58du);
+        EnsuresEqual(ret[2], 0xbc57ac4cu);
+        EnsuresEqual(ret[3], 0x9b00dbd8u);
+    }
+
+    vle::utils::Philox a(42), b(42), c(42, 1);
+    std::vector<std::uint32_t> va(103), vb(103);
+
+    for (auto &elem : va)
+        elem = a();
+    b.fill(vb.data(), vb.size());
+    Ensures(va == vb);
+    Ensures(c() != va[0]);
+
+    vle::utils::Philox d(42);
+    d.discard(57);
+    EnsuresEqual(d(), va[57]);
+    d.discard(2);
+    EnsuresEqual(d(), va[60]);
+
+    vle::utils::Philox e(42);
+    e();
+    e.fill(vb.data(), 10);
+    Ensures(std::equal(vb.begin(), vb.begin() + 10, va.begin() + 1));
+
+    Ensures(a.split(1)() == b.split(1)());
+    Ensures(a.split(1)() != a.split(2)());
+}
+
+void test_rand_stream()
+{
+    vle::utils::RandStream a(1, "top:model"), b(1, "top:model");
+    vle::utils::RandStream c(2, "top:model"), d(1, "top:other");
+
+    EnsuresEqual(a.getInt(), b.getInt());
+    Ensures(a.getInt() != c.getInt());
+    Ensures(b.getInt() != d.getInt());
+
+    for (int i = 0; i < 1000; ++i) {
+        int x = a.getInt(-3, 3);
+        Ensures(x >= -3 and x <= 3);
+        double y = a.getDouble();
+        Ensures(y >= 0.0 and y < 1.0);
+        double z = a.getDouble(-1.0, 1.0);
+        Ensures(z >= -1.0 and z < 1.0);
+        Ensures(a.exponential(2.0) >= 0.0);
+    }
+
+    {
+        vle::utils::RandStream x(7, "m"), y(7, "m");
+        std::vector<double> v(300);
+        x.fillDouble(v.data(), v.size());
+        for (auto elem : v)
+            EnsuresEqual(elem, y.getDouble());
+    }
+
+    {
+        vle::utils::RandStream x(7, "m");
+        std::vector<double> v(100000);
+        x.fillNormal(v.data(), v.size(), 2.0, 3.0);
+        double mean = std::accumulate(v.begin(), v.end(), 0.0) / v.size();
+        double var = 0.0;
+        for (auto elem : v)
+            var += (elem - mean) * (elem - mean);
+        var /= v.size();
+        Ensures(std::abs(mean - 2.0) < 0.05);
+        Ensures(std::abs(var - 9.0) < 0.2);
+    }
+
+    {
+        vle::utils::RandStream x(7, "m");
+        auto y = x.split(1);
+        auto z = x.split(1);
+        EnsuresEqual(y.getInt(), z.getInt());
+        Ensures(x.split(2).getInt() != z.getInt());
+    }
+}
+
+struct test_log_sink : vle::utils::Context::LogFunctor
+{
+    std::vector<std::string> *messages;
+
+    explicit test_log_sink(std::vector<std::string> *m)
+        : messages(m)
+    {
+    }
+
+    virtual void write(const vle::utils::Context & /*ctx*/,
+                       int /*priority*/,
+                       const char * /*file*/,
+                       int /*line*/,
+                       const char * /*fn*/,
+                       const char *format,
+                       va_list args) noexcept override
+    {
+        char buffer[512];
+        vsnprintf(buffer, sizeof(buffer), format, args);
+        messages->emplace_back(buffer);
+    }
+};
+
+void log_async(vle::utils::AsyncLog &log,
+               const vle::utils::Context &ctx,
+               const char *format,
+               ...)
+{
+    va_list args;
+    va_start(args, format);
+    log.write(ctx, 7, __FILE__, __LINE__, __FUNCTION__, format, args);
+    va_end(args);
+}
+
+void test_async_log()
+{
+    auto ctx = vle::utils::make_context();
+    std::vector<std::string> messages;
+
+    {
+        vle::utils::AsyncLog log(
+            std::make_unique<test_log_sink>(&messages), 1024);
+
+        std::string tmp("temporary");
+        log_async(log, *ctx, "%d %5.2f %s %lu %c %% %zu %x\n", -12, 3.14159,
+                  tmp.c_str(), 42ul, 'a', std::size_t(7), 255u);
+        tmp.assign("overwritten");
+        log_async(log, *ctx, "%*d|\n", 4, 1);
+        log.flush();
+
+        EnsuresEqual(messages.size(), 2u);
+        EnsuresEqual(messages[0], "-12  3.14 temporary 42 a % 7 ff\n");
+        EnsuresEqual(messages[1], "   1|\n");
+        EnsuresEqual(log.dropped(), 0u);
+    }
+
+    messages.clear();
+
+    {
+        vle::utils::AsyncLog log(
+            std::make_unique<test_log_sink>(&messages), 8);
+        std::vector<std::thread> threads;
+
+        for (int i = 0; i < 4; ++i)
+            threads.emplace_back([&log, &ctx, i]() {
+                for (int j = 0; j < 1000; ++j)
+                    log_async(log, *ctx, "thread %d message %d\n", i, j);
+            });
+
+        for (auto &th : threads)
+            th.join();
+
+        log.flush();
+
+        auto written = std::count_if(
+            messages.begin(), messages.end(), [](const std::string &str) {
+                return str.compare(0, 7, "thread ") == 0;
+            });
+
+        EnsuresEqual(written + log.dropped(), 4000u);
+    }
+}
+
 void date_time()
 {
     std::cout << "Test date_time " << vle::utils::DateTime::currentDate()
@@ -488,6 +662,9 @@ int main()
     test_format();
     test_algo();
     test_generator();
+    test_philox();
+    test_rand_stream();
+    test_async_log();
     date_time();
     julian_date();
     to_time_function();
@@ -0,0 +1,175 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <vle/value/Mapped.hpp>
+
+namespace vle {
+namespace value {
+
+namespace {
+
+template <typename T>
+void write_elements(std::ostream &out, const MappedSpan<T> &span)
+{
+    for (std::size_t i = 0, e = span.size(); i != e; ++i) {
+        if (i)
+            out << ' ';
+        out << +span[i];
+    }
+}
+
+} // anonymous namespace
+
+void Mapped::writeFile(std::ostream &out) const
+{
+    if (not isOpen()) {
+        writeString(out);
+        return;
+    }
+
+    switch (m_type) {
+    case DOUBLE:
+        write_elements(out, span<double>());
+        break;
+    case FLOAT:
+        write_elements(out, span<float>());
+        break;
+    case INT32:
+        write_elements(out, span<std::int32_t>());
+        break;
+    case INT64:
+        write_elements(out, span<std::int64_t>());
+        break;
+    case UINT8:
+        write_elements(out, span<std::uint8_t>());
+        break;
+    }
+}
+
+void Mapped::writeString(std::ostream &out) const
+{
+    out << "(mapped ";
+    if (not m_package.empty())
+        out << m_package << ':';
+    out << m_file << ' ' << elementName(m_type) << ')';
+}
+
+void Mapped::writeXml(std::ostream &out) const
+{
+    out << "<mapped ";
+    if (not m_package.empty())
+        out << "package=\"" << m_package << "\" ";
+    out << "file=\"" << m_file << "\" type=\"" << elementName(m_type)
+        << "\" ";
+    if (m_columns)
+        out << "columns=\"" << m_columns << "\" ";
+    out << "/>";
+}
+
+void Mapped::open(const std::string &filename)
+{
+    auto data = utils::MappedFile::open(filename);
+
+    std::size_t row = elementSize(m_type) * (m_columns ? m_columns : 1);
+    if (data->size() % row != 0)
+        throw utils::ArgError(
+            (fmt(_("Mapped: the size of '%1%' (%2% bytes) is not a multiple "
+                   "of %3% bytes")) %
+             filename % data->size() % row)
+                .str());
+
+    m_data = std::move(data);
+}
+
+void Mapped::check(element_type type) const
+{
+    if (type != m_type)
+        throw utils::CastError(
+            (fmt(_("Mapped: '%1%' stores %2% not %3%")) % m_file %
+             elementName(m_type) % elementName(type))
+                .str());
+
+    if (not m_data)
+        throw utils::FileError(
+            (fmt(_("Mapped: '%1%' is not opened")) % m_file).str());
+}
+
+std::size_t Mapped::elementSize(element_type type) noexcept
+{
+    switch (type) {
+    case DOUBLE:
+        return sizeof(double);
+    case FLOAT:
+        return sizeof(float);
+    case INT32:
+        return sizeof(std::int32_t);
+    case INT64:
+        return sizeof(std::int64_t);
+    case UINT8:
+        return sizeof(std::uint8_t);
+    }
+
+    return 1;
+}
+
+Mapped::element_type Mapped::elementType(const std::string &name)
+{
+    if (name == "double")
+        return DOUBLE;
+    if (name == "float")
+        return FLOAT;
+    if (name == "int32")
+        return INT32;
+    if (name == "int64")
+        return INT64;
+    if (name == "uint8")
+        return UINT8;
+
+    throw utils::ArgError(
+        (fmt(_("Mapped: unknown type '%1%'")) % name).str());
+}
+
+const char *Mapped::elementName(element_type type) noexcept
+{
+    switch (type) {
+    case DOUBLE:
+        return "double";
+    case FLOAT:
+        return "float";
+    case INT32:
+        return "int32";
+    case INT64:
+        return "int64";
+    case UINT8:
+        return "uint8";
+    }
+
+    return "";
+}
+}
+} // namespace vle value
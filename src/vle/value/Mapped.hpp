@@ -0,0 +1,310 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_VALUE_MAPPED_HPP
+#define VLE_VALUE_MAPPED_HPP 1
+
+#include <cstdint>
+#include <vle/DllDefines.hpp>
+#include <vle/utils/MappedFile.hpp>
+#include <vle/value/Value.hpp>
+
+namespace vle {
+namespace value {
+
+/**
+ * @brief A read only view of a contiguous array of numbers stored into a
+ * value::Mapped. The span does not copy the data: it is valid while the
+ * value::Mapped (or a copy of it) exists.
+ */
+template <typename T> class MappedSpan
+{
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using const_iterator = const T *;
+
+    MappedSpan(const T *data, size_type size, size_type columns)
+        : m_data(data)
+        , m_size(size)
+        , m_columns(columns ? columns : size)
+    {
+    }
+
+    const T *data() const noexcept { return m_data; }
+    size_type size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+    const_iterator begin() const noexcept { return m_data; }
+    const_iterator end() const noexcept { return m_data + m_size; }
+
+    /**
+     * @brief Get the number of columns of the data. It is the size of the
+     * span if the value::Mapped does not define columns.
+     */
+    size_type columns() const noexcept { return m_columns; }
+
+    size_type rows() const noexcept
+    {
+        return m_columns ? m_size / m_columns : 0;
+    }
+
+    const T &operator[](size_type i) const noexcept { return m_data[i]; }
+
+    /**
+     * @brief Get the element at @e column, @e row like value::Table.
+     */
+    const T &operator()(size_type column, size_type row) const noexcept
+    {
+        return m_data[row * m_columns + column];
+    }
+
+private:
+    const T *m_data;
+    size_type m_size;
+    size_type m_columns;
+};
+
+/**
+ * @brief Mapped Value references an external binary file of numbers
+ * (for example a weather series or a spatial grid stored into the @c data
+ * directory of a package). The file is mapped in memory read only and the
+ * mapping is shared by all the copies of the value and by all the values
+ * which reference the same file.
+ *
+ * @code
+ * <mapped package="foo" file="weather.bin" type="double" columns="4" />
+ * @endcode
+ *
+ * The file is a raw array of numbers in the native byte order. The
+ * simulation kernel opens the file when it builds the models (see
+ * devs::InitEventList::getMapped).
+ */
+class VLE_API Mapped : public Value {
+public:
+    /**
+     * @brief The type of the numbers stored into the file.
+     */
+    enum element_type { DOUBLE, FLOAT, INT32, INT64, UINT8 };
+
+    /**
+     * @brief Build a Mapped object.
+     * @param package The package where the file is stored. If empty, the
+     * file is a path.
+     * @param file The name of the file in the @c data directory of the
+     * package.
+     * @param type The type of the numbers.
+     * @param columns The number of columns of the data or 0.
+     */
+    Mapped(std::string package,
+           std::string file,
+           element_type type = DOUBLE,
+           std::size_t columns = 0)
+        : m_package(std::move(package))
+        , m_file(std::move(file))
+        , m_columns(columns)
+        , m_type(type)
+    {
+    }
+
+    /**
+     * @brief Copy constructor. The copy shares the mapping.
+     * @param value The value to copy.
+     */
+    Mapped(const Mapped &value) = default;
+
+    /**
+     * @brief Nothing to delete.
+     */
+    virtual ~Mapped() {}
+
+    ///
+    ////
+    ///
+
+    /**
+     * @brief Build a Mapped.
+     * @return A new allocated Mapped.
+     */
+    static std::unique_ptr<value::Value> create(const std::string &package,
+                                                const std::string &file,
+                                                element_type type = DOUBLE,
+                                                std::size_t columns = 0)
+    {
+        return std::unique_ptr<value::Value>(
+            new Mapped(package, file, type, columns));
+    }
+
+    ///
+    ////
+    ///
+
+    /**
+     * @brief Clone the current Mapped. The clone shares the mapping.
+     * @return A new Mapped.
+     */
+    virtual std::unique_ptr<Value> clone() const override
+    {
+        return std::unique_ptr<Value>(new Mapped(*this));
+    }
+
+    /**
+     * @brief Get the type of this class.
+     * @return Return Value::MAPPED.
+     */
+    virtual Value::type getType() const override { return Value::MAPPED; }
+
+    /**
+     * @brief Push the numbers separated by space into the stream, or the
+     * name of the file if the file is not opened.
+     * @param out The output stream.
+     */
+    virtual void writeFile(std::ostream &out) const override;
+
+    /**
+     * @brief Push the package and the file names into the stream.
+     * @param out The output stream.
+     */
+    virtual void writeString(std::ostream &out) const override;
+
+    /**
+     * @brief Push the mapped tag into the stream.
+     * @code
+     * <mapped package="foo" file="weather.bin" type="double" />
+     * @endcode
+     * @param out The output stream.
+     */
+    virtual void writeXml(std::ostream &out) const override;
+
+    ///
+    ////
+    ///
+
+    /**
+     * @brief Map the file. The mapping is shared with the other values
+     * which reference the same file (see utils::MappedFile::open).
+     * @param filename The path of the file, generally the file() into the
+     * data directory of the package().
+     * @throw utils::FileError if the file cannot be mapped,
+     * utils::ArgError if the size of the file is not a multiple of the
+     * size of a row.
+     */
+    void open(const std::string &filename);
+
+    /**
+     * @brief Check if the file is mapped.
+     */
+    bool isOpen() const noexcept { return m_data.get() != nullptr; }
+
+    const std::string &package() const noexcept { return m_package; }
+    const std::string &file() const noexcept { return m_file; }
+    element_type elementType() const noexcept { return m_type; }
+    std::size_t columns() const noexcept { return m_columns; }
+
+    /**
+     * @brief Get the number of elements of the mapped file.
+     * @return 0 if the file is not mapped.
+     */
+    std::size_t size() const noexcept
+    {
+        return m_data ? m_data->size() / elementSize(m_type) : 0;
+    }
+
+    /**
+     * @brief Get a view of the numbers of the mapped file.
+     * @code
+     * auto weather = mapped.span<double>();
+     * for (auto x : weather)
+     *     sum += x;
+     * @endcode
+     * @throw utils::CastError if T does not match the type of the numbers,
+     * utils::FileError if the file is not mapped.
+     */
+    template <typename T> MappedSpan<T> span() const
+    {
+        check(elementTypeOf(static_cast<const T *>(nullptr)));
+
+        return MappedSpan<T>(
+            reinterpret_cast<const T *>(m_data->data()), size(), m_columns);
+    }
+
+    /**
+     * @brief Get the size in bytes of a number.
+     */
+    static std::size_t elementSize(element_type type) noexcept;
+
+    /**
+     * @brief Convert a type name (double, float, int32, int64 or uint8)
+     * into an element_type.
+     * @throw utils::ArgError if the name is unknown.
+     */
+    static element_type elementType(const std::string &name);
+
+    /**
+     * @brief Get the name of an element_type.
+     */
+    static const char *elementName(element_type type) noexcept;
+
+private:
+    std::string m_package;
+    std::string m_file;
+    std::shared_ptr<const utils::MappedFile> m_data;
+    std::size_t m_columns;
+    element_type m_type;
+
+    void check(element_type type) const;
+
+    static element_type elementTypeOf(const double *) { return DOUBLE; }
+    static element_type elementTypeOf(const float *) { return FLOAT; }
+    static element_type elementTypeOf(const std::int32_t *) { return INT32; }
+    static element_type elementTypeOf(const std::int64_t *) { return INT64; }
+    static element_type elementTypeOf(const std::uint8_t *) { return UINT8; }
+};
+
+inline const Mapped &toMappedValue(std::shared_ptr<Value> value)
+{
+    return value::reference(value).toMapped();
+}
+
+inline const Mapped &toMappedValue(std::shared_ptr<const Value> value)
+{
+    return value::reference(value).toMapped();
+}
+
+inline const Mapped &toMappedValue(const std::unique_ptr<Value> &value)
+{
+    return value::reference(value).toMapped();
+}
+
+inline const Mapped &toMappedValue(const Value &value)
+{
+    return value.toMapped();
+}
+
+inline Mapped &toMappedValue(Value &value) { return value.toMapped(); }
+}
+} // namespace vle value
+
+#endif
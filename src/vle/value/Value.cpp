@@ -31,6 +31,7 @@
 #include <vle/value/Double.hpp>
 #include <vle/value/Integer.hpp>
 #include <vle/value/Map.hpp>
+#include <vle/value/Mapped.hpp>
 #include <vle/value/Matrix.hpp>
 #include <vle/value/Null.hpp>
 #include <vle/value/Set.hpp>
@@ -153,6 +154,14 @@ const Matrix &Value::toMatrix() const
     return static_cast<const Matrix &>(*this);
 }
 
+const Mapped &Value::toMapped() const
+{
+    if (not isMapped()) {
+        throw utils::CastError(_("Value is not a mapped value"));
+    }
+    return static_cast<const Mapped &>(*this);
+}
+
 const User &Value::toUser() const
 {
     if (not isUser()) {
@@ -249,6 +258,14 @@ Matrix &Value::toMatrix()
     return static_cast<Matrix &>(*this);
 }
 
+Mapped &Value::toMapped()
+{
+    if (not isMapped()) {
+        throw utils::CastError(_("Value is not a mapped value"));
+    }
+    return static_cast<Mapped &>(*this);
+}
+
 User &Value::toUser()
 {
     if (not isUser()) {
@@ -301,6 +318,9 @@ std::shared_ptr<Value> clone(std::shared_ptr<const Value> v)
     case Value::MATRIX:
         return std::static_pointer_cast<Value>(
             std::make_shared<Matrix>(v->toMatrix()));
+    case Value::MAPPED:
+        return std::static_pointer_cast<Value>(
+            std::make_shared<Mapped>(v->toMapped()));
     case Value::USER:
         return std::shared_ptr<Value>();
     }
@@ -47,6 +47,7 @@ class Table;
 class Xml;
 class Null;
 class Matrix;
+class Mapped;
 class User;
 
 /**
@@ -66,7 +67,8 @@ public:
         XMLTYPE,
         NIL,
         MATRIX,
-        USER
+        USER,
+        MAPPED
     };
 
     /**
@@ -171,6 +173,8 @@ public:
 
     inline bool isMatrix() const { return getType() == Value::MATRIX; }
 
+    inline bool isMapped() const { return getType() == Value::MAPPED; }
+
     inline bool isUser() const { return getType() == Value::USER; }
 
     const Boolean &toBoolean() const;
@@ -184,6 +188,7 @@ public:
     const Xml &toXml() const;
     const Null &toNull() const;
     const Matrix &toMatrix() const;
+    const Mapped &toMapped() const;
     const User &toUser() const;
 
     Boolean &toBoolean();
@@ -197,6 +202,7 @@ public:
     Xml &toXml();
     Null &toNull();
     Matrix &toMatrix();
+    Mapped &toMapped();
     User &toUser();
 
     /**
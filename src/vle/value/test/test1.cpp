@@ -26,6 +26,7 @@
 
 #include <boost/lexical_cast.hpp>
 #include <boost/utility.hpp>
+#include <cstdio>
 #include <fstream>
 #include <functional>
 #include <iostream>
@@ -37,6 +38,7 @@
 #include <vle/value/Double.hpp>
 #include <vle/value/Integer.hpp>
 #include <vle/value/Map.hpp>
+#include <vle/value/Mapped.hpp>
 #include <vle/value/Matrix.hpp>
 #include <vle/value/Null.hpp>
 #include <vle/value/Set.hpp>
@@ -391,6 +393,52 @@ void test_table()
     Ensures(t(0, 2) == 4.);
 }
 
+void test_mapped()
+{
+    const std::string filename("test_values_mapped.bin");
+
+    {
+        std::ofstream ofs(filename, std::ios::binary);
+        for (int i = 0; i < 6; ++i) {
+            double value = i * 0.5;
+            ofs.write(reinterpret_cast<const char *>(&value), sizeof(value));
+        }
+    }
+
+    value::Mapped m("", filename, value::Mapped::DOUBLE, 2);
+    Ensures(not m.isOpen());
+    EnsuresThrow(m.span<double>(), vle::utils::FileError);
+
+    m.open(filename);
+    Ensures(m.isOpen());
+    Ensures(m.size() == 6);
+
+    auto span = m.span<double>();
+    Ensures(span.size() == 6);
+    Ensures(span.columns() == 2);
+    Ensures(span.rows() == 3);
+    Ensures(span[0] == 0.0);
+    Ensures(span[5] == 2.5);
+    Ensures(span(1, 2) == 2.5);
+    EnsuresThrow(m.span<float>(), vle::utils::CastError);
+
+    auto clone = m.clone();
+    Ensures(clone->isMapped());
+    Ensures(clone->toMapped().span<double>().data() == span.data());
+
+    value::Mapped other("", filename, value::Mapped::DOUBLE, 2);
+    other.open(filename);
+    Ensures(other.span<double>().data() == span.data());
+
+    value::Mapped bad("", filename, value::Mapped::INT64, 4);
+    EnsuresThrow(bad.open(filename), vle::utils::ArgError);
+
+    Ensures(value::Mapped::elementType("uint8") == value::Mapped::UINT8);
+    EnsuresThrow(value::Mapped::elementType("int16"), vle::utils::ArgError);
+
+    std::remove(filename.c_str());
+}
+
 int main()
 {
     vle::Init app;
@@ -404,6 +452,7 @@ int main()
     test_user_value();
     test_tuple();
     test_table();
+    test_mapped();
 
     return unit_test::report_errors();
 }
@@ -38,10 +38,6 @@ namespace vle { namespace vpz {
 
 BaseModel::BaseModel(const std::string& name, CoupledModel* parent) :
     m_parent(parent),
-    m_x(-1),
-    m_y(-1),
-    m_width(-1),
-    m_height(-1),
     m_name(name)
 {
     if (parent) {
@@ -53,10 +49,7 @@ BaseModel::BaseModel(const BaseModel& mdl) :
     m_parent(nullptr),
     m_inPortList(mdl.m_inPortList),
     m_outPortList(mdl.m_outPortList),
-    m_x(mdl.m_x),
-    m_y(mdl.m_y),
-    m_width(mdl.m_width),
-    m_height(mdl.m_height),
+    m_graphics(mdl.m_graphics ? new Graphics(*mdl.m_graphics) : nullptr),
     m_name(mdl.m_name)
 {
     std::for_each(mdl.m_inPortList.begin(), mdl.m_inPortList.end(),
@@ -71,10 +64,7 @@ void BaseModel::swap(BaseModel& mdl)
     std::swap(m_parent, mdl.m_parent);
     std::swap(m_inPortList, mdl.m_inPortList);
     std::swap(m_outPortList, mdl.m_outPortList);
-    std::swap(m_x, mdl.m_x);
-    std::swap(m_y, mdl.m_y);
-    std::swap(m_width, mdl.m_width);
-    std::swap(m_height, mdl.m_height);
+    std::swap(m_graphics, mdl.m_graphics);
     std::swap(m_name, mdl.m_name);
 }
 
@@ -610,6 +600,38 @@ void BaseModel::writePortListXML(std::ostream& out) const
     }
 }
 
+void BaseModel::clearGraphics()
+{
+    m_graphics.reset();
+
+    if (isCoupled()) {
+        for (auto& elem : static_cast<CoupledModel*>(this)->getModelList())
+            elem.second->clearGraphics();
+    }
+}
+
+void BaseModel::clearConnections()
+{
+    for (auto& elem : m_inPortList)
+        elem.second.clear();
+
+    for (auto& elem : m_outPortList)
+        elem.second.clear();
+
+    if (isCoupled()) {
+        auto* coupled = static_cast<CoupledModel*>(this);
+
+        for (auto& elem : coupled->getInternalInputPortList())
+            elem.second.clear();
+
+        for (auto& elem : coupled->getInternalOutputPortList())
+            elem.second.clear();
+
+        for (auto& elem : coupled->getModelList())
+            elem.second->clearConnections();
+    }
+}
+
 void BaseModel::writeGraphics(std::ostream& out) const
 {
     if (x() >= 0) {
@@ -695,11 +717,7 @@ bool BaseModel::isInList(const ModelList& lst, BaseModel* m)
 }
 
 BaseModel::BaseModel() :
-    m_parent(nullptr),
-    m_x(-1),
-    m_y(-1),
-    m_width(-1),
-    m_height(-1)
+    m_parent(nullptr)
 {
     throw utils::NotYetImplemented("BaseModel::BaseModel not developed");
 }
@@ -33,6 +33,7 @@
 #include <ostream>
 #include <vector>
 #include <map>
+#include <memory>
 #include <list>
 #include <set>
 
@@ -354,75 +355,95 @@ namespace vle { namespace vpz {
 
         /**
          * @brief Get X position of model.
-         * @return a X position.
+         * @return a X position or -1 if undefined.
          */
-        inline int x() const { return m_x; }
+        inline int x() const { return m_graphics ? m_graphics->x : -1; }
 
         /**
          * @brief Get Y position of model.
-         * @return a Y position.
+         * @return a Y position or -1 if undefined.
          */
-        inline int y() const { return m_y; }
+        inline int y() const { return m_graphics ? m_graphics->y : -1; }
 
         /**
          * @brief Get the width of model.
-         * @return a width.
+         * @return a width or -1 if undefined.
          */
-        inline int width() const { return m_width; }
+        inline int width() const
+        { return m_graphics ? m_graphics->width : -1; }
 
         /**
          * @brief Get the height of model.
-         * @return a height.
+         * @return a height or -1 if undefined.
          */
-        inline int height() const { return m_height; }
+        inline int height() const
+        { return m_graphics ? m_graphics->height : -1; }
 
         /**
          * @brief Get the X force of model.
          * @return a force.
          */
-        inline const float& dx() const { return m_dx; }
+        inline const float& dx() const
+        { return m_graphics ? m_graphics->dx : noForce(); }
 
         /**
          * @brief Get the Y force of model.
          * @return a force.
          */
-        inline const float& dy() const { return m_dy; }
+        inline const float& dy() const
+        { return m_graphics ? m_graphics->dy : noForce(); }
 
         /**
          * @brief Set a new X position to model.
          * @param x new X position.
          */
-        inline void setX(int x) { m_x = x; }
+        inline void setX(int x) { graphics().x = x; }
 
         /**
          * @brief Set a new Y position to model.
          * @param y new Y position.
          */
-        inline void setY(int y) { m_y = y; }
+        inline void setY(int y) { graphics().y = y; }
 
         /**
          * @brief Set a new width to model.
          * @param width new width.
          */
-        inline void setWidth(int width) { m_width = width; }
+        inline void setWidth(int width) { graphics().width = width; }
 
         /**
          * @brief Set a new height to model.
          * @param height new height.
          */
-        inline void setHeight(int height) { m_height = height; }
+        inline void setHeight(int height) { graphics().height = height; }
 
         /**
          * @brief Set a new X force to model.
          * @param dx new force.
          */
-        inline void setDx(const float& dx) { m_dx = dx; }
+        inline void setDx(const float& dx) { graphics().dx = dx; }
 
         /**
          * @brief Set a new Y force to model.
          * @param dy new force.
          */
-        inline void setDy(const float& dy) { m_dy = dy; }
+        inline void setDy(const float& dy) { graphics().dy = dy; }
+
+        /**
+         * @brief Remove the graphics information (position, size and
+         * force) of the model and of its sub-models. The simulation
+         * kernel does not use them: a headless simulation drops them to
+         * reduce the memory of large models.
+         */
+        void clearGraphics();
+
+        /**
+         * @brief Remove the connections of the ports of the model and of
+         * its sub-models. The names of the ports are kept. A simulation
+         * kernel which stores its own graph of the connections drops them
+         * to reduce the memory of large models.
+         */
+        void clearConnections();
 
         /**
          * @brief Set a new position to model.
@@ -539,12 +560,35 @@ namespace vle { namespace vpz {
         ConnectionList  m_inPortList;
         ConnectionList  m_outPortList;
 
-        int   m_x;
-        int   m_y;
-        int   m_width;
-        int   m_height;
-        float m_dx;
-        float m_dy;
+        /**
+         * @brief The graphics information, allocated by the first
+         * setter.
+         */
+        struct Graphics
+        {
+            int   x = -1;
+            int   y = -1;
+            int   width = -1;
+            int   height = -1;
+            float dx = 0.f;
+            float dy = 0.f;
+        };
+
+        std::unique_ptr<Graphics> m_graphics;
+
+        Graphics& graphics()
+        {
+            if (not m_graphics)
+                m_graphics.reset(new Graphics);
+
+            return *m_graphics;
+        }
+
+        static const float& noForce()
+        {
+            static const float force = 0.f;
+            return force;
+        }
 
         void writePort(std::ostream& out) const;
         void writeGraphics(std::ostream& out) const;
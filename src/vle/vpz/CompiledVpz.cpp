@@ -0,0 +1,802 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Filesystem.hpp>
+#include <vle/utils/MappedFile.hpp>
+#include <vle/utils/i18n.hpp>
+#include <vle/value/Boolean.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
+#include <vle/value/Map.hpp>
+#include <vle/value/Mapped.hpp>
+#include <vle/value/Matrix.hpp>
+#include <vle/value/Null.hpp>
+#include <vle/value/Set.hpp>
+#include <vle/value/String.hpp>
+#include <vle/value/Table.hpp>
+#include <vle/value/Tuple.hpp>
+#include <vle/value/XML.hpp>
+#include <vle/vpz/AtomicModel.hpp>
+#include <vle/vpz/CompiledVpz.hpp>
+#include <vle/vpz/CoupledModel.hpp>
+#include <vle/vpz/Vpz.hpp>
+
+namespace {
+
+/*
+ * The compiled vpz starts with a fixed size header: a magic string, the
+ * version of the format, a byte order mark and the hash of the source xml
+ * file. The body stores the objects in the order of the xml file with
+ * fixed size integers and length prefixed strings.
+ */
+const char compiled_magic[8] = {'V', 'L', 'E', 'V', 'P', 'Z', 'C', '\0'};
+const std::uint32_t compiled_version = 3;
+const std::uint32_t compiled_byte_order = 0x01020304;
+
+enum model_tag : std::uint8_t { model_atomic = 0, model_coupled = 1 };
+
+class CompiledWriter
+{
+public:
+    template <typename T> void put(T value)
+    {
+        const char *ptr = reinterpret_cast<const char *>(&value);
+        m_buffer.append(ptr, sizeof(T));
+    }
+
+    void put(const std::string &str)
+    {
+        put<std::uint32_t>(static_cast<std::uint32_t>(str.size()));
+        m_buffer.append(str);
+    }
+
+    void put(const std::vector<double> &vec)
+    {
+        put<std::uint64_t>(vec.size());
+        m_buffer.append(reinterpret_cast<const char *>(vec.data()),
+                        vec.size() * sizeof(double));
+    }
+
+    void put(const vle::value::Value &value)
+    {
+        using vle::value::Value;
+
+        put<std::uint8_t>(value.getType());
+
+        switch (value.getType()) {
+        case Value::BOOLEAN:
+            put<std::uint8_t>(value.toBoolean().value() ? 1 : 0);
+            break;
+        case Value::INTEGER:
+            put<std::int32_t>(value.toInteger().value());
+            break;
+        case Value::DOUBLE:
+            put<double>(value.toDouble().value());
+            break;
+        case Value::STRING:
+            put(value.toString().value());
+            break;
+        case Value::XMLTYPE:
+            put(value.toXml().value());
+            break;
+        case Value::NIL:
+            break;
+        case Value::SET:
+            put<std::uint64_t>(value.toSet().size());
+            for (const auto &elem : value.toSet())
+                putOptional(elem.get());
+            break;
+        case Value::MAP:
+            put<std::uint64_t>(value.toMap().size());
+            for (const auto &elem : value.toMap()) {
+                put(elem.first);
+                putOptional(elem.second.get());
+            }
+            break;
+        case Value::TUPLE:
+            put(value.toTuple().value());
+            break;
+        case Value::TABLE:
+            put<std::uint64_t>(value.toTable().width());
+            put<std::uint64_t>(value.toTable().height());
+            put(value.toTable().value());
+            break;
+        case Value::MATRIX: {
+            const auto &matrix = value.toMatrix();
+            put<std::uint64_t>(matrix.columns());
+            put<std::uint64_t>(matrix.rows());
+            put<std::uint64_t>(matrix.columns_max());
+            put<std::uint64_t>(matrix.rows_max());
+            put<std::uint64_t>(matrix.resizeColumn());
+            put<std::uint64_t>(matrix.resizeRow());
+            for (std::size_t r = 0; r < matrix.rows(); ++r)
+                for (std::size_t c = 0; c < matrix.columns(); ++c)
+                    putOptional(matrix.get(c, r).get());
+            break;
+        }
+        case Value::MAPPED:
+            put(value.toMapped().package());
+            put(value.toMapped().file());
+            put<std::uint8_t>(value.toMapped().elementType());
+            put<std::uint64_t>(value.toMapped().columns());
+            break;
+        case Value::USER:
+            throw vle::utils::ArgError(
+                _("Compiled vpz: cannot compile a user value"));
+        }
+    }
+
+    void putOptional(const vle::value::Value *value)
+    {
+        put<std::uint8_t>(value ? 1 : 0);
+        if (value)
+            put(*value);
+    }
+
+    void put(const vle::vpz::BaseModel &mdl)
+    {
+        put<std::uint8_t>(mdl.isAtomic() ? model_atomic : model_coupled);
+        put(mdl.getName());
+
+        bool graphics = mdl.x() != -1 or mdl.y() != -1 or
+                        mdl.width() != -1 or mdl.height() != -1;
+        put<std::uint8_t>(graphics ? 1 : 0);
+        if (graphics) {
+            put<std::int32_t>(mdl.x());
+            put<std::int32_t>(mdl.y());
+            put<std::int32_t>(mdl.width());
+            put<std::int32_t>(mdl.height());
+        }
+
+        putPorts(mdl.getInputPortList());
+        putPorts(mdl.getOutputPortList());
+
+        if (mdl.isAtomic()) {
+            const auto &atom = static_cast<const vle::vpz::AtomicModel &>(mdl);
+
+            put<std::uint32_t>(
+                static_cast<std::uint32_t>(atom.conditions().size()));
+            for (const auto &elem : atom.conditions())
+                put(elem);
+            put(atom.dynamics());
+            put(atom.observables());
+            put<std::uint8_t>(atom.needDebug() ? 1 : 0);
+        } else {
+            const auto &cpl = static_cast<const vle::vpz::CoupledModel &>(mdl);
+
+            put<std::uint32_t>(
+                static_cast<std::uint32_t>(cpl.getModelList().size()));
+            for (const auto &elem : cpl.getModelList())
+                put(*elem.second);
+
+            putConnections(cpl);
+        }
+    }
+
+    const std::string &buffer() const { return m_buffer; }
+
+private:
+    std::string m_buffer;
+
+    void putPorts(const vle::vpz::ConnectionList &ports)
+    {
+        put<std::uint32_t>(static_cast<std::uint32_t>(ports.size()));
+        for (const auto &elem : ports)
+            put(elem.first);
+    }
+
+    /*
+     * Connections are stored as (source model, source port, destination
+     * model, destination port) where an empty model name is the coupled
+     * model itself, like in CoupledModel::writeConnections.
+     */
+    void putConnections(const vle::vpz::CoupledModel &cpl)
+    {
+        std::vector<const std::string *> cnts;
+
+        for (const auto &elem : cpl.getInternalOutputPortList())
+            for (const auto &jt : elem.second) {
+                cnts.push_back(&jt.first->getName());
+                cnts.push_back(&jt.second);
+                cnts.push_back(nullptr);
+                cnts.push_back(&elem.first);
+            }
+
+        for (const auto &elem : cpl.getInternalInputPortList())
+            for (const auto &jt : elem.second) {
+                cnts.push_back(nullptr);
+                cnts.push_back(&elem.first);
+                cnts.push_back(&jt.first->getName());
+                cnts.push_back(&jt.second);
+            }
+
+        for (const auto &mdl : cpl.getModelList())
+            for (const auto &elem : mdl.second->getOutputPortList())
+                for (const auto &jt : elem.second)
+                    if (jt.first != &cpl) {
+                        cnts.push_back(&mdl.second->getName());
+                        cnts.push_back(&elem.first);
+                        cnts.push_back(&jt.first->getName());
+                        cnts.push_back(&jt.second);
+                    }
+
+        put<std::uint64_t>(cnts.size() / 4);
+        for (const auto *elem : cnts)
+            put(elem ? *elem : std::string());
+    }
+};
+
+class CompiledReader
+{
+public:
+    CompiledReader(const char *begin, const char *end)
+        : m_ptr(begin)
+        , m_end(end)
+    {
+    }
+
+    template <typename T> T get()
+    {
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::string getString()
+    {
+        auto size = get<std::uint32_t>();
+        const char *ptr = take(size);
+        return std::string(ptr, size);
+    }
+
+    void getDoubles(std::vector<double> &vec)
+    {
+        auto size = get<std::uint64_t>();
+        if (size > remaining() / sizeof(double))
+            corrupted();
+
+        vec.resize(size);
+        std::memcpy(vec.data(), take(size * sizeof(double)),
+                    size * sizeof(double));
+    }
+
+    std::unique_ptr<vle::value::Value> getValue()
+    {
+        using vle::value::Value;
+
+        switch (get<std::uint8_t>()) {
+        case Value::BOOLEAN:
+            return vle::value::Boolean::create(get<std::uint8_t>() != 0);
+        case Value::INTEGER:
+            return vle::value::Integer::create(get<std::int32_t>());
+        case Value::DOUBLE:
+            return vle::value::Double::create(get<double>());
+        case Value::STRING:
+            return vle::value::String::create(getString());
+        case Value::XMLTYPE:
+            return vle::value::Xml::create(getString());
+        case Value::NIL:
+            return vle::value::Null::create();
+        case Value::SET: {
+            auto result = vle::value::Set::create();
+            auto size = getCount();
+            for (std::uint64_t i = 0; i < size; ++i)
+                result->toSet().value().emplace_back(getOptional());
+            return result;
+        }
+        case Value::MAP: {
+            auto result = vle::value::Map::create();
+            auto size = getCount();
+            for (std::uint64_t i = 0; i < size; ++i) {
+                auto key = getString();
+                result->toMap().value()[key] = getOptional();
+            }
+            return result;
+        }
+        case Value::TUPLE: {
+            auto result = vle::value::Tuple::create();
+            getDoubles(result->toTuple().value());
+            return result;
+        }
+        case Value::TABLE: {
+            auto width = get<std::uint64_t>();
+            auto height = get<std::uint64_t>();
+            if (height != 0 and
+                width > remaining() / sizeof(double) / height)
+                corrupted();
+
+            auto result = vle::value::Table::create(width, height);
+            getDoubles(result->toTable().value());
+            if (result->toTable().value().size() != width * height)
+                corrupted();
+            return result;
+        }
+        case Value::MATRIX:
+            return getMatrix();
+        case Value::MAPPED: {
+            auto package = getString();
+            auto file = getString();
+            auto type = get<std::uint8_t>();
+            auto columns = get<std::uint64_t>();
+            if (type > vle::value::Mapped::UINT8)
+                corrupted();
+            return vle::value::Mapped::create(
+                package,
+                file,
+                static_cast<vle::value::Mapped::element_type>(type),
+                columns);
+        }
+        default:
+            corrupted();
+        }
+
+        return nullptr;
+    }
+
+    std::unique_ptr<vle::value::Value> getOptional()
+    {
+        return get<std::uint8_t>() ? getValue() : nullptr;
+    }
+
+    vle::vpz::BaseModel *getModel(vle::vpz::CoupledModel *parent)
+    {
+        auto tag = get<std::uint8_t>();
+        auto name = getString();
+        vle::vpz::BaseModel *mdl = nullptr;
+
+        if (tag == model_atomic)
+            mdl = new vle::vpz::AtomicModel(name, parent);
+        else if (tag == model_coupled)
+            mdl = new vle::vpz::CoupledModel(name, parent);
+        else
+            corrupted();
+
+        /* The parent owns the children: only the root model is freed if
+           the file is corrupted. */
+        std::unique_ptr<vle::vpz::BaseModel> root(parent ? nullptr : mdl);
+
+        if (get<std::uint8_t>()) {
+            mdl->setX(get<std::int32_t>());
+            mdl->setY(get<std::int32_t>());
+            mdl->setWidth(get<std::int32_t>());
+            mdl->setHeight(get<std::int32_t>());
+        }
+
+        for (auto i = get<std::uint32_t>(); i > 0; --i)
+            mdl->addInputPort(getString());
+        for (auto i = get<std::uint32_t>(); i > 0; --i)
+            mdl->addOutputPort(getString());
+
+        if (tag == model_atomic) {
+            auto *atom = static_cast<vle::vpz::AtomicModel *>(mdl);
+
+            for (auto i = get<std::uint32_t>(); i > 0; --i)
+                atom->addCondition(getString());
+            atom->setDynamics(getString());
+            atom->setObservables(getString());
+            if (get<std::uint8_t>())
+                atom->setDebug();
+        } else {
+            auto *cpl = static_cast<vle::vpz::CoupledModel *>(mdl);
+
+            for (auto i = get<std::uint32_t>(); i > 0; --i)
+                getModel(cpl);
+
+            for (auto i = get<std::uint64_t>(); i > 0; --i) {
+                auto src = getString();
+                auto srcport = getString();
+                auto dst = getString();
+                auto dstport = getString();
+
+                if (src.empty())
+                    cpl->addInputConnection(srcport, dst, dstport);
+                else if (dst.empty())
+                    cpl->addOutputConnection(src, srcport, dstport);
+                else
+                    cpl->addInternalConnection(src, srcport, dst, dstport);
+            }
+        }
+
+        root.release();
+        return mdl;
+    }
+
+    bool finished() const { return m_ptr == m_end; }
+
+    [[noreturn]] static void corrupted()
+    {
+        throw vle::utils::FileError(_("Compiled vpz: corrupted file"));
+    }
+
+private:
+    const char *m_ptr;
+    const char *m_end;
+
+    std::size_t remaining() const
+    {
+        return static_cast<std::size_t>(m_end - m_ptr);
+    }
+
+    /* Read the number of elements of a container: each element uses at
+       least one byte, a greater number is a corrupted file and not an
+       allocation to try. */
+    std::uint64_t getCount()
+    {
+        auto size = get<std::uint64_t>();
+        if (size > remaining())
+            corrupted();
+
+        return size;
+    }
+
+    const char *take(std::size_t size)
+    {
+        if (size > remaining())
+            corrupted();
+
+        const char *ptr = m_ptr;
+        m_ptr += size;
+        return ptr;
+    }
+
+    std::unique_ptr<vle::value::Value> getMatrix()
+    {
+        auto columns = get<std::uint64_t>();
+        auto rows = get<std::uint64_t>();
+        auto columnmax = get<std::uint64_t>();
+        auto rowmax = get<std::uint64_t>();
+        auto stepcol = get<std::uint64_t>();
+        auto steprow = get<std::uint64_t>();
+
+        if (columns > columnmax or rows > rowmax or
+            (rows != 0 and columns > remaining() / rows))
+            corrupted();
+
+        std::unique_ptr<vle::value::Matrix> result;
+        if (columnmax * rowmax == 0)
+            result.reset(new vle::value::Matrix(0, 0, stepcol, steprow));
+        else
+            result.reset(new vle::value::Matrix(
+                columns, rows, columnmax, rowmax, stepcol, steprow));
+
+        for (std::uint64_t r = 0; r < rows; ++r)
+            for (std::uint64_t c = 0; c < columns; ++c) {
+                auto value = getOptional();
+                if (value)
+                    result->set(c, r, std::move(value));
+            }
+
+        return result;
+    }
+};
+
+void write_conditions(CompiledWriter &out, const vle::vpz::Conditions &cnds)
+{
+    out.put<std::uint32_t>(
+        static_cast<std::uint32_t>(cnds.conditionlist().size()));
+    for (const auto &cnd : cnds) {
+        out.put(cnd.second.name());
+        out.put<std::uint8_t>(cnd.second.isPermanent() ? 1 : 0);
+        out.put<std::uint32_t>(
+            static_cast<std::uint32_t>(cnd.second.conditionvalues().size()));
+
+        for (const auto &port : cnd.second.conditionvalues()) {
+            out.put(port.first);
+            out.put<std::uint64_t>(port.second.size());
+            for (const auto &value : port.second)
+                out.putOptional(value.get());
+        }
+    }
+}
+
+void read_conditions(CompiledReader &in, vle::vpz::Conditions &cnds)
+{
+    for (auto i = in.get<std::uint32_t>(); i > 0; --i) {
+        vle::vpz::Condition &cnd(cnds.add(vle::vpz::Condition(in.getString())));
+        cnd.permanent(in.get<std::uint8_t>() != 0);
+
+        for (auto j = in.get<std::uint32_t>(); j > 0; --j) {
+            auto portname = in.getString();
+            cnd.add(portname);
+
+            auto &values = cnd.getSetValues(portname);
+            for (auto k = in.get<std::uint64_t>(); k > 0; --k)
+                values.emplace_back(in.getOptional());
+        }
+    }
+}
+
+void write_views(CompiledWriter &out, const vle::vpz::Views &views)
+{
+    out.put<std::uint32_t>(
+        static_cast<std::uint32_t>(views.outputs().outputlist().size()));
+    for (const auto &elem : views.outputs()) {
+        out.put(elem.second.name());
+        out.put(elem.second.location());
+        out.put(elem.second.plugin());
+        out.put(elem.second.package());
+        out.putOptional(elem.second.data().get());
+    }
+
+    out.put<std::uint32_t>(static_cast<std::uint32_t>(views.viewlist().size()));
+    for (const auto &elem : views) {
+        out.put(elem.second.name());
+        out.put<std::uint32_t>(elem.second.type());
+        out.put(elem.second.output());
+        out.put<double>(elem.second.timestep());
+        out.put(elem.second.data());
+        out.put<std::uint8_t>(elem.second.is_enable() ? 1 : 0);
+        out.put<std::uint8_t>(elem.second.aggregation());
+        out.put<double>(elem.second.window());
+    }
+
+    out.put<std::uint32_t>(static_cast<std::uint32_t>(
+        views.observables().observablelist().size()));
+    for (const auto &elem : views.observables()) {
+        out.put(elem.second.name());
+        out.put<std::uint8_t>(elem.second.isPermanent() ? 1 : 0);
+        out.put<std::uint32_t>(static_cast<std::uint32_t>(
+            elem.second.observableportlist().size()));
+
+        for (const auto &port : elem.second) {
+            out.put(port.second.name());
+            out.put<std::uint32_t>(
+                static_cast<std::uint32_t>(port.second.viewnamelist().size()));
+            for (const auto &view : port.second)
+                out.put(view);
+        }
+    }
+}
+
+void read_views(CompiledReader &in, vle::vpz::Views &views)
+{
+    for (auto i = in.get<std::uint32_t>(); i > 0; --i) {
+        auto name = in.getString();
+        auto location = in.getString();
+        auto plugin = in.getString();
+        auto package = in.getString();
+
+        auto &output =
+            views.outputs().addStream(name, location, plugin, package);
+        auto data = in.getOptional();
+        if (data)
+            output.setData(std::move(data));
+    }
+
+    for (auto i = in.get<std::uint32_t>(); i > 0; --i) {
+        auto name = in.getString();
+        auto type = static_cast<vle::vpz::View::Type>(in.get<std::uint32_t>());
+        auto output = in.getString();
+        auto timestep = in.get<double>();
+        auto data = in.getString();
+        bool enable = in.get<std::uint8_t>() != 0;
+        auto aggregation = in.get<std::uint8_t>();
+        auto window = in.get<double>();
+
+        if (aggregation > vle::vpz::View::AGGREGATE_SUM)
+            CompiledReader::corrupted();
+
+        auto &view =
+            views.add(vle::vpz::View(name, type, output, timestep, enable));
+        view.setData(data);
+        view.setAggregation(
+            static_cast<vle::vpz::View::Aggregation>(aggregation), window);
+    }
+
+    for (auto i = in.get<std::uint32_t>(); i > 0; --i) {
+        auto &obs = views.addObservable(in.getString());
+        obs.permanent(in.get<std::uint8_t>() != 0);
+
+        for (auto j = in.get<std::uint32_t>(); j > 0; --j) {
+            auto &port = obs.add(in.getString());
+            for (auto k = in.get<std::uint32_t>(); k > 0; --k)
+                port.add(in.getString());
+        }
+    }
+}
+
+} // anonymous namespace
+
+namespace vle {
+namespace vpz {
+
+std::uint64_t compiledHash(const std::string &filename)
+{
+    utils::MappedFile file(filename);
+
+    std::uint64_t hash = UINT64_C(14695981039346656037);
+    const auto *ptr = reinterpret_cast<const unsigned char *>(file.data());
+
+    for (std::size_t i = 0, e = file.size(); i != e; ++i) {
+        hash ^= ptr[i];
+        hash *= UINT64_C(1099511628211);
+    }
+
+    return hash;
+}
+
+void writeCompiled(const Vpz &vpz,
+                   const std::string &filename,
+                   std::uint64_t hash)
+{
+    CompiledWriter out;
+
+    for (char c : compiled_magic)
+        out.put<char>(c);
+    out.put<std::uint32_t>(compiled_version);
+    out.put<std::uint32_t>(compiled_byte_order);
+    out.put<std::uint64_t>(hash);
+
+    const Project &prj = vpz.project();
+    out.put(prj.author());
+    out.put(prj.date());
+    out.put(prj.version());
+    out.put<std::int32_t>(prj.instance());
+
+    out.put<std::uint8_t>(prj.model().node() ? 1 : 0);
+    if (prj.model().node())
+        out.put(*prj.model().node());
+
+    out.put<std::uint32_t>(
+        static_cast<std::uint32_t>(prj.dynamics().dynamiclist().size()));
+    for (const auto &elem : prj.dynamics()) {
+        out.put(elem.second.name());
+        out.put(elem.second.package());
+        out.put(elem.second.library());
+        out.put(elem.second.language());
+        out.put<std::uint8_t>(elem.second.isPermanent() ? 1 : 0);
+    }
+
+    out.put<std::uint32_t>(
+        static_cast<std::uint32_t>(prj.classes().list().size()));
+    for (const auto &elem : prj.classes()) {
+        out.put(elem.second.name());
+        out.put<std::uint8_t>(elem.second.node() ? 1 : 0);
+        if (elem.second.node())
+            out.put(*elem.second.node());
+    }
+
+    const Experiment &exp = prj.experiment();
+    out.put(exp.name());
+    out.put(exp.combination());
+    write_conditions(out, exp.conditions());
+    write_views(out, exp.views());
+
+    /*
+     * The file is written next to the destination with a unique name and
+     * renamed to never expose a partially written file to a concurrent
+     * reader nor share the temporary file with a concurrent compilation.
+     */
+    std::string tmp =
+        filename + utils::Path::unique_path(".%%%%-%%%%-%%%%.tmp").string();
+
+    {
+        std::ofstream ofs(tmp, std::ios::binary | std::ios::trunc);
+        ofs.write(out.buffer().data(),
+                  static_cast<std::streamsize>(out.buffer().size()));
+
+        if (not ofs.good()) {
+            std::remove(tmp.c_str());
+            throw utils::FileError(
+                (fmt(_("Compiled vpz: cannot write file '%1%'")) % filename)
+                    .str());
+        }
+    }
+
+    if (std::rename(tmp.c_str(), filename.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        throw utils::FileError(
+            (fmt(_("Compiled vpz: cannot write file '%1%'")) % filename)
+                .str());
+    }
+}
+
+bool readCompiled(Vpz &vpz, const std::string &filename, std::uint64_t hash)
+{
+    std::unique_ptr<utils::MappedFile> file;
+
+    try {
+        file.reset(new utils::MappedFile(filename));
+    }
+    catch (const utils::FileError & /*e*/) {
+        return false;
+    }
+
+    if (file->empty())
+        return false;
+
+    CompiledReader in(file->data(), file->data() + file->size());
+
+    try {
+        for (char c : compiled_magic)
+            if (in.get<char>() != c)
+                return false;
+
+        if (in.get<std::uint32_t>() != compiled_version or
+            in.get<std::uint32_t>() != compiled_byte_order or
+            in.get<std::uint64_t>() != hash)
+            return false;
+    } catch (const utils::FileError & /*e*/) {
+        return false;
+    }
+
+    /* The sizes are checked before the allocations but a corrupted file
+       can still ask for a huge container (a matrix with a large reserve
+       for example) or build an invalid model graph: all these errors are
+       corruption errors. */
+    try {
+        Project &prj = vpz.project();
+        prj.setAuthor(in.getString());
+        prj.setDate(in.getString());
+        prj.setVersion(in.getString());
+        prj.setInstance(in.get<std::int32_t>());
+
+        if (in.get<std::uint8_t>())
+            prj.model().setGraph(
+                std::unique_ptr<BaseModel>(in.getModel(nullptr)));
+
+        for (auto i = in.get<std::uint32_t>(); i > 0; --i) {
+            Dynamic dyn(in.getString());
+            dyn.setPackage(in.getString());
+            dyn.setLibrary(in.getString());
+            dyn.setLanguage(in.getString());
+            dyn.permanent(in.get<std::uint8_t>() != 0);
+            prj.dynamics().add(dyn);
+        }
+
+        for (auto i = in.get<std::uint32_t>(); i > 0; --i) {
+            Class &cls = prj.classes().add(in.getString());
+            if (in.get<std::uint8_t>())
+                cls.setGraph(std::unique_ptr<BaseModel>(in.getModel(nullptr)));
+        }
+
+        Experiment &exp = prj.experiment();
+        exp.setName(in.getString());
+
+        auto combination = in.getString();
+        if (not combination.empty())
+            exp.setCombination(combination);
+        read_conditions(in, exp.conditions());
+        read_views(in, exp.views());
+
+        if (not in.finished())
+            CompiledReader::corrupted();
+    } catch (const utils::FileError & /*e*/) {
+        throw;
+    } catch (const std::exception & /*e*/) {
+        CompiledReader::corrupted();
+    }
+
+    return true;
+}
+}
+} // namespace vle vpz
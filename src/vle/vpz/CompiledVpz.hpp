@@ -0,0 +1,79 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_VPZ_COMPILEDVPZ_HPP
+#define VLE_VPZ_COMPILEDVPZ_HPP
+
+#include <cstdint>
+#include <string>
+#include <vle/DllDefines.hpp>
+
+namespace vle {
+namespace vpz {
+
+class Vpz;
+
+/**
+ * @brief Compute the FNV-1a 64 bits hash of the content of a file. The
+ * hash of the xml file is stored into the compiled vpz file to detect an
+ * out of date compiled file.
+ * @param filename The file to read.
+ * @return The hash of the file.
+ * @throw utils::FileError if the file cannot be read.
+ */
+VLE_LOCAL std::uint64_t compiledHash(const std::string &filename);
+
+/**
+ * @brief Write a binary form of the vpz into the file @e filename. The
+ * binary form stores the project, the model graph, the dynamics, the
+ * classes and the experiment with all the values of the conditions.
+ * @param vpz The vpz to write.
+ * @param filename The compiled file to write.
+ * @param hash The hash of the source xml file.
+ * @throw utils::FileError if the file cannot be written,
+ * utils::ArgError if a value cannot be compiled (value::User).
+ */
+VLE_LOCAL void writeCompiled(const Vpz &vpz,
+                             const std::string &filename,
+                             std::uint64_t hash);
+
+/**
+ * @brief Fill the vpz from the compiled file @e filename. The file is
+ * mapped in memory and read in place.
+ * @param vpz The vpz to fill. The vpz must be cleared before.
+ * @param filename The compiled file to read.
+ * @param hash The hash of the source xml file.
+ * @return false if the file does not exist, is not a compiled vpz, or
+ * if it was compiled from another version of the xml file.
+ * @throw utils::FileError if the compiled file is corrupted.
+ */
+VLE_LOCAL bool readCompiled(Vpz &vpz,
+                            const std::string &filename,
+                            std::uint64_t hash);
+}
+} // namespace vle vpz
+
+#endif
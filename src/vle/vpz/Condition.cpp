@@ -49,6 +49,7 @@ namespace vpz {
 Condition::Condition(const std::string &name)
     : Base()
     , m_name(name)
+    , m_ispermanent(false)
 {
 }
 
@@ -72,6 +72,13 @@ public:
      */
     Condition& operator=(const Condition &cnd);
 
+    /**
+     * @brief Move constructor. Values are moved, not cloned.
+     */
+    Condition(Condition &&cnd) = default;
+
+    Condition& operator=(Condition &&cnd) = default;
+
     /**
      * @brief Delete all the values attached to this Conditon.
      */
@@ -73,6 +73,8 @@ public:
 
     Conditions(const Conditions &cond) = default;
     Conditions &operator=(const Conditions &cond) = default;
+    Conditions(Conditions &&cond) = default;
+    Conditions &operator=(Conditions &&cond) = default;
 
     /**
      * @brief Nothing to delete.
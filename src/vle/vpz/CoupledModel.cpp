@@ -1484,11 +1484,11 @@ bool CoupledModel::newPosition()
             it->second->setY(y);
         }
 
-        if (it->second->x() > m_width)
-            it->second->setX(m_width);
+        if (it->second->x() > width())
+            it->second->setX(width());
 
-        if (it->second->y() > m_height)
-            it->second->setY(m_height);
+        if (it->second->y() > height())
+            it->second->setY(height());
 
         if (it->second->x() != x or it->second->y() != y) {
             correct = false;
@@ -24,9 +24,11 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cmath>
 #include <vle/utils/Exception.hpp>
 #include <vle/utils/i18n.hpp>
 #include <vle/value/Double.hpp>
+#include <vle/value/Integer.hpp>
 #include <vle/value/Set.hpp>
 #include <vle/vpz/Experiment.hpp>
 
@@ -142,6 +144,80 @@ double Experiment::begin() const
     return dur[0]->toDouble().value();
 }
 
+void Experiment::setResolution(double resolution)
+{
+    if (not conditions().exist(defaultSimulationEngineCondName()))
+        throw utils::ArgError(_("The simulation engine condition"
+                                "does not exist"));
+
+    if (resolution < 0.0 or std::isinf(resolution) or std::isnan(resolution))
+        throw utils::ArgError(_("The time resolution must be positive"));
+
+    auto &condSim = conditions().get(defaultSimulationEngineCondName());
+    condSim.setValueToPort("time-resolution",
+                           std::make_shared<vle::value::Double>(resolution));
+}
+
+double Experiment::resolution() const
+{
+    if (not conditions().exist(defaultSimulationEngineCondName()))
+        return 0.0;
+
+    const auto &condSim = conditions().get(defaultSimulationEngineCondName());
+    const auto &values = condSim.conditionvalues();
+    auto it = values.find("time-resolution");
+
+    if (it == values.end() or it->second.empty())
+        return 0.0;
+
+    const auto &value = it->second[0];
+    double ret = -1.0;
+    if (value and value->isInteger())
+        ret = static_cast<double>(value->toInteger().value());
+    else if (value and value->isDouble())
+        ret = value->toDouble().value();
+
+    if (ret < 0.0 or std::isinf(ret) or std::isnan(ret))
+        throw utils::ArgError(_("The time resolution must be positive"));
+
+    return ret;
+}
+
+void Experiment::setSeed(std::uint64_t seed)
+{
+    if (not conditions().exist(defaultSimulationEngineCondName()))
+        throw utils::ArgError(_("The simulation engine condition"
+                                "does not exist"));
+
+    auto &condSim = conditions().get(defaultSimulationEngineCondName());
+    condSim.setValueToPort(
+        "seed",
+        std::make_shared<vle::value::Integer>(static_cast<int64_t>(seed)));
+}
+
+std::uint64_t Experiment::seed() const
+{
+    if (not conditions().exist(defaultSimulationEngineCondName()))
+        return 1;
+
+    const auto &condSim = conditions().get(defaultSimulationEngineCondName());
+    const auto &values = condSim.conditionvalues();
+    auto it = values.find("seed");
+
+    if (it == values.end() or it->second.empty())
+        return 1;
+
+    const auto &value = it->second[0];
+    if (value and value->isInteger() and value->toInteger().value() >= 0)
+        return static_cast<std::uint64_t>(value->toInteger().value());
+
+    if (value and value->isDouble() and value->toDouble().value() >= 0.0 and
+        std::isfinite(value->toDouble().value()))
+        return static_cast<std::uint64_t>(value->toDouble().value());
+
+    throw utils::ArgError(_("The seed must be a positive number"));
+}
+
 void Experiment::cleanNoPermanent()
 {
     m_conditions.cleanNoPermanent();
@@ -150,7 +226,8 @@ void Experiment::cleanNoPermanent()
 
 void Experiment::setCombination(const std::string &name)
 {
-    if (name != "linear" and name != "total") {
+    if (name != "linear" and name != "total" and name != "lhs" and
+        name != "saltelli") {
         throw utils::ArgError(
             (fmt(_("Unknow combination '%1%'")) % name).str());
     }
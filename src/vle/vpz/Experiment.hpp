@@ -29,6 +29,7 @@
 #define VLE_VPZ_EXPERIMENT_HPP
 
 #include <vle/DllDefines.hpp>
+#include <cstdint>
 #include <vle/vpz/Base.hpp>
 #include <vle/vpz/Conditions.hpp>
 #include <vle/vpz/Views.hpp>
@@ -50,6 +51,11 @@ namespace vle { namespace vpz {
          */
         Experiment();
 
+        Experiment(const Experiment& exp) = default;
+        Experiment& operator=(const Experiment& exp) = default;
+        Experiment(Experiment&& exp) = default;
+        Experiment& operator=(Experiment&& exp) = default;
+
         /**
          * @brief Nothing to delete.
          */
@@ -179,6 +185,42 @@ namespace vle { namespace vpz {
          */
         double begin() const;
 
+        /**
+         * @brief Assign the time resolution of the simulation. The
+         * simulation kernel rounds the date of all the events to a multiple
+         * of the resolution.
+         * @param resolution The resolution, 0 for a continuous time.
+         * @throw utils::ArgError if resolution is < 0.
+         */
+        void setResolution(double resolution);
+
+        /**
+         * @brief Get the time resolution of the simulation from the
+         * @e time-resolution port (an integer or a real) of the
+         * simulation engine condition.
+         * @return The resolution or 0 if the port does not exist.
+         * @throw utils::ArgError if the resolution is not a positive
+         * number.
+         */
+        double resolution() const;
+
+        /**
+         * @brief Assign the seed of the random streams of the simulation
+         * (see devs::Dynamics::randStream).
+         * @param seed The new seed.
+         * @throw utils::ArgError if the simulation engine condition does
+         * not exist.
+         */
+        void setSeed(std::uint64_t seed);
+
+        /**
+         * @brief Get the seed of the random streams of the simulation from
+         * the @e seed port of the simulation engine condition.
+         * @return The seed or 1 if the port does not exist.
+         * @throw utils::ArgError if the seed is not a positive number.
+         */
+        std::uint64_t seed() const;
+
         /**
          * @brief Set the experimental design combination.
          * @param name The new name of experimental design combination.
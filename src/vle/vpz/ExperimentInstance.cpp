@@ -0,0 +1,157 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/i18n.hpp>
+#include <vle/value/Double.hpp>
+#include <vle/vpz/ExperimentInstance.hpp>
+
+namespace vle {
+namespace vpz {
+
+ExperimentInstance::ExperimentInstance(std::shared_ptr<const Vpz> base,
+                                       uint32_t index)
+  : m_base(std::move(base))
+  , m_index(index)
+{
+    if (not m_base)
+        throw utils::ArgError(_("ExperimentInstance: empty vpz"));
+
+    m_name = m_base->project().experiment().name();
+}
+
+void ExperimentInstance::overlay(const std::string &condition,
+                                 const std::string &port,
+                                 std::shared_ptr<value::Value> value)
+{
+    const auto &cnd = m_base->project().experiment().conditions().get(
+        condition);
+
+    if (cnd.conditionvalues().find(port) == cnd.conditionvalues().end())
+        throw utils::ArgError(
+            (fmt(_("ExperimentInstance: condition `%1%' has no port `%2%'")) %
+             condition % port)
+                .str());
+
+    m_overlay[condition][port] = std::move(value);
+}
+
+std::shared_ptr<value::Value>
+ExperimentInstance::value(const std::string &condition,
+                          const std::string &port) const
+{
+    auto it = m_overlay.find(condition);
+    if (it != m_overlay.end()) {
+        auto jt = it->second.find(port);
+        if (jt != it->second.end())
+            return jt->second;
+    }
+
+    const auto &values = m_base->project()
+                             .experiment()
+                             .conditions()
+                             .get(condition)
+                             .getSetValues(port);
+
+    return values.empty() ? std::shared_ptr<value::Value>() : values[0];
+}
+
+Conditions ExperimentInstance::conditions() const
+{
+    Conditions ret;
+    ret.conditionlist().clear();
+
+    for (const auto &cnd :
+         m_base->project().experiment().conditions().conditionlist()) {
+        Condition single(cnd.first);
+        single.permanent(cnd.second.isPermanent());
+        auto overlay = m_overlay.find(cnd.first);
+
+        for (const auto &port : cnd.second.conditionvalues()) {
+            auto &values = single.conditionvalues()[port.first];
+
+            if (overlay != m_overlay.end()) {
+                auto jt = overlay->second.find(port.first);
+                if (jt != overlay->second.end()) {
+                    values.emplace_back(jt->second);
+                    continue;
+                }
+            }
+
+            if (not port.second.empty())
+                values.emplace_back(port.second.front());
+        }
+
+        ret.conditionlist().emplace(cnd.first, std::move(single));
+    }
+
+    return ret;
+}
+
+Experiment ExperimentInstance::experiment() const
+{
+    const auto &exp = m_base->project().experiment();
+
+    Experiment ret;
+    ret.clear();
+    ret.setName(m_name);
+    if (not exp.combination().empty())
+        ret.setCombination(exp.combination());
+    ret.views() = exp.views();
+    ret.conditions() = conditions();
+
+    return ret;
+}
+
+std::unique_ptr<Vpz> ExperimentInstance::vpz() const
+{
+    std::unique_ptr<Vpz> ret(new Vpz(*m_base));
+    ret->project().setInstance(m_index);
+    ret->project().experiment() = experiment();
+
+    return ret;
+}
+
+double ExperimentInstance::begin() const
+{
+    auto ret = value(Experiment::defaultSimulationEngineCondName(), "begin");
+    if (not ret)
+        throw utils::ArgError(_("The simulation engine condition is empty"));
+
+    return ret->toDouble().value();
+}
+
+double ExperimentInstance::duration() const
+{
+    auto ret =
+        value(Experiment::defaultSimulationEngineCondName(), "duration");
+    if (not ret)
+        throw utils::ArgError(_("The simulation engine condition is empty"));
+
+    return ret->toDouble().value();
+}
+}
+} // namespace vle vpz
@@ -0,0 +1,141 @@
+/*
+ * This file is part of VLE, a framework for multi-modeling, simulation
+ * and analysis of complex dynamical systems.
+ * http://www.vle-project.org
+ *
+ * Copyright (c) 2003-2016 Gauthier Quesnel <quesnel@users.sourceforge.net>
+ * Copyright (c) 2003-2016 ULCO http://www.univ-littoral.fr
+ * Copyright (c) 2007-2016 INRA http://www.inra.fr
+ *
+ * See the AUTHORS or Authors.txt file for copyright owners and
+ * contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VLE_VPZ_EXPERIMENTINSTANCE_HPP
+#define VLE_VPZ_EXPERIMENTINSTANCE_HPP
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vle/DllDefines.hpp>
+#include <vle/vpz/Vpz.hpp>
+
+namespace vle {
+namespace vpz {
+
+/**
+ * @brief An ExperimentInstance is a lightweight combination of an
+ * experimental frame. It shares an immutable base @c vpz::Vpz between all
+ * the combinations and stores only an overlay of the condition values of
+ * the combination.
+ *
+ * Unlike a copy of the @c vpz::Vpz, building an ExperimentInstance does
+ * not clone the model tree, the classes or the condition values. The
+ * @c devs::RootCoordinator clones only the model tree it needs to run the
+ * simulation and shares the condition values (the values must not be
+ * modified by the models).
+ *
+ * @code
+ * auto base = std::make_shared<const vpz::Vpz>("file.vpz");
+ * vpz::ExperimentInstance instance(base, 0);
+ * instance.overlay("cond", "port", value::Double::create(1.0));
+ *
+ * devs::RootCoordinator root(context);
+ * root.load(instance);
+ * @endcode
+ */
+class VLE_API ExperimentInstance {
+public:
+    /**
+     * @brief Build an ExperimentInstance without overlay: each port of
+     * each condition is assigned with its first value.
+     * @param base The shared experimental frame.
+     * @param index The index of the combination.
+     * @throw utils::ArgError if base is null.
+     */
+    ExperimentInstance(std::shared_ptr<const Vpz> base, uint32_t index);
+
+    ExperimentInstance(const ExperimentInstance &) = default;
+    ExperimentInstance &operator=(const ExperimentInstance &) = default;
+    ExperimentInstance(ExperimentInstance &&) = default;
+    ExperimentInstance &operator=(ExperimentInstance &&) = default;
+
+    ~ExperimentInstance() = default;
+
+    /**
+     * @brief Replace the value of the port of the condition.
+     * @param condition The name of the condition.
+     * @param port The name of the port.
+     * @param value The value to use for this combination.
+     * @throw utils::ArgError if condition or port does not exist in the
+     * base.
+     */
+    void overlay(const std::string &condition,
+                 const std::string &port,
+                 std::shared_ptr<value::Value> value);
+
+    /**
+     * @brief Get the value of a port of a condition: the overlay value if
+     * it exists, the first value of the base otherwise.
+     * @return A null pointer if the port has no value.
+     * @throw utils::ArgError if condition or port does not exist.
+     */
+    std::shared_ptr<value::Value> value(const std::string &condition,
+                                        const std::string &port) const;
+
+    /**
+     * @brief Build the single-valued conditions of this combination. The
+     * values are shared with the base and the overlay, not cloned.
+     */
+    Conditions conditions() const;
+
+    /**
+     * @brief Build the experiment of this combination (name, views and
+     * single-valued conditions).
+     */
+    Experiment experiment() const;
+
+    /**
+     * @brief Build a complete @c vpz::Vpz for this combination. Use it
+     * only if a file must be written (sub-process for example).
+     */
+    std::unique_ptr<Vpz> vpz() const;
+
+    double begin() const;
+
+    double duration() const;
+
+    inline const Vpz &base() const { return *m_base; }
+
+    inline uint32_t index() const { return m_index; }
+
+    inline void setName(const std::string &name) { m_name = name; }
+
+    inline const std::string &name() const { return m_name; }
+
+private:
+    using PortOverlay =
+        std::unordered_map<std::string, std::shared_ptr<value::Value>>;
+
+    std::shared_ptr<const Vpz> m_base;
+    std::unordered_map<std::string, PortOverlay> m_overlay;
+    std::string m_name;
+    uint32_t m_index;
+};
+}
+} // namespace vle vpz
+
+#endif
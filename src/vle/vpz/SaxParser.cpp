@@ -42,6 +42,7 @@
 #include <vle/value/Double.hpp>
 #include <vle/value/Integer.hpp>
 #include <vle/value/Map.hpp>
+#include <vle/value/Mapped.hpp>
 #include <vle/value/Null.hpp>
 #include <vle/value/Set.hpp>
 #include <vle/value/String.hpp>
@@ -84,6 +85,7 @@ StartFuncList &starts()
         {(const xmlChar *)"table", &SaxParser::onTable},
         {(const xmlChar *)"xml", &SaxParser::onXML},
         {(const xmlChar *)"null", &SaxParser::onNull},
+        {(const xmlChar *)"mapped", &SaxParser::onMapped},
         {(const xmlChar *)"vle_project", &SaxParser::onVLEProject},
         {(const xmlChar *)"structures", &SaxParser::onStructures},
         {(const xmlChar *)"model", &SaxParser::onModel},
@@ -128,6 +130,7 @@ EndFuncList &ends()
         {(const xmlChar *)"table", &SaxParser::onEndTable},
         {(const xmlChar *)"xml", &SaxParser::onEndXML},
         {(const xmlChar *)"null", &SaxParser::onEndNull},
+        {(const xmlChar *)"mapped", &SaxParser::onEndMapped},
         {(const xmlChar *)"vle_project", &SaxParser::onEndVLEProject},
         {(const xmlChar *)"structures", &SaxParser::onEndStructures},
         {(const xmlChar *)"model", &SaxParser::onEndModel},
@@ -183,7 +186,7 @@ void SaxParser::parse(std::istream &is, std::size_t size)
 
     xmlSAXHandler sax;
     memset(&sax, 0, sizeof(xmlSAXHandler));
-    sax.initialized = XML_SAX2_MAGIC;
+    sax.initialized = 1;
     sax.startDocument = &SaxParser::onStartDocument;
     sax.endDocument = &SaxParser::onEndDocument;
     sax.startElement = &SaxParser::onStartElement;
@@ -542,6 +545,52 @@ void SaxParser::onNull(const xmlChar **)
     m_valuestack.pushNull();
 }
 
+void SaxParser::onMapped(const xmlChar **att)
+{
+    const xmlChar *package = nullptr;
+    const xmlChar *file = nullptr;
+    const xmlChar *type = nullptr;
+    const xmlChar *columns = nullptr;
+
+    for (int i = 0; att[i] != nullptr; i += 2) {
+        if (xmlStrcmp(att[i], (const xmlChar *)"package") == 0) {
+            package = att[i + 1];
+        }
+        else if (xmlStrcmp(att[i], (const xmlChar *)"file") == 0) {
+            file = att[i + 1];
+        }
+        else if (xmlStrcmp(att[i], (const xmlChar *)"type") == 0) {
+            type = att[i + 1];
+        }
+        else if (xmlStrcmp(att[i], (const xmlChar *)"columns") == 0) {
+            columns = att[i + 1];
+        }
+    }
+
+    if (not file) {
+        throw utils::SaxParserError(
+            _("Mapped tag does not have a 'file' attribute"));
+    }
+
+    value::Mapped::element_type elementtype = value::Mapped::DOUBLE;
+    if (type) {
+        try {
+            elementtype = value::Mapped::elementType(xmlCharToString(type));
+        }
+        catch (const utils::ArgError &e) {
+            throw utils::SaxParserError(e.what());
+        }
+    }
+
+    m_valuestack.pushNull();
+    m_valuestack.pushOnVectorValue<value::Mapped>(
+        package ? xmlCharToString(package) : std::string(),
+        xmlCharToString(file),
+        elementtype,
+        columns ? boost::numeric_cast<std::size_t>(xmlCharToInt(columns))
+                : std::size_t(0));
+}
+
 void SaxParser::onVLEProject(const xmlChar **att)
 {
     assert(not m_isValue);
@@ -798,6 +847,10 @@ void SaxParser::onEndNull()
     m_valuestack.pushOnVectorValue<value::Null>();
 }
 
+void SaxParser::onEndMapped()
+{
+}
+
 void SaxParser::onEndPort()
 {
     if (m_vpzstack.top()->isCondition()) {
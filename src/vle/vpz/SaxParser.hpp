@@ -187,6 +187,7 @@ public:
     void onTable(const xmlChar **att);
     void onXML(const xmlChar **att);
     void onNull(const xmlChar **att);
+    void onMapped(const xmlChar **att);
     void onVLEProject(const xmlChar **att);
     void onStructures(const xmlChar **att);
     void onModel(const xmlChar **att);
@@ -226,6 +227,7 @@ public:
     void onEndTable();
     void onEndXML();
     void onEndNull();
+    void onEndMapped();
     void onEndVLEProject();
     void onEndStructures();
     void onEndModel();
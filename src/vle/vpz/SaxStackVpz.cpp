@@ -753,6 +753,8 @@ void SaxStackVpz::pushView(const xmlChar **att)
     const xmlChar *output = nullptr;
     const xmlChar *timestep = nullptr;
     const xmlChar *enable = nullptr;
+    const xmlChar *aggregation = nullptr;
+    const xmlChar *window = nullptr;
 
     for (int i = 0; att[i] != nullptr; i += 2) {
         if (xmlStrcmp(att[i], (const xmlChar *)"name") == 0) {
@@ -770,6 +772,12 @@ void SaxStackVpz::pushView(const xmlChar **att)
         else if (xmlStrcmp(att[i], (const xmlChar *)"enable") == 0) {
             enable = att[i + 1];
         }
+        else if (xmlStrcmp(att[i], (const xmlChar *)"aggregation") == 0) {
+            aggregation = att[i + 1];
+        }
+        else if (xmlStrcmp(att[i], (const xmlChar *)"window") == 0) {
+            window = att[i + 1];
+        }
     }
 
     bool enable_b = true;
@@ -777,16 +785,17 @@ void SaxStackVpz::pushView(const xmlChar **att)
         enable_b = false;
     }
     Views &views(m_vpz.project().experiment().views());
+    View *view = nullptr;
 
     if (xmlStrcmp(type, (const xmlChar *)"timed") == 0) {
         if (not timestep) {
             throw utils::SaxParserError(
                 _("View tag does not have a timestep attribute"));
         }
-        views.addTimedView(xmlCharToString(name),
-                           xmlXPathCastStringToNumber(timestep),
-                           xmlCharToString(output),
-                           enable_b);
+        view = &views.addTimedView(xmlCharToString(name),
+                                   xmlXPathCastStringToNumber(timestep),
+                                   xmlCharToString(output),
+                                   enable_b);
     }
     else {
         using ustring = std::basic_string<unsigned char>;
@@ -822,10 +831,25 @@ void SaxStackVpz::pushView(const xmlChar **att)
                 begin = std::string::npos;
         }
 
-        views.addEventView(xmlCharToString(name),
-                           static_cast<View::Type>(viewtype),
-                           xmlCharToString(output),
-                           enable_b);
+        view = &views.addEventView(xmlCharToString(name),
+                                   static_cast<View::Type>(viewtype),
+                                   xmlCharToString(output),
+                                   enable_b);
+    }
+
+    if (aggregation) {
+        if (not window) {
+            throw utils::SaxParserError(
+                _("View tag does not have a window attribute"));
+        }
+
+        try {
+            view->setAggregation(
+                View::aggregation(xmlCharToString(aggregation)),
+                xmlXPathCastStringToNumber(window));
+        } catch (const utils::ArgError &e) {
+            throw utils::SaxParserError(std::string(e.what()));
+        }
     }
 }
 
@@ -34,10 +34,12 @@ namespace vle { namespace vpz {
 View::View(const std::string& name, View::Type type,
            const std::string& output, double timestep, bool enable)
     : m_timestep(timestep)
+    , m_window(0.0)
     , m_name(name)
     , m_output(output)
     , m_enabled(enable)
     , m_type(type)
+    , m_aggregation(AGGREGATE_NONE)
 {
     if (m_type == View::TIMED) {
         if (m_timestep <= 0.0) {
@@ -50,10 +52,12 @@ View::View(const std::string& name, View::Type type,
 
 View::View(const std::string& name)
     : m_timestep(0.0)
+    , m_window(0.0)
     , m_name(name)
     , m_enabled(true)
     , m_type(static_cast<Type>(View::INTERNAL | View::EXTERNAL |
                                View::CONFLUENT))
+    , m_aggregation(AGGREGATE_NONE)
 {
 }
 
@@ -67,6 +71,10 @@ void View::write(std::ostream& out) const
     if (m_type == TIMED)
         out << "timestep=\"" << m_timestep << "\" ";
 
+    if (m_aggregation != AGGREGATE_NONE)
+        out << "aggregation=\"" << aggregationName(m_aggregation) << "\" "
+            << "window=\"" << m_window << "\" ";
+
     if (m_data.empty()) {
         out << "/>\n";
     } else {
@@ -124,11 +132,57 @@ void View::setTimestep(double time)
     m_timestep = time;
 }
 
+void View::setAggregation(Aggregation aggregation, double window)
+{
+    if (aggregation != AGGREGATE_NONE and not (window > 0.0)) {
+        throw utils::ArgError(
+            (fmt(_("Bad aggregation window %1% for view %2%")) % window %
+             m_name).str());
+    }
+
+    m_aggregation = aggregation;
+    m_window = aggregation == AGGREGATE_NONE ? 0.0 : window;
+}
+
+const char* View::aggregationName(Aggregation aggregation)
+{
+    switch (aggregation) {
+    case AGGREGATE_MEAN:
+        return "mean";
+    case AGGREGATE_MIN:
+        return "min";
+    case AGGREGATE_MAX:
+        return "max";
+    case AGGREGATE_SUM:
+        return "sum";
+    default:
+        return "none";
+    }
+}
+
+View::Aggregation View::aggregation(const std::string& name)
+{
+    if (name == "none")
+        return AGGREGATE_NONE;
+    if (name == "mean")
+        return AGGREGATE_MEAN;
+    if (name == "min")
+        return AGGREGATE_MIN;
+    if (name == "max")
+        return AGGREGATE_MAX;
+    if (name == "sum")
+        return AGGREGATE_SUM;
+
+    throw utils::ArgError(
+        (fmt(_("Unknown view aggregation '%1%'")) % name).str());
+}
+
 bool View::operator==(const View& view) const
 {
     return m_name == view.name() and m_type == view.type()
 	and m_output == view.output()
-	and m_timestep == view.timestep() and m_data == view.data();
+	and m_timestep == view.timestep() and m_data == view.data()
+	and m_aggregation == view.aggregation() and m_window == view.window();
 }
 
 
@@ -55,6 +55,21 @@ namespace vle { namespace vpz {
             FINISH    = 1 << 6
         };
 
+        /**
+         * @brief Define the reduction applied by the kernel to the
+         * observations of a View. With an aggregation, the numeric values
+         * (double, integer or boolean) of each observable are reduced
+         * over a window and only the result of the window is sent to the
+         * Output.
+         */
+        enum Aggregation {
+            AGGREGATE_NONE,
+            AGGREGATE_MEAN,
+            AGGREGATE_MIN,
+            AGGREGATE_MAX,
+            AGGREGATE_SUM
+        };
+
         /**
          * @brief Build a new event view with a specific name.
          * @param name The name of the View.
@@ -84,6 +99,8 @@ namespace vle { namespace vpz {
          * @code
          * <view name="name" output="outout" type="event" />
          * <view name="name" output="output" type="finish" />
+         * <view name="name" output="output" type="timed" timestep="1"
+         *       aggregation="mean" window="24" />
          * @endcode
          * @param out Output stream.
          */
@@ -150,6 +167,43 @@ namespace vle { namespace vpz {
         inline double timestep() const
         { return m_timestep; }
 
+        /**
+         * @brief Get the aggregation of the observations.
+         * @return AGGREGATE_NONE by default.
+         */
+        inline Aggregation aggregation() const
+        { return m_aggregation; }
+
+        /**
+         * @brief Get the duration of the aggregation windows.
+         * @return A duration, 0 if the View does not aggregate.
+         */
+        inline double window() const
+        { return m_window; }
+
+        /**
+         * @brief Assign the aggregation of the observations. The first
+         * window starts at the begin of the simulation.
+         * @param aggregation The reduction.
+         * @param window The duration of a window.
+         * @throw utils::ArgError if the window is not greater than 0 and
+         * the aggregation is not AGGREGATE_NONE.
+         */
+        void setAggregation(Aggregation aggregation, double window);
+
+        /**
+         * @brief Get a string representation of the aggregation.
+         * @return "none", "mean", "min", "max" or "sum".
+         */
+        static const char* aggregationName(Aggregation aggregation);
+
+        /**
+         * @brief Get the aggregation from its string representation.
+         * @param name "none", "mean", "min", "max" or "sum".
+         * @throw utils::ArgError if the name is unknown.
+         */
+        static Aggregation aggregation(const std::string& name);
+
         /**
          * @brief Check if the view is enable.
          * @details Return true if the view is enabled. Default (in
@@ -209,11 +263,13 @@ namespace vle { namespace vpz {
 
     private:
         double          m_timestep;
+        double          m_window;
         std::string     m_name;
         std::string     m_output;
         std::string     m_data;
         bool            m_enabled;
         Type            m_type;
+        Aggregation     m_aggregation;
     };
 
 inline
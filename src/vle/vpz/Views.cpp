@@ -179,6 +179,8 @@ void Views::renameOutput(const std::string& oldname,
                 addEventView(copy.name(), copy.type(), newname);
                 break;
             }
+            get(copy.name()).setAggregation(copy.aggregation(),
+                                            copy.window());
         }
     }
 }
@@ -198,6 +200,7 @@ void Views::renameView(const std::string& oldname,
 	addEventView(newname, copy.type(), newname);
 	break;
     }
+    get(newname).setAggregation(copy.aggregation(), copy.window());
 }
 
 void Views::copyOutput(const std::string& outputname,
@@ -235,6 +238,7 @@ void Views::copyView(const std::string& viewname,
 	addEventView(copy.name(), copy.type(), copyoutputname);
 	break;
     }
+    get(copy.name()).setAggregation(copy.aggregation(), copy.window());
 }
 
 
@@ -29,9 +29,11 @@
 #include <limits>
 #include <sstream>
 #include <vle/utils/Exception.hpp>
+#include <vle/utils/Filesystem.hpp>
 #include <vle/utils/i18n.hpp>
 #include <vle/value/Double.hpp>
 #include <vle/vle.hpp>
+#include <vle/vpz/CompiledVpz.hpp>
 #include <vle/vpz/SaxParser.hpp>
 #include <vle/vpz/Vpz.hpp>
 
@@ -70,8 +72,25 @@ void Vpz::parseFile(const std::string &filename)
     project().experiment().conditions().deleteValueSet();
     m_filename.assign(filename);
 
-    vpz::SaxParser saxparser(*this);
-    saxparser.parseFile(filename);
+    bool compiled = false;
+    std::string compiledfile = compiledFilename(filename);
+
+    if (utils::Path(compiledfile).is_file()) {
+        try {
+            compiled =
+                readCompiled(*this, compiledfile, compiledHash(filename));
+        }
+        catch (const utils::FileError & /*e*/) {
+            clear();
+            project().experiment().conditions().deleteValueSet();
+            m_filename.assign(filename);
+        }
+    }
+
+    if (not compiled) {
+        vpz::SaxParser saxparser(*this);
+        saxparser.parseFile(filename);
+    }
 
     auto &cnd = project().experiment().conditions().get(
         Experiment::defaultSimulationEngineCondName());
@@ -82,6 +101,17 @@ void Vpz::parseFile(const std::string &filename)
     }
 }
 
+void Vpz::compile(const std::string &filename)
+{
+    Vpz vpz;
+    vpz.project().experiment().conditions().deleteValueSet();
+
+    vpz::SaxParser saxparser(vpz);
+    saxparser.parseFile(filename);
+
+    writeCompiled(vpz, compiledFilename(filename), compiledHash(filename));
+}
+
 void Vpz::parseMemory(const std::string &buffer)
 {
     clear();
@@ -82,12 +82,35 @@ public:
     virtual Base::type getType() const override { return VLE_VPZ_VPZ; }
 
     /**
-     * @brief Open a VPZ file project.
+     * @brief Open a VPZ file project. If the compiled form of the file
+     * (see compile()) exists and was compiled from the same content, it
+     * is loaded instead of the XML file.
      * @param filename file to read.
      * @throw utils::ArgError if an error occured during loading.
      */
     void parseFile(const std::string &filename);
 
+    /**
+     * @brief Parse the XML file @e filename and write its binary compiled
+     * form into compiledFilename(filename). The compiled file stores a
+     * hash of the XML file: parseFile() ignores it when the XML file
+     * changes.
+     * @param filename The VPZ file to compile.
+     * @throw utils::FileError if the compiled file cannot be written,
+     * utils::ArgError if the VPZ file cannot be parsed.
+     */
+    static void compile(const std::string &filename);
+
+    /**
+     * @brief Get the name of the compiled form of a VPZ file.
+     * @param filename The VPZ file.
+     * @return The VPZ file name with a \c c suffix (.vpzc).
+     */
+    static std::string compiledFilename(const std::string &filename)
+    {
+        return filename + 'c';
+    }
+
     /**
      * @brief Open a VPZ from a buffer.
      * @param buffer the buffer to parse XML.
@@ -25,14 +25,19 @@
  */
 
 #include <boost/algorithm/string.hpp>
+#include <fstream>
 #include <vle/utils/Context.hpp>
+#include <vle/utils/Exception.hpp>
+#include <vle/utils/Filesystem.hpp>
 #include <vle/utils/unit-test.hpp>
 #include <vle/value/Double.hpp>
 #include <vle/value/Integer.hpp>
 #include <vle/value/Map.hpp>
+#include <vle/value/Table.hpp>
 #include <vle/value/Value.hpp>
 #include <vle/vle.hpp>
 #include <vle/vpz/AtomicModel.hpp>
+#include <vle/vpz/CompiledVpz.hpp>
 #include <vle/vpz/CoupledModel.hpp>
 #include <vle/vpz/Vpz.hpp>
 
@@ -789,6 +794,145 @@ void test_read_write_read2()
     check_unittest_vpz(vpz2);
 }
 
+void test_compiled_vpz()
+{
+    auto ctx = vle::utils::make_context();
+    vpz::Vpz xml;
+    xml.parseFile(ctx->getTemplate("unittest.vpz").string());
+
+    auto tmp = vle::utils::Path::temp_directory_path() /
+               vle::utils::Path::unique_path("vle-%%%%-%%%%-%%%%.vpz");
+    auto filename = tmp.string();
+    auto compiledfile = vpz::Vpz::compiledFilename(filename);
+    xml.write(filename);
+
+    vpz::Vpz::compile(filename);
+    Ensures(vle::utils::Path(compiledfile).is_file());
+
+    {
+        // Read the compiled file only, without the xml fallback.
+        vpz::Vpz compiled;
+        compiled.project().experiment().conditions().deleteValueSet();
+        Ensures(vpz::readCompiled(
+            compiled, compiledfile, vpz::compiledHash(filename)));
+        check_unittest_vpz(compiled);
+    }
+
+    {
+        vpz::Vpz compiled(filename);
+        check_unittest_vpz(compiled);
+    }
+
+    {
+        // A modified xml file invalidates the compiled file.
+        std::ofstream ofs(filename, std::ios::app);
+        ofs << "\n";
+    }
+
+    {
+        vpz::Vpz stale;
+        Ensures(not vpz::readCompiled(
+            stale, compiledfile, vpz::compiledHash(filename)));
+    }
+
+    {
+        vpz::Vpz stale(filename);
+        check_unittest_vpz(stale);
+    }
+
+    {
+        // A truncated compiled file falls back to the xml file.
+        vpz::Vpz::compile(filename);
+        std::ifstream ifs(compiledfile, std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(ifs)),
+                            std::istreambuf_iterator<char>());
+        ifs.close();
+        std::ofstream ofs(compiledfile, std::ios::binary | std::ios::trunc);
+        ofs.write(content.data(), content.size() / 2);
+    }
+
+    {
+        vpz::Vpz truncated;
+        auto hash = vpz::compiledHash(filename);
+        EnsuresThrow(vpz::readCompiled(truncated, compiledfile, hash),
+                     vle::utils::FileError);
+    }
+
+    {
+        vpz::Vpz truncated(filename);
+        check_unittest_vpz(truncated);
+    }
+
+    vle::utils::Path(compiledfile).remove();
+    tmp.remove();
+}
+
+void test_compiled_vpz_corrupted()
+{
+    auto ctx = vle::utils::make_context();
+    vpz::Vpz xml;
+    xml.parseFile(ctx->getTemplate("unittest.vpz").string());
+
+    vpz::Condition table("table");
+    auto value = value::Table::create(3, 2);
+    value->toTable().get(0, 0) = 42.0;
+    table.addValueToPort("t", std::move(value));
+    xml.project().experiment().conditions().add(table);
+
+    auto tmp = vle::utils::Path::temp_directory_path() /
+               vle::utils::Path::unique_path("vle-%%%%-%%%%-%%%%.vpz");
+    auto filename = tmp.string();
+    auto compiledfile = vpz::Vpz::compiledFilename(filename);
+    xml.write(filename);
+    vpz::Vpz::compile(filename);
+
+    std::string content;
+    {
+        std::ifstream ifs(compiledfile, std::ios::binary);
+        content.assign((std::istreambuf_iterator<char>(ifs)),
+                       std::istreambuf_iterator<char>());
+    }
+
+    // Replace the width of the table by a huge value.
+    std::string pattern(1, static_cast<char>(value::Value::TABLE));
+    const std::uint64_t width = 3, height = 2;
+    pattern.append(reinterpret_cast<const char *>(&width), sizeof(width));
+    pattern.append(reinterpret_cast<const char *>(&height), sizeof(height));
+
+    auto position = content.find(pattern);
+    Ensures(position != std::string::npos);
+    if (position != std::string::npos) {
+        const std::uint64_t huge = UINT64_C(1) << 60;
+        content.replace(position + 1,
+                        sizeof(huge),
+                        reinterpret_cast<const char *>(&huge),
+                        sizeof(huge));
+
+        std::ofstream ofs(compiledfile, std::ios::binary | std::ios::trunc);
+        ofs.write(content.data(), content.size());
+    }
+
+    {
+        vpz::Vpz corrupted;
+        auto hash = vpz::compiledHash(filename);
+        EnsuresThrow(vpz::readCompiled(corrupted, compiledfile, hash),
+                     vle::utils::FileError);
+    }
+
+    {
+        // The xml file is used instead of the corrupted file.
+        vpz::Vpz fallback(filename);
+        const auto &values =
+            fallback.project().experiment().conditions().get("table")
+                .getSetValues("t");
+        EnsuresEqual(values.size(), 1);
+        EnsuresEqual(values[0]->toTable().get(0, 0), 42.0);
+    }
+
+    vle::utils::Path(compiledfile).remove();
+    tmp.remove();
+}
+
 void test_copy_del_views()
 {
     auto ctx = vle::utils::make_context();
@@ -855,6 +999,8 @@ int main()
     test_connection();
     test_read_write_read();
     test_read_write_read2();
+    test_compiled_vpz();
+    test_compiled_vpz_corrupted();
     test_copy_del_views();
     test_equal_dynamics();
     test_equal_outputs();
@@ -746,6 +746,32 @@ void test_name()
     EnsuresEqual(b->getCompleteName(), "top,top1,x");
 }
 
+void test_clear_graphics()
+{
+    CoupledModel top("top", nullptr);
+    AtomicModel *a = top.addAtomicModel("a");
+
+    Ensures(a->x() == -1 and a->width() == -1);
+
+    top.setSize(200, 100);
+    a->setPosition(10, 20);
+    a->setSize(30, 40);
+    EnsuresEqual(a->x(), 10);
+    EnsuresEqual(a->height(), 40);
+
+    std::unique_ptr<BaseModel> copy(top.clone());
+    top.clearGraphics();
+
+    EnsuresEqual(top.width(), -1);
+    EnsuresEqual(a->x(), -1);
+    EnsuresEqual(a->height(), -1);
+
+    auto *b = copy->toCoupled()->findModel("a");
+    EnsuresEqual(copy->width(), 200);
+    EnsuresEqual(b->x(), 10);
+    EnsuresEqual(b->height(), 40);
+}
+
 int main()
 {
     vle::Init app;
@@ -769,6 +795,7 @@ int main()
     test_atomic_model_source_2();
     test_atomic_model_source_3();
     test_name();
+    test_clear_graphics();
 
     return unit_test::report_errors();
 }